@@ -21,8 +21,17 @@ class AnimatedMaps {
     public:
         virtual AnimatedMapsOutputInstance::Pointer createInstance(MemoryResource* memRes) const = 0;
         virtual ConstArrayView<std::uint16_t> getAnimatedMapIndicesForLOD(std::uint16_t  /*unused*/) const = 0;
+        // Input indices of the conditional table rows used on the given LOD (parallel to the animated map indices)
+        virtual ConstArrayView<std::uint16_t> getAnimatedMapInputIndicesForLOD(std::uint16_t  /*unused*/) const = 0;
         virtual void calculate(const ControlsInputInstance* inputs, AnimatedMapsOutputInstance* outputs,
                                std::uint16_t lod) const = 0;
+        virtual void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                               ConstArrayView<AnimatedMapsOutputInstance*> outputs,
+                               std::uint16_t lod) const = 0;
+        // Recalculate only the animated maps computed by the given conditional table rows, which must
+        // contain all rows of those animated maps (of the current LOD), in ascending order
+        virtual void calculate(const ControlsInputInstance* inputs, AnimatedMapsOutputInstance* outputs,
+                               ConstArrayView<std::uint16_t> rows) const = 0;
         virtual void load(terse::BinaryInputArchive<BoundedIOStream>& archive) = 0;
         virtual void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) = 0;
 
@@ -8,6 +8,7 @@
 #include "riglogic/controls/ControlsInputInstance.h"
 
 #include <cassert>
+#include <cstddef>
 #include <utility>
 
 namespace rl4 {
@@ -30,12 +31,40 @@ ConstArrayView<std::uint16_t> AnimatedMapsImpl::getAnimatedMapIndicesForLOD(std:
     return outputIndices.subview(0ul, lods[lod]);
 }
 
+ConstArrayView<std::uint16_t> AnimatedMapsImpl::getAnimatedMapInputIndicesForLOD(std::uint16_t lod) const {
+    assert(lod < lods.size());
+    const auto inputIndices = conditionals.getInputIndices();
+    return inputIndices.subview(0ul, lods[lod]);
+}
+
 void AnimatedMapsImpl::calculate(const ControlsInputInstance* inputs, AnimatedMapsOutputInstance* outputs,
                                  std::uint16_t lod) const {
     assert(lod < lods.size());
     conditionals.calculateForward(inputs->getInputBuffer().data(), outputs->getOutputBuffer().data(), lods[lod]);
 }
 
+void AnimatedMapsImpl::calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                                 ConstArrayView<AnimatedMapsOutputInstance*> outputs,
+                                 std::uint16_t lod) const {
+    assert(lod < lods.size());
+    assert(inputs.size() == outputs.size());
+    auto memRes = lods.get_allocator().getMemoryResource();
+    Vector<const float*> inputBuffers{inputs.size(), nullptr, memRes};
+    Vector<float*> outputBuffers{outputs.size(), nullptr, memRes};
+    for (std::size_t bi = 0ul; bi < inputs.size(); ++bi) {
+        inputBuffers[bi] = inputs[bi]->getInputBuffer().data();
+        outputBuffers[bi] = outputs[bi]->getOutputBuffer().data();
+    }
+    conditionals.calculateForward(ConstArrayView<const float*>{inputBuffers},
+                                  ConstArrayView<float*>{outputBuffers},
+                                  lods[lod]);
+}
+
+void AnimatedMapsImpl::calculate(const ControlsInputInstance* inputs, AnimatedMapsOutputInstance* outputs,
+                                 ConstArrayView<std::uint16_t> rows) const {
+    conditionals.calculateForward(inputs->getInputBuffer().data(), outputs->getOutputBuffer().data(), rows);
+}
+
 void AnimatedMapsImpl::load(terse::BinaryInputArchive<BoundedIOStream>& archive) {
     archive(lods, conditionals);
 }
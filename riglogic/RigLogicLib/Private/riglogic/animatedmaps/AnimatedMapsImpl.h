@@ -20,8 +20,14 @@ class AnimatedMapsImpl : public AnimatedMaps {
                          AnimatedMapsOutputInstance::Factory instanceFactory_);
         AnimatedMapsOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         ConstArrayView<std::uint16_t> getAnimatedMapIndicesForLOD(std::uint16_t lod) const override;
+        ConstArrayView<std::uint16_t> getAnimatedMapInputIndicesForLOD(std::uint16_t lod) const override;
         void calculate(const ControlsInputInstance* inputs, AnimatedMapsOutputInstance* outputs,
                        std::uint16_t lod) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<AnimatedMapsOutputInstance*> outputs,
+                       std::uint16_t lod) const override;
+        void calculate(const ControlsInputInstance* inputs, AnimatedMapsOutputInstance* outputs,
+                       ConstArrayView<std::uint16_t> rows) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override;
 
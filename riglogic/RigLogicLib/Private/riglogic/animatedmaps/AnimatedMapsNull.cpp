@@ -14,10 +14,23 @@ ConstArrayView<std::uint16_t> AnimatedMapsNull::getAnimatedMapIndicesForLOD(std:
     return {};
 }
 
+ConstArrayView<std::uint16_t> AnimatedMapsNull::getAnimatedMapInputIndicesForLOD(std::uint16_t  /*unused*/) const {
+    return {};
+}
+
 void AnimatedMapsNull::calculate(const ControlsInputInstance*  /*unused*/, AnimatedMapsOutputInstance*  /*unused*/,
                                  std::uint16_t  /*unused*/) const {
 }
 
+void AnimatedMapsNull::calculate(ConstArrayView<const ControlsInputInstance*>  /*unused*/,
+                                 ConstArrayView<AnimatedMapsOutputInstance*>  /*unused*/,
+                                 std::uint16_t  /*unused*/) const {
+}
+
+void AnimatedMapsNull::calculate(const ControlsInputInstance*  /*unused*/, AnimatedMapsOutputInstance*  /*unused*/,
+                                 ConstArrayView<std::uint16_t>  /*unused*/) const {
+}
+
 void AnimatedMapsNull::load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) {
 }
 
@@ -17,8 +17,14 @@ class AnimatedMapsNull : public AnimatedMaps {
     public:
         AnimatedMapsOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         ConstArrayView<std::uint16_t> getAnimatedMapIndicesForLOD(std::uint16_t  /*unused*/) const override;
+        ConstArrayView<std::uint16_t> getAnimatedMapInputIndicesForLOD(std::uint16_t  /*unused*/) const override;
         void calculate(const ControlsInputInstance*  /*unused*/, AnimatedMapsOutputInstance*  /*unused*/,
                        std::uint16_t  /*unused*/) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*>  /*unused*/,
+                       ConstArrayView<AnimatedMapsOutputInstance*>  /*unused*/,
+                       std::uint16_t  /*unused*/) const override;
+        void calculate(const ControlsInputInstance*  /*unused*/, AnimatedMapsOutputInstance*  /*unused*/,
+                       ConstArrayView<std::uint16_t>  /*unused*/) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>&  /*unused*/) override;
 };
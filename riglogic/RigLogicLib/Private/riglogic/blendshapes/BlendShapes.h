@@ -21,8 +21,16 @@ class BlendShapes {
     public:
         virtual BlendShapesOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const = 0;
         virtual ConstArrayView<std::uint16_t> getBlendShapeChannelIndicesForLOD(std::uint16_t lod) const = 0;
+        // Input indices of the blend shape channel mappings used on the given LOD (parallel to the channel indices)
+        virtual ConstArrayView<std::uint16_t> getBlendShapeChannelInputIndicesForLOD(std::uint16_t lod) const = 0;
         virtual void calculate(const ControlsInputInstance* inputs, BlendShapesOutputInstance* outputs,
                                std::uint16_t lod) const = 0;
+        virtual void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                               ConstArrayView<BlendShapesOutputInstance*> outputs,
+                               std::uint16_t lod) const = 0;
+        // Recalculate only the given blend shape channel mappings (positions within the LOD's mappings)
+        virtual void calculate(const ControlsInputInstance* inputs, BlendShapesOutputInstance* outputs,
+                               ConstArrayView<std::uint16_t> mappingIndices) const = 0;
         virtual void load(terse::BinaryInputArchive<BoundedIOStream>& archive) = 0;
         virtual void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) = 0;
 
@@ -6,7 +6,9 @@
 #include "riglogic/blendshapes/BlendShapesOutputInstance.h"
 #include "riglogic/controls/ControlsInputInstance.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 namespace rl4 {
@@ -30,6 +32,11 @@ ConstArrayView<std::uint16_t> BlendShapesImpl::getBlendShapeChannelIndicesForLOD
     return {outputIndices.data(), lods[lod]};
 }
 
+ConstArrayView<std::uint16_t> BlendShapesImpl::getBlendShapeChannelInputIndicesForLOD(std::uint16_t lod) const {
+    assert(lod < lods.size());
+    return {inputIndices.data(), lods[lod]};
+}
+
 void BlendShapesImpl::calculate(const ControlsInputInstance* inputs, BlendShapesOutputInstance* outputs,
                                 std::uint16_t lod) const {
     assert(lod < lods.size());
@@ -41,6 +48,39 @@ void BlendShapesImpl::calculate(const ControlsInputInstance* inputs, BlendShapes
     }
 }
 
+void BlendShapesImpl::calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                                ConstArrayView<BlendShapesOutputInstance*> outputs,
+                                std::uint16_t lod) const {
+    assert(lod < lods.size());
+    assert(inputs.size() == outputs.size());
+    auto memRes = lods.get_allocator().getMemoryResource();
+    Vector<const float*> inputBuffers{inputs.size(), nullptr, memRes};
+    Vector<float*> outputBuffers{outputs.size(), nullptr, memRes};
+    for (std::size_t bi = 0ul; bi < inputs.size(); ++bi) {
+        auto outputBuffer = outputs[bi]->getOutputBuffer();
+        std::fill(outputBuffer.begin(), outputBuffer.end(), 0.0f);
+        inputBuffers[bi] = inputs[bi]->getInputBuffer().data();
+        outputBuffers[bi] = outputBuffer.data();
+    }
+    // Index pairs are loaded once and scattered into the outputs of all instances in the batch
+    for (std::uint16_t i = 0u; i < lods[lod]; ++i) {
+        const std::uint16_t inputIndex = inputIndices[i];
+        const std::uint16_t outputIndex = outputIndices[i];
+        for (std::size_t bi = 0ul; bi < inputBuffers.size(); ++bi) {
+            outputBuffers[bi][outputIndex] = inputBuffers[bi][inputIndex];
+        }
+    }
+}
+
+void BlendShapesImpl::calculate(const ControlsInputInstance* inputs, BlendShapesOutputInstance* outputs,
+                                ConstArrayView<std::uint16_t> mappingIndices) const {
+    const auto inputBuffer = inputs->getInputBuffer();
+    auto outputBuffer = outputs->getOutputBuffer();
+    for (auto i : mappingIndices) {
+        outputBuffer[outputIndices[i]] = inputBuffer[inputIndices[i]];
+    }
+}
+
 void BlendShapesImpl::load(terse::BinaryInputArchive<BoundedIOStream>& archive) {
     archive(lods, inputIndices, outputIndices);
 }
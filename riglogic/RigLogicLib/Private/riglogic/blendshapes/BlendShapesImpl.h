@@ -20,7 +20,13 @@ class BlendShapesImpl : public BlendShapes {
                         BlendShapesOutputInstance::Factory instanceFactory_);
         BlendShapesOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         ConstArrayView<std::uint16_t> getBlendShapeChannelIndicesForLOD(std::uint16_t lod) const override;
+        ConstArrayView<std::uint16_t> getBlendShapeChannelInputIndicesForLOD(std::uint16_t lod) const override;
         void calculate(const ControlsInputInstance* inputs, BlendShapesOutputInstance* outputs, std::uint16_t lod) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<BlendShapesOutputInstance*> outputs,
+                       std::uint16_t lod) const override;
+        void calculate(const ControlsInputInstance* inputs, BlendShapesOutputInstance* outputs,
+                       ConstArrayView<std::uint16_t> mappingIndices) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override;
 
@@ -14,10 +14,23 @@ ConstArrayView<std::uint16_t> BlendShapesNull::getBlendShapeChannelIndicesForLOD
     return {};
 }
 
+ConstArrayView<std::uint16_t> BlendShapesNull::getBlendShapeChannelInputIndicesForLOD(std::uint16_t  /*unused*/) const {
+    return {};
+}
+
 void BlendShapesNull::calculate(const ControlsInputInstance*  /*unused*/, BlendShapesOutputInstance*  /*unused*/,
                                 std::uint16_t  /*unused*/) const {
 }
 
+void BlendShapesNull::calculate(ConstArrayView<const ControlsInputInstance*>  /*unused*/,
+                                ConstArrayView<BlendShapesOutputInstance*>  /*unused*/,
+                                std::uint16_t  /*unused*/) const {
+}
+
+void BlendShapesNull::calculate(const ControlsInputInstance*  /*unused*/, BlendShapesOutputInstance*  /*unused*/,
+                                ConstArrayView<std::uint16_t>  /*unused*/) const {
+}
+
 void BlendShapesNull::load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) {
 }
 
@@ -16,8 +16,14 @@ class BlendShapesNull : public BlendShapes {
     public:
         BlendShapesOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         ConstArrayView<std::uint16_t> getBlendShapeChannelIndicesForLOD(std::uint16_t  /*unused*/) const override;
+        ConstArrayView<std::uint16_t> getBlendShapeChannelInputIndicesForLOD(std::uint16_t  /*unused*/) const override;
         void calculate(const ControlsInputInstance*  /*unused*/, BlendShapesOutputInstance*  /*unused*/,
                        std::uint16_t  /*unused*/) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*>  /*unused*/,
+                       ConstArrayView<BlendShapesOutputInstance*>  /*unused*/,
+                       std::uint16_t  /*unused*/) const override;
+        void calculate(const ControlsInputInstance*  /*unused*/, BlendShapesOutputInstance*  /*unused*/,
+                       ConstArrayView<std::uint16_t>  /*unused*/) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>&  /*unused*/) override;
 
@@ -145,6 +145,74 @@ void ConditionalTable::calculateForward(const float* inputs, float* outputs, std
     }
 }
 
+void ConditionalTable::calculateForward(ConstArrayView<const float*> inputs,
+                                        ConstArrayView<float*> outputs,
+                                        std::uint16_t rowCount) const {
+    assert(inputs.size() == outputs.size());
+    const std::size_t batchSize = inputs.size();
+    for (auto output : outputs) {
+        std::fill_n(output, outputCount, 0.0f);
+    }
+
+    // Each instance may match a different row within a sequence of intervals, so the row from which
+    // the evaluation resumes (after skipping the remaining intervals of a matched row) is tracked
+    // separately for each instance in the batch
+    Vector<std::uint16_t> nextRows{batchSize, {}, rangeMaps.get_allocator().getMemoryResource()};
+    for (std::uint16_t row = {}; row < rowCount; ++row) {
+        const std::uint16_t inIndex = inputIndices[row];
+        const std::uint16_t outIndex = outputIndices[row];
+        const float from = fromValues[row];
+        const float to = toValues[row];
+        const float slope = slopeValues[row];
+        const float cut = cutValues[row];
+        for (std::size_t bi = {}; bi < batchSize; ++bi) {
+            if (row < nextRows[bi]) {
+                continue;
+            }
+            const float inValue = inputs[bi][inIndex];
+            if ((from <= inValue) && (inValue <= to)) {
+                outputs[bi][outIndex] += (slope * inValue + cut);
+                nextRows[bi] = static_cast<std::uint16_t>(row + intervalsRemaining[row] + 1u);
+            }
+        }
+    }
+
+    for (auto output : outputs) {
+        for (std::size_t i = 0ul; i < outputCount; ++i) {
+            output[i] = extd::clamp(output[i], clampMin, clampMax);
+        }
+    }
+}
+
+void ConditionalTable::calculateForward(const float* inputs, float* outputs, ConstArrayView<std::uint16_t> rows) const {
+    // Only the outputs written by the given rows are recalculated, so all rows of those outputs must be present
+    for (auto row : rows) {
+        outputs[outputIndices[row]] = 0.0f;
+    }
+
+    std::uint16_t nextRow = {};
+    for (auto row : rows) {
+        if (row < nextRow) {
+            continue;
+        }
+        const float inValue = inputs[inputIndices[row]];
+        const float from = fromValues[row];
+        const float to = toValues[row];
+        if ((from <= inValue) && (inValue <= to)) {
+            const std::uint16_t outIndex = outputIndices[row];
+            const float slope = slopeValues[row];
+            const float cut = cutValues[row];
+            outputs[outIndex] += (slope * inValue + cut);
+            nextRow = static_cast<std::uint16_t>(row + intervalsRemaining[row] + 1u);
+        }
+    }
+
+    for (auto row : rows) {
+        const std::uint16_t outIndex = outputIndices[row];
+        outputs[outIndex] = extd::clamp(outputs[outIndex], clampMin, clampMax);
+    }
+}
+
 void ConditionalTable::calculateForward(const float* inputs, float* outputs) const {
     calculateForward(inputs, outputs, static_cast<std::uint16_t>(outputIndices.size()));
 }
@@ -79,6 +79,8 @@ class ConditionalTable {
         ConstArrayView<std::uint16_t> getOutputIndices() const;
         void calculateForward(const float* inputs, float* outputs) const;
         void calculateForward(const float* inputs, float* outputs, std::uint16_t rowCount) const;
+        void calculateForward(ConstArrayView<const float*> inputs, ConstArrayView<float*> outputs, std::uint16_t rowCount) const;
+        void calculateForward(const float* inputs, float* outputs, ConstArrayView<std::uint16_t> rows) const;
         void calculateReverse(float* inputs, const float* outputs) const;
         void calculateReverse(float* inputs, const float* outputs, std::uint16_t rowCount) const;
 
@@ -33,6 +33,18 @@ ConstArrayView<std::uint16_t> Controls::getPSDIndicesForLOD(std::uint16_t lod) c
     return psds.getPSDOutputIndicesForLOD(lod);
 }
 
+ConstArrayView<std::uint16_t> Controls::getPSDInputIndices(std::uint16_t psdIndex) const {
+    return psds.getPSDInputIndices(psdIndex);
+}
+
+ConstArrayView<std::uint16_t> Controls::getGUIToRawInputIndices() const {
+    return guiToRawMapping.getInputIndices();
+}
+
+ConstArrayView<std::uint16_t> Controls::getGUIToRawOutputIndices() const {
+    return guiToRawMapping.getOutputIndices();
+}
+
 void Controls::mapGUIToRaw(ControlsInputInstance* instance) const {
     auto guiControlBuffer = instance->getGUIControlBuffer();
     assert(guiControlBuffer.size() == guiToRawMapping.getInputCount());
@@ -51,4 +63,21 @@ void Controls::calculate(ControlsInputInstance* instance, std::uint16_t lod) con
     psds.calculate(instance->getInputBuffer(), instance->getClampBuffer(), lod);
 }
 
+void Controls::calculate(ConstArrayView<ControlsInputInstance*> instances, std::uint16_t lod) const {
+    auto memRes = initialValues.get_allocator().getMemoryResource();
+    Vector<ArrayView<float> > inputBuffers{memRes};
+    Vector<ArrayView<float> > clampBuffers{memRes};
+    inputBuffers.reserve(instances.size());
+    clampBuffers.reserve(instances.size());
+    for (auto instance : instances) {
+        inputBuffers.push_back(instance->getInputBuffer());
+        clampBuffers.push_back(instance->getClampBuffer());
+    }
+    psds.calculate(ArrayView<ArrayView<float> >{inputBuffers}, ArrayView<ArrayView<float> >{clampBuffers}, lod);
+}
+
+void Controls::calculate(ControlsInputInstance* instance, ConstArrayView<std::uint16_t> psdIndices) const {
+    psds.calculate(instance->getInputBuffer(), instance->getClampBuffer(), psdIndices);
+}
+
 }  // namespace rl4
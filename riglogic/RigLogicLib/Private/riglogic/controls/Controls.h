@@ -24,9 +24,15 @@ class Controls {
         ControlsInputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const;
         void registerControls(std::uint16_t lod, ConstArrayView<std::uint16_t> controlIndices);
         ConstArrayView<std::uint16_t> getPSDIndicesForLOD(std::uint16_t lod) const;
+        ConstArrayView<std::uint16_t> getPSDInputIndices(std::uint16_t psdIndex) const;
+        // GUI control and raw control of each row of the GUI to raw mapping
+        ConstArrayView<std::uint16_t> getGUIToRawInputIndices() const;
+        ConstArrayView<std::uint16_t> getGUIToRawOutputIndices() const;
         void mapGUIToRaw(ControlsInputInstance* instance) const;
         void mapRawToGUI(ControlsInputInstance* instance) const;
         void calculate(ControlsInputInstance* instance, std::uint16_t lod) const;
+        void calculate(ConstArrayView<ControlsInputInstance*> instances, std::uint16_t lod) const;
+        void calculate(ControlsInputInstance* instance, ConstArrayView<std::uint16_t> psdIndices) const;
 
         template<class Archive>
         void serialize(Archive& archive) {
@@ -78,6 +78,12 @@ ConstArrayView<std::uint16_t> PSDNet::getPSDOutputIndicesForLOD(std::uint16_t lo
     return outputLODs[lod];
 }
 
+ConstArrayView<std::uint16_t> PSDNet::getPSDInputIndices(std::uint16_t psdIndex) const {
+    assert((psdIndex >= psdMinIndex) && (psdIndex <= psdMaxIndex));
+    const PSD psd = psds[static_cast<std::size_t>(psdIndex) - static_cast<std::size_t>(psdMinIndex)];
+    return ConstArrayView<std::uint16_t>{inputIndicesPerPSD}.subview(psd.offset, psd.size);
+}
+
 void PSDNet::calculate(ArrayView<float> inputs, ArrayView<float> clampBuffer, std::uint16_t lod) const {
     ConstArrayView<std::uint16_t> inputIndices = inputLODs[lod];
     ConstArrayView<std::uint16_t> outputIndices = outputLODs[lod];
@@ -97,4 +103,46 @@ void PSDNet::calculate(ArrayView<float> inputs, ArrayView<float> clampBuffer, st
     }
 }
 
+void PSDNet::calculate(ArrayView<float> inputs, ArrayView<float> clampBuffer, ConstArrayView<std::uint16_t> psdIndices) const {
+    // Inputs are clamped as they are consumed, as only the inputs of the given PSDs are needed
+    for (auto psdIndex : psdIndices) {
+        const PSD psd = psds[static_cast<std::size_t>(psdIndex) - static_cast<std::size_t>(psdMinIndex)];
+        float psdOutput = psd.weight;
+        for (std::size_t i = psd.offset; i < psd.offset + psd.size; ++i) {
+            const std::uint16_t inputIndex = inputIndicesPerPSD[i];
+            clampBuffer[inputIndex] = extd::clamp(inputs[inputIndex], minPSDValue, maxPSDValue);
+            psdOutput *= clampBuffer[inputIndex];
+        }
+        inputs[psdIndex] = std::min(maxPSDValue, psdOutput);
+    }
+}
+
+void PSDNet::calculate(ArrayView<ArrayView<float> > inputs,
+                       ArrayView<ArrayView<float> > clampBuffers,
+                       std::uint16_t lod) const {
+    assert(inputs.size() == clampBuffers.size());
+    ConstArrayView<std::uint16_t> inputIndices = inputLODs[lod];
+    ConstArrayView<std::uint16_t> outputIndices = outputLODs[lod];
+    const std::size_t batchSize = inputs.size();
+
+    for (auto inputIndex : inputIndices) {
+        for (std::size_t bi = {}; bi < batchSize; ++bi) {
+            clampBuffers[bi][inputIndex] = extd::clamp(inputs[bi][inputIndex], minPSDValue, maxPSDValue);
+        }
+    }
+
+    // PSD descriptors and their input indices are loaded once for all instances in the batch
+    for (auto outputIndex : outputIndices) {
+        const PSD psd = psds[static_cast<std::size_t>(outputIndex) - static_cast<std::size_t>(psdMinIndex)];
+        for (std::size_t bi = {}; bi < batchSize; ++bi) {
+            ConstArrayView<float> clampBuffer = clampBuffers[bi];
+            float psdOutput = psd.weight;
+            for (std::size_t i = psd.offset; i < psd.offset + psd.size; ++i) {
+                psdOutput *= clampBuffer[inputIndicesPerPSD[i]];
+            }
+            inputs[bi][outputIndex] = std::min(maxPSDValue, psdOutput);
+        }
+    }
+}
+
 }  // namespace rl4
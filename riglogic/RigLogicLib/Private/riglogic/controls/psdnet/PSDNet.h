@@ -34,7 +34,12 @@ class PSDNet {
         std::uint16_t getPSDCount() const;
         ConstArrayView<std::uint16_t> getPSDInputIndicesForLOD(std::uint16_t lod) const;
         ConstArrayView<std::uint16_t> getPSDOutputIndicesForLOD(std::uint16_t lod) const;
+        ConstArrayView<std::uint16_t> getPSDInputIndices(std::uint16_t psdIndex) const;
         void calculate(ArrayView<float> inputs, ArrayView<float> clampBuffer, std::uint16_t lod) const;
+        void calculate(ArrayView<float> inputs, ArrayView<float> clampBuffer, ConstArrayView<std::uint16_t> psdIndices) const;
+        void calculate(ArrayView<ArrayView<float> > inputs,
+                       ArrayView<ArrayView<float> > clampBuffers,
+                       std::uint16_t lod) const;
 
         template<class Archive>
         void serialize(Archive& archive) {
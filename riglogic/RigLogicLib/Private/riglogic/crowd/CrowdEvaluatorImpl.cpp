@@ -0,0 +1,269 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/crowd/CrowdEvaluatorImpl.h"
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/riglogic/RigInstance.h"
+#include "riglogic/riglogic/RigLogicImpl.h"
+#include "riglogic/riglogic/Stats.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+namespace {
+
+// Coarse relative costs of the units of work done during evaluation, expressed in joint delta values.
+// They only need to be good enough to keep the initial distribution of instances between threads
+// balanced, as work stealing evens out the remaining differences.
+constexpr std::uint64_t instanceCost = 64ul;
+constexpr std::uint64_t psdCost = 2ul;
+constexpr std::uint64_t blendShapeChannelCost = 1ul;
+constexpr std::uint64_t animatedMapCost = 4ul;
+constexpr std::uint64_t rbfSolverCost = 512ul;
+constexpr std::uint64_t neuralNetworkCost = 4096ul;
+
+inline std::uint64_t estimateCost(const Stats& stats) {
+    return instanceCost +
+           static_cast<std::uint64_t>(stats.jointDeltaValueCount) +
+           static_cast<std::uint64_t>(stats.psdCount) * psdCost +
+           static_cast<std::uint64_t>(stats.blendShapeChannelCount) * blendShapeChannelCost +
+           static_cast<std::uint64_t>(stats.animatedMapCount) * animatedMapCost +
+           static_cast<std::uint64_t>(stats.rbfSolverCount) * rbfSolverCost +
+           static_cast<std::uint64_t>(stats.neuralNetworkCount) * neuralNetworkCost;
+}
+
+inline std::uint16_t resolveThreadCount(std::uint16_t threadCount) {
+    if (threadCount != 0u) {
+        return threadCount;
+    }
+    const unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+    return static_cast<std::uint16_t>(hardwareThreadCount > 1u ? hardwareThreadCount - 1u : 0u);
+}
+
+inline std::uint64_t packRange(std::uint32_t head, std::uint32_t tail) {
+    return (static_cast<std::uint64_t>(tail) << 32u) | static_cast<std::uint64_t>(head);
+}
+
+inline std::uint32_t getHead(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range & 0xFFFFFFFFul);
+}
+
+inline std::uint32_t getTail(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range >> 32u);
+}
+
+}  // namespace
+
+CrowdEvaluator* CrowdEvaluator::create(const RigLogic* rigLogic, std::uint16_t threadCount, MemoryResource* memRes) {
+    PolyAllocator<CrowdEvaluatorImpl> alloc{memRes};
+    return alloc.newObject(rigLogic, threadCount, memRes);
+}
+
+void CrowdEvaluator::destroy(CrowdEvaluator* instance) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    auto ptr = static_cast<CrowdEvaluatorImpl*>(instance);
+    PolyAllocator<CrowdEvaluatorImpl> alloc{ptr->getMemoryResource()};
+    alloc.deleteObject(ptr);
+}
+
+CrowdEvaluator::~CrowdEvaluator() = default;
+
+void CrowdEvaluatorImpl::WorkQueue::assign(std::uint32_t head, std::uint32_t tail) {
+    range.store(packRange(head, tail), std::memory_order_release);
+}
+
+bool CrowdEvaluatorImpl::WorkQueue::popFront(std::uint32_t& index) {
+    std::uint64_t current = range.load(std::memory_order_acquire);
+    while (getHead(current) < getTail(current)) {
+        const std::uint64_t desired = packRange(getHead(current) + 1u, getTail(current));
+        if (range.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            index = getHead(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CrowdEvaluatorImpl::WorkQueue::popBack(std::uint32_t& index) {
+    std::uint64_t current = range.load(std::memory_order_acquire);
+    while (getHead(current) < getTail(current)) {
+        const std::uint64_t desired = packRange(getHead(current), getTail(current) - 1u);
+        if (range.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            index = getTail(current) - 1u;
+            return true;
+        }
+    }
+    return false;
+}
+
+CrowdEvaluatorImpl::CrowdEvaluatorImpl(const RigLogic* rigLogic_, std::uint16_t threadCount, MemoryResource* memRes_) :
+    memRes{memRes_},
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    rigLogic{static_cast<const RigLogicImpl*>(rigLogic_)},
+    lodCosts{memRes_},
+    scheduledInstances{memRes_},
+    queuedInstances{memRes_},
+    queueLoads{memRes_},
+    queueOffsets{memRes_},
+    // Without background threads, all instances are put into a single queue, drained by the waiting thread
+    queues(std::max(static_cast<std::size_t>(resolveThreadCount(threadCount)), static_cast<std::size_t>(1ul)), memRes_),
+    threads{memRes_},
+    generation{},
+    stopping{false},
+    pendingCount{} {
+
+    const std::uint16_t lodCount = rigLogic->getLODCount();
+    lodCosts.resize(std::max(lodCount, static_cast<std::uint16_t>(1u)));
+    for (std::uint16_t lod = {}; lod < lodCount; ++lod) {
+        Stats stats{};
+        rigLogic->collectCalculationStats(lod, &stats);
+        lodCosts[lod] = estimateCost(stats);
+    }
+
+    queueLoads.resize(queues.size());
+    queueOffsets.resize(queues.size());
+
+    const std::uint16_t spawnCount = resolveThreadCount(threadCount);
+    threads.reserve(spawnCount);
+    for (std::size_t i = {}; i < spawnCount; ++i) {
+        threads.emplace_back(&CrowdEvaluatorImpl::work, this, i);
+    }
+}
+
+CrowdEvaluatorImpl::~CrowdEvaluatorImpl() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::uint16_t CrowdEvaluatorImpl::getThreadCount() const {
+    return static_cast<std::uint16_t>(threads.size());
+}
+
+void CrowdEvaluatorImpl::calculate(RigInstance** instances, std::size_t count) {
+    submit(instances, count);
+    wait();
+}
+
+void CrowdEvaluatorImpl::submit(RigInstance** instances, std::size_t count) {
+    wait();
+    if (count == 0ul) {
+        return;
+    }
+    pendingCount.store(count, std::memory_order_relaxed);
+    schedule(instances, count);
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        ++generation;
+    }
+    workAvailable.notify_all();
+}
+
+void CrowdEvaluatorImpl::wait() {
+    if (pendingCount.load(std::memory_order_acquire) == 0ul) {
+        return;
+    }
+    drain(0ul, threads.empty());
+    std::unique_lock<std::mutex> lock{mutex};
+    workFinished.wait(lock, [this]() {
+            return pendingCount.load(std::memory_order_acquire) == 0ul;
+        });
+}
+
+MemoryResource* CrowdEvaluatorImpl::getMemoryResource() {
+    return memRes;
+}
+
+void CrowdEvaluatorImpl::schedule(RigInstance** instances, std::size_t count) {
+    const auto maxLOD = static_cast<std::uint16_t>(lodCosts.size() - 1ul);
+    scheduledInstances.resize(count);
+    for (std::size_t i = {}; i < count; ++i) {
+        const std::uint16_t lod = std::min(instances[i]->getLOD(), maxLOD);
+        scheduledInstances[i] = ScheduledInstance{lodCosts[lod], instances[i], 0ul};
+    }
+    // Assigning the most expensive instances first to the least loaded queue (longest processing time first)
+    // keeps the estimated load of all queues close to even
+    std::sort(scheduledInstances.begin(), scheduledInstances.end(), [](const ScheduledInstance& lhs,
+                                                                       const ScheduledInstance& rhs) {
+            return lhs.cost > rhs.cost;
+        });
+    std::fill(queueLoads.begin(), queueLoads.end(), 0ul);
+    std::fill(queueOffsets.begin(), queueOffsets.end(), 0u);
+    for (auto& scheduled : scheduledInstances) {
+        const auto leastLoaded = std::min_element(queueLoads.begin(), queueLoads.end());
+        scheduled.queueIndex = static_cast<std::size_t>(std::distance(queueLoads.begin(), leastLoaded));
+        *leastLoaded += scheduled.cost;
+        ++queueOffsets[scheduled.queueIndex];
+    }
+    // Convert per-queue counts into start offsets of each queue's contiguous range
+    std::uint32_t offset = {};
+    for (auto& queueOffset : queueOffsets) {
+        const std::uint32_t queueSize = queueOffset;
+        queueOffset = offset;
+        offset += queueSize;
+    }
+    // Scatter instances into their queue's range, leaving each offset pointing to the end of its range
+    queuedInstances.resize(count);
+    for (const auto& scheduled : scheduledInstances) {
+        queuedInstances[queueOffsets[scheduled.queueIndex]++] = scheduled.instance;
+    }
+    for (std::size_t qi = {}; qi < queues.size(); ++qi) {
+        const std::uint32_t head = (qi == 0ul ? 0u : queueOffsets[qi - 1ul]);
+        queues[qi].assign(head, queueOffsets[qi]);
+    }
+}
+
+void CrowdEvaluatorImpl::work(std::size_t queueIndex) {
+    std::uint64_t lastGeneration = {};
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            workAvailable.wait(lock, [this, lastGeneration]() {
+                    return stopping || (generation != lastGeneration);
+                });
+            if (stopping) {
+                return;
+            }
+            lastGeneration = generation;
+        }
+        drain(queueIndex, true);
+    }
+}
+
+void CrowdEvaluatorImpl::drain(std::size_t queueIndex, bool ownsQueue) {
+    const std::size_t queueCount = queues.size();
+    std::uint32_t index = {};
+    while (true) {
+        bool acquired = ownsQueue && queues[queueIndex].popFront(index);
+        for (std::size_t offset = 1ul; !acquired && (offset <= queueCount); ++offset) {
+            acquired = queues[(queueIndex + offset) % queueCount].popBack(index);
+        }
+        if (!acquired) {
+            return;
+        }
+        rigLogic->calculate(queuedInstances[index]);
+        if (pendingCount.fetch_sub(1ul, std::memory_order_acq_rel) == 1ul) {
+            std::lock_guard<std::mutex> lock{mutex};
+            workFinished.notify_all();
+        }
+    }
+}
+
+}  // namespace rl4
@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/riglogic/CrowdEvaluator.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+class RigLogicImpl;
+
+class CrowdEvaluatorImpl : public CrowdEvaluator {
+    public:
+        CrowdEvaluatorImpl(const RigLogic* rigLogic_, std::uint16_t threadCount, MemoryResource* memRes_);
+        ~CrowdEvaluatorImpl();
+
+        CrowdEvaluatorImpl(const CrowdEvaluatorImpl&) = delete;
+        CrowdEvaluatorImpl& operator=(const CrowdEvaluatorImpl&) = delete;
+
+        CrowdEvaluatorImpl(CrowdEvaluatorImpl&&) = delete;
+        CrowdEvaluatorImpl& operator=(CrowdEvaluatorImpl&&) = delete;
+
+        std::uint16_t getThreadCount() const override;
+        void calculate(RigInstance** instances, std::size_t count) override;
+        void submit(RigInstance** instances, std::size_t count) override;
+        void wait() override;
+
+        MemoryResource* getMemoryResource();
+
+    private:
+        struct ScheduledInstance {
+            std::uint64_t cost;
+            RigInstance* instance;
+            std::size_t queueIndex;
+        };
+
+        // A range of queued instances [head, tail) packed into a single word, so it can be updated atomically.
+        // The owner thread takes instances from the head, while threads that ran out of work steal from the tail.
+        struct WorkQueue {
+            std::atomic<std::uint64_t> range;
+            // Keep queues of different threads on separate cache lines
+            char padding[64ul - sizeof(std::atomic<std::uint64_t>)];
+
+            WorkQueue() : range{}, padding{} {
+            }
+
+            void assign(std::uint32_t head, std::uint32_t tail);
+            bool popFront(std::uint32_t& index);
+            bool popBack(std::uint32_t& index);
+        };
+
+    private:
+        void schedule(RigInstance** instances, std::size_t count);
+        void work(std::size_t queueIndex);
+        void drain(std::size_t queueIndex, bool ownsQueue);
+
+    private:
+        MemoryResource* memRes;
+        const RigLogicImpl* rigLogic;
+        Vector<std::uint64_t> lodCosts;
+        Vector<ScheduledInstance> scheduledInstances;
+        Vector<RigInstance*> queuedInstances;
+        Vector<std::uint64_t> queueLoads;
+        Vector<std::uint32_t> queueOffsets;
+        Vector<WorkQueue> queues;
+        Vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workFinished;
+        std::uint64_t generation;
+        bool stopping;
+        std::atomic<std::size_t> pendingCount;
+};
+
+}  // namespace rl4
@@ -20,7 +20,14 @@ enum class JointFilterAttributeType : std::uint8_t {
 }  // namespace
 
 JointBehaviorFilter::JointBehaviorFilter(const dna::Reader* reader_, MemoryResource* memRes) :
+    JointBehaviorFilter{reader_, nullptr, memRes} {
+}
+
+JointBehaviorFilter::JointBehaviorFilter(const dna::Reader* reader_,
+                                         const Vector<RepackedJointGroup>* repackedJointGroups_,
+                                         MemoryResource* memRes) :
     reader{reader_},
+    repackedJointGroups{repackedJointGroups_},
     filters{memRes} {
 }
 
@@ -117,6 +124,38 @@ bool JointBehaviorFilter::isAttributeEnabled(std::uint16_t absAttrIndex) const {
     return false;
 }
 
+ConstArrayView<std::uint16_t> JointBehaviorFilter::getLODs(std::uint16_t jointGroupIndex) const {
+    if (repackedJointGroups != nullptr) {
+        const auto& lods = (*repackedJointGroups)[jointGroupIndex].lods;
+        return ConstArrayView<std::uint16_t>{lods.data(), lods.size()};
+    }
+    return reader->getJointGroupLODs(jointGroupIndex);
+}
+
+ConstArrayView<std::uint16_t> JointBehaviorFilter::getInputIndices(std::uint16_t jointGroupIndex) const {
+    if (repackedJointGroups != nullptr) {
+        const auto& inputIndices = (*repackedJointGroups)[jointGroupIndex].inputIndices;
+        return ConstArrayView<std::uint16_t>{inputIndices.data(), inputIndices.size()};
+    }
+    return reader->getJointGroupInputIndices(jointGroupIndex);
+}
+
+ConstArrayView<std::uint16_t> JointBehaviorFilter::getOutputIndices(std::uint16_t jointGroupIndex) const {
+    if (repackedJointGroups != nullptr) {
+        const auto& outputIndices = (*repackedJointGroups)[jointGroupIndex].outputIndices;
+        return ConstArrayView<std::uint16_t>{outputIndices.data(), outputIndices.size()};
+    }
+    return reader->getJointGroupOutputIndices(jointGroupIndex);
+}
+
+ConstArrayView<float> JointBehaviorFilter::getValues(std::uint16_t jointGroupIndex) const {
+    if (repackedJointGroups != nullptr) {
+        const auto& values = (*repackedJointGroups)[jointGroupIndex].values;
+        return ConstArrayView<float>{values.data(), values.size()};
+    }
+    return reader->getJointGroupValues(jointGroupIndex);
+}
+
 dna::TranslationUnit JointBehaviorFilter::getTranslationUnit() const {
     return reader->getTranslationUnit();
 }
@@ -142,11 +181,14 @@ std::uint16_t JointBehaviorFilter::getColumnCount() const {
 }
 
 std::uint16_t JointBehaviorFilter::getJointGroupCount() const {
+    if (repackedJointGroups != nullptr) {
+        return static_cast<std::uint16_t>(repackedJointGroups->size());
+    }
     return reader->getJointGroupCount();
 }
 
 void JointBehaviorFilter::copyInputIndices(std::uint16_t jointGroupIndex, ArrayView<std::uint16_t> dest) const {
-    const auto inputIndices = reader->getJointGroupInputIndices(jointGroupIndex);
+    const auto inputIndices = getInputIndices(jointGroupIndex);
     #if defined(_MSC_VER) && !defined(__clang__) && (_MSC_VER < 1938)
         #if (_MSC_VER >= 1900) && (__cplusplus >= 202002L)
             std::copy(inputIndices.begin(),
@@ -163,7 +205,7 @@ void JointBehaviorFilter::copyInputIndices(std::uint16_t jointGroupIndex, ArrayV
 }
 
 void JointBehaviorFilter::copyOutputIndices(std::uint16_t jointGroupIndex, ArrayView<std::uint16_t> dest) const {
-    const auto outputIndices = reader->getJointGroupOutputIndices(jointGroupIndex);
+    const auto outputIndices = getOutputIndices(jointGroupIndex);
     std::uint16_t* pDst = dest.data();
     for (auto outputIndex : outputIndices) {
         if (isAttributeEnabled(outputIndex)) {
@@ -173,10 +215,10 @@ void JointBehaviorFilter::copyOutputIndices(std::uint16_t jointGroupIndex, Array
 }
 
 void JointBehaviorFilter::copyValues(std::uint16_t jointGroupIndex, ArrayView<float> dest) const {
-    const auto values = reader->getJointGroupValues(jointGroupIndex);
-    const auto outputIndices = reader->getJointGroupOutputIndices(jointGroupIndex);
+    const auto values = getValues(jointGroupIndex);
+    const auto outputIndices = getOutputIndices(jointGroupIndex);
     const auto rowCount = outputIndices.size();
-    const auto colCount = reader->getJointGroupInputIndices(jointGroupIndex).size();
+    const auto colCount = getInputIndices(jointGroupIndex).size();
     float* pDst = dest.data();
     for (std::size_t row = {}; row < rowCount; ++row) {
         if (isAttributeEnabled(outputIndices[row])) {
@@ -200,10 +242,10 @@ void JointBehaviorFilter::copyValues(std::uint16_t jointGroupIndex, ArrayView<fl
 }
 
 std::uint16_t JointBehaviorFilter::getRowCountForLOD(std::uint16_t jointGroupIndex, std::uint16_t lod) const {
-    const auto lods = reader->getJointGroupLODs(jointGroupIndex);
+    const auto lods = getLODs(jointGroupIndex);
     assert(lods.size() == reader->getLODCount());
 
-    const auto outputIndices = reader->getJointGroupOutputIndices(jointGroupIndex);
+    const auto outputIndices = getOutputIndices(jointGroupIndex);
     std::uint16_t rowCount = {};
     for (std::size_t row = {}; row < lods[lod]; ++row) {
         if (isAttributeEnabled(outputIndices[row])) {
@@ -218,7 +260,7 @@ std::uint16_t JointBehaviorFilter::getRowCount(std::uint16_t jointGroupIndex) co
 }
 
 std::uint16_t JointBehaviorFilter::getColumnCount(std::uint16_t jointGroupIndex) const {
-    return static_cast<std::uint16_t>(reader->getJointGroupInputIndices(jointGroupIndex).size());
+    return static_cast<std::uint16_t>(getInputIndices(jointGroupIndex).size());
 }
 
 const dna::Reader* JointBehaviorFilter::getReader() const {
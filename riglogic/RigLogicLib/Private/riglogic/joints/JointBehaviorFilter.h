@@ -3,6 +3,7 @@
 #pragma once
 
 #include "riglogic/TypeDefs.h"
+#include "riglogic/joints/JointGroupRepacking.h"
 
 namespace rl4 {
 
@@ -20,6 +21,10 @@ class JointBehaviorFilter {
 
     public:
         JointBehaviorFilter(const dna::Reader* reader_, MemoryResource* memRes);
+        // Joint groups are read from the given repacked joint groups instead of the reader (if not null)
+        JointBehaviorFilter(const dna::Reader* reader_,
+                            const Vector<RepackedJointGroup>* repackedJointGroups_,
+                            MemoryResource* memRes);
 
         JointBehaviorFilter& include(dna::TranslationRepresentation translationType);
         JointBehaviorFilter& include(dna::RotationRepresentation rotationType);
@@ -46,7 +51,7 @@ class JointBehaviorFilter {
 
         template<typename ... TAttr>
         JointBehaviorFilter only(TAttr... attrTypes) const {
-            JointBehaviorFilter filtered{reader, filters.get_allocator().getMemoryResource()};
+            JointBehaviorFilter filtered{reader, repackedJointGroups, filters.get_allocator().getMemoryResource()};
             return filtered.included(attrTypes ...);
         }
 
@@ -68,9 +73,14 @@ class JointBehaviorFilter {
 
     private:
         bool isAttributeEnabled(std::uint16_t absAttrIndex) const;
+        ConstArrayView<std::uint16_t> getLODs(std::uint16_t jointGroupIndex) const;
+        ConstArrayView<std::uint16_t> getInputIndices(std::uint16_t jointGroupIndex) const;
+        ConstArrayView<std::uint16_t> getOutputIndices(std::uint16_t jointGroupIndex) const;
+        ConstArrayView<float> getValues(std::uint16_t jointGroupIndex) const;
 
     private:
         const dna::Reader* reader;
+        const Vector<RepackedJointGroup>* repackedJointGroups;
         Vector<FilterType> filters;
 
 };
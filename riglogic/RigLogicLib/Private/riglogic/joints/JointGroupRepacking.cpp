@@ -0,0 +1,406 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/joints/JointGroupRepacking.h"
+
+#include "riglogic/system/simd/Utils.h"
+#include "riglogic/utils/Extd.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+namespace {
+
+constexpr std::uint32_t attributesPerJoint = 9u;
+constexpr std::uint32_t maxRowCount = std::numeric_limits<std::uint16_t>::max();
+constexpr std::uint32_t noCluster = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint16_t noLODDepth = std::numeric_limits<std::uint16_t>::max();
+
+bool isRotation(std::uint16_t outputIndex) {
+    const std::uint32_t relAttrIndex = outputIndex % attributesPerJoint;
+    return (relAttrIndex >= 3u) && (relAttrIndex < 6u);
+}
+
+struct SourceRow {
+    std::uint16_t jointGroupIndex;
+    std::uint16_t rowIndex;
+    std::uint16_t outputIndex;
+    // Number of LODs the row is in
+    std::uint16_t lodDepth;
+};
+
+struct Cluster {
+    Vector<std::uint32_t> rows;
+    // Bitset of the input indices on which any of the rows depend
+    Vector<std::uint64_t> columns;
+    std::uint32_t columnCount;
+    std::uint32_t version;
+    bool merged;
+    bool pinned;
+
+    Cluster(std::size_t wordCount, MemoryResource* memRes) :
+        rows{memRes},
+        columns{wordCount, {}, memRes},
+        columnCount{},
+        version{},
+        merged{},
+        pinned{} {
+    }
+
+};
+
+struct Merger {
+    std::uint64_t gain;
+    std::uint32_t target;
+    std::uint32_t other;
+    std::uint32_t targetVersion;
+    std::uint32_t otherVersion;
+
+    bool operator<(const Merger& rhs) const {
+        // Ties are broken towards the lowest cluster indices, so the outcome does not depend on the heap layout
+        if (gain != rhs.gain) {
+            return gain < rhs.gain;
+        }
+        if (target != rhs.target) {
+            return target > rhs.target;
+        }
+        return other > rhs.other;
+    }
+
+};
+
+std::uint32_t countBits(std::uint64_t word) {
+    std::uint32_t count = {};
+    for (; word != 0u; word &= (word - 1u)) {
+        ++count;
+    }
+    return count;
+}
+
+std::uint32_t countSharedColumns(const Cluster& lhs, const Cluster& rhs) {
+    std::uint32_t count = {};
+    for (std::size_t i = {}; i < lhs.columns.size(); ++i) {
+        count += countBits(lhs.columns[i] & rhs.columns[i]);
+    }
+    return count;
+}
+
+class LayoutCost {
+    public:
+        explicit LayoutCost(std::uint32_t rowAlignment_) : rowAlignment{rowAlignment_}, blockHeight{rowAlignment_ * 2u} {
+        }
+
+        std::uint64_t of(std::uint32_t rowCount, std::uint32_t columnCount) const {
+            const std::uint32_t paddedRowCount = extd::roundUp(rowCount, rowAlignment);
+            const std::uint32_t blockCount = (paddedRowCount + blockHeight - 1u) / blockHeight;
+            return static_cast<std::uint64_t>(columnCount) * (paddedRowCount / rowAlignment + blockCount + 1u);
+        }
+
+        void accumulate(JointGroupLayoutStats& stats, std::uint32_t rowCount, std::uint32_t columnCount) const {
+            const std::uint32_t paddedRowCount = extd::roundUp(rowCount, rowAlignment);
+            stats.jointGroupCount += 1u;
+            stats.rowCount += rowCount;
+            stats.columnCount += columnCount;
+            stats.paddedValueCount += paddedRowCount * columnCount;
+            stats.inputBroadcastCount += ((paddedRowCount + blockHeight - 1u) / blockHeight) * columnCount;
+        }
+
+    private:
+        std::uint32_t rowAlignment;
+        std::uint32_t blockHeight;
+
+};
+
+Vector<RepackedJointGroup> copyJointGroups(const dna::Reader* reader, MemoryResource* memRes) {
+    Vector<RepackedJointGroup> jointGroups{memRes};
+    jointGroups.reserve(reader->getJointGroupCount());
+    for (std::uint16_t jgi = {}; jgi < reader->getJointGroupCount(); ++jgi) {
+        jointGroups.emplace_back(memRes);
+        auto& group = jointGroups.back();
+        const auto lods = reader->getJointGroupLODs(jgi);
+        const auto inputIndices = reader->getJointGroupInputIndices(jgi);
+        const auto outputIndices = reader->getJointGroupOutputIndices(jgi);
+        const auto values = reader->getJointGroupValues(jgi);
+        const auto jointIndices = reader->getJointGroupJointIndices(jgi);
+        group.lods.assign(lods.begin(), lods.end());
+        group.inputIndices.assign(inputIndices.begin(), inputIndices.end());
+        group.outputIndices.assign(outputIndices.begin(), outputIndices.end());
+        group.values.assign(values.begin(), values.end());
+        group.jointIndices.assign(jointIndices.begin(), jointIndices.end());
+    }
+    return jointGroups;
+}
+
+}  // namespace
+
+std::uint32_t JointGroupRepacking::getRowAlignment(const Configuration& config) {
+    // Joint group rows are padded to the width of the float vectors of the resolved calculation type
+    switch (getActiveFeatures(config).calculationType) {
+        case CalculationType::AVX512:
+            return 16u;
+        case CalculationType::AVX:
+            return 8u;
+        default:
+            return 4u;
+    }
+}
+
+Vector<RepackedJointGroup> JointGroupRepacking::repack(const dna::Reader* reader,
+                                                       std::uint32_t rowAlignment,
+                                                       JointGroupRepackingReport* report,
+                                                       MemoryResource* memRes) {
+    const LayoutCost layoutCost{rowAlignment};
+    const std::uint16_t lodCount = reader->getLODCount();
+    const std::uint16_t jointGroupCount = reader->getJointGroupCount();
+
+    // Collect all non-zero rows of LOD 0, and measure the layout of the existing joint groups
+    JointGroupLayoutStats before = {};
+    std::uint64_t costBefore = {};
+    bool repackable = true;
+    std::size_t inputCount = {};
+    std::size_t jointCount = {};
+    Vector<SourceRow> sourceRows{memRes};
+    Vector<std::uint32_t> firstSourceRows{jointGroupCount, static_cast<std::uint32_t>(-1), memRes};
+    Vector<char> usedColumns{memRes};
+    for (std::uint16_t jgi = {}; jgi < jointGroupCount; ++jgi) {
+        const auto lods = reader->getJointGroupLODs(jgi);
+        const auto inputIndices = reader->getJointGroupInputIndices(jgi);
+        const auto outputIndices = reader->getJointGroupOutputIndices(jgi);
+        const auto values = reader->getJointGroupValues(jgi);
+        const std::size_t colCount = inputIndices.size();
+        // Rows of lower LODs must be a prefix of the rows of higher LODs
+        if (lods.size() != lodCount) {
+            repackable = false;
+        }
+        for (std::size_t lod = 1ul; lod < lods.size(); ++lod) {
+            repackable = repackable && (lods[lod] <= lods[lod - 1ul]);
+        }
+        for (const auto inputIndex : inputIndices) {
+            inputCount = std::max(inputCount, static_cast<std::size_t>(inputIndex) + 1ul);
+        }
+
+        const std::size_t rowCount = std::min((lods.size() == 0ul) ? std::size_t{} : static_cast<std::size_t>(lods[0]),
+                                              outputIndices.size());
+        usedColumns.assign(colCount, 0);
+        std::uint32_t usedRowCount = {};
+        for (std::size_t row = {}; row < rowCount; ++row) {
+            bool used = false;
+            for (std::size_t col = {}; col < colCount; ++col) {
+                if (values[row * colCount + col] != 0.0f) {
+                    usedColumns[col] = 1;
+                    used = true;
+                }
+            }
+            if (!used) {
+                continue;
+            }
+            const auto lodDepth = static_cast<std::uint16_t>(std::count_if(lods.begin(), lods.end(), [row](std::uint16_t size) {
+                    return row < size;
+                }));
+            if (firstSourceRows[jgi] == static_cast<std::uint32_t>(-1)) {
+                firstSourceRows[jgi] = static_cast<std::uint32_t>(sourceRows.size());
+            }
+            sourceRows.push_back({jgi, static_cast<std::uint16_t>(row), outputIndices[row], lodDepth});
+            jointCount = std::max(jointCount, static_cast<std::size_t>(outputIndices[row] / attributesPerJoint) + 1ul);
+            ++usedRowCount;
+        }
+        const auto usedColumnCount = static_cast<std::uint32_t>(std::count(usedColumns.begin(), usedColumns.end(), 1));
+        layoutCost.accumulate(before, usedRowCount, usedColumnCount);
+        costBefore += layoutCost.of(usedRowCount, usedColumnCount);
+    }
+
+    // Every joint starts out as a cluster of its own, holding all of its rows
+    const std::size_t wordCount = (inputCount + 63ul) / 64ul;
+    Vector<Cluster> clusters{memRes};
+    Vector<std::uint32_t> clusterOfJoint{jointCount, noCluster, memRes};
+    Vector<std::uint16_t> rotationLODDepths{jointCount, noLODDepth, memRes};
+    for (std::uint32_t sri = {}; sri < sourceRows.size(); ++sri) {
+        const SourceRow& sourceRow = sourceRows[sri];
+        const std::size_t jointIndex = sourceRow.outputIndex / attributesPerJoint;
+        if (clusterOfJoint[jointIndex] == noCluster) {
+            clusterOfJoint[jointIndex] = static_cast<std::uint32_t>(clusters.size());
+            clusters.emplace_back(wordCount, memRes);
+        }
+        Cluster& cluster = clusters[clusterOfJoint[jointIndex]];
+        cluster.rows.push_back(sri);
+        // The rotations converted in each LOD are found through the joint of the last rotation row of the LOD,
+        // which is only possible if no other joint is ordered between the rotation rows of a joint
+        if (isRotation(sourceRow.outputIndex)) {
+            if ((rotationLODDepths[jointIndex] != noLODDepth) && (rotationLODDepths[jointIndex] != sourceRow.lodDepth)) {
+                cluster.pinned = true;
+            }
+            rotationLODDepths[jointIndex] = sourceRow.lodDepth;
+        }
+        const auto inputIndices = reader->getJointGroupInputIndices(sourceRow.jointGroupIndex);
+        const auto values = reader->getJointGroupValues(sourceRow.jointGroupIndex);
+        const std::size_t colCount = inputIndices.size();
+        for (std::size_t col = {}; col < colCount; ++col) {
+            if (values[sourceRow.rowIndex * colCount + col] != 0.0f) {
+                cluster.columns[inputIndices[col] / 64u] |= (std::uint64_t{1} << (inputIndices[col] % 64u));
+            }
+        }
+    }
+    for (auto& cluster : clusters) {
+        cluster.columnCount = countSharedColumns(cluster, cluster);
+    }
+
+    auto evaluate = [&](std::uint32_t lhs, std::uint32_t rhs, Merger& merger) {
+            const Cluster& a = clusters[lhs];
+            const Cluster& b = clusters[rhs];
+            const auto rowCount = static_cast<std::uint32_t>(a.rows.size() + b.rows.size());
+            // Clusters without shared columns cost at least as much merged as separately, and joints whose rotation
+            // rows are not all in the same LODs keep a group of their own
+            const std::uint32_t sharedColumnCount = countSharedColumns(a, b);
+            if (a.pinned || b.pinned || (sharedColumnCount == 0u) || (rowCount > maxRowCount)) {
+                return false;
+            }
+            const std::uint64_t separate = layoutCost.of(static_cast<std::uint32_t>(a.rows.size()), a.columnCount) +
+                layoutCost.of(static_cast<std::uint32_t>(b.rows.size()), b.columnCount);
+            const std::uint64_t merged = layoutCost.of(rowCount, a.columnCount + b.columnCount - sharedColumnCount);
+            if (merged >= separate) {
+                return false;
+            }
+            merger = {separate - merged, std::min(lhs, rhs), std::max(lhs, rhs), 0u, 0u};
+            merger.targetVersion = clusters[merger.target].version;
+            merger.otherVersion = clusters[merger.other].version;
+            return true;
+        };
+
+    std::priority_queue<Merger, Vector<Merger>, std::less<Merger> > mergers{std::less<Merger>{}, Vector<Merger>{memRes}};
+    Merger merger = {};
+    for (std::uint32_t lhs = {}; lhs < clusters.size(); ++lhs) {
+        for (std::uint32_t rhs = lhs + 1u; rhs < clusters.size(); ++rhs) {
+            if (evaluate(lhs, rhs, merger)) {
+                mergers.push(merger);
+            }
+        }
+    }
+    while (!mergers.empty()) {
+        const Merger best = mergers.top();
+        mergers.pop();
+        Cluster& target = clusters[best.target];
+        Cluster& other = clusters[best.other];
+        // Skip mergers that were evaluated before either cluster changed
+        if (target.merged || other.merged || (target.version != best.targetVersion) || (other.version != best.otherVersion)) {
+            continue;
+        }
+        target.rows.insert(target.rows.end(), other.rows.begin(), other.rows.end());
+        for (std::size_t i = {}; i < wordCount; ++i) {
+            target.columns[i] |= other.columns[i];
+        }
+        target.columnCount = countSharedColumns(target, target);
+        ++target.version;
+        other.merged = true;
+        other.rows.clear();
+        for (std::uint32_t ci = {}; ci < clusters.size(); ++ci) {
+            if ((ci != best.target) && !clusters[ci].merged && evaluate(best.target, ci, merger)) {
+                mergers.push(merger);
+            }
+        }
+    }
+
+    JointGroupLayoutStats after = {};
+    std::uint64_t costAfter = {};
+    for (const auto& cluster : clusters) {
+        if (!cluster.merged) {
+            layoutCost.accumulate(after, static_cast<std::uint32_t>(cluster.rows.size()), cluster.columnCount);
+            costAfter += layoutCost.of(static_cast<std::uint32_t>(cluster.rows.size()), cluster.columnCount);
+        }
+    }
+
+    if (!repackable || (costAfter >= costBefore)) {
+        if (report != nullptr) {
+            report->before = before;
+            report->after = before;
+        }
+        return copyJointGroups(reader, memRes);
+    }
+    if (report != nullptr) {
+        report->before = before;
+        report->after = after;
+    }
+
+    Vector<RepackedJointGroup> jointGroups{memRes};
+    Vector<std::uint32_t> jointGroupOfJoint{jointCount, noCluster, memRes};
+    Vector<std::uint32_t> columnPositions{inputCount, {}, memRes};
+    for (std::uint32_t ci = {}; ci < clusters.size(); ++ci) {
+        Cluster& cluster = clusters[ci];
+        if (cluster.merged) {
+            continue;
+        }
+        jointGroups.emplace_back(memRes);
+        auto& group = jointGroups.back();
+
+        // Rows that are in the most LODs come first, and the rows of a joint stay next to each other within a LOD
+        std::sort(cluster.rows.begin(), cluster.rows.end(), [&sourceRows](std::uint32_t lhs, std::uint32_t rhs) {
+                const SourceRow& a = sourceRows[lhs];
+                const SourceRow& b = sourceRows[rhs];
+                if (a.lodDepth != b.lodDepth) {
+                    return a.lodDepth > b.lodDepth;
+                }
+                return a.outputIndex < b.outputIndex;
+            });
+
+        for (std::size_t inputIndex = {}; inputIndex < inputCount; ++inputIndex) {
+            if ((cluster.columns[inputIndex / 64ul] & (std::uint64_t{1} << (inputIndex % 64ul))) != 0u) {
+                columnPositions[inputIndex] = static_cast<std::uint32_t>(group.inputIndices.size());
+                group.inputIndices.push_back(static_cast<std::uint16_t>(inputIndex));
+            }
+        }
+
+        const std::size_t colCount = group.inputIndices.size();
+        group.values.resize(cluster.rows.size() * colCount, 0.0f);
+        group.lods.resize(lodCount, 0u);
+        for (std::size_t row = {}; row < cluster.rows.size(); ++row) {
+            const SourceRow& sourceRow = sourceRows[cluster.rows[row]];
+            const auto inputIndices = reader->getJointGroupInputIndices(sourceRow.jointGroupIndex);
+            const auto values = reader->getJointGroupValues(sourceRow.jointGroupIndex);
+            for (std::size_t col = {}; col < inputIndices.size(); ++col) {
+                const float value = values[sourceRow.rowIndex * inputIndices.size() + col];
+                if (value != 0.0f) {
+                    group.values[row * colCount + columnPositions[inputIndices[col]]] += value;
+                }
+            }
+            group.outputIndices.push_back(sourceRow.outputIndex);
+            group.jointIndices.push_back(static_cast<std::uint16_t>(sourceRow.outputIndex / attributesPerJoint));
+            jointGroupOfJoint[sourceRow.outputIndex / attributesPerJoint] = static_cast<std::uint32_t>(jointGroups.size() - 1ul);
+            for (std::uint16_t lod = {}; lod < sourceRow.lodDepth; ++lod) {
+                ++group.lods[lod];
+            }
+        }
+    }
+
+    // Joints without any non-zero rows stay with the rows of the group they were listed in
+    for (std::uint16_t jgi = {}; jgi < jointGroupCount; ++jgi) {
+        std::uint32_t destination = {};
+        if (firstSourceRows[jgi] != static_cast<std::uint32_t>(-1)) {
+            const std::size_t jointIndex = sourceRows[firstSourceRows[jgi]].outputIndex / attributesPerJoint;
+            destination = jointGroupOfJoint[jointIndex];
+        }
+        for (const auto jointIndex : reader->getJointGroupJointIndices(jgi)) {
+            if ((jointIndex >= jointCount) || (jointGroupOfJoint[jointIndex] == noCluster)) {
+                jointGroups[destination].jointIndices.push_back(jointIndex);
+            }
+        }
+    }
+    for (auto& group : jointGroups) {
+        std::sort(group.jointIndices.begin(), group.jointIndices.end());
+        group.jointIndices.erase(std::unique(group.jointIndices.begin(), group.jointIndices.end()), group.jointIndices.end());
+    }
+
+    return jointGroups;
+}
+
+}  // namespace rl4
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/riglogic/Configuration.h"
+#include "riglogic/riglogic/JointGroupRepacker.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+// A joint group in the same layout as stored in DNA
+struct RepackedJointGroup {
+    Vector<std::uint16_t> lods;
+    Vector<std::uint16_t> inputIndices;
+    Vector<std::uint16_t> outputIndices;
+    Vector<float> values;
+    Vector<std::uint16_t> jointIndices;
+
+    explicit RepackedJointGroup(MemoryResource* memRes) :
+        lods{memRes},
+        inputIndices{memRes},
+        outputIndices{memRes},
+        values{memRes},
+        jointIndices{memRes} {
+    }
+
+};
+
+/*
+ * Clusters joints into joint groups by the inputs their rows depend on
+ *
+ * Every joint (all of its non-zero rows, from whichever groups they are in) starts out as a cluster of its own,
+ * and the two clusters whose merger reduces the estimated evaluation cost the most are merged, until no merger
+ * reduces it any further. The cost of a group is estimated per column, as the padded row blocks it is multiplied
+ * with, plus the input broadcasts (one per block height, i.e. two vectors of rows), plus the input load itself.
+ * Rows of merged groups are ordered by the last LOD they are in, so each LOD is again a prefix of the rows.
+ * Joints whose rotation rows are not all in the same LODs are not merged with other joints, as their rotation
+ * rows could not be kept next to each other.
+ */
+struct JointGroupRepacking {
+    // Number of rows the joint groups are padded to, for the calculation type the given configuration resolves to
+    static std::uint32_t getRowAlignment(const Configuration& config);
+    // Returns the repacked joint groups, or a copy of the joint groups of the reader if repacking does not reduce the cost
+    static Vector<RepackedJointGroup> repack(const dna::Reader* reader,
+                                             std::uint32_t rowAlignment,
+                                             JointGroupRepackingReport* report,
+                                             MemoryResource* memRes);
+
+};
+
+}  // namespace rl4
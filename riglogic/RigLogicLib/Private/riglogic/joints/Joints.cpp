@@ -6,6 +6,8 @@
 #include "riglogic/riglogic/RigInstance.h"
 #include "riglogic/types/Aliases.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 
 namespace rl4 {
@@ -15,7 +17,9 @@ Joints::Joints(JointsEvaluator::Pointer evaluator_, MemoryResource* memRes) :
     neutralValues{memRes},
     variableAttributeIndices{memRes},
     jointIndices{memRes},
-    jointGroupCount{} {
+    jointGroupCount{},
+    workItemSlices{memRes},
+    workItemOffsets{memRes} {
 }
 
 Joints::Joints(JointsEvaluator::Pointer evaluator_,
@@ -27,7 +31,52 @@ Joints::Joints(JointsEvaluator::Pointer evaluator_,
     neutralValues{std::move(neutralValues_)},
     variableAttributeIndices{std::move(variableAttributeIndices_)},
     jointIndices{std::move(jointIndices_)},
-    jointGroupCount{jointGroupCount_} {
+    jointGroupCount{jointGroupCount_},
+    workItemSlices{neutralValues.get_allocator().getMemoryResource()},
+    workItemOffsets{neutralValues.get_allocator().getMemoryResource()} {
+    planWorkItems();
+}
+
+void Joints::planWorkItems() {
+    auto memRes = neutralValues.get_allocator().getMemoryResource();
+    const auto lodCount = static_cast<std::uint16_t>(jointIndices.size());
+    workItemSlices.assign(lodCount, Vector<JointGroupSlice>{memRes});
+    workItemOffsets.assign(lodCount, Vector<std::uint32_t>{memRes});
+    Vector<std::uint32_t> costs{memRes};
+    for (std::uint16_t lod = {}; lod < lodCount; ++lod) {
+        auto& slices = workItemSlices[lod];
+        costs.clear();
+        std::uint64_t totalCost = {};
+        std::uint32_t maxCost = {};
+        for (std::uint16_t jointGroupIndex = {}; jointGroupIndex < jointGroupCount; ++jointGroupIndex) {
+            const std::uint16_t sliceCount = evaluator->getJointGroupSliceCount(jointGroupIndex);
+            for (std::uint16_t sliceIndex = {}; sliceIndex < sliceCount; ++sliceIndex) {
+                const std::uint32_t cost = evaluator->getJointGroupSliceCost(lod, jointGroupIndex, sliceIndex);
+                // Slices without any rows on this LOD have nothing to evaluate
+                if (cost != 0u) {
+                    slices.push_back({jointGroupIndex, sliceIndex});
+                    costs.push_back(cost);
+                    totalCost += cost;
+                    maxCost = std::max(maxCost, cost);
+                }
+            }
+        }
+
+        const auto targetCost = std::max(static_cast<std::uint64_t>(maxCost), totalCost / targetWorkItemCount);
+        auto& offsets = workItemOffsets[lod];
+        offsets.push_back(0u);
+        std::uint64_t workItemCost = {};
+        for (std::size_t i = 0ul; i < slices.size(); ++i) {
+            if ((workItemCost != 0u) && (workItemCost + costs[i] > targetCost)) {
+                offsets.push_back(static_cast<std::uint32_t>(i));
+                workItemCost = {};
+            }
+            workItemCost += costs[i];
+        }
+        if (!slices.empty()) {
+            offsets.push_back(static_cast<std::uint32_t>(slices.size()));
+        }
+    }
 }
 
 JointsOutputInstance::Pointer Joints::createInstance(MemoryResource* instanceMemRes) const {
@@ -54,6 +103,60 @@ void Joints::calculate(const ControlsInputInstance* inputs,
     evaluator->calculate(inputs, outputs, lod, jointGroupIndex);
 }
 
+void Joints::calculateChanged(const ControlsInputInstance* inputs,
+                              ConstArrayView<float> previousInputs,
+                              JointsOutputInstance* outputs,
+                              std::uint16_t lod,
+                              std::uint16_t jointGroupIndex) const {
+    evaluator->calculateChanged(inputs, previousInputs, outputs, lod, jointGroupIndex);
+}
+
+void Joints::calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<JointsOutputInstance*> outputs,
+                       std::uint16_t lod) const {
+    evaluator->calculate(inputs, outputs, lod);
+}
+
+std::uint16_t Joints::getWorkItemCount(std::uint16_t lod) const {
+    if (lod >= workItemOffsets.size()) {
+        return {};
+    }
+    return static_cast<std::uint16_t>(workItemOffsets[lod].size() - 1ul);
+}
+
+void Joints::calculateWorkItem(const ControlsInputInstance* inputs,
+                               JointsOutputInstance* outputs,
+                               std::uint16_t lod,
+                               std::uint16_t workItemIndex) const {
+    assert(workItemIndex < getWorkItemCount(lod));
+    const auto& offsets = workItemOffsets[lod];
+    for (std::uint32_t i = offsets[workItemIndex]; i < offsets[workItemIndex + 1ul]; ++i) {
+        const auto& slice = workItemSlices[lod][i];
+        evaluator->calculate(inputs, outputs, lod, slice.jointGroupIndex, slice.sliceIndex);
+    }
+}
+
+void Joints::calculateUngrouped(const ControlsInputInstance* inputs, JointsOutputInstance* outputs, std::uint16_t lod) const {
+    evaluator->calculateUngrouped(inputs, outputs, lod);
+}
+
+std::uint16_t Joints::getUngroupedPartitionCount(std::uint16_t lod) const {
+    return evaluator->getUngroupedPartitionCount(lod);
+}
+
+void Joints::calculateUngrouped(const ControlsInputInstance* inputs,
+                                JointsOutputInstance* outputs,
+                                std::uint16_t lod,
+                                std::uint16_t partitionIndex) const {
+    evaluator->calculateUngrouped(inputs, outputs, lod, partitionIndex);
+}
+
+void Joints::collectJointGroupInputIndices(std::uint16_t lod,
+                                           std::uint16_t jointGroupIndex,
+                                           Vector<std::uint16_t>& inputIndices) const {
+    evaluator->collectJointGroupInputIndices(lod, jointGroupIndex, inputIndices);
+}
+
 ConstArrayView<float> Joints::getNeutralValues() const {
     return ConstArrayView<float>{neutralValues};
 }
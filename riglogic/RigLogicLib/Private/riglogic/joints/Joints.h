@@ -33,11 +33,36 @@ class Joints {
                        JointsOutputInstance* outputs,
                        std::uint16_t lod,
                        std::uint16_t jointGroupIndex) const;
+        void calculateChanged(const ControlsInputInstance* inputs,
+                              ConstArrayView<float> previousInputs,
+                              JointsOutputInstance* outputs,
+                              std::uint16_t lod,
+                              std::uint16_t jointGroupIndex) const;
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<JointsOutputInstance*> outputs,
+                       std::uint16_t lod) const;
+        // Work items evaluate all joint groups of a LOD, with roughly equal cost and disjoint outputs, by splitting large
+        // joint groups into slices, and merging slices of consecutive (small) joint groups
+        std::uint16_t getWorkItemCount(std::uint16_t lod) const;
+        void calculateWorkItem(const ControlsInputInstance* inputs,
+                               JointsOutputInstance* outputs,
+                               std::uint16_t lod,
+                               std::uint16_t workItemIndex) const;
+        void calculateUngrouped(const ControlsInputInstance* inputs, JointsOutputInstance* outputs, std::uint16_t lod) const;
+        std::uint16_t getUngroupedPartitionCount(std::uint16_t lod) const;
+        void calculateUngrouped(const ControlsInputInstance* inputs,
+                                JointsOutputInstance* outputs,
+                                std::uint16_t lod,
+                                std::uint16_t partitionIndex) const;
+        void collectJointGroupInputIndices(std::uint16_t lod,
+                                           std::uint16_t jointGroupIndex,
+                                           Vector<std::uint16_t>& inputIndices) const;
 
         template<class Archive>
         void load(Archive& archive) {
             evaluator->load(archive);
             archive >> neutralValues >> variableAttributeIndices >> jointIndices >> jointGroupCount;
+            planWorkItems();
         }
 
         template<class Archive>
@@ -50,12 +75,28 @@ class Joints {
         ConstArrayView<float> getNeutralValues() const;
         ConstArrayView<std::uint16_t> getVariableAttributeIndices(std::uint16_t lod) const;
 
+    private:
+        void planWorkItems();
+
+    private:
+        // Work items aim to be no cheaper than 1 / targetWorkItemCount of all joint groups of a LOD (unless a single
+        // slice is more expensive than that), leaving enough of them to balance the load of several workers
+        static constexpr std::uint32_t targetWorkItemCount = 32u;
+
+        struct JointGroupSlice {
+            std::uint16_t jointGroupIndex;
+            std::uint16_t sliceIndex;
+        };
+
     private:
         JointsEvaluator::Pointer evaluator;
         Vector<float> neutralValues;
         Matrix<std::uint16_t> variableAttributeIndices;
         Matrix<std::uint16_t> jointIndices;
         std::uint16_t jointGroupCount;
+        // Per LOD, work item i consists of slices [workItemOffsets[lod][i], workItemOffsets[lod][i + 1])
+        Matrix<JointGroupSlice> workItemSlices;
+        Matrix<std::uint32_t> workItemOffsets;
 
 };
 
@@ -26,6 +26,42 @@ class JointsEvaluator {
                                JointsOutputInstance* outputs,
                                std::uint16_t lod,
                                std::uint16_t jointGroupIndex) const = 0;
+        // Update the outputs of a joint group, last calculated from previousInputs, for the inputs that changed since
+        // (joint groups whose outputs are linear in their inputs may apply only the changes of those inputs)
+        virtual void calculateChanged(const ControlsInputInstance* inputs,
+                                      ConstArrayView<float> previousInputs,
+                                      JointsOutputInstance* outputs,
+                                      std::uint16_t lod,
+                                      std::uint16_t jointGroupIndex) const = 0;
+        // Joint groups may be split into slices with disjoint outputs, which can be evaluated concurrently, and which
+        // together produce the same outputs as evaluating the whole joint group
+        virtual std::uint16_t getJointGroupSliceCount(std::uint16_t jointGroupIndex) const = 0;
+        // Estimated cost of evaluating the given slice on the given LOD, in (roughly) multiply-adds
+        virtual std::uint32_t getJointGroupSliceCost(std::uint16_t lod,
+                                                     std::uint16_t jointGroupIndex,
+                                                     std::uint16_t sliceIndex) const = 0;
+        virtual void calculate(const ControlsInputInstance* inputs,
+                               JointsOutputInstance* outputs,
+                               std::uint16_t lod,
+                               std::uint16_t jointGroupIndex,
+                               std::uint16_t sliceIndex) const = 0;
+        virtual void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                               ConstArrayView<JointsOutputInstance*> outputs,
+                               std::uint16_t lod) const = 0;
+        // Evaluate behaviors not partitioned into joint groups, which must run after all joint groups are done
+        virtual void calculateUngrouped(const ControlsInputInstance* inputs, JointsOutputInstance* outputs,
+                                        std::uint16_t lod) const = 0;
+        // Behaviors not partitioned into joint groups may be split into partitions with disjoint outputs of their own,
+        // which can be evaluated concurrently (but still only after all joint groups are done)
+        virtual std::uint16_t getUngroupedPartitionCount(std::uint16_t lod) const = 0;
+        virtual void calculateUngrouped(const ControlsInputInstance* inputs,
+                                        JointsOutputInstance* outputs,
+                                        std::uint16_t lod,
+                                        std::uint16_t partitionIndex) const = 0;
+        // Append the input indices read by the given joint group on the given LOD (duplicates are allowed)
+        virtual void collectJointGroupInputIndices(std::uint16_t lod,
+                                                   std::uint16_t jointGroupIndex,
+                                                   Vector<std::uint16_t>& inputIndices) const = 0;
         virtual void load(terse::BinaryInputArchive<BoundedIOStream>& archive) = 0;
         virtual void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) = 0;
 };
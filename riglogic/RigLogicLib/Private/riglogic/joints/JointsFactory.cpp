@@ -4,6 +4,7 @@
 
 #include "riglogic/TypeDefs.h"
 #include "riglogic/joints/JointBehaviorFilter.h"
+#include "riglogic/joints/JointGroupRepacking.h"
 #include "riglogic/joints/JointsBuilder.h"
 #include "riglogic/joints/JointsEvaluator.h"
 #include "riglogic/joints/JointsNullEvaluator.h"
@@ -148,7 +149,13 @@ Joints::Pointer JointsFactory::create(const Configuration& config,
         return UniqueInstance<Joints>::with(memRes).create(std::move(evaluator), memRes);
     }
 
-    JointBehaviorFilter filter{reader, memRes};
+    Vector<RepackedJointGroup> repackedJointGroups{memRes};
+    if (config.repackJointGroups) {
+        const auto rowAlignment = JointGroupRepacking::getRowAlignment(config);
+        repackedJointGroups = JointGroupRepacking::repack(reader, rowAlignment, nullptr, memRes);
+    }
+
+    JointBehaviorFilter filter{reader, (config.repackJointGroups ? &repackedJointGroups : nullptr), memRes};
     filter.include(dna::TranslationRepresentation::Vector);
     filter.include(dna::RotationRepresentation::EulerAngles);
     filter.include(dna::RotationRepresentation::Quaternion);
@@ -22,6 +22,54 @@ void JointsNullEvaluator::calculate(const ControlsInputInstance*  /*unused*/,
                                     std::uint16_t  /*unused*/) const {
 }
 
+void JointsNullEvaluator::calculateChanged(const ControlsInputInstance*  /*unused*/,
+                                           ConstArrayView<float>  /*unused*/,
+                                           JointsOutputInstance*  /*unused*/,
+                                           std::uint16_t  /*unused*/,
+                                           std::uint16_t  /*unused*/) const {
+}
+
+std::uint16_t JointsNullEvaluator::getJointGroupSliceCount(std::uint16_t  /*unused*/) const {
+    return {};
+}
+
+std::uint32_t JointsNullEvaluator::getJointGroupSliceCost(std::uint16_t  /*unused*/,
+                                                          std::uint16_t  /*unused*/,
+                                                          std::uint16_t  /*unused*/) const {
+    return {};
+}
+
+void JointsNullEvaluator::calculate(const ControlsInputInstance*  /*unused*/,
+                                    JointsOutputInstance*  /*unused*/,
+                                    std::uint16_t  /*unused*/,
+                                    std::uint16_t  /*unused*/,
+                                    std::uint16_t  /*unused*/) const {
+}
+
+void JointsNullEvaluator::calculate(ConstArrayView<const ControlsInputInstance*>  /*unused*/,
+                                    ConstArrayView<JointsOutputInstance*>  /*unused*/,
+                                    std::uint16_t  /*unused*/) const {
+}
+
+void JointsNullEvaluator::calculateUngrouped(const ControlsInputInstance*  /*unused*/, JointsOutputInstance*  /*unused*/,
+                                             std::uint16_t  /*unused*/) const {
+}
+
+std::uint16_t JointsNullEvaluator::getUngroupedPartitionCount(std::uint16_t  /*unused*/) const {
+    return {};
+}
+
+void JointsNullEvaluator::calculateUngrouped(const ControlsInputInstance*  /*unused*/,
+                                             JointsOutputInstance*  /*unused*/,
+                                             std::uint16_t  /*unused*/,
+                                             std::uint16_t  /*unused*/) const {
+}
+
+void JointsNullEvaluator::collectJointGroupInputIndices(std::uint16_t  /*unused*/,
+                                                        std::uint16_t  /*unused*/,
+                                                        Vector<std::uint16_t>&  /*unused*/) const {
+}
+
 void JointsNullEvaluator::load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) {
 }
 
@@ -21,6 +21,33 @@ class JointsNullEvaluator : public JointsEvaluator {
                        JointsOutputInstance*  /*unused*/,
                        std::uint16_t  /*unused*/,
                        std::uint16_t  /*unused*/) const override;
+        void calculateChanged(const ControlsInputInstance*  /*unused*/,
+                              ConstArrayView<float>  /*unused*/,
+                              JointsOutputInstance*  /*unused*/,
+                              std::uint16_t  /*unused*/,
+                              std::uint16_t  /*unused*/) const override;
+        std::uint16_t getJointGroupSliceCount(std::uint16_t  /*unused*/) const override;
+        std::uint32_t getJointGroupSliceCost(std::uint16_t  /*unused*/,
+                                             std::uint16_t  /*unused*/,
+                                             std::uint16_t  /*unused*/) const override;
+        void calculate(const ControlsInputInstance*  /*unused*/,
+                       JointsOutputInstance*  /*unused*/,
+                       std::uint16_t  /*unused*/,
+                       std::uint16_t  /*unused*/,
+                       std::uint16_t  /*unused*/) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*>  /*unused*/,
+                       ConstArrayView<JointsOutputInstance*>  /*unused*/,
+                       std::uint16_t  /*unused*/) const override;
+        void calculateUngrouped(const ControlsInputInstance*  /*unused*/, JointsOutputInstance*  /*unused*/,
+                                std::uint16_t  /*unused*/) const override;
+        std::uint16_t getUngroupedPartitionCount(std::uint16_t  /*unused*/) const override;
+        void calculateUngrouped(const ControlsInputInstance*  /*unused*/,
+                                JointsOutputInstance*  /*unused*/,
+                                std::uint16_t  /*unused*/,
+                                std::uint16_t  /*unused*/) const override;
+        void collectJointGroupInputIndices(std::uint16_t  /*unused*/,
+                                           std::uint16_t  /*unused*/,
+                                           Vector<std::uint16_t>&  /*unused*/) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>&  /*unused*/) override;
 
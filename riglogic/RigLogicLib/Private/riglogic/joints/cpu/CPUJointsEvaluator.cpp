@@ -49,6 +49,92 @@ void CPUJointsEvaluator::calculate(const ControlsInputInstance* inputs,
     // No twist swing evaluation per joint group
 }
 
+void CPUJointsEvaluator::calculateChanged(const ControlsInputInstance* inputs,
+                                          ConstArrayView<float> previousInputs,
+                                          JointsOutputInstance* outputs,
+                                          std::uint16_t lod,
+                                          std::uint16_t jointGroupIndex) const {
+    bpcmEvaluator->calculateChanged(inputs, previousInputs, outputs, lod, jointGroupIndex);
+    quaternionEvaluator->calculateChanged(inputs, previousInputs, outputs, lod, jointGroupIndex);
+}
+
+std::uint16_t CPUJointsEvaluator::getJointGroupSliceCount(std::uint16_t jointGroupIndex) const {
+    // Slices of Euler angle joints are followed by the slices of quaternion joints of the same joint group
+    return static_cast<std::uint16_t>(bpcmEvaluator->getJointGroupSliceCount(jointGroupIndex) +
+                                      quaternionEvaluator->getJointGroupSliceCount(jointGroupIndex));
+}
+
+std::uint32_t CPUJointsEvaluator::getJointGroupSliceCost(std::uint16_t lod,
+                                                         std::uint16_t jointGroupIndex,
+                                                         std::uint16_t sliceIndex) const {
+    const std::uint16_t bpcmSliceCount = bpcmEvaluator->getJointGroupSliceCount(jointGroupIndex);
+    if (sliceIndex < bpcmSliceCount) {
+        return bpcmEvaluator->getJointGroupSliceCost(lod, jointGroupIndex, sliceIndex);
+    }
+    return quaternionEvaluator->getJointGroupSliceCost(lod, jointGroupIndex,
+                                                       static_cast<std::uint16_t>(sliceIndex - bpcmSliceCount));
+}
+
+void CPUJointsEvaluator::calculate(const ControlsInputInstance* inputs,
+                                   JointsOutputInstance* outputs,
+                                   std::uint16_t lod,
+                                   std::uint16_t jointGroupIndex,
+                                   std::uint16_t sliceIndex) const {
+    const std::uint16_t bpcmSliceCount = bpcmEvaluator->getJointGroupSliceCount(jointGroupIndex);
+    if (sliceIndex < bpcmSliceCount) {
+        bpcmEvaluator->calculate(inputs, outputs, lod, jointGroupIndex, sliceIndex);
+    } else {
+        quaternionEvaluator->calculate(inputs, outputs, lod, jointGroupIndex,
+                                       static_cast<std::uint16_t>(sliceIndex - bpcmSliceCount));
+    }
+}
+
+void CPUJointsEvaluator::calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                                   ConstArrayView<JointsOutputInstance*> outputs,
+                                   std::uint16_t lod) const {
+    if (bpcmEvaluator) {
+        bpcmEvaluator->calculate(inputs, outputs, lod);
+    }
+    if (quaternionEvaluator) {
+        quaternionEvaluator->calculate(inputs, outputs, lod);
+    }
+    if (twistSwingEvaluator) {
+        twistSwingEvaluator->calculate(inputs, outputs, lod);
+    }
+}
+
+void CPUJointsEvaluator::calculateUngrouped(const ControlsInputInstance* inputs,
+                                            JointsOutputInstance* outputs,
+                                            std::uint16_t lod) const {
+    if (twistSwingEvaluator) {
+        twistSwingEvaluator->calculate(inputs, outputs, lod);
+    }
+}
+
+std::uint16_t CPUJointsEvaluator::getUngroupedPartitionCount(std::uint16_t lod) const {
+    // Twist swing setups are the only behavior not partitioned into joint groups
+    return (twistSwingEvaluator ? twistSwingEvaluator->getUngroupedPartitionCount(lod) : static_cast<std::uint16_t>(0));
+}
+
+void CPUJointsEvaluator::calculateUngrouped(const ControlsInputInstance* inputs,
+                                            JointsOutputInstance* outputs,
+                                            std::uint16_t lod,
+                                            std::uint16_t partitionIndex) const {
+    twistSwingEvaluator->calculateUngrouped(inputs, outputs, lod, partitionIndex);
+}
+
+void CPUJointsEvaluator::collectJointGroupInputIndices(std::uint16_t lod,
+                                                       std::uint16_t jointGroupIndex,
+                                                       Vector<std::uint16_t>& inputIndices) const {
+    if (bpcmEvaluator) {
+        bpcmEvaluator->collectJointGroupInputIndices(lod, jointGroupIndex, inputIndices);
+    }
+    if (quaternionEvaluator) {
+        quaternionEvaluator->collectJointGroupInputIndices(lod, jointGroupIndex, inputIndices);
+    }
+    // Twist swing setups are not partitioned into joint groups
+}
+
 void CPUJointsEvaluator::load(terse::BinaryInputArchive<BoundedIOStream>& archive) {
     bpcmEvaluator->load(archive);
     quaternionEvaluator->load(archive);
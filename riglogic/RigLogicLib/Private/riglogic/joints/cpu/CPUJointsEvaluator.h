@@ -28,6 +28,33 @@ class CPUJointsEvaluator : public JointsEvaluator {
                        JointsOutputInstance* outputs,
                        std::uint16_t lod,
                        std::uint16_t jointGroupIndex) const override;
+        void calculateChanged(const ControlsInputInstance* inputs,
+                              ConstArrayView<float> previousInputs,
+                              JointsOutputInstance* outputs,
+                              std::uint16_t lod,
+                              std::uint16_t jointGroupIndex) const override;
+        std::uint16_t getJointGroupSliceCount(std::uint16_t jointGroupIndex) const override;
+        std::uint32_t getJointGroupSliceCost(std::uint16_t lod,
+                                             std::uint16_t jointGroupIndex,
+                                             std::uint16_t sliceIndex) const override;
+        void calculate(const ControlsInputInstance* inputs,
+                       JointsOutputInstance* outputs,
+                       std::uint16_t lod,
+                       std::uint16_t jointGroupIndex,
+                       std::uint16_t sliceIndex) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<JointsOutputInstance*> outputs,
+                       std::uint16_t lod) const override;
+        void calculateUngrouped(const ControlsInputInstance* inputs, JointsOutputInstance* outputs,
+                                std::uint16_t lod) const override;
+        std::uint16_t getUngroupedPartitionCount(std::uint16_t lod) const override;
+        void calculateUngrouped(const ControlsInputInstance* inputs,
+                                JointsOutputInstance* outputs,
+                                std::uint16_t lod,
+                                std::uint16_t partitionIndex) const override;
+        void collectJointGroupInputIndices(std::uint16_t lod,
+                                           std::uint16_t jointGroupIndex,
+                                           Vector<std::uint16_t>& inputIndices) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override;
 
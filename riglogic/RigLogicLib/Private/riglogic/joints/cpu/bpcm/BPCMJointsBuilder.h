@@ -16,6 +16,7 @@
 #include "riglogic/types/Aliases.h"
 #include "riglogic/types/bpcm/Optimizer.h"
 #include "riglogic/utils/Extd.h"
+#include "riglogic/utils/Macros.h"
 
 #ifdef _MSC_VER
     #pragma warning(push)
@@ -35,6 +36,8 @@ namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TIterator>
 static void remapOutputIndicesForQuaternions(TIterator begin, TIterator end) {
     for (auto it = begin; it != end; ++it) {
@@ -294,6 +297,9 @@ typename UniqueInstance<JointGroupLinearCalculationStrategy<T> >::PointerType cr
     RotationOrder rotationOrder,
     dna::RotationUnit rotationUnit,
     MemoryResource* memRes) {
+    // Used only when any of the Euler angle rotation orders are built in
+    RL_UNUSED(rotationOrder);
+    RL_UNUSED(rotationUnit);
 
     if (rotationType == RotationType::EulerAngles) {
         using CalculationStrategy = VectorizedJointGroupLinearCalculationStrategy<T, TFVec, NoopAdapter>;
@@ -392,9 +398,11 @@ JointsEvaluator::Pointer BPCMJointsBuilder<TValue, TFVec>::build() {
     auto strategy =
         createJointGroupLinearStrategy<TValue, TFVec>(config.rotationType, config.rotationOrder, rotationUnit, memRes);
     auto factory = UniqueInstance<Evaluator<TValue>, JointsEvaluator>::with(memRes);
-    return factory.create(std::move(storage), std::move(strategy), nullptr, memRes);
+    return factory.create(std::move(storage), std::move(strategy), nullptr, BlockHeight(), PadTo(), memRes);
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX512
+#include "trimd/Isolate.h"
+
+#include "riglogic/joints/cpu/bpcm/BPCMJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/bpcm/BPCMJointsBuilder.h"
+#include "riglogic/utils/Macros.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_AVX512
+// AVX-512 variant (AVX-512F)
+UniqueInstance<JointsBuilder>::PointerType BPCMJointsBuilderFactory::createAVX512(const Configuration& config,
+                                                                                  FloatingPointType floatingPointType,
+                                                                                  MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using AVX512BPCMJointsBuilder = bpcm::BPCMJointsBuilder<std::uint16_t, trimd::avx512::F512>;
+            return UniqueInstance<AVX512BPCMJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using AVX512BPCMJointsBuilder = bpcm::BPCMJointsBuilder<float, trimd::avx512::F512>;
+    return UniqueInstance<AVX512BPCMJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_AVX512
+
+}  // namespace rl4
@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/joints/cpu/bpcm/BPCMJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/bpcm/BPCMJointsBuilder.h"
+#include "riglogic/utils/Macros.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_SSE
+// SSE variant (SSE2, and F16C for half floats)
+UniqueInstance<JointsBuilder>::PointerType BPCMJointsBuilderFactory::createSSE(const Configuration& config,
+                                                                               FloatingPointType floatingPointType,
+                                                                               MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using SSEBPCMJointsBuilder = bpcm::BPCMJointsBuilder<std::uint16_t, trimd::sse::F128>;
+            return UniqueInstance<SSEBPCMJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using SSEBPCMJointsBuilder = bpcm::BPCMJointsBuilder<float, trimd::sse::F128>;
+    return UniqueInstance<SSEBPCMJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_SSE
+
+}  // namespace rl4
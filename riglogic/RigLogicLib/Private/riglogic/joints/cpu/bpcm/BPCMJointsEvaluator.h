@@ -9,13 +9,20 @@
 #include "riglogic/joints/cpu/bpcm/CalculationStrategy.h"
 #include "riglogic/joints/cpu/bpcm/Storage.h"
 #include "riglogic/riglogic/RigInstanceImpl.h"
+#include "riglogic/types/StorageLayout.h"
+#include "riglogic/utils/Extd.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 
 namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TValue>
 class Evaluator : public JointsEvaluator {
     public:
@@ -24,16 +31,35 @@ class Evaluator : public JointsEvaluator {
         struct Accessor;
         friend Accessor;
 
+    public:
+        // Joint groups are split into slices of at least this many rows (and of whole row blocks)
+        static constexpr std::uint32_t sliceRowCount = 64u;
+        // Batched instances are processed in chunks, so their buffers can be gathered on the stack
+        static constexpr std::size_t instanceChunkSize = 16ul;
+        // Number of values in the (stack) buffer into which the inputs of a chunk of instances are gathered
+        static constexpr std::size_t batchBufferCapacity = 4096ul;
+
     public:
         Evaluator(JointStorage<TValue>&& storage_,
                   CalculationStrategyPointer strategy_,
                   JointsOutputInstance::Factory instanceFactory_,
+                  std::uint32_t blockHeight_,
+                  std::uint32_t padTo_,
                   MemoryResource* memRes_) :
             memRes{memRes_},
             storage{std::move(storage_)},
             jointGroups{takeStorageSnapshot(storage, memRes)},
             strategy{std::move(strategy_)},
-            instanceFactory{instanceFactory_} {
+            instanceFactory{instanceFactory_},
+            blockHeight{blockHeight_},
+            padTo{padTo_},
+            slices{memRes},
+            sliceOffsets{memRes},
+            sliceLODs{memRes},
+            sliceRotationLODs{memRes},
+            batchCapacity{} {
+            sliceJointGroups();
+            batchCapacity = computeBatchCapacity();
         }
 
         JointsOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override {
@@ -66,13 +92,329 @@ class Evaluator : public JointsEvaluator {
                                 lod);
         }
 
+        void calculateChanged(const ControlsInputInstance* inputs,
+                              ConstArrayView<float> previousInputs,
+                              JointsOutputInstance* outputs,
+                              std::uint16_t lod,
+                              std::uint16_t jointGroupIndex) const override {
+            assert(strategy != nullptr);
+            if (!strategy->calculateChanged(jointGroups[jointGroupIndex],
+                                            inputs->getInputBuffer(),
+                                            previousInputs,
+                                            outputs->getOutputBuffer(),
+                                            lod)) {
+                calculate(inputs, outputs, lod, jointGroupIndex);
+            }
+        }
+
+        std::uint16_t getJointGroupSliceCount(std::uint16_t jointGroupIndex) const override {
+            if (jointGroupIndex >= jointGroups.size()) {
+                return {};
+            }
+            return static_cast<std::uint16_t>(sliceOffsets[jointGroupIndex + 1ul] - sliceOffsets[jointGroupIndex]);
+        }
+
+        std::uint32_t getJointGroupSliceCost(std::uint16_t lod,
+                                             std::uint16_t jointGroupIndex,
+                                             std::uint16_t sliceIndex) const override {
+            const auto& slice = slices[sliceOffsets[jointGroupIndex] + sliceIndex];
+            // Every row is a dot product of the input columns, plus storing the result
+            return slice.lods[lod].outputLODs.size * (slice.lods[lod].inputLODs.size + 1u);
+        }
+
+        void calculate(const ControlsInputInstance* inputs,
+                       JointsOutputInstance* outputs,
+                       std::uint16_t lod,
+                       std::uint16_t jointGroupIndex,
+                       std::uint16_t sliceIndex) const override {
+            assert(strategy != nullptr);
+            assert(sliceIndex < getJointGroupSliceCount(jointGroupIndex));
+            strategy->calculate(slices[sliceOffsets[jointGroupIndex] + sliceIndex],
+                                inputs->getInputBuffer(),
+                                outputs->getOutputBuffer(),
+                                lod);
+        }
+
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<JointsOutputInstance*> outputs,
+                       std::uint16_t lod) const override {
+            assert(strategy != nullptr);
+            assert(inputs.size() == outputs.size());
+            if (batchCapacity == 0ul) {
+                // The inputs of four instances for the widest joint group do not fit into the batch buffer
+                for (std::size_t i = {}; i < inputs.size(); ++i) {
+                    calculate(inputs[i], outputs[i], lod);
+                }
+                return;
+            }
+            ConstArrayView<float> inputBuffers[instanceChunkSize];
+            ArrayView<float> outputBuffers[instanceChunkSize];
+            // Inputs of a chunk of instances, gathered for all columns of the widest joint group
+            float batchBuffer[batchBufferCapacity];
+            for (std::size_t chunkStart = {}; chunkStart < inputs.size(); chunkStart += batchCapacity) {
+                const std::size_t remaining = inputs.size() - chunkStart;
+                const std::size_t chunkSize = (remaining < batchCapacity ? remaining : batchCapacity);
+                for (std::size_t i = {}; i < chunkSize; ++i) {
+                    inputBuffers[i] = inputs[chunkStart + i]->getInputBuffer();
+                    outputBuffers[i] = outputs[chunkStart + i]->getOutputBuffer();
+                }
+                for (const auto& jointGroup : jointGroups) {
+                    strategy->calculate(jointGroup,
+                                        ConstArrayView<ConstArrayView<float> >{inputBuffers, chunkSize},
+                                        ArrayView<ArrayView<float> >{outputBuffers, chunkSize},
+                                        ArrayView<float>{batchBuffer, batchBufferCapacity},
+                                        lod);
+                }
+            }
+        }
+
+        void calculateUngrouped(const ControlsInputInstance*  /*unused*/, JointsOutputInstance*  /*unused*/,
+                                std::uint16_t  /*unused*/) const override {
+        }
+
+        std::uint16_t getUngroupedPartitionCount(std::uint16_t  /*unused*/) const override {
+            return {};
+        }
+
+        void calculateUngrouped(const ControlsInputInstance*  /*unused*/,
+                                JointsOutputInstance*  /*unused*/,
+                                std::uint16_t  /*unused*/,
+                                std::uint16_t  /*unused*/) const override {
+        }
+
+        void collectJointGroupInputIndices(std::uint16_t lod,
+                                           std::uint16_t jointGroupIndex,
+                                           Vector<std::uint16_t>& inputIndices) const override {
+            const auto& jointGroup = jointGroups[jointGroupIndex];
+            const std::uint16_t* columns = jointGroup.inputIndices;
+            inputIndices.insert(inputIndices.end(), columns, columns + jointGroup.lods[lod].inputLODs.size);
+        }
+
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override {
-            archive(storage);
+            StorageLayout dumpedLayout{};
+            archive(dumpedLayout);
+            if (dumpedLayout == getStorageLayout()) {
+                archive(storage);
+            } else if (dumpedLayout.valueType == StorageValueType::HalfFloat) {
+                loadConverted<std::uint16_t>(archive, dumpedLayout);
+            } else {
+                loadConverted<float>(archive, dumpedLayout);
+            }
             jointGroups = takeStorageSnapshot(storage, memRes);
+            sliceJointGroups();
+            batchCapacity = computeBatchCapacity();
         }
 
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override {
-            archive(storage);
+            StorageLayout layout = getStorageLayout();
+            archive(layout, storage);
+        }
+
+    private:
+        // Instances are batched in multiples of four, as many as the batch buffer holds the inputs of the widest
+        // joint group for
+        std::size_t computeBatchCapacity() const {
+            std::size_t maxColumnCount = {};
+            for (const auto& jointGroup : jointGroups) {
+                maxColumnCount = std::max(maxColumnCount, static_cast<std::size_t>(jointGroup.colCount));
+            }
+            if (maxColumnCount == 0ul) {
+                return instanceChunkSize;
+            }
+            const std::size_t capacity = std::min(instanceChunkSize, batchBufferCapacity / maxColumnCount);
+            return capacity - (capacity % 4ul);
+        }
+
+        StorageLayout getStorageLayout() const {
+            return StorageLayout{blockHeight, padTo, 1u, StorageValueTypeOf<TValue>::value};
+        }
+
+        // Storage dumped by a variant of a different vector width (or floating point type) is re-arranged into the
+        // layout of this one, with the rows of each joint group re-padded for its block heights
+        template<typename TSource>
+        void loadConverted(terse::BinaryInputArchive<BoundedIOStream>& archive, const StorageLayout& dumpedLayout) {
+            JointStorage<TSource> dumped{memRes};
+            archive(dumped);
+
+            storage = JointStorage<TValue>{memRes};
+            storage.inputIndices.resize(dumped.inputIndices.size());
+            std::copy(dumped.inputIndices.begin(), dumped.inputIndices.end(), storage.inputIndices.begin());
+            storage.lodRegions.assign(dumped.lodRegions.begin(), dumped.lodRegions.end());
+            storage.outputRotationIndices.assign(dumped.outputRotationIndices.begin(), dumped.outputRotationIndices.end());
+            storage.outputRotationLODs.assign(dumped.outputRotationLODs.begin(), dumped.outputRotationLODs.end());
+            storage.jointGroups.assign(dumped.jointGroups.begin(), dumped.jointGroups.end());
+
+            const std::size_t jointGroupCount = storage.jointGroups.size();
+            const std::size_t lodCount = (jointGroupCount == 0ul ? 0ul : storage.lodRegions.size() / jointGroupCount);
+            // Rows beyond the largest LOD are never evaluated, so they are only kept as padding
+            Vector<std::uint32_t> unpaddedRowCounts{jointGroupCount, 0u, memRes};
+            std::uint32_t valuesOffset = {};
+            std::uint32_t outputIndicesOffset = {};
+            for (std::size_t i = 0ul; i < jointGroupCount; ++i) {
+                auto& jointGroup = storage.jointGroups[i];
+                for (std::size_t lod = 0ul; lod < lodCount; ++lod) {
+                    unpaddedRowCounts[i] = std::max(unpaddedRowCounts[i], storage.lodRegions[jointGroup.lodsOffset + lod].outputLODs.size);
+                }
+                jointGroup.rowCount = extd::roundUp(unpaddedRowCounts[i], padTo);
+                jointGroup.valuesOffset = valuesOffset;
+                jointGroup.valuesSize = jointGroup.rowCount * jointGroup.colCount;
+                jointGroup.outputIndicesOffset = outputIndicesOffset;
+                valuesOffset += jointGroup.valuesSize;
+                outputIndicesOffset += jointGroup.rowCount;
+            }
+
+            const StorageLayout layout = getStorageLayout();
+            storage.values.resize(valuesOffset);
+            storage.outputIndices.resize(outputIndicesOffset);
+            for (std::size_t i = 0ul; i < jointGroupCount; ++i) {
+                const auto& source = dumped.jointGroups[i];
+                auto& jointGroup = storage.jointGroups[i];
+                // Padded rows are laid out just like rows of zeros, so the padded row count is the extent of the source
+                convertBlockedMatrix(storage.values.data() + jointGroup.valuesOffset,
+                                     layout,
+                                     dumped.values.data() + source.valuesOffset,
+                                     dumpedLayout,
+                                     Extent{source.rowCount, source.colCount},
+                                     unpaddedRowCounts[i],
+                                     memRes);
+                const std::uint16_t* outputIndices = dumped.outputIndices.data() + source.outputIndicesOffset;
+                std::fill_n(std::copy_n(outputIndices, unpaddedRowCounts[i], storage.outputIndices.data() + jointGroup.outputIndicesOffset),
+                            jointGroup.rowCount - unpaddedRowCounts[i],
+                            static_cast<std::uint16_t>(0u));
+                for (std::size_t lod = 0ul; lod < lodCount; ++lod) {
+                    auto& outputLODs = storage.lodRegions[jointGroup.lodsOffset + lod].outputLODs;
+                    outputLODs = RowLOD(outputLODs.size, jointGroup.rowCount, blockHeight, padTo);
+                }
+            }
+        }
+
+        /*
+         * Split joint groups into slices of whole row blocks, each a view of the same columns, but of a range of rows
+         *
+         * Rows of different slices are disjoint, so slices may be evaluated concurrently. When Euler angles are
+         * converted to quaternions, all rows of a joint must end up in the same slice as the conversion of its
+         * rotation, so slice boundaries which would split joints are skipped, and groups whose rotations are not
+         * ordered the same way as their rows are not split at all.
+         */
+        void sliceJointGroups() {
+            const std::size_t jointGroupCount = jointGroups.size();
+            const std::size_t lodCount = (jointGroupCount == 0ul ? 0ul : storage.lodRegions.size() / jointGroupCount);
+            const bool hasRotationLODs = !storage.outputRotationLODs.empty();
+
+            // Row and rotation boundaries of all slices, with groups that are not split keeping their own views
+            struct SliceBounds {
+                std::uint32_t rowBegin;
+                std::uint32_t rowEnd;
+                std::uint32_t rotationBegin;
+                std::uint32_t rotationEnd;
+            };
+            Vector<SliceBounds> bounds{memRes};
+            Vector<std::uint32_t> rowBoundaries{memRes};
+            Vector<std::uint32_t> rotationBoundaries{memRes};
+            UnorderedMap<std::uint16_t, std::uint32_t> lastRowOfJoint{memRes};
+            sliceOffsets.assign(jointGroupCount + 1ul, 0u);
+            for (std::size_t i = 0ul; i < jointGroupCount; ++i) {
+                const auto& jointGroup = jointGroups[i];
+                std::uint32_t unpaddedRowCount = {};
+                std::uint32_t rotationCount = {};
+                for (std::size_t lod = 0ul; lod < lodCount; ++lod) {
+                    unpaddedRowCount = std::max(unpaddedRowCount, jointGroup.lods[lod].outputLODs.size);
+                    if (hasRotationLODs) {
+                        rotationCount = std::max(rotationCount, static_cast<std::uint32_t>(jointGroup.outputRotationLODs[lod]));
+                    }
+                }
+
+                rowBoundaries.clear();
+                rotationBoundaries.clear();
+                rowBoundaries.push_back(0u);
+                rotationBoundaries.push_back(0u);
+                lastRowOfJoint.clear();
+                if (hasRotationLODs && (unpaddedRowCount > sliceRowCount)) {
+                    for (std::uint32_t row = {}; row < unpaddedRowCount; ++row) {
+                        lastRowOfJoint[static_cast<std::uint16_t>(jointGroup.outputIndices[row] / 10u)] = row;
+                    }
+                }
+                // A boundary is valid only if no joint with rows before it has rows after it as well
+                std::uint32_t lastRowOfPrecedingJoints = {};
+                for (std::uint32_t row = {}; row < unpaddedRowCount; ++row) {
+                    if ((row % blockHeight == 0u) && (row - rowBoundaries.back() >= sliceRowCount) &&
+                        (lastRowOfPrecedingJoints < row)) {
+                        rowBoundaries.push_back(row);
+                    }
+                    if (!lastRowOfJoint.empty()) {
+                        const auto joint = static_cast<std::uint16_t>(jointGroup.outputIndices[row] / 10u);
+                        lastRowOfPrecedingJoints = std::max(lastRowOfPrecedingJoints, lastRowOfJoint[joint]);
+                    }
+                }
+                if (hasRotationLODs) {
+                    // Rotations are converted by the slice which holds the rows of their joint
+                    std::size_t slice = {};
+                    for (std::uint32_t rotation = {}; (rotation < rotationCount) && (rowBoundaries.size() > 1ul); ++rotation) {
+                        const auto joint = static_cast<std::uint16_t>(jointGroup.outputRotationIndices[rotation] / 10u);
+                        const auto it = lastRowOfJoint.find(joint);
+                        if (it == lastRowOfJoint.end()) {
+                            rowBoundaries.resize(1ul);
+                            break;
+                        }
+                        const auto next = static_cast<std::size_t>(std::distance(rowBoundaries.begin(),
+                                                                                 std::upper_bound(rowBoundaries.begin(),
+                                                                                                  rowBoundaries.end(),
+                                                                                                  it->second)) - 1);
+                        if (next < slice) {
+                            rowBoundaries.resize(1ul);
+                            break;
+                        }
+                        for (; slice < next; ++slice) {
+                            rotationBoundaries.push_back(rotation);
+                        }
+                    }
+                }
+                rotationBoundaries.resize(rowBoundaries.size(), rotationCount);
+
+                sliceOffsets[i + 1ul] = sliceOffsets[i] + static_cast<std::uint32_t>(rowBoundaries.size());
+                for (std::size_t s = 0ul; s < rowBoundaries.size(); ++s) {
+                    const std::uint32_t rowEnd = (s + 1ul < rowBoundaries.size() ? rowBoundaries[s + 1ul] : jointGroup.rowCount);
+                    const std::uint32_t rotationEnd = (s + 1ul < rotationBoundaries.size() ? rotationBoundaries[s + 1ul] : rotationCount);
+                    bounds.push_back({rowBoundaries[s], rowEnd, rotationBoundaries[s], rotationEnd});
+                }
+            }
+
+            // Views reference the LOD regions of slices, so those are allocated up front
+            slices.resize(bounds.size());
+            sliceLODs.resize(bounds.size() * lodCount);
+            sliceRotationLODs.resize(hasRotationLODs ? bounds.size() * lodCount : 0ul);
+            for (std::size_t i = 0ul; i < jointGroupCount; ++i) {
+                const auto& jointGroup = jointGroups[i];
+                if (sliceOffsets[i + 1ul] - sliceOffsets[i] == 1u) {
+                    slices[sliceOffsets[i]] = jointGroup;
+                    continue;
+                }
+                for (std::uint32_t si = sliceOffsets[i]; si < sliceOffsets[i + 1ul]; ++si) {
+                    const auto& bound = bounds[si];
+                    const std::uint32_t rowCount = bound.rowEnd - bound.rowBegin;
+                    const std::uint32_t rotationCount = bound.rotationEnd - bound.rotationBegin;
+                    auto& slice = slices[si];
+                    slice = jointGroup;
+                    slice.values = jointGroup.values + static_cast<std::size_t>(bound.rowBegin) * jointGroup.colCount;
+                    slice.rowCount = rowCount;
+                    slice.outputIndices = jointGroup.outputIndices + bound.rowBegin;
+                    slice.outputRotationIndices = jointGroup.outputRotationIndices + bound.rotationBegin;
+                    slice.lods = sliceLODs.data() + si * lodCount;
+                    slice.outputRotationLODs = (hasRotationLODs ? sliceRotationLODs.data() + si * lodCount : nullptr);
+                    for (std::size_t lod = 0ul; lod < lodCount; ++lod) {
+                        const std::uint32_t lodRowCount = jointGroup.lods[lod].outputLODs.size;
+                        const std::uint32_t sliceLODRowCount =
+                            std::min(rowCount, lodRowCount - std::min(lodRowCount, bound.rowBegin));
+                        sliceLODs[si * lodCount + lod].inputLODs = jointGroup.lods[lod].inputLODs;
+                        sliceLODs[si * lodCount + lod].outputLODs = RowLOD(sliceLODRowCount, rowCount, blockHeight, padTo);
+                        if (hasRotationLODs) {
+                            const std::uint32_t lodRotationCount = jointGroup.outputRotationLODs[lod];
+                            sliceRotationLODs[si * lodCount + lod] = static_cast<std::uint16_t>(
+                                std::min(rotationCount, lodRotationCount - std::min(lodRotationCount, bound.rotationBegin)));
+                        }
+                    }
+                }
+            }
         }
 
     private:
@@ -81,8 +423,18 @@ class Evaluator : public JointsEvaluator {
         Vector<JointGroupView<TValue> > jointGroups;
         CalculationStrategyPointer strategy;
         JointsOutputInstance::Factory instanceFactory;
+        std::uint32_t blockHeight;
+        std::uint32_t padTo;
+        // Slices of joint group i are [sliceOffsets[i], sliceOffsets[i + 1])
+        Vector<JointGroupView<TValue> > slices;
+        Vector<std::uint32_t> sliceOffsets;
+        Vector<LODRegion> sliceLODs;
+        Vector<std::uint16_t> sliceRotationLODs;
+        std::size_t batchCapacity;
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
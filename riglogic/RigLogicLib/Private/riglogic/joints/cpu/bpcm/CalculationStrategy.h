@@ -9,14 +9,18 @@
 #include "riglogic/types/Aliases.h"
 #include "riglogic/utils/Macros.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 // *INDENT-OFF*
 namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 /*
  * Process the remainder portion after 8x4 blocks
  *
@@ -56,8 +60,8 @@ static FORCE_INLINE void processBlocks8x1(const std::uint16_t* inputIndicesEndAl
         const TFVec inputVec{inputs[*inputIndices]};
         const TFVec blk1 = TFVec::fromAlignedSource(values);
         const TFVec blk2 = TFVec::fromAlignedSource(values + TFVec::size());
-        sum1 += (blk1 * inputVec);
-        sum2 += (blk2 * inputVec);
+        sum1 = trimd::fmadd(blk1, inputVec, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec, sum2);
     }
 }
 
@@ -116,14 +120,14 @@ static FORCE_INLINE void processBlocks8x4(const std::uint16_t* inputIndicesStart
         const TFVec blk6 = TFVec::fromAlignedSource(values + TFVec::size() * 5);
         const TFVec blk7 = TFVec::fromAlignedSource(values + TFVec::size() * 6);
         const TFVec blk8 = TFVec::fromAlignedSource(values + TFVec::size() * 7);
-        sum1 += (blk1 * inputVec1);
-        sum2 += (blk2 * inputVec1);
-        sum3 += (blk3 * inputVec2);
-        sum4 += (blk4 * inputVec2);
-        sum5 += (blk5 * inputVec3);
-        sum6 += (blk6 * inputVec3);
-        sum7 += (blk7 * inputVec4);
-        sum8 += (blk8 * inputVec4);
+        sum1 = trimd::fmadd(blk1, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec1, sum2);
+        sum3 = trimd::fmadd(blk3, inputVec2, sum3);
+        sum4 = trimd::fmadd(blk4, inputVec2, sum4);
+        sum5 = trimd::fmadd(blk5, inputVec3, sum5);
+        sum6 = trimd::fmadd(blk6, inputVec3, sum6);
+        sum7 = trimd::fmadd(blk7, inputVec4, sum7);
+        sum8 = trimd::fmadd(blk8, inputVec4, sum8);
     }
     // Process 8x1 horizontal remainder portion after 8x4 blocks are consumed
     processBlocks8x1(inputIndicesEndAlignedTo4, inputIndicesEnd, inputs, values, sum1, sum2);
@@ -176,7 +180,7 @@ static FORCE_INLINE void processBlocks4x1(const std::uint16_t* inputIndicesEndAl
          ++inputIndices, values += TFVec::size()) {
         const TFVec inputVec{inputs[*inputIndices]};
         const TFVec blk = TFVec::fromAlignedSource(values);
-        sum1 += (blk * inputVec);
+        sum1 = trimd::fmadd(blk, inputVec, sum1);
     }
 }
 
@@ -242,14 +246,14 @@ static FORCE_INLINE void processBlocks4x8(const std::uint16_t* inputIndicesStart
         const TFVec blk6 = TFVec::fromAlignedSource(values + TFVec::size() * 5);
         const TFVec blk7 = TFVec::fromAlignedSource(values + TFVec::size() * 6);
         const TFVec blk8 = TFVec::fromAlignedSource(values + TFVec::size() * 7);
-        sum1 += (blk1 * inputVec1);
-        sum2 += (blk2 * inputVec2);
-        sum3 += (blk3 * inputVec3);
-        sum4 += (blk4 * inputVec4);
-        sum5 += (blk5 * inputVec5);
-        sum6 += (blk6 * inputVec6);
-        sum7 += (blk7 * inputVec7);
-        sum8 += (blk8 * inputVec8);
+        sum1 = trimd::fmadd(blk1, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec2, sum2);
+        sum3 = trimd::fmadd(blk3, inputVec3, sum3);
+        sum4 = trimd::fmadd(blk4, inputVec4, sum4);
+        sum5 = trimd::fmadd(blk5, inputVec5, sum5);
+        sum6 = trimd::fmadd(blk6, inputVec6, sum6);
+        sum7 = trimd::fmadd(blk7, inputVec7, sum7);
+        sum8 = trimd::fmadd(blk8, inputVec8, sum8);
     }
     // Process 4x1 horizontal remainder portion after 4x8 blocks are consumed
     processBlocks4x1(inputIndicesEndAlignedTo8, inputIndicesEnd, inputs, values, sum1);
@@ -320,6 +324,442 @@ static FORCE_INLINE void processJointGroupBlock4(const JointGroupView<T>& jointG
     }
 }
 
+// Upper bound on the number of active columns collected for a single joint group
+constexpr std::size_t maxActiveColumnCount = 512ul;
+
+/*
+ * Collect the columns of a joint group whose inputs are non-zero
+ *
+ * In most frames the majority of controls are exactly zero, so their columns
+ * contribute nothing to the outputs. The positions of the remaining (active)
+ * columns are stored along with their already gathered input values, and the
+ * list is padded with zero-valued entries to a multiple of four, so the active
+ * block processors need no remainder handling.
+ * Returns false if the active columns are too dense (or too many) for skipping
+ * the inactive ones to pay off, in which case the regular block processors are
+ * to be used.
+ */
+template<typename T>
+static FORCE_INLINE bool collectActiveColumns(const JointGroupView<T>& jointGroup,
+                                              ConstArrayView<float> inputs,
+                                              std::uint16_t lod,
+                                              std::uint32_t* activeColumns,
+                                              float* activeInputs,
+                                              std::size_t& activeCount) {
+    const std::size_t columnCount = jointGroup.lods[lod].inputLODs.size;
+    // Leave room for the padding, and give up when more than three quarters of the columns are active
+    const std::size_t activeCountLimit = std::min(maxActiveColumnCount - 4ul, columnCount - (columnCount >> 2ul));
+    std::size_t count = 0ul;
+    for (std::size_t col = 0ul; col < columnCount; ++col) {
+        const float input = inputs[jointGroup.inputIndices[col]];
+        activeColumns[count] = static_cast<std::uint32_t>(col);
+        activeInputs[count] = input;
+        count += static_cast<std::size_t>(input != 0.0f);
+        if (count > activeCountLimit) {
+            return false;
+        }
+    }
+    for (; (count % 4ul) != 0ul; ++count) {
+        activeColumns[count] = 0u;
+        activeInputs[count] = 0.0f;
+    }
+    activeCount = count;
+    return true;
+}
+
+/*
+ * Collect the columns of a joint group whose inputs changed since the outputs were calculated
+ *
+ * The outputs are linear in the inputs, so they can be updated by the changed columns
+ * alone, weighted by the differences of their inputs, which are collected the same way
+ * as active columns (and processed by the same block processors).
+ * Returns false if too many columns changed for the update to be cheaper than
+ * calculating the joint group anew.
+ */
+template<typename T>
+static FORCE_INLINE bool collectChangedColumns(const JointGroupView<T>& jointGroup,
+                                               ConstArrayView<float> inputs,
+                                               ConstArrayView<float> previousInputs,
+                                               std::uint16_t lod,
+                                               std::uint32_t* changedColumns,
+                                               float* inputDeltas,
+                                               std::size_t& changedCount) {
+    const std::size_t columnCount = jointGroup.lods[lod].inputLODs.size;
+    // Leave room for the padding, and give up when more than half of the columns changed
+    const std::size_t changedCountLimit = std::min(maxActiveColumnCount - 4ul, columnCount >> 1ul);
+    std::size_t count = 0ul;
+    for (std::size_t col = 0ul; col < columnCount; ++col) {
+        const std::uint16_t inputIndex = jointGroup.inputIndices[col];
+        const float delta = inputs[inputIndex] - previousInputs[inputIndex];
+        changedColumns[count] = static_cast<std::uint32_t>(col);
+        inputDeltas[count] = delta;
+        count += static_cast<std::size_t>(delta != 0.0f);
+        if (count > changedCountLimit) {
+            return false;
+        }
+    }
+    for (; (count % 4ul) != 0ul; ++count) {
+        changedColumns[count] = 0u;
+        inputDeltas[count] = 0.0f;
+    }
+    changedCount = count;
+    return true;
+}
+
+/*
+ * Process a single 8-row block, consuming only the active columns of the joint group
+ *
+ * Works the same way as the 8x4 block processor, but instead of walking all input
+ * indices, it walks the list of active columns, so the value blocks of columns
+ * with zero inputs are never loaded. The column-major layout of values within a
+ * block keeps the values of each active column contiguous.
+ */
+template<typename TFVec, typename T>
+static FORCE_INLINE void processActiveBlocks8x4(const std::uint32_t* activeColumns,
+                                                const float* activeInputs,
+                                                std::size_t activeCount,
+                                                const T* values,
+                                                float* outbuf) {
+    constexpr std::size_t blockHeight = 2ul * TFVec::size();
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    TFVec sum5{};
+    TFVec sum6{};
+    TFVec sum7{};
+    TFVec sum8{};
+    for (std::size_t i = 0ul; i < activeCount; i += 4ul) {
+        const T* colValues1 = values + activeColumns[i] * blockHeight;
+        const T* colValues2 = values + activeColumns[i + 1ul] * blockHeight;
+        const T* colValues3 = values + activeColumns[i + 2ul] * blockHeight;
+        const T* colValues4 = values + activeColumns[i + 3ul] * blockHeight;
+        const TFVec inputVec1{activeInputs[i]};
+        const TFVec inputVec2{activeInputs[i + 1ul]};
+        const TFVec inputVec3{activeInputs[i + 2ul]};
+        const TFVec inputVec4{activeInputs[i + 3ul]};
+        const TFVec blk1 = TFVec::fromAlignedSource(colValues1);
+        const TFVec blk2 = TFVec::fromAlignedSource(colValues1 + TFVec::size());
+        const TFVec blk3 = TFVec::fromAlignedSource(colValues2);
+        const TFVec blk4 = TFVec::fromAlignedSource(colValues2 + TFVec::size());
+        const TFVec blk5 = TFVec::fromAlignedSource(colValues3);
+        const TFVec blk6 = TFVec::fromAlignedSource(colValues3 + TFVec::size());
+        const TFVec blk7 = TFVec::fromAlignedSource(colValues4);
+        const TFVec blk8 = TFVec::fromAlignedSource(colValues4 + TFVec::size());
+        sum1 = trimd::fmadd(blk1, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec1, sum2);
+        sum3 = trimd::fmadd(blk3, inputVec2, sum3);
+        sum4 = trimd::fmadd(blk4, inputVec2, sum4);
+        sum5 = trimd::fmadd(blk5, inputVec3, sum5);
+        sum6 = trimd::fmadd(blk6, inputVec3, sum6);
+        sum7 = trimd::fmadd(blk7, inputVec4, sum7);
+        sum8 = trimd::fmadd(blk8, inputVec4, sum8);
+    }
+
+    sum1 += sum3;
+    sum2 += sum4;
+    sum5 += sum7;
+    sum6 += sum8;
+    sum1 += sum5;
+    sum2 += sum6;
+
+    sum1.alignedStore(outbuf);
+    sum2.alignedStore(outbuf + TFVec::size());
+}
+
+/*
+ * Process a single 4-row block (vertical remainder), consuming only the active columns of the joint group
+ */
+template<typename TFVec, typename T>
+static FORCE_INLINE void processActiveBlocks4x4(const std::uint32_t* activeColumns,
+                                                const float* activeInputs,
+                                                std::size_t activeCount,
+                                                const T* values,
+                                                float* outbuf) {
+    constexpr std::size_t blockHeight = TFVec::size();
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    for (std::size_t i = 0ul; i < activeCount; i += 4ul) {
+        const TFVec inputVec1{activeInputs[i]};
+        const TFVec inputVec2{activeInputs[i + 1ul]};
+        const TFVec inputVec3{activeInputs[i + 2ul]};
+        const TFVec inputVec4{activeInputs[i + 3ul]};
+        const TFVec blk1 = TFVec::fromAlignedSource(values + activeColumns[i] * blockHeight);
+        const TFVec blk2 = TFVec::fromAlignedSource(values + activeColumns[i + 1ul] * blockHeight);
+        const TFVec blk3 = TFVec::fromAlignedSource(values + activeColumns[i + 2ul] * blockHeight);
+        const TFVec blk4 = TFVec::fromAlignedSource(values + activeColumns[i + 3ul] * blockHeight);
+        sum1 = trimd::fmadd(blk1, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec2, sum2);
+        sum3 = trimd::fmadd(blk3, inputVec3, sum3);
+        sum4 = trimd::fmadd(blk4, inputVec4, sum4);
+    }
+
+    sum1 += sum2;
+    sum3 += sum4;
+    sum1 += sum3;
+
+    sum1.alignedStore(outbuf);
+}
+
+static FORCE_INLINE void writeOutput(float& output, float value, std::false_type  /*unused*/) {
+    output = value;
+}
+
+static FORCE_INLINE void writeOutput(float& output, float value, std::true_type  /*unused*/) {
+    output += value;
+}
+
+/*
+ * Orchestrate the execution of the active block processors for a given joint group
+ *
+ * Follows the same partitioning of rows as processJointGroupBlock4, but each block
+ * consumes only the previously collected active columns. When accumulating, the
+ * results are added to the outputs instead of replacing them (for applying the
+ * changes of inputs, see collectChangedColumns).
+ */
+template<typename TFVec, bool Accumulate = false, typename T>
+static FORCE_INLINE void processActiveJointGroupBlock4(const JointGroupView<T>& jointGroup,
+                                                       const std::uint32_t* activeColumns,
+                                                       const float* activeInputs,
+                                                       std::size_t activeCount,
+                                                       ArrayView<float> outputs,
+                                                       std::uint16_t lod) {
+    const std::integral_constant<bool, Accumulate> accumulate{};
+    const T* values = jointGroup.values;
+    const LODRegion& lodRegion = jointGroup.lods[lod];
+    const std::uint16_t* outputIndices = jointGroup.outputIndices;
+    const std::uint16_t* const outputIndicesEnd = outputIndices + lodRegion.outputLODs.size;
+    const std::uint16_t* const outputIndicesEndPaddedToLastFullBlock = outputIndices + lodRegion.outputLODs.sizePaddedToLastFullBlock;
+    const std::uint16_t* const outputIndicesEndPaddedToSecondLastFullBlock = outputIndices + lodRegion.outputLODs.sizePaddedToSecondLastFullBlock;
+    constexpr std::size_t halfBlockHeight = TFVec::size();
+    constexpr std::size_t fullBlockHeight = 2ul * TFVec::size();
+    const std::size_t halfBlockSize = jointGroup.colCount * halfBlockHeight;
+    const std::size_t fullBlockSize = jointGroup.colCount * fullBlockHeight;
+    // Process portion of matrix that's partitionable into 8-row blocks (including the last, masked-off block)
+    for (; outputIndices < outputIndicesEndPaddedToLastFullBlock; outputIndices += fullBlockHeight, values += fullBlockSize) {
+        alignas(TFVec::alignment()) float outbuf[fullBlockHeight];
+        processActiveBlocks8x4<TFVec>(activeColumns, activeInputs, activeCount, values, static_cast<float*>(outbuf));
+        // Ignore results that came from rows after the last LOD row
+        const std::size_t rowCount = (outputIndices < outputIndicesEndPaddedToSecondLastFullBlock
+                                      ? fullBlockHeight
+                                      : (lodRegion.outputLODs.size % fullBlockHeight));
+        for (std::size_t i = 0ul; i < rowCount; ++i) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            writeOutput(outputs[outputIndices[i]], outbuf[i], accumulate);
+        }
+    }
+    // Process vertical remainder portion of matrix that's partitionable into 4-row blocks
+    for (; outputIndices < outputIndicesEnd; outputIndices += halfBlockHeight, values += halfBlockSize) {
+        alignas(TFVec::alignment()) float outbuf[halfBlockHeight];
+        processActiveBlocks4x4<TFVec>(activeColumns, activeInputs, activeCount, values, static_cast<float*>(outbuf));
+        // Ignore results that came from rows after the last LOD row
+        const auto rowCount = std::min(halfBlockHeight, static_cast<std::size_t>(outputIndicesEnd - outputIndices));
+        for (std::size_t i = 0ul; i < rowCount; ++i) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            writeOutput(outputs[outputIndices[i]], outbuf[i], accumulate);
+        }
+    }
+}
+
+/*
+ * Process a single 8-row block for a batch of four input vectors
+ *
+ * Consumes 4 x 2 values per input index, but instead of multiplying the loaded
+ * values against a single input vector, it multiplies them against the inputs of
+ * four distinct rig instances. The inputs are expected to be pre-gathered into a
+ * column-major batch buffer (one row per column, each row holding the inputs of all
+ * instances in the batch), so a single iteration only needs to broadcast the four
+ * adjacent batch values, and every value of the block is loaded exactly once for
+ * all four instances.
+ *
+ *  [ A B C D ] [ E F G H ] ... Batch buffer (one row of instance inputs per column)
+ *
+ *    0 1 2
+ *  0 x y z  |  A * x + E * y + ...  B * x + F * y + ...  C * x + ...  D * x + ...
+ *  1 x y z  |  A * x + E * y + ...  B * x + F * y + ...  C * x + ...  D * x + ...
+ *  ...
+ *  7 x y z  |  A * x + E * y + ...  B * x + F * y + ...  C * x + ...  D * x + ...
+ *
+ */
+template<typename TFVec, typename T>
+static FORCE_INLINE void processBlocks8x1Batch4(const float* batchInputs,
+                                                std::size_t batchStride,
+                                                std::size_t columnCount,
+                                                const T* values,
+                                                float* outbuf) {
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    TFVec sum5{};
+    TFVec sum6{};
+    TFVec sum7{};
+    TFVec sum8{};
+    for (std::size_t col = 0ul; col < columnCount; ++col, batchInputs += batchStride, values += (2ul * TFVec::size())) {
+        const TFVec blk1 = TFVec::fromAlignedSource(values);
+        const TFVec blk2 = TFVec::fromAlignedSource(values + TFVec::size());
+        const TFVec inputVec1{batchInputs[0]};
+        const TFVec inputVec2{batchInputs[1]};
+        const TFVec inputVec3{batchInputs[2]};
+        const TFVec inputVec4{batchInputs[3]};
+        sum1 = trimd::fmadd(blk1, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec1, sum2);
+        sum3 = trimd::fmadd(blk1, inputVec2, sum3);
+        sum4 = trimd::fmadd(blk2, inputVec2, sum4);
+        sum5 = trimd::fmadd(blk1, inputVec3, sum5);
+        sum6 = trimd::fmadd(blk2, inputVec3, sum6);
+        sum7 = trimd::fmadd(blk1, inputVec4, sum7);
+        sum8 = trimd::fmadd(blk2, inputVec4, sum8);
+    }
+    sum1.alignedStore(outbuf);
+    sum2.alignedStore(outbuf + TFVec::size());
+    sum3.alignedStore(outbuf + TFVec::size() * 2);
+    sum4.alignedStore(outbuf + TFVec::size() * 3);
+    sum5.alignedStore(outbuf + TFVec::size() * 4);
+    sum6.alignedStore(outbuf + TFVec::size() * 5);
+    sum7.alignedStore(outbuf + TFVec::size() * 6);
+    sum8.alignedStore(outbuf + TFVec::size() * 7);
+}
+
+/*
+ * Process a single 4-row block (vertical remainder) for a batch of four input vectors
+ *
+ * Same as the 8-row variant, but works on the vertical remainder portion of the
+ * matrix, where blocks are only half the height.
+ */
+template<typename TFVec, typename T>
+static FORCE_INLINE void processBlocks4x1Batch4(const float* batchInputs,
+                                                std::size_t batchStride,
+                                                std::size_t columnCount,
+                                                const T* values,
+                                                float* outbuf) {
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    for (std::size_t col = 0ul; col < columnCount; ++col, batchInputs += batchStride, values += TFVec::size()) {
+        const TFVec blk = TFVec::fromAlignedSource(values);
+        const TFVec inputVec1{batchInputs[0]};
+        const TFVec inputVec2{batchInputs[1]};
+        const TFVec inputVec3{batchInputs[2]};
+        const TFVec inputVec4{batchInputs[3]};
+        sum1 = trimd::fmadd(blk, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk, inputVec2, sum2);
+        sum3 = trimd::fmadd(blk, inputVec3, sum3);
+        sum4 = trimd::fmadd(blk, inputVec4, sum4);
+    }
+    sum1.alignedStore(outbuf);
+    sum2.alignedStore(outbuf + TFVec::size());
+    sum3.alignedStore(outbuf + TFVec::size() * 2);
+    sum4.alignedStore(outbuf + TFVec::size() * 3);
+}
+
+/*
+ * Orchestrate the execution of the needed block processors for a given joint group,
+ * evaluating it for a whole batch of rig instances (which must all be on the same LOD)
+ *
+ * Instances are processed in groups of four, for which the inputs are first gathered
+ * into the column-major batch buffer, so each block of values is streamed from memory
+ * only once per group of four instances, instead of once per instance. The remaining
+ * (less than four) instances are evaluated by the regular, single instance block
+ * processors.
+ */
+template<typename TFVec, typename T>
+static FORCE_INLINE void processJointGroupBlock4Batch(const JointGroupView<T>& jointGroup,
+                                                      ConstArrayView<ConstArrayView<float> > inputs,
+                                                      ArrayView<ArrayView<float> > outputs,
+                                                      ArrayView<float> batchBuffer,
+                                                      std::uint16_t lod) {
+    constexpr std::size_t batchWidth = 4ul;
+    const std::size_t batchSize = inputs.size();
+    const std::size_t batchStride = batchSize - (batchSize % batchWidth);
+    const LODRegion& lodRegion = jointGroup.lods[lod];
+    const std::size_t columnCount = lodRegion.inputLODs.size;
+    assert(batchBuffer.size() >= (columnCount * batchStride));
+    // Gather inputs of the batched instances, so they are laid out adjacently for each column
+    for (std::size_t col = 0ul; col < columnCount; ++col) {
+        const std::uint16_t inputIndex = jointGroup.inputIndices[col];
+        float* batchInputs = batchBuffer.data() + col * batchStride;
+        for (std::size_t bi = 0ul; bi < batchStride; ++bi) {
+            batchInputs[bi] = inputs[bi][inputIndex];
+        }
+    }
+
+    const T* values = jointGroup.values;
+    const std::uint16_t* const inputIndices = jointGroup.inputIndices;
+    const std::uint16_t* const inputIndicesEnd = inputIndices + lodRegion.inputLODs.size;
+    const std::uint16_t* const inputIndicesEndAlignedTo4 = inputIndices + lodRegion.inputLODs.sizeAlignedTo4;
+    const std::uint16_t* const inputIndicesEndAlignedTo8 = inputIndices + lodRegion.inputLODs.sizeAlignedTo8;
+    const std::uint16_t* outputIndices = jointGroup.outputIndices;
+    const std::uint16_t* const outputIndicesEnd = outputIndices + lodRegion.outputLODs.size;
+    const std::uint16_t* const outputIndicesEndPaddedToLastFullBlock = outputIndices + lodRegion.outputLODs.sizePaddedToLastFullBlock;
+    const std::uint16_t* const outputIndicesEndPaddedToSecondLastFullBlock = outputIndices + lodRegion.outputLODs.sizePaddedToSecondLastFullBlock;
+    constexpr std::size_t halfBlockHeight = TFVec::size();
+    constexpr std::size_t fullBlockHeight = 2ul * TFVec::size();
+    const std::size_t halfBlockSize = jointGroup.colCount * halfBlockHeight;
+    const std::size_t fullBlockSize = jointGroup.colCount * fullBlockHeight;
+    // Process portion of matrix that's partitionable into 8x4 blocks (including the last, masked-off block)
+    for (; outputIndices < outputIndicesEndPaddedToLastFullBlock; outputIndices += fullBlockHeight, values += fullBlockSize) {
+        // Ignore results that came from rows after the last LOD row
+        const std::size_t rowCount = (outputIndices < outputIndicesEndPaddedToSecondLastFullBlock
+                                      ? fullBlockHeight
+                                      : (lodRegion.outputLODs.size % fullBlockHeight));
+        std::size_t bi = 0ul;
+        for (; bi < batchStride; bi += batchWidth) {
+            alignas(TFVec::alignment()) float outbuf[fullBlockHeight * batchWidth];
+            processBlocks8x1Batch4<TFVec>(batchBuffer.data() + bi, batchStride, columnCount, values, static_cast<float*>(outbuf));
+            for (std::size_t i = 0ul; i < rowCount; ++i) {
+                // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+                const std::uint16_t outputIndex = outputIndices[i];
+                outputs[bi + 0ul][outputIndex] = outbuf[i];
+                outputs[bi + 1ul][outputIndex] = outbuf[i + fullBlockHeight];
+                outputs[bi + 2ul][outputIndex] = outbuf[i + fullBlockHeight * 2ul];
+                outputs[bi + 3ul][outputIndex] = outbuf[i + fullBlockHeight * 3ul];
+                // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+            }
+        }
+        for (; bi < batchSize; ++bi) {
+            alignas(TFVec::alignment()) float outbuf[fullBlockHeight];
+            processBlocks8x4<TFVec>(inputIndices, inputIndicesEndAlignedTo4, inputIndicesEnd, inputs[bi], values,
+                                    static_cast<float*>(outbuf));
+            for (std::size_t i = 0ul; i < rowCount; ++i) {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                outputs[bi][outputIndices[i]] = outbuf[i];
+            }
+        }
+    }
+    // Process vertical remainder portion of matrix that's partitionable into 4x8 blocks
+    for (; outputIndices < outputIndicesEnd; outputIndices += halfBlockHeight, values += halfBlockSize) {
+        // Ignore results that came from rows after the last LOD row
+        const auto rowCount = std::min(halfBlockHeight, static_cast<std::size_t>(outputIndicesEnd - outputIndices));
+        std::size_t bi = 0ul;
+        for (; bi < batchStride; bi += batchWidth) {
+            alignas(TFVec::alignment()) float outbuf[halfBlockHeight * batchWidth];
+            processBlocks4x1Batch4<TFVec>(batchBuffer.data() + bi, batchStride, columnCount, values, static_cast<float*>(outbuf));
+            for (std::size_t i = 0ul; i < rowCount; ++i) {
+                // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+                const std::uint16_t outputIndex = outputIndices[i];
+                outputs[bi + 0ul][outputIndex] = outbuf[i];
+                outputs[bi + 1ul][outputIndex] = outbuf[i + halfBlockHeight];
+                outputs[bi + 2ul][outputIndex] = outbuf[i + halfBlockHeight * 2ul];
+                outputs[bi + 3ul][outputIndex] = outbuf[i + halfBlockHeight * 3ul];
+                // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+            }
+        }
+        for (; bi < batchSize; ++bi) {
+            alignas(TFVec::alignment()) float outbuf[halfBlockHeight];
+            processBlocks4x8<TFVec>(inputIndices, inputIndicesEndAlignedTo8, inputIndicesEnd, inputs[bi], values,
+                                    static_cast<float*>(outbuf));
+            for (std::size_t i = 0ul; i < rowCount; ++i) {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                outputs[bi][outputIndices[i]] = outbuf[i];
+            }
+        }
+    }
+}
+
 template<typename T>
 struct JointGroupLinearCalculationStrategy {
     virtual ~JointGroupLinearCalculationStrategy() = default;
@@ -328,6 +768,18 @@ struct JointGroupLinearCalculationStrategy {
                            ConstArrayView<float> inputs,
                            ArrayView<float> outputs,
                            std::uint16_t lod) const = 0;
+    virtual void calculate(const JointGroupView<T>& jointGroup,
+                           ConstArrayView<ConstArrayView<float> > inputs,
+                           ArrayView<ArrayView<float> > outputs,
+                           ArrayView<float> batchBuffer,
+                           std::uint16_t lod) const = 0;
+    // Apply the changes of inputs since previousInputs to outputs calculated from them, returns false (leaving
+    // the outputs untouched) if the joint group is to be calculated anew instead
+    virtual bool calculateChanged(const JointGroupView<T>& jointGroup,
+                                  ConstArrayView<float> inputs,
+                                  ConstArrayView<float> previousInputs,
+                                  ArrayView<float> outputs,
+                                  std::uint16_t lod) const = 0;
 
 };
 
@@ -336,12 +788,58 @@ struct VectorizedJointGroupLinearCalculationStrategy : public JointGroupLinearCa
 
     void calculate(const JointGroupView<T>& jointGroup, ConstArrayView<float> inputs, ArrayView<float> outputs,
                    std::uint16_t lod) const override {
-        processJointGroupBlock4<TFVec>(jointGroup, inputs, outputs, lod);
-        TRotationAdapter::adapt(jointGroup, outputs, lod);
+        std::uint32_t activeColumns[maxActiveColumnCount];
+        float activeInputs[maxActiveColumnCount];
+        std::size_t activeCount = {};
+        // Skip the columns of controls that are zero in this frame, unless most of them are in use anyway
+        if (collectActiveColumns(jointGroup, inputs, lod, static_cast<std::uint32_t*>(activeColumns),
+                                 static_cast<float*>(activeInputs), activeCount)) {
+            processActiveJointGroupBlock4<TFVec>(jointGroup, static_cast<const std::uint32_t*>(activeColumns),
+                                                 static_cast<const float*>(activeInputs), activeCount, outputs, lod);
+        } else {
+            processJointGroupBlock4<TFVec>(jointGroup, inputs, outputs, lod);
+        }
+        TRotationAdapter::template adapt<TFVec>(jointGroup, outputs, lod);
+    }
+
+    void calculate(const JointGroupView<T>& jointGroup,
+                   ConstArrayView<ConstArrayView<float> > inputs,
+                   ArrayView<ArrayView<float> > outputs,
+                   ArrayView<float> batchBuffer,
+                   std::uint16_t lod) const override {
+        processJointGroupBlock4Batch<TFVec>(jointGroup, inputs, outputs, batchBuffer, lod);
+        for (auto output : outputs) {
+            TRotationAdapter::template adapt<TFVec>(jointGroup, output, lod);
+        }
+    }
+
+    bool calculateChanged(const JointGroupView<T>& jointGroup,
+                          ConstArrayView<float> inputs,
+                          ConstArrayView<float> previousInputs,
+                          ArrayView<float> outputs,
+                          std::uint16_t lod) const override {
+        // Rotations converted to quaternions are not linear in the inputs, so their changes cannot be applied
+        if (!TRotationAdapter::isLinear(jointGroup, lod)) {
+            return false;
+        }
+        std::uint32_t changedColumns[maxActiveColumnCount];
+        float inputDeltas[maxActiveColumnCount];
+        std::size_t changedCount = {};
+        if (!collectChangedColumns(jointGroup, inputs, previousInputs, lod, static_cast<std::uint32_t*>(changedColumns),
+                                   static_cast<float*>(inputDeltas), changedCount)) {
+            return false;
+        }
+        if (changedCount != 0ul) {
+            processActiveJointGroupBlock4<TFVec, true>(jointGroup, static_cast<const std::uint32_t*>(changedColumns),
+                                                       static_cast<const float*>(inputDeltas), changedCount, outputs, lod);
+        }
+        return true;
     }
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
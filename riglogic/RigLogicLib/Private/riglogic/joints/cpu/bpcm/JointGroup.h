@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "riglogic/system/simd/SIMD.h"
 #include "riglogic/types/PaddedBlockView.h"
 #include "riglogic/joints/cpu/utils/LODRegion.h"
 
@@ -11,6 +12,8 @@ namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 struct JointGroup {
     // Start of non-zero values in storage
     std::uint32_t valuesOffset;
@@ -44,6 +47,8 @@ struct JointGroup {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
@@ -9,42 +9,147 @@
 
 #include <tdm/Quat.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
 namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 struct NoopAdapter {
 
     template<typename T>
+    static FORCE_INLINE bool isLinear(const JointGroupView<T>&  /*unused*/, std::uint16_t  /*unused*/) {
+        return true;
+    }
+
+    template<typename TFVec, typename T>
     static FORCE_INLINE void adapt(const JointGroupView<T>&  /*unused*/, ArrayView<float>  /*unused*/,
                                    std::uint16_t  /*unused*/) {
     }
 
 };
 
+/*
+ * Each quaternion component is a sum of two products of the half-angle sines and cosines, and rotation orders
+ * differ only by the signs of the second products (see tdm::Euler2Quat):
+ *
+ *   x = sx * cy * cz + sign.x * cx * sy * sz
+ *   y = cx * sy * cz + sign.y * sx * cy * sz
+ *   z = cx * cy * sz + sign.z * sx * sy * cz
+ *   w = cx * cy * cz + sign.w * sx * sy * sz
+ */
+template<tdm::rot_seq Order>
+struct EulerToQuaternionSigns;
+
+template<>
+struct EulerToQuaternionSigns<tdm::rot_seq::xyz> {
+    static constexpr float x = 1.0f, y = -1.0f, z = 1.0f, w = -1.0f;
+};
+
+template<>
+struct EulerToQuaternionSigns<tdm::rot_seq::xzy> {
+    static constexpr float x = -1.0f, y = -1.0f, z = 1.0f, w = 1.0f;
+};
+
+template<>
+struct EulerToQuaternionSigns<tdm::rot_seq::yxz> {
+    static constexpr float x = 1.0f, y = -1.0f, z = -1.0f, w = 1.0f;
+};
+
+template<>
+struct EulerToQuaternionSigns<tdm::rot_seq::yzx> {
+    static constexpr float x = 1.0f, y = 1.0f, z = -1.0f, w = -1.0f;
+};
+
+template<>
+struct EulerToQuaternionSigns<tdm::rot_seq::zxy> {
+    static constexpr float x = -1.0f, y = 1.0f, z = 1.0f, w = -1.0f;
+};
+
+template<>
+struct EulerToQuaternionSigns<tdm::rot_seq::zyx> {
+    static constexpr float x = -1.0f, y = 1.0f, z = -1.0f, w = 1.0f;
+};
+
+/*
+ * Converts the Euler angles of TFVec::size() rotations at a time, which are gathered through outputRotationIndices
+ * into one vector per angle, converted in lanes, and scattered back as quaternions into the same four outputs.
+ * The last chunk is padded with zero angles, whose results are not written back.
+ */
 template<typename TAngle, tdm::rot_seq Order>
 struct EulerAnglesToQuaternions {
 
     static_assert(std::is_same<TAngle, tdm::fdeg>::value || std::is_same<TAngle, tdm::frad>::value,
                   "TAngle must be either tdm::fdeg or tdm::frad.");
 
+    // Outputs of joint groups without rotations on the given LOD are left as they were calculated
     template<typename T>
+    static FORCE_INLINE bool isLinear(const JointGroupView<T>& jointGroup, std::uint16_t lod) {
+        return (jointGroup.outputRotationLODs[lod] == 0u);
+    }
+
+    template<typename TFVec, typename T>
     static FORCE_INLINE void adapt(const JointGroupView<T>& jointGroup, ArrayView<float> outputs, std::uint16_t lod) {
-        for (std::size_t row = {}; row < jointGroup.outputRotationLODs[lod]; ++row) {
-            const auto rotationStartIndex = jointGroup.outputRotationIndices[row];
-            tdm::frad3 euler{tdm::frad{TAngle{outputs[rotationStartIndex + 0ul]}},
-                             tdm::frad{TAngle{outputs[rotationStartIndex + 1ul]}},
-                             tdm::frad{TAngle{outputs[rotationStartIndex + 2ul]}}};
-            const tdm::fquat q = tdm::fquat::fromEuler<Order>(euler);
-            outputs[rotationStartIndex + 0ul] = q.x;
-            outputs[rotationStartIndex + 1ul] = q.y;
-            outputs[rotationStartIndex + 2ul] = q.z;
-            outputs[rotationStartIndex + 3ul] = q.w;
+        using Signs = EulerToQuaternionSigns<Order>;
+        constexpr std::size_t laneCount = TFVec::size();
+        // Half of the angle, converted to radians
+        const TFVec halfAngleScale{tdm::frad{TAngle{0.5f}}.value};
+        const std::size_t rotationCount = jointGroup.outputRotationLODs[lod];
+        alignas(TFVec::alignment()) float buffer[4ul][laneCount];
+
+        for (std::size_t row = {}; row < rotationCount; row += laneCount) {
+            const std::size_t chunkSize = std::min(laneCount, rotationCount - row);
+            const std::uint16_t* rotationStartIndices = jointGroup.outputRotationIndices + row;
+            for (std::size_t lane = {}; lane < chunkSize; ++lane) {
+                const float* euler = outputs.data() + rotationStartIndices[lane];
+                buffer[0][lane] = euler[0];
+                buffer[1][lane] = euler[1];
+                buffer[2][lane] = euler[2];
+            }
+            for (std::size_t lane = chunkSize; lane < laneCount; ++lane) {
+                buffer[0][lane] = 0.0f;
+                buffer[1][lane] = 0.0f;
+                buffer[2][lane] = 0.0f;
+            }
+
+            TFVec sx;
+            TFVec cx;
+            TFVec sy;
+            TFVec cy;
+            TFVec sz;
+            TFVec cz;
+            trimd::sincos(TFVec::fromAlignedSource(buffer[0]) * halfAngleScale, sx, cx);
+            trimd::sincos(TFVec::fromAlignedSource(buffer[1]) * halfAngleScale, sy, cy);
+            trimd::sincos(TFVec::fromAlignedSource(buffer[2]) * halfAngleScale, sz, cz);
+
+            const TFVec cycz = cy * cz;
+            const TFVec sysz = sy * sz;
+            const TFVec sycz = sy * cz;
+            const TFVec cysz = cy * sz;
+            fmadd(cx * sysz, TFVec{Signs::x}, sx * cycz).alignedStore(buffer[0]);
+            fmadd(sx * cysz, TFVec{Signs::y}, cx * sycz).alignedStore(buffer[1]);
+            fmadd(sx * sycz, TFVec{Signs::z}, cx * cysz).alignedStore(buffer[2]);
+            fmadd(sx * sysz, TFVec{Signs::w}, cx * cycz).alignedStore(buffer[3]);
+
+            for (std::size_t lane = {}; lane < chunkSize; ++lane) {
+                float* q = outputs.data() + rotationStartIndices[lane];
+                q[0] = buffer[0][lane];
+                q[1] = buffer[1][lane];
+                q[2] = buffer[2][lane];
+                q[3] = buffer[3][lane];
+            }
         }
     }
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
@@ -4,6 +4,7 @@
 
 #include "riglogic/TypeDefs.h"
 #include "riglogic/joints/cpu/bpcm/JointGroup.h"
+#include "riglogic/types/MappableVector.h"
 
 #include <cstdint>
 
@@ -11,14 +12,16 @@ namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TValue>
 struct JointStorage {
     // All non-zero values
-    AlignedVector<TValue> values;
+    MappableVector<TValue> values;
     // Sub-matrix col -> input vector
-    AlignedVector<std::uint16_t> inputIndices;
+    MappableVector<std::uint16_t> inputIndices;
     // Sub-matrix row -> output vector
-    AlignedVector<std::uint16_t> outputIndices;
+    MappableVector<std::uint16_t> outputIndices;
     // Output index boundaries for each LOD
     Vector<LODRegion> lodRegions;
     // Rotation indices (the start index for each rotation, used for conversion to quaternions)
@@ -47,18 +50,18 @@ struct JointStorage {
 
 template<typename TValue>
 struct JointGroupView {
-    TValue* values;
+    const TValue* values;
     std::uint32_t colCount;
     std::uint32_t rowCount;
-    std::uint16_t* inputIndices;
-    std::uint16_t* outputIndices;
-    std::uint16_t* outputRotationIndices;
-    std::uint16_t* outputRotationLODs;
-    LODRegion* lods;
+    const std::uint16_t* inputIndices;
+    const std::uint16_t* outputIndices;
+    const std::uint16_t* outputRotationIndices;
+    const std::uint16_t* outputRotationLODs;
+    const LODRegion* lods;
 };
 
 template<typename TValue>
-Vector<JointGroupView<TValue> > takeStorageSnapshot(JointStorage<TValue>& storage, MemoryResource* memRes) {
+Vector<JointGroupView<TValue> > takeStorageSnapshot(const JointStorage<TValue>& storage, MemoryResource* memRes) {
     Vector<JointGroupView<TValue> > snapshot{storage.jointGroups.size(), {}, memRes};
     for (std::size_t i = 0ul; i < storage.jointGroups.size(); ++i) {
         const auto& jointGroup = storage.jointGroups[i];
@@ -74,6 +77,8 @@ Vector<JointGroupView<TValue> > takeStorageSnapshot(JointStorage<TValue>& storag
     return snapshot;
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
@@ -13,6 +13,8 @@
 // *INDENT-OFF*
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 /*
  * FastLerp between 4 arbitrary and 4 identity quaternions
  *
@@ -196,6 +198,22 @@ static FORCE_INLINE void normalize(TFVec& qxACEG, TFVec& qyACEG, TFVec& qzACEG,
     qwACEG *= rSqrtSum;
 }
 
+/*
+ * Multiply the accumulator quaternions B, D, F, H by the blended quaternions A, C, E, G (see below)
+ */
+template<typename TFVec>
+static FORCE_INLINE void accumulate(const TFVec& qxACEG, const TFVec& qyACEG, const TFVec& qzACEG, const TFVec& qwACEG,
+                                    TFVec& qxBDFH, TFVec& qyBDFH, TFVec& qzBDFH, TFVec& qwBDFH) {
+    const TFVec qxTmp = trimd::fnmadd(qzACEG, qyBDFH, trimd::fmadd(qyACEG, qzBDFH, trimd::fmadd(qxACEG, qwBDFH, qwACEG * qxBDFH)));
+    const TFVec qyTmp = trimd::fmadd(qzACEG, qxBDFH, trimd::fmadd(qyACEG, qwBDFH, trimd::fnmadd(qxACEG, qzBDFH, qwACEG * qyBDFH)));
+    const TFVec qzTmp = trimd::fmadd(qzACEG, qwBDFH, trimd::fnmadd(qyACEG, qxBDFH, trimd::fmadd(qxACEG, qyBDFH, qwACEG * qzBDFH)));
+    const TFVec qwTmp = trimd::fnmadd(qzACEG, qzBDFH, trimd::fnmadd(qyACEG, qyBDFH, trimd::fnmadd(qxACEG, qxBDFH, qwACEG * qwBDFH)));
+    qxBDFH = qxTmp;
+    qyBDFH = qyTmp;
+    qzBDFH = qzTmp;
+    qwBDFH = qwTmp;
+}
+
 /*
  * Multiply each quaternion of a joint group by the expression weight, and combine them together into a single rotation
  *
@@ -271,15 +289,7 @@ static FORCE_INLINE void blendQuaternions(const T* quaternions,
         const TFVec weights{inputs[inputIndices[col]]};
         fastlerpWithIdentity(qxACEG, qyACEG, qzACEG, qwACEG, weights);
         normalize(qxACEG, qyACEG, qzACEG, qwACEG);
-        // Accumulate blended in q[xyzw]Tmp
-        const TFVec qxTmp = (qwACEG * qxBDFH) + (qxACEG * qwBDFH) + (qyACEG * qzBDFH) - (qzACEG * qyBDFH);
-        const TFVec qyTmp = (qwACEG * qyBDFH) - (qxACEG * qzBDFH) + (qyACEG * qwBDFH) + (qzACEG * qxBDFH);
-        const TFVec qzTmp = (qwACEG * qzBDFH) + (qxACEG * qyBDFH) - (qyACEG * qxBDFH) + (qzACEG * qwBDFH);
-        const TFVec qwTmp = (qwACEG * qwBDFH) - (qxACEG * qxBDFH) - (qyACEG * qyBDFH) - (qzACEG * qzBDFH);
-        qxBDFH = qxTmp;
-        qyBDFH = qyTmp;
-        qzBDFH = qzTmp;
-        qwBDFH = qwTmp;
+        accumulate(qxACEG, qyACEG, qzACEG, qwACEG, qxBDFH, qyBDFH, qzBDFH, qwBDFH);
     }
     qxBDFH.alignedStore(outbuf);
     qyBDFH.alignedStore(outbuf + TFVec::size());
@@ -287,6 +297,99 @@ static FORCE_INLINE void blendQuaternions(const T* quaternions,
     qwBDFH.alignedStore(outbuf + TFVec::size() * 3);
 }
 
+constexpr std::size_t maxActiveQuaternionColumnCount = 512ul;
+
+/*
+ * Columns of a joint group split by their inputs in the current frame
+ *
+ * Both lists keep the original column order, as the blended quaternions are multiplied together
+ * in column order, and quaternion multiplication is not commutative (which is also why columns
+ * cannot be reordered to keep frequently active ones together).
+ */
+struct QuaternionColumns {
+    std::uint32_t active[maxActiveQuaternionColumnCount];
+    float activeInputs[maxActiveQuaternionColumnCount];
+    std::size_t activeCount;
+    std::uint32_t inactive[maxActiveQuaternionColumnCount];
+    std::size_t inactiveCount;
+};
+
+/*
+ * Split the columns of a joint group into the ones whose inputs are non-zero, and the ones whose inputs are zero
+ *
+ * Returns false if the joint group has more columns than the lists can hold, in which case all columns are to be
+ * blended by blendQuaternions.
+ */
+template<typename T>
+static FORCE_INLINE bool collectActiveQuaternionColumns(const JointGroup<T>& jointGroup,
+                                                        ConstArrayView<float> inputs,
+                                                        std::uint16_t lod,
+                                                        QuaternionColumns& columns) {
+    const std::size_t columnCount = jointGroup.lods[lod].inputLODs.size;
+    if (columnCount > maxActiveQuaternionColumnCount) {
+        return false;
+    }
+    std::size_t activeCount = 0ul;
+    std::size_t inactiveCount = 0ul;
+    for (std::size_t col = 0ul; col < columnCount; ++col) {
+        const float input = inputs[jointGroup.inputIndices[col]];
+        const bool isActive = (input != 0.0f);
+        columns.active[activeCount] = static_cast<std::uint32_t>(col);
+        columns.activeInputs[activeCount] = input;
+        columns.inactive[inactiveCount] = static_cast<std::uint32_t>(col);
+        activeCount += static_cast<std::size_t>(isActive);
+        inactiveCount += static_cast<std::size_t>(!isActive);
+    }
+    columns.activeCount = activeCount;
+    columns.inactiveCount = inactiveCount;
+    return true;
+}
+
+/*
+ * Same as blendQuaternions, but blending only the active columns
+ *
+ * A column with zero weight is blended into the identity quaternion, apart from lanes where its w is negative,
+ * for which fastlerp picks the negated identity, so the sign bits of those lanes are flipped at the end instead.
+ * As only the w components of inactive columns are loaded, and the blending is skipped altogether for them,
+ * the cost of a joint group scales with the number of active controls. Columns with a weight of one skip the
+ * fastlerp, which leaves their quaternions unchanged.
+ * The results differ from blendQuaternions only in not being scaled by the approximate inverse square root of
+ * one for each inactive column (which with hardware rsqrt estimates is not exactly one).
+ */
+template<typename TFVec, typename T>
+static FORCE_INLINE void blendActiveQuaternions(const T* quaternions, const QuaternionColumns& columns, float* outbuf) {
+    constexpr std::size_t columnStride = TFVec::size() * 4;
+    // Initialize accumulators to identity quaternion
+    TFVec qxBDFH{0.0f};
+    TFVec qyBDFH{0.0f};
+    TFVec qzBDFH{0.0f};
+    TFVec qwBDFH{1.0f};
+    for (std::size_t i = {}; i < columns.activeCount; ++i) {
+        const T* quaternion = quaternions + columns.active[i] * columnStride;
+        TFVec qxACEG = TFVec::fromAlignedSource(quaternion);
+        TFVec qyACEG = TFVec::fromAlignedSource(quaternion + TFVec::size());
+        TFVec qzACEG = TFVec::fromAlignedSource(quaternion + TFVec::size() * 2);
+        TFVec qwACEG = TFVec::fromAlignedSource(quaternion + TFVec::size() * 3);
+        const float weight = columns.activeInputs[i];
+        if (weight != 1.0f) {
+            fastlerpWithIdentity(qxACEG, qyACEG, qzACEG, qwACEG, TFVec{weight});
+        }
+        normalize(qxACEG, qyACEG, qzACEG, qwACEG);
+        accumulate(qxACEG, qyACEG, qzACEG, qwACEG, qxBDFH, qyBDFH, qzBDFH, qwBDFH);
+    }
+    const TFVec signBit{-0.0f};
+    TFVec signs{0.0f};
+    for (std::size_t i = {}; i < columns.inactiveCount; ++i) {
+        const T* quaternion = quaternions + columns.inactive[i] * columnStride;
+        const TFVec qwACEG = TFVec::fromAlignedSource(quaternion + TFVec::size() * 3);
+        signs = signs ^ (signBit & (qwACEG < TFVec{0.0f}));
+    }
+    (qxBDFH ^ signs).alignedStore(outbuf);
+    (qyBDFH ^ signs).alignedStore(outbuf + TFVec::size());
+    (qzBDFH ^ signs).alignedStore(outbuf + TFVec::size() * 2);
+    (qwBDFH ^ signs).alignedStore(outbuf + TFVec::size() * 3);
+}
+
 template<typename T>
 struct JointGroupQuaternionCalculationStrategy {
     virtual ~JointGroupQuaternionCalculationStrategy() = default;
@@ -311,16 +414,20 @@ struct VectorizedJointGroupQuaternionCalculationStrategy : public JointGroupQuat
         const std::uint16_t* const outputIndicesEndPaddedToSecondLastFullBlock = outputIndices + lodRegion.outputLODs.sizePaddedToSecondLastFullBlock;
         const std::size_t fullBlockSize = (TFVec256::size() * 4) * jointGroup.colCount;
         const std::size_t halfBlockSize = (TFVec128::size() * 4) * jointGroup.colCount;
+        QuaternionColumns columns;
+        // Skip the columns of controls that are zero in this frame
+        const QuaternionColumns* activeColumns =
+            (collectActiveQuaternionColumns(jointGroup, inputs, lod, columns) ? &columns : nullptr);
 
         for (; outputIndices < outputIndicesEndPaddedToSecondLastFullBlock; outputIndices += (TFVec256::size() * 4), quaternions += fullBlockSize) {
             alignas(TFVec256::alignment()) float outbuf[TFVec256::size() * 4];
-            blendQuaternions<TFVec256>(quaternions, inputIndices, inputs, static_cast<float*>(outbuf));
+            blend<TFVec256>(quaternions, activeColumns, inputIndices, inputs, static_cast<float*>(outbuf));
             TRotationAdapter::forward(outbuf, TFVec256::size(), TFVec256::size(), outputIndices, outputs);
         }
 
         for (; outputIndices < outputIndicesEndPaddedToLastFullBlock; outputIndices += (TFVec256::size() * 4), quaternions += fullBlockSize) {
             alignas(TFVec256::alignment()) float outbuf[TFVec256::size() * 4];
-            blendQuaternions<TFVec256>(quaternions, inputIndices, inputs, static_cast<float*>(outbuf));
+            blend<TFVec256>(quaternions, activeColumns, inputIndices, inputs, static_cast<float*>(outbuf));
             // Ignore results that came from rows after the last LOD row
             const auto quaternionCount = (lodRegion.outputLODs.size % (TFVec256::size() * 4)) / 4;
             TRotationAdapter::forward(outbuf, quaternionCount, TFVec256::size(), outputIndices, outputs);
@@ -328,14 +435,29 @@ struct VectorizedJointGroupQuaternionCalculationStrategy : public JointGroupQuat
 
         for (; outputIndices < outputIndicesEnd; outputIndices += (TFVec128::size() * 4), quaternions += halfBlockSize) {
             alignas(TFVec128::alignment()) float outbuf[TFVec128::size() * 4];
-            blendQuaternions<TFVec128>(quaternions, inputIndices, inputs, static_cast<float*>(outbuf));
+            blend<TFVec128>(quaternions, activeColumns, inputIndices, inputs, static_cast<float*>(outbuf));
             // Ignore results that came from rows after the last LOD row
             const auto quaternionCount = static_cast<std::size_t>(outputIndicesEnd - outputIndices) / 4;
             TRotationAdapter::forward(outbuf, quaternionCount, TFVec128::size(), outputIndices, outputs);
         }
     }
 
+    template<typename TFVec>
+    static FORCE_INLINE void blend(const T* quaternions,
+                                   const QuaternionColumns* activeColumns,
+                                   ConstArrayView<std::uint16_t> inputIndices,
+                                   ConstArrayView<float> inputs,
+                                   float* outbuf) {
+        if (activeColumns != nullptr) {
+            blendActiveQuaternions<TFVec>(quaternions, *activeColumns, outbuf);
+        } else {
+            blendQuaternions<TFVec>(quaternions, inputIndices, inputs, outbuf);
+        }
+    }
+
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
 // *INDENT-ON*
@@ -4,15 +4,19 @@
 
 #include "riglogic/TypeDefs.h"
 #include "riglogic/joints/cpu/utils/LODRegion.h"
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/types/MappableVector.h"
 
 #include <cstdint>
 
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TValue>
 struct JointGroup {
     // All non-zero values
-    AlignedVector<TValue> values;
+    MappableVector<TValue> values;
     // Sub-matrix col -> input vector
     Vector<std::uint16_t> inputIndices;
     // Sub-matrix row -> output vector
@@ -39,4 +43,6 @@ struct JointGroup {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
@@ -11,12 +11,16 @@
 #include "riglogic/joints/cpu/utils/JointGroupOptimizer.h"
 #include "riglogic/riglogic/Configuration.h"
 #include "riglogic/types/bpcm/Optimizer.h"
+#include "riglogic/types/StorageLayout.h"
 #include "riglogic/utils/Extd.h"
+#include "riglogic/utils/Macros.h"
 
 #include <tdm/Quat.h>
 
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TValue, typename TFVec256, typename TFVec128>
 class QuaternionJointsBuilder : public JointsBuilder {
     public:
@@ -39,12 +43,13 @@ class QuaternionJointsBuilder : public JointsBuilder {
         void setLODs(JointGroup<TValue>& group, ConstArrayView<std::uint16_t> outputIndices);
         void remapOutputIndices(JointGroup<TValue>& group);
 
+        // Each block holds the four quaternion components of as many joints as fit into a single register
         static constexpr std::uint32_t BlockHeight() {
-            return 32u;
+            return static_cast<std::uint32_t>(TFVec256::size() * 4ul);
         }
 
         static constexpr std::uint32_t PadTo() {
-            return 16u;
+            return static_cast<std::uint32_t>(TFVec128::size() * 4ul);
         }
 
         static constexpr std::uint32_t Stride() {
@@ -279,6 +284,9 @@ typename UniqueInstance<JointGroupQuaternionCalculationStrategy<T> >::PointerTyp
     RotationOrder rotationOrder,
     dna::RotationUnit rotationUnit,
     MemoryResource* memRes) {
+    // Used only when any of the Euler angle rotation orders are built in
+    RL_UNUSED(rotationOrder);
+    RL_UNUSED(rotationUnit);
 
     if (rotationType == RotationType::Quaternions) {
         using CalculationStrategy = VectorizedJointGroupQuaternionCalculationStrategy<T, TFVec256, TFVec128, PassthroughAdapter>;
@@ -379,7 +387,10 @@ JointsEvaluator::Pointer QuaternionJointsBuilder<TValue, TFVec256, TFVec128>::bu
                                                                                    config.rotationOrder,
                                                                                    rotationUnit,
                                                                                    memRes);
-    return factory.create(std::move(strategy), std::move(jointGroups), nullptr, memRes);
+    const StorageLayout layout{BlockHeight(), PadTo(), Stride(), StorageValueTypeOf<TValue>::value};
+    return factory.create(std::move(strategy), std::move(jointGroups), nullptr, layout, memRes);
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
@@ -11,6 +11,18 @@ namespace rl4 {
 struct QuaternionJointsBuilderFactory {
     static UniqueInstance<JointsBuilder>::PointerType create(const Configuration& config, MemoryResource* memRes);
 
+    // Instruction set specific variants, each defined in its own translation unit (QuaternionJointsBuilderFactory<ISA>.cpp),
+    // where its kernels are compiled for that instruction set (see system/simd/SIMD.h)
+    static UniqueInstance<JointsBuilder>::PointerType createSSE(const Configuration& config,
+                                                                FloatingPointType floatingPointType,
+                                                                MemoryResource* memRes);
+    static UniqueInstance<JointsBuilder>::PointerType createAVX(const Configuration& config,
+                                                                FloatingPointType floatingPointType,
+                                                                MemoryResource* memRes);
+    static UniqueInstance<JointsBuilder>::PointerType createAVX512(const Configuration& config,
+                                                                   FloatingPointType floatingPointType,
+                                                                   MemoryResource* memRes);
+
 };
 
 }  // namespace rl4
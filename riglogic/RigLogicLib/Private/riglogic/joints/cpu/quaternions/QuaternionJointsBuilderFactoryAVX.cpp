@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX2
+#include "trimd/Isolate.h"
+
+#include "riglogic/joints/cpu/quaternions/QuaternionJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/quaternions/QuaternionJointsBuilder.h"
+#include "riglogic/utils/Macros.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_AVX
+// AVX variant (AVX2 and FMA, and F16C for half floats)
+UniqueInstance<JointsBuilder>::PointerType QuaternionJointsBuilderFactory::createAVX(const Configuration& config,
+                                                                                     FloatingPointType floatingPointType,
+                                                                                     MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using AVXQuaternionJointsBuilder = QuaternionJointsBuilder<std::uint16_t, trimd::avx::F256, trimd::sse::F128>;
+            return UniqueInstance<AVXQuaternionJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using AVXQuaternionJointsBuilder = QuaternionJointsBuilder<float, trimd::avx::F256, trimd::sse::F128>;
+    return UniqueInstance<AVXQuaternionJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_AVX
+
+}  // namespace rl4
@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/joints/cpu/quaternions/QuaternionJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/quaternions/QuaternionJointsBuilder.h"
+#include "riglogic/utils/Macros.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_SSE
+// SSE variant (SSE2, and F16C for half floats)
+UniqueInstance<JointsBuilder>::PointerType QuaternionJointsBuilderFactory::createSSE(const Configuration& config,
+                                                                                     FloatingPointType floatingPointType,
+                                                                                     MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using SSEQuaternionJointsBuilder = QuaternionJointsBuilder<std::uint16_t, trimd::sse::F256, trimd::sse::F128>;
+            return UniqueInstance<SSEQuaternionJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using SSEQuaternionJointsBuilder = QuaternionJointsBuilder<float, trimd::sse::F256, trimd::sse::F128>;
+    return UniqueInstance<SSEQuaternionJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_SSE
+
+}  // namespace rl4
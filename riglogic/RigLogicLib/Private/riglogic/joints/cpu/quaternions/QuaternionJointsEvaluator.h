@@ -8,11 +8,15 @@
 #include "riglogic/joints/JointsOutputInstance.h"
 #include "riglogic/joints/cpu/quaternions/CalculationStrategy.h"
 #include "riglogic/joints/cpu/quaternions/JointGroup.h"
+#include "riglogic/types/StorageLayout.h"
+#include "riglogic/utils/Extd.h"
 
 #include <cstdint>
 #include <iostream>
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TValue>
 class QuaternionJointsEvaluator : public JointsEvaluator {
     public:
@@ -26,7 +30,8 @@ class QuaternionJointsEvaluator : public JointsEvaluator {
         QuaternionJointsEvaluator(CalculationStrategyPointer strategy_,
                                   Vector<JointGroup<TValue> >&& jointGroups_,
                                   JointsOutputInstance::Factory instanceFactory_,
-                                  MemoryResource* memRes);
+                                  StorageLayout layout_,
+                                  MemoryResource* memRes_);
 
         JointsOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         std::uint32_t getJointDeltaValueCountForLOD(std::uint16_t lod) const override;
@@ -35,13 +40,46 @@ class QuaternionJointsEvaluator : public JointsEvaluator {
                        JointsOutputInstance* outputs,
                        std::uint16_t lod,
                        std::uint16_t jointGroupIndex) const override;
+        void calculateChanged(const ControlsInputInstance* inputs,
+                              ConstArrayView<float> previousInputs,
+                              JointsOutputInstance* outputs,
+                              std::uint16_t lod,
+                              std::uint16_t jointGroupIndex) const override;
+        std::uint16_t getJointGroupSliceCount(std::uint16_t jointGroupIndex) const override;
+        std::uint32_t getJointGroupSliceCost(std::uint16_t lod,
+                                             std::uint16_t jointGroupIndex,
+                                             std::uint16_t sliceIndex) const override;
+        void calculate(const ControlsInputInstance* inputs,
+                       JointsOutputInstance* outputs,
+                       std::uint16_t lod,
+                       std::uint16_t jointGroupIndex,
+                       std::uint16_t sliceIndex) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<JointsOutputInstance*> outputs,
+                       std::uint16_t lod) const override;
+        void calculateUngrouped(const ControlsInputInstance*  /*unused*/, JointsOutputInstance*  /*unused*/,
+                                std::uint16_t  /*unused*/) const override;
+        std::uint16_t getUngroupedPartitionCount(std::uint16_t  /*unused*/) const override;
+        void calculateUngrouped(const ControlsInputInstance*  /*unused*/,
+                                JointsOutputInstance*  /*unused*/,
+                                std::uint16_t  /*unused*/,
+                                std::uint16_t  /*unused*/) const override;
+        void collectJointGroupInputIndices(std::uint16_t lod,
+                                           std::uint16_t jointGroupIndex,
+                                           Vector<std::uint16_t>& inputIndices) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override;
 
     private:
+        template<typename TSource>
+        void loadConverted(terse::BinaryInputArchive<BoundedIOStream>& archive, const StorageLayout& dumpedLayout);
+
+    private:
+        MemoryResource* memRes;
         CalculationStrategyPointer strategy;
         Vector<JointGroup<TValue> > jointGroups;
         JointsOutputInstance::Factory instanceFactory;
+        StorageLayout layout;
 
 };
 
@@ -49,10 +87,13 @@ template<typename TValue>
 QuaternionJointsEvaluator<TValue>::QuaternionJointsEvaluator(CalculationStrategyPointer strategy_,
                                                              Vector<JointGroup<TValue> >&& jointGroups_,
                                                              JointsOutputInstance::Factory instanceFactory_,
-                                                             MemoryResource*  /*unused*/) :
+                                                             StorageLayout layout_,
+                                                             MemoryResource* memRes_) :
+    memRes{memRes_},
     strategy{std::move(strategy_)},
     jointGroups{std::move(jointGroups_)},
-    instanceFactory{instanceFactory_} {
+    instanceFactory{instanceFactory_},
+    layout{layout_} {
 }
 
 template<typename TValue>
@@ -90,14 +131,136 @@ void QuaternionJointsEvaluator<TValue>::calculate(const ControlsInputInstance* i
     strategy->calculate(jointGroups[jointGroupIndex], inputs->getInputBuffer(), outputs->getOutputBuffer(), lod);
 }
 
+template<typename TValue>
+void QuaternionJointsEvaluator<TValue>::calculateChanged(const ControlsInputInstance* inputs,
+                                                         ConstArrayView<float>  /*unused*/,
+                                                         JointsOutputInstance* outputs,
+                                                         std::uint16_t lod,
+                                                         std::uint16_t jointGroupIndex) const {
+    // Blended quaternions are not linear in the inputs, so the whole joint group is recalculated
+    calculate(inputs, outputs, lod, jointGroupIndex);
+}
+
+template<typename TValue>
+std::uint16_t QuaternionJointsEvaluator<TValue>::getJointGroupSliceCount(std::uint16_t jointGroupIndex) const {
+    // Quaternions of a joint group are blended column by column, so the whole group is a single slice
+    return static_cast<std::uint16_t>(jointGroupIndex < jointGroups.size() ? 1 : 0);
+}
+
+template<typename TValue>
+std::uint32_t QuaternionJointsEvaluator<TValue>::getJointGroupSliceCost(std::uint16_t lod,
+                                                                       std::uint16_t jointGroupIndex,
+                                                                       std::uint16_t  /*unused*/) const {
+    const auto& lodRegion = jointGroups[jointGroupIndex].lods[lod];
+    // Every value is blended from all input columns with a lerp and a quaternion product (about four multiply-adds
+    // per value each), plus storing the result
+    return lodRegion.outputLODs.size * (4u * lodRegion.inputLODs.size + 1u);
+}
+
+template<typename TValue>
+void QuaternionJointsEvaluator<TValue>::calculate(const ControlsInputInstance* inputs,
+                                                  JointsOutputInstance* outputs,
+                                                  std::uint16_t lod,
+                                                  std::uint16_t jointGroupIndex,
+                                                  std::uint16_t  /*unused*/) const {
+    calculate(inputs, outputs, lod, jointGroupIndex);
+}
+
+template<typename TValue>
+void QuaternionJointsEvaluator<TValue>::calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                                                  ConstArrayView<JointsOutputInstance*> outputs,
+                                                  std::uint16_t lod) const {
+    assert(inputs.size() == outputs.size());
+    for (std::size_t i = {}; i < inputs.size(); ++i) {
+        calculate(inputs[i], outputs[i], lod);
+    }
+}
+
+template<typename TValue>
+void QuaternionJointsEvaluator<TValue>::calculateUngrouped(const ControlsInputInstance*  /*unused*/,
+                                                           JointsOutputInstance*  /*unused*/,
+                                                           std::uint16_t  /*unused*/) const {
+}
+
+template<typename TValue>
+std::uint16_t QuaternionJointsEvaluator<TValue>::getUngroupedPartitionCount(std::uint16_t  /*unused*/) const {
+    return {};
+}
+
+template<typename TValue>
+void QuaternionJointsEvaluator<TValue>::calculateUngrouped(const ControlsInputInstance*  /*unused*/,
+                                                           JointsOutputInstance*  /*unused*/,
+                                                           std::uint16_t  /*unused*/,
+                                                           std::uint16_t  /*unused*/) const {
+}
+
+template<typename TValue>
+void QuaternionJointsEvaluator<TValue>::collectJointGroupInputIndices(std::uint16_t lod,
+                                                                      std::uint16_t jointGroupIndex,
+                                                                      Vector<std::uint16_t>& inputIndices) const {
+    if (jointGroupIndex < jointGroups.size()) {
+        const auto& jointGroup = jointGroups[jointGroupIndex];
+        const auto columns = jointGroup.inputIndices.begin();
+        inputIndices.insert(inputIndices.end(), columns, columns + jointGroup.lods[lod].inputLODs.size);
+    }
+}
+
 template<typename TValue>
 void QuaternionJointsEvaluator<TValue>::load(terse::BinaryInputArchive<BoundedIOStream>& archive) {
-    archive(jointGroups);
+    StorageLayout dumpedLayout{};
+    archive(dumpedLayout);
+    if (dumpedLayout == layout) {
+        archive(jointGroups);
+    } else if (dumpedLayout.valueType == StorageValueType::HalfFloat) {
+        loadConverted<std::uint16_t>(archive, dumpedLayout);
+    } else {
+        loadConverted<float>(archive, dumpedLayout);
+    }
 }
 
 template<typename TValue>
 void QuaternionJointsEvaluator<TValue>::save(terse::BinaryOutputArchive<BoundedIOStream>& archive) {
-    archive(jointGroups);
+    archive(layout, jointGroups);
 }
 
+// Joint groups dumped by a variant of a different vector width (or floating point type) are re-arranged into the
+// layout of this one, with their rows re-padded for its block heights
+template<typename TValue>
+template<typename TSource>
+void QuaternionJointsEvaluator<TValue>::loadConverted(terse::BinaryInputArchive<BoundedIOStream>& archive,
+                                                      const StorageLayout& dumpedLayout) {
+    Vector<JointGroup<TSource> > dumped{memRes};
+    archive(dumped);
+
+    jointGroups.clear();
+    jointGroups.reserve(dumped.size());
+    for (const auto& source : dumped) {
+        jointGroups.emplace_back(memRes);
+        auto& group = jointGroups.back();
+        group.inputIndices.assign(source.inputIndices.begin(), source.inputIndices.end());
+        group.outputIndices.assign(source.outputIndices.begin(), source.outputIndices.end());
+        group.lods.assign(source.lods.begin(), source.lods.end());
+        group.colCount = source.colCount;
+        if (source.values.empty()) {
+            continue;
+        }
+        // Output indices are not padded, so they hold the unpadded row count
+        const auto rowCount = static_cast<std::uint32_t>(source.outputIndices.size());
+        group.rowCount = extd::roundUp(rowCount, layout.padTo);
+        group.values.resize(static_cast<std::size_t>(group.rowCount) * group.colCount);
+        convertBlockedMatrix(group.values.data(),
+                             layout,
+                             source.values.data(),
+                             dumpedLayout,
+                             Extent{rowCount, source.colCount},
+                             rowCount,
+                             memRes);
+        for (auto& lod : group.lods) {
+            lod.outputLODs = RowLOD(lod.outputLODs.size, group.rowCount, layout.blockHeight, layout.padTo);
+        }
+    }
+}
+
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
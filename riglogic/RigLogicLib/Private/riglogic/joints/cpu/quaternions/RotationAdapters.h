@@ -10,6 +10,8 @@
 
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 struct PassthroughAdapter {
 
     static FORCE_INLINE void forward(const float* quaternions,
@@ -89,4 +91,6 @@ struct QuaternionsToEulerAngles {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
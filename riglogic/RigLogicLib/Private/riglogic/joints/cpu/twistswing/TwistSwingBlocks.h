@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/system/simd/SIMD.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+/*
+ * Twist and swing setups of a single LOD, flattened for vectorized evaluation
+ *
+ * Setups are grouped into blocks of blockSize setups (one per vector lane) which extract the twist about the
+ * same axis, so the twist and swing of all setups in a block are computed by the same vector operations.
+ * Each setup produces three rotations per lane: its twist (inverted for swing setups), its inverted swing,
+ * and the identity. The outputs of a block each blend one of these rotations towards identity, and multiply
+ * the result by another one of them (the inverted twist for swing outputs, the identity otherwise):
+ *
+ *   rotation lanes   [twist 0 .. twist N-1, inverted swing 0 .. inverted swing N-1, identity ...]
+ *   output           premultiplierLane * slerp(sourceLane, identity, blendWeight)
+ *
+ * Only outputs of joints present in the LOD are kept, and only the last output of each joint (which is the
+ * one the unflattened setups would leave behind), so outputs are disjoint and blocks may be evaluated in any
+ * order. Blocks are split into partitions of roughly equal output counts, which may be evaluated concurrently.
+ */
+struct TwistSwingBlocks {
+    // Per block
+    Vector<std::uint8_t> twistAxes;
+    Vector<std::uint32_t> outputOffsets;  // Padded to a multiple of blockSize
+    Vector<std::uint32_t> outputCounts;
+    // Per setup lane, with the four input indices of each block stored as [x x ... x, y y ... y, z z ... z, w w ... w]
+    Vector<std::uint16_t> inputIndices;
+    Vector<float> twistSigns;  // -1 for swing setups, whose twist is inverted, 1 for twist only setups
+    // Per output (padded), with padding blending the identity
+    Vector<std::uint8_t> sourceLanes;
+    Vector<std::uint8_t> premultiplierLanes;
+    Vector<float> blendWeights;
+    Vector<std::uint16_t> outputIndices;  // 4 per output
+    // Partition i consists of blocks [partitionOffsets[i], partitionOffsets[i + 1])
+    Vector<std::uint32_t> partitionOffsets;
+
+    explicit TwistSwingBlocks(MemoryResource* memRes) :
+        twistAxes{memRes},
+        outputOffsets{memRes},
+        outputCounts{memRes},
+        inputIndices{memRes},
+        twistSigns{memRes},
+        sourceLanes{memRes},
+        premultiplierLanes{memRes},
+        blendWeights{memRes},
+        outputIndices{memRes},
+        partitionOffsets{memRes} {
+    }
+
+    std::uint16_t getPartitionCount() const {
+        return static_cast<std::uint16_t>(partitionOffsets.empty() ? 0ul : partitionOffsets.size() - 1ul);
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(twistAxes);
+        archive(outputOffsets);
+        archive(outputCounts);
+        archive(inputIndices);
+        archive(twistSigns);
+        archive(sourceLanes);
+        archive(premultiplierLanes);
+        archive(blendWeights);
+        archive(outputIndices);
+        archive(partitionOffsets);
+    }
+
+};
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace rl4
@@ -6,12 +6,21 @@
 #include "riglogic/joints/JointBehaviorFilter.h"
 #include "riglogic/joints/JointsBuilder.h"
 #include "riglogic/joints/cpu/quaternions/RotationAdapters.h"
+#include "riglogic/joints/cpu/twistswing/TwistSwingBlocks.h"
 #include "riglogic/joints/cpu/twistswing/TwistSwingJointsEvaluator.h"
+#include "riglogic/joints/cpu/twistswing/TwistSwingSetup.h"
 #include "riglogic/riglogic/Configuration.h"
 #include "riglogic/utils/Extd.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<class TContainer, class UContainer>
 static bool containersEqual(const TContainer& lhs, const UContainer& rhs) {
     if (lhs.size() != rhs.size()) {
@@ -27,6 +36,12 @@ static bool containersEqual(const TContainer& lhs, const UContainer& rhs) {
 
 template<typename TValue, typename TFVec256, typename TFVec128>
 class TwistSwingJointsBuilder : public JointsBuilder {
+    public:
+        static constexpr std::size_t blockSize = TFVec256::size();
+        // Blocks are gathered into partitions of at least this many outputs (except for the last one), so the
+        // partitions evaluated concurrently are not too small to be worth dispatching
+        static constexpr std::uint32_t minPartitionOutputCount = 64u;
+
     public:
         TwistSwingJointsBuilder(const Configuration& config_, MemoryResource* memRes_);
 
@@ -37,10 +52,14 @@ class TwistSwingJointsBuilder : public JointsBuilder {
         void registerControls(Controls* controls) override;
         JointsEvaluator::Pointer build() override;
 
+    private:
+        void flattenSetups(const dna::Reader* reader);
+
     private:
         Configuration config;
         MemoryResource* memRes;
         Vector<TwistSwingSetup> setups;
+        Vector<TwistSwingBlocks> lods;
         dna::RotationUnit rotationUnit;
 };
 
@@ -50,6 +69,7 @@ TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::TwistSwingJointsBuilder(con
     config{config_},
     memRes{memRes_},
     setups{memRes_},
+    lods{memRes_},
     rotationUnit{} {
 }
 
@@ -160,6 +180,137 @@ void TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::fillStorage(const Join
         }
     }
 
+    flattenSetups(reader);
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128>
+void TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::flattenSetups(const dna::Reader* reader) {
+    const std::size_t attributesPerJoint = (config.rotationType == RotationType::EulerAngles ? 9ul : 10ul);
+    const std::uint16_t jointCount = reader->getJointCount();
+    const std::uint16_t lodCount = reader->getLODCount();
+
+    // All outputs, in the order in which the setups write them
+    struct SetupOutput {
+        std::uint32_t setupIndex;
+        std::uint32_t index;
+        bool swing;
+    };
+    Vector<SetupOutput> setupOutputs{memRes};
+    Vector<std::uint32_t> setupOutputOffsets{memRes};
+    for (std::uint32_t setupIndex = {}; setupIndex < setups.size(); ++setupIndex) {
+        const auto& setup = setups[setupIndex];
+        setupOutputOffsets.push_back(static_cast<std::uint32_t>(setupOutputs.size()));
+        for (std::uint32_t si = {}; si < setup.swingBlendWeights.size(); ++si) {
+            setupOutputs.push_back({setupIndex, si, true});
+        }
+        for (std::uint32_t ti = {}; ti < setup.twistBlendWeights.size(); ++ti) {
+            setupOutputs.push_back({setupIndex, ti, false});
+        }
+    }
+    setupOutputOffsets.push_back(static_cast<std::uint32_t>(setupOutputs.size()));
+    auto getOutputIndices = [this](const SetupOutput& output) {
+            const auto& setup = setups[output.setupIndex];
+            return (output.swing ? &setup.swingOutputIndices[output.index * 4ul] : &setup.twistOutputIndices[output.index * 4ul]);
+        };
+    auto getTwistAxis = [this](std::uint32_t setupIndex) {
+            const auto& setup = setups[setupIndex];
+            return static_cast<std::uint8_t>(setup.swingInputIndices.empty() ? setup.twistTwistAxis : setup.swingTwistAxis);
+        };
+
+    Vector<bool> jointInLOD(jointCount, false, memRes);
+    Vector<bool> jointWritten(jointCount, false, memRes);
+    Vector<bool> outputKept(setupOutputs.size(), false, memRes);
+    Vector<bool> setupKept(setups.size(), false, memRes);
+    Vector<std::uint32_t> setupIndices{memRes};
+
+    lods.reserve(lodCount);
+    for (std::uint16_t lod = {}; lod < lodCount; ++lod) {
+        std::fill(jointInLOD.begin(), jointInLOD.end(), false);
+        for (const auto jointIndex : reader->getJointIndicesForLOD(lod)) {
+            jointInLOD[jointIndex] = true;
+        }
+        // Setups evaluated later overwrite the outputs of earlier ones, so only the last output of each joint is kept
+        std::fill(jointWritten.begin(), jointWritten.end(), false);
+        std::fill(setupKept.begin(), setupKept.end(), false);
+        for (std::size_t i = setupOutputs.size(); i > 0ul; --i) {
+            const std::size_t jointIndex = getOutputIndices(setupOutputs[i - 1ul])[0] / attributesPerJoint;
+            outputKept[i - 1ul] = jointInLOD[jointIndex] && !jointWritten[jointIndex];
+            jointWritten[jointIndex] = jointWritten[jointIndex] || outputKept[i - 1ul];
+            setupKept[setupOutputs[i - 1ul].setupIndex] = setupKept[setupOutputs[i - 1ul].setupIndex] || outputKept[i - 1ul];
+        }
+
+        setupIndices.clear();
+        for (std::uint32_t setupIndex = {}; setupIndex < setups.size(); ++setupIndex) {
+            if (setupKept[setupIndex]) {
+                setupIndices.push_back(setupIndex);
+            }
+        }
+        std::stable_sort(setupIndices.begin(), setupIndices.end(), [&getTwistAxis](std::uint32_t lhs, std::uint32_t rhs) {
+                return getTwistAxis(lhs) < getTwistAxis(rhs);
+            });
+
+        TwistSwingBlocks blocks{memRes};
+        blocks.partitionOffsets.push_back(0u);
+        std::uint32_t partitionOutputCount = {};
+        for (std::size_t blockStart = {}; blockStart < setupIndices.size();) {
+            const std::uint8_t twistAxis = getTwistAxis(setupIndices[blockStart]);
+            std::size_t blockEnd = blockStart + 1ul;
+            while ((blockEnd < setupIndices.size()) && (blockEnd - blockStart < blockSize) &&
+                   (getTwistAxis(setupIndices[blockEnd]) == twistAxis)) {
+                ++blockEnd;
+            }
+
+            // Unused lanes of the block read the first input, and are never referred to by any output
+            const std::size_t inputOffset = blocks.inputIndices.size();
+            blocks.twistAxes.push_back(twistAxis);
+            blocks.inputIndices.resize(inputOffset + blockSize * 4ul, static_cast<std::uint16_t>(0));
+            blocks.twistSigns.resize(blocks.twistAxes.size() * blockSize, 1.0f);
+            for (std::size_t lane = {}; lane < blockEnd - blockStart; ++lane) {
+                const auto& setup = setups[setupIndices[blockStart + lane]];
+                const bool swing = !setup.swingInputIndices.empty();
+                const auto& inputIndices = (swing ? setup.swingInputIndices : setup.twistInputIndices);
+                for (std::size_t c = {}; c < 4ul; ++c) {
+                    blocks.inputIndices[inputOffset + c * blockSize + lane] = inputIndices[c];
+                }
+                blocks.twistSigns[(blocks.twistAxes.size() - 1ul) * blockSize + lane] = (swing ? -1.0f : 1.0f);
+            }
+
+            const auto outputOffset = static_cast<std::uint32_t>(blocks.blendWeights.size());
+            for (std::size_t lane = {}; lane < blockEnd - blockStart; ++lane) {
+                const std::uint32_t setupIndex = setupIndices[blockStart + lane];
+                const auto& setup = setups[setupIndex];
+                for (std::uint32_t i = setupOutputOffsets[setupIndex]; i < setupOutputOffsets[setupIndex + 1ul]; ++i) {
+                    if (!outputKept[i]) {
+                        continue;
+                    }
+                    const auto& output = setupOutputs[i];
+                    // Swing outputs blend the inverted swing, and premultiply it with the inverted twist, while twist
+                    // outputs just blend the twist (inverted if the setup has a swing part as well)
+                    blocks.sourceLanes.push_back(static_cast<std::uint8_t>(output.swing ? blockSize + lane : lane));
+                    blocks.premultiplierLanes.push_back(static_cast<std::uint8_t>(output.swing ? lane : blockSize * 2ul));
+                    blocks.blendWeights.push_back(output.swing ? setup.swingBlendWeights[output.index] : setup.twistBlendWeights[output.index]);
+                    const std::uint16_t* outputIndices = getOutputIndices(output);
+                    blocks.outputIndices.insert(blocks.outputIndices.end(), outputIndices, outputIndices + 4ul);
+                }
+            }
+            const auto outputCount = static_cast<std::uint32_t>(blocks.blendWeights.size() - outputOffset);
+            const std::size_t paddedOutputCount = extd::roundUp(static_cast<std::size_t>(outputCount), blockSize);
+            blocks.sourceLanes.resize(outputOffset + paddedOutputCount, static_cast<std::uint8_t>(blockSize * 2ul));
+            blocks.premultiplierLanes.resize(outputOffset + paddedOutputCount, static_cast<std::uint8_t>(blockSize * 2ul));
+            blocks.blendWeights.resize(outputOffset + paddedOutputCount, 0.0f);
+            blocks.outputIndices.resize((outputOffset + paddedOutputCount) * 4ul, static_cast<std::uint16_t>(0));
+            blocks.outputOffsets.push_back(outputOffset);
+            blocks.outputCounts.push_back(outputCount);
+
+            partitionOutputCount += outputCount;
+            blockStart = blockEnd;
+            if ((partitionOutputCount >= minPartitionOutputCount) || (blockStart == setupIndices.size())) {
+                blocks.partitionOffsets.push_back(static_cast<std::uint32_t>(blocks.twistAxes.size()));
+                partitionOutputCount = {};
+            }
+        }
+        lods.push_back(std::move(blocks));
+    }
 }
 
 template<typename TValue, typename TFVec256, typename TFVec128>
@@ -171,7 +322,7 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
 
     if (config.rotationType == RotationType::Quaternions) {
         using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, PassthroughAdapter>;
-        return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+        return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
     }
 
     #ifdef RL_BUILD_WITH_XYZ_ROTATION_ORDER
@@ -179,11 +330,11 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
             if (rotationUnit == dna::RotationUnit::degrees) {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::fdeg,
                                                                                                                     tdm::rot_seq::xyz> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             } else {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::frad,
                                                                                                                     tdm::rot_seq::xyz> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             }
         }
     #endif  // RL_BUILD_WITH_XYZ_ROTATION_ORDER
@@ -193,11 +344,11 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
             if (rotationUnit == dna::RotationUnit::degrees) {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::fdeg,
                                                                                                                     tdm::rot_seq::xzy> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             } else {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::frad,
                                                                                                                     tdm::rot_seq::xzy> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             }
         }
     #endif  // RL_BUILD_WITH_XZY_ROTATION_ORDER
@@ -207,11 +358,11 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
             if (rotationUnit == dna::RotationUnit::degrees) {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::fdeg,
                                                                                                                     tdm::rot_seq::yxz> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             } else {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::frad,
                                                                                                                     tdm::rot_seq::yxz> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             }
         }
     #endif  // RL_BUILD_WITH_YXZ_ROTATION_ORDER
@@ -221,11 +372,11 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
             if (rotationUnit == dna::RotationUnit::degrees) {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::fdeg,
                                                                                                                     tdm::rot_seq::yzx> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             } else {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::frad,
                                                                                                                     tdm::rot_seq::yzx> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             }
         }
     #endif  // RL_BUILD_WITH_YZX_ROTATION_ORDER
@@ -235,11 +386,11 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
             if (rotationUnit == dna::RotationUnit::degrees) {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::fdeg,
                                                                                                                     tdm::rot_seq::zxy> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             } else {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::frad,
                                                                                                                     tdm::rot_seq::zxy> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             }
         }
     #endif  // RL_BUILD_WITH_ZXY_ROTATION_ORDER
@@ -249,11 +400,11 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
             if (rotationUnit == dna::RotationUnit::degrees) {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::fdeg,
                                                                                                                     tdm::rot_seq::zyx> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             } else {
                 using TSJEvaluator = TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, QuaternionsToEulerAngles<tdm::frad,
                                                                                                                     tdm::rot_seq::zyx> >;
-                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(setups), nullptr, memRes);
+                return UniqueInstance<TSJEvaluator, JointsEvaluator>::with(memRes).create(std::move(lods), nullptr, memRes);
             }
         }
     #endif  // RL_BUILD_WITH_ZYX_ROTATION_ORDER
@@ -261,4 +412,6 @@ JointsEvaluator::Pointer TwistSwingJointsBuilder<TValue, TFVec256, TFVec128>::bu
     return nullptr;
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
@@ -11,6 +11,12 @@ namespace rl4 {
 struct TwistSwingJointsBuilderFactory {
     static UniqueInstance<JointsBuilder>::PointerType create(const Configuration& config, MemoryResource* memRes);
 
+    // Instruction set specific variants, each defined in its own translation unit (TwistSwingJointsBuilderFactory<ISA>.cpp),
+    // where its kernels are compiled for that instruction set (see system/simd/SIMD.h)
+    static UniqueInstance<JointsBuilder>::PointerType createSSE(const Configuration& config, MemoryResource* memRes);
+    static UniqueInstance<JointsBuilder>::PointerType createAVX(const Configuration& config, MemoryResource* memRes);
+    static UniqueInstance<JointsBuilder>::PointerType createAVX512(const Configuration& config, MemoryResource* memRes);
+
 };
 
 }  // namespace rl4
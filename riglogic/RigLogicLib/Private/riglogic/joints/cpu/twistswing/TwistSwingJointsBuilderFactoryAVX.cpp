@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX2
+#include "trimd/Isolate.h"
+
+#include "riglogic/joints/cpu/twistswing/TwistSwingJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/twistswing/TwistSwingJointsBuilder.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_AVX
+// AVX variant (AVX2 and FMA)
+UniqueInstance<JointsBuilder>::PointerType TwistSwingJointsBuilderFactory::createAVX(const Configuration& config,
+                                                                                     MemoryResource* memRes) {
+    using AVXTwistSwingJointsBuilder = TwistSwingJointsBuilder<float, trimd::avx::F256, trimd::sse::F128>;
+    return UniqueInstance<AVXTwistSwingJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_AVX
+
+}  // namespace rl4
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX512
+#include "trimd/Isolate.h"
+
+#include "riglogic/joints/cpu/twistswing/TwistSwingJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/twistswing/TwistSwingJointsBuilder.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_AVX512
+// AVX-512 variant (AVX-512F)
+UniqueInstance<JointsBuilder>::PointerType TwistSwingJointsBuilderFactory::createAVX512(const Configuration& config,
+                                                                                        MemoryResource* memRes) {
+    // Rigs rarely have enough twist and swing setups sharing an axis to fill 16 lanes, so blocks stay 8 lanes wide
+    using AVX512TwistSwingJointsBuilder = TwistSwingJointsBuilder<float, trimd::avx::F256, trimd::sse::F128>;
+    return UniqueInstance<AVX512TwistSwingJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_AVX512
+
+}  // namespace rl4
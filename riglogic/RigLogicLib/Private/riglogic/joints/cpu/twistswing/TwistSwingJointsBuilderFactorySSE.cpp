@@ -0,0 +1,18 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/joints/cpu/twistswing/TwistSwingJointsBuilderFactory.h"
+
+#include "riglogic/joints/cpu/twistswing/TwistSwingJointsBuilder.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_SSE
+// SSE variant (SSE2)
+UniqueInstance<JointsBuilder>::PointerType TwistSwingJointsBuilderFactory::createSSE(const Configuration& config,
+                                                                                     MemoryResource* memRes) {
+    using SSETwistSwingJointsBuilder = TwistSwingJointsBuilder<float, trimd::sse::F256, trimd::sse::F128>;
+    return UniqueInstance<SSETwistSwingJointsBuilder, JointsBuilder>::with(memRes).create(config, memRes);
+}
+#endif  // RL_BUILD_WITH_SSE
+
+}  // namespace rl4
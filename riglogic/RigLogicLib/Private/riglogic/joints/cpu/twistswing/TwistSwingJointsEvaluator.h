@@ -6,39 +6,69 @@
 #include "riglogic/controls/ControlsInputInstance.h"
 #include "riglogic/joints/JointsEvaluator.h"
 #include "riglogic/joints/JointsOutputInstance.h"
-#include "riglogic/joints/cpu/twistswing/TwistSwingSetup.h"
-
-#include <tdm/Computations.h>
-#include <tdm/Quat.h>
+#include "riglogic/joints/cpu/twistswing/TwistSwingBlocks.h"
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
 
+#include <cassert>
 #include <cstdint>
 #include <cstddef>
+#include <limits>
 
 namespace rl4 {
 
-static inline tdm::fquat separateTwistComponentByAxisX(const tdm::fquat& input) {
-    const tdm::fquat twist{input.x, 0.0f, 0.0f, input.w};
-    return (twist.length2() == 0.0f) ? tdm::fquat{} : tdm::normalize(twist);
-}
+TRIMD_BEGIN_ISA_NAMESPACE
+
+namespace twistswing {
 
-static inline tdm::fquat separateTwistComponentByAxisY(const tdm::fquat& input) {
-    const tdm::fquat twist{0.0f, input.y, 0.0f, input.w};
-    return (twist.length2() == 0.0f) ? tdm::fquat{} : tdm::normalize(twist);
+// Hamilton product of quaternions given as [x, y, z, w] vectors, each lane holding a different quaternion
+template<typename TFVec>
+static FORCE_INLINE void multiply(const TFVec* lhs, const TFVec* rhs, TFVec* result) {
+    result[0] = lhs[3] * rhs[0] + lhs[0] * rhs[3] + lhs[1] * rhs[2] - lhs[2] * rhs[1];
+    result[1] = lhs[3] * rhs[1] + lhs[1] * rhs[3] + lhs[2] * rhs[0] - lhs[0] * rhs[2];
+    result[2] = lhs[3] * rhs[2] + lhs[2] * rhs[3] + lhs[0] * rhs[1] - lhs[1] * rhs[0];
+    result[3] = lhs[3] * rhs[3] - lhs[0] * rhs[0] - lhs[1] * rhs[1] - lhs[2] * rhs[2];
 }
 
-static inline tdm::fquat separateTwistComponentByAxisZ(const tdm::fquat& input) {
-    const tdm::fquat twist{0.0f, 0.0f, input.z, input.w};
-    return (twist.length2() == 0.0f) ? tdm::fquat{} : tdm::normalize(twist);
+// Same as tdm::slerp(q, identity, t), where the dot product of q and identity is just q.w
+template<typename TFVec>
+static FORCE_INLINE void slerpToIdentity(const TFVec* q, const TFVec& t, TFVec* result) {
+    const TFVec one{1.0f};
+    const TFVec cosTheta = abs(q[3]);
+    // Identity is negated for quaternions in the other hemisphere, to take the shorter path
+    const TFVec identitySign = q[3] ^ cosTheta;
+    const TFVec theta = trimd::acos(cosTheta);
+    const TFVec rSinTheta = one / trimd::sin(theta);
+    const TFVec oneMinusT = one - t;
+    // Nearly parallel quaternions fall back to linear interpolation (masking out the division by zero)
+    const TFVec linear = (cosTheta > TFVec{1.0f - std::numeric_limits<float>::epsilon()});
+    const TFVec t1 = andnot(linear, trimd::sin(oneMinusT * theta) * rSinTheta) | (oneMinusT & linear);
+    const TFVec t2 = andnot(linear, trimd::sin(t * theta) * rSinTheta) | (t & linear);
+    result[0] = q[0] * t1;
+    result[1] = q[1] * t1;
+    result[2] = q[2] * t1;
+    result[3] = fmadd(q[3], t1, t2 ^ identitySign);
 }
 
+}  // namespace twistswing
+
+/*
+ * Evaluates twist and swing setups flattened into TwistSwingBlocks, one block of setups per TFVec256 vector
+ *
+ * Twist and swing outputs are not partitioned into joint groups (and they overwrite rotations computed by
+ * joint groups), so the per joint group overload does nothing. Instead, the setups of each LOD are split
+ * into partitions with disjoint outputs, which can be evaluated concurrently once all joint groups are done.
+ */
 template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
 class TwistSwingJointsEvaluator : public JointsEvaluator {
     public:
         struct Accessor;
         friend Accessor;
 
+        static constexpr std::size_t blockSize = TFVec256::size();
+
     public:
-        explicit TwistSwingJointsEvaluator(Vector<TwistSwingSetup>&& setups_,
+        explicit TwistSwingJointsEvaluator(Vector<TwistSwingBlocks>&& lods_,
                                            JointsOutputInstance::Factory instanceFactory_,
                                            MemoryResource* memRes);
 
@@ -49,21 +79,54 @@ class TwistSwingJointsEvaluator : public JointsEvaluator {
                        JointsOutputInstance* outputs,
                        std::uint16_t lod,
                        std::uint16_t jointGroupIndex) const override;
+        void calculateChanged(const ControlsInputInstance*  /*unused*/,
+                              ConstArrayView<float>  /*unused*/,
+                              JointsOutputInstance*  /*unused*/,
+                              std::uint16_t  /*unused*/,
+                              std::uint16_t  /*unused*/) const override;
+        std::uint16_t getJointGroupSliceCount(std::uint16_t  /*unused*/) const override;
+        std::uint32_t getJointGroupSliceCost(std::uint16_t  /*unused*/,
+                                             std::uint16_t  /*unused*/,
+                                             std::uint16_t  /*unused*/) const override;
+        void calculate(const ControlsInputInstance*  /*unused*/,
+                       JointsOutputInstance*  /*unused*/,
+                       std::uint16_t  /*unused*/,
+                       std::uint16_t  /*unused*/,
+                       std::uint16_t  /*unused*/) const override;
+        void calculate(ConstArrayView<const ControlsInputInstance*> inputs,
+                       ConstArrayView<JointsOutputInstance*> outputs,
+                       std::uint16_t lod) const override;
+        void calculateUngrouped(const ControlsInputInstance* inputs, JointsOutputInstance* outputs,
+                                std::uint16_t lod) const override;
+        std::uint16_t getUngroupedPartitionCount(std::uint16_t lod) const override;
+        void calculateUngrouped(const ControlsInputInstance* inputs,
+                                JointsOutputInstance* outputs,
+                                std::uint16_t lod,
+                                std::uint16_t partitionIndex) const override;
+        void collectJointGroupInputIndices(std::uint16_t  /*unused*/,
+                                           std::uint16_t  /*unused*/,
+                                           Vector<std::uint16_t>&  /*unused*/) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override;
 
     private:
-        Vector<TwistSwingSetup> setups;
+        static void calculateBlock(const TwistSwingBlocks& blocks,
+                                   std::size_t blockIndex,
+                                   ConstArrayView<float> inputBuffer,
+                                   ArrayView<float> outputBuffer);
+
+    private:
+        Vector<TwistSwingBlocks> lods;
         JointsOutputInstance::Factory instanceFactory;
 
 };
 
 template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
 TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::TwistSwingJointsEvaluator(
-    Vector<TwistSwingSetup>&& setups_,
+    Vector<TwistSwingBlocks>&& lods_,
     JointsOutputInstance::Factory instanceFactory_,
     MemoryResource*  /*unused*/) :
-    setups{std::move(setups_)},
+    lods{std::move(lods_)},
     instanceFactory{std::move(instanceFactory_)} {
 }
 
@@ -81,68 +144,97 @@ std::uint32_t TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAda
 }
 
 template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
-void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculate(const ControlsInputInstance* inputs,
-                                                                                        JointsOutputInstance* outputs,
-                                                                                        std::uint16_t  /*unused*/) const {
-    const auto inputBuffer = inputs->getInputBuffer();
-    auto outputBuffer = outputs->getOutputBuffer();
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculateBlock(const TwistSwingBlocks& blocks,
+                                                                                             std::size_t blockIndex,
+                                                                                             ConstArrayView<float> inputBuffer,
+                                                                                             ArrayView<float> outputBuffer) {
+    alignas(TFVec256::alignment()) float inputQuaternions[4ul][blockSize];
+    const std::uint16_t* inputIndices = blocks.inputIndices.data() + blockIndex * blockSize * 4ul;
+    for (std::size_t c = {}; c < 4ul; ++c) {
+        for (std::size_t lane = {}; lane < blockSize; ++lane) {
+            inputQuaternions[c][lane] = inputBuffer[inputIndices[c * blockSize + lane]];
+        }
+    }
+    const TFVec256 q[] = {
+        TFVec256::fromAlignedSource(inputQuaternions[0]),
+        TFVec256::fromAlignedSource(inputQuaternions[1]),
+        TFVec256::fromAlignedSource(inputQuaternions[2]),
+        TFVec256::fromAlignedSource(inputQuaternions[3])
+    };
 
-    const tdm::fquat identity;
+    // Normalized twist about the block's axis (identity for inputs without a twist component), which is
+    // inverted for swing setups (where it's a unit quaternion, so its inverse is just the conjugate)
+    const std::size_t axis = blocks.twistAxes[blockIndex];
+    const TFVec256 length2 = fmadd(q[axis], q[axis], q[3] * q[3]);
+    const TFVec256 hasTwist = (length2 != TFVec256{});
+    const TFVec256 rLength = (TFVec256{1.0f} / sqrt(length2)) & hasTwist;
+    const TFVec256 twistSigns = TFVec256::fromUnalignedSource(blocks.twistSigns.data() + blockIndex * blockSize);
+    TFVec256 twist[4] = {};
+    twist[axis] = q[axis] * rLength * twistSigns;
+    twist[3] = (q[3] * rLength) | andnot(hasTwist, TFVec256{1.0f});
 
-    static constexpr decltype(separateTwistComponentByAxisX) * separateTwistComponent[] = {
-        separateTwistComponentByAxisX,
-        separateTwistComponentByAxisY,
-        separateTwistComponentByAxisZ
+    TFVec256 swing[4];
+    twistswing::multiply(q, twist, swing);
+    const TFVec256 rSwingLength2 = TFVec256{1.0f} / (swing[0] * swing[0] + swing[1] * swing[1] + swing[2] * swing[2] +
+                                                     swing[3] * swing[3]);
+    const TFVec256 invSwing[] = {
+        TFVec256{} - swing[0] * rSwingLength2,
+        TFVec256{} - swing[1] * rSwingLength2,
+        TFVec256{} - swing[2] * rSwingLength2,
+        swing[3] * rSwingLength2
     };
 
-    for (const auto& setup : setups) {
-        tdm::fquat invTwist;
-
-        // A TwistSwingSetup instance will only have both twist and swing portions populated if both of them
-        // rely on the same input control indices. Otherwise either the swing or the twist portion will be populated only.
-        if (!setup.swingInputIndices.empty()) {
-            const tdm::fquat swingInput{inputBuffer[setup.swingInputIndices[0]],
-                                        inputBuffer[setup.swingInputIndices[1]],
-                                        inputBuffer[setup.swingInputIndices[2]],
-                                        inputBuffer[setup.swingInputIndices[3]]};
-            const tdm::fquat twist = separateTwistComponent[static_cast<std::size_t>(setup.swingTwistAxis)](swingInput);
-            invTwist = tdm::inverse(twist);
-            const tdm::fquat swing = swingInput * invTwist;
-            const tdm::fquat invSwing = tdm::inverse(swing);
-
-            for (std::size_t si = {}; si < setup.swingBlendWeights.size(); ++si) {
-                const float swingBlendWeight = setup.swingBlendWeights[si];
-                const tdm::fquat invSwingFraction = tdm::slerp(invSwing, identity, swingBlendWeight);
-                const tdm::fquat swingOutput = invTwist * invSwingFraction;
-                const std::uint16_t* outputIndices = &setup.swingOutputIndices[si * 4ul];
-                const float outbuf[] = {swingOutput.x, swingOutput.y, swingOutput.z, swingOutput.w};
-                TRotationAdapter::forward(outbuf, 1ul, 1ul, outputIndices, outputBuffer);
+    alignas(TFVec256::alignment()) float rotations[4ul][blockSize * 3ul];
+    for (std::size_t c = {}; c < 4ul; ++c) {
+        twist[c].alignedStore(rotations[c]);
+        invSwing[c].alignedStore(rotations[c] + blockSize);
+        TFVec256{c == 3ul ? 1.0f : 0.0f}.alignedStore(rotations[c] + blockSize * 2ul);
+    }
+
+    const std::uint32_t outputOffset = blocks.outputOffsets[blockIndex];
+    const std::uint32_t outputCount = blocks.outputCounts[blockIndex];
+    for (std::uint32_t chunkStart = {}; chunkStart < outputCount; chunkStart += static_cast<std::uint32_t>(blockSize)) {
+        const std::size_t offset = outputOffset + chunkStart;
+        alignas(TFVec256::alignment()) float sources[4ul][blockSize];
+        alignas(TFVec256::alignment()) float premultipliers[4ul][blockSize];
+        for (std::size_t lane = {}; lane < blockSize; ++lane) {
+            const std::uint8_t sourceLane = blocks.sourceLanes[offset + lane];
+            const std::uint8_t premultiplierLane = blocks.premultiplierLanes[offset + lane];
+            for (std::size_t c = {}; c < 4ul; ++c) {
+                sources[c][lane] = rotations[c][sourceLane];
+                premultipliers[c][lane] = rotations[c][premultiplierLane];
             }
         }
-
-        if (!setup.twistInputIndices.empty() && setup.swingInputIndices.empty()) {
-            // 1. When swing and twist input indices are the same, both twist and swing setups are merged
-            // into a single setup instance. In this case, twist needs no recalculation, since both
-            // twist and swing rely on the same input joint.
-            // 2. When swing and twist input indices are different, they will be on separate setup instances,
-            // in which case the swing portion will remain empty (when twist data exists), so this part needs
-            // to be executed. This is the "fromEnd" case calculation.
-            const tdm::fquat twistInput{inputBuffer[setup.twistInputIndices[0]],
-                                        inputBuffer[setup.twistInputIndices[1]],
-                                        inputBuffer[setup.twistInputIndices[2]],
-                                        inputBuffer[setup.twistInputIndices[3]]};
-            const tdm::fquat twist = separateTwistComponent[static_cast<std::size_t>(setup.twistTwistAxis)](twistInput);
-            invTwist = twist;  // No actual inversion is needed here
+        TFVec256 source[4];
+        TFVec256 premultiplier[4];
+        for (std::size_t c = {}; c < 4ul; ++c) {
+            source[c] = TFVec256::fromAlignedSource(sources[c]);
+            premultiplier[c] = TFVec256::fromAlignedSource(premultipliers[c]);
         }
+        const TFVec256 blendWeights = TFVec256::fromUnalignedSource(blocks.blendWeights.data() + offset);
+
+        TFVec256 fraction[4];
+        TFVec256 result[4];
+        twistswing::slerpToIdentity(source, blendWeights, fraction);
+        twistswing::multiply(premultiplier, fraction, result);
 
-        assert((setup.twistBlendWeights.size() * 4) == setup.twistOutputIndices.size());
-        for (std::size_t ti = {}; ti < setup.twistBlendWeights.size(); ++ti) {
-            const float twistBlendWeight = setup.twistBlendWeights[ti];
-            const tdm::fquat twistOutput = tdm::slerp(invTwist, identity, twistBlendWeight);
-            const float outbuf[] = {twistOutput.x, twistOutput.y, twistOutput.z, twistOutput.w};
-            const std::uint16_t* outputIndices = &setup.twistOutputIndices[ti * 4ul];
-            TRotationAdapter::forward(outbuf, 1ul, 1ul, outputIndices, outputBuffer);
+        alignas(TFVec256::alignment()) float outbuf[4ul][blockSize];
+        for (std::size_t c = {}; c < 4ul; ++c) {
+            result[c].alignedStore(outbuf[c]);
         }
+        const std::size_t remainingCount = outputCount - chunkStart;
+        const std::size_t count = (remainingCount < blockSize ? remainingCount : blockSize);
+        TRotationAdapter::forward(&outbuf[0][0], count, blockSize, &blocks.outputIndices[offset * 4ul], outputBuffer);
+    }
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculate(const ControlsInputInstance* inputs,
+                                                                                        JointsOutputInstance* outputs,
+                                                                                        std::uint16_t lod) const {
+    const std::uint16_t partitionCount = getUngroupedPartitionCount(lod);
+    for (std::uint16_t partitionIndex = {}; partitionIndex < partitionCount; ++partitionIndex) {
+        calculateUngrouped(inputs, outputs, lod, partitionIndex);
     }
 }
 
@@ -153,16 +245,97 @@ void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::ca
                                                                                         std::uint16_t  /*unused*/) const {
 }
 
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculateChanged(
+    const ControlsInputInstance*  /*unused*/,
+    ConstArrayView<float>  /*unused*/,
+    JointsOutputInstance*  /*unused*/,
+    std::uint16_t  /*unused*/,
+    std::uint16_t  /*unused*/) const {
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+std::uint16_t TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::getJointGroupSliceCount(
+    std::uint16_t  /*unused*/) const {
+    return {};
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+std::uint32_t TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::getJointGroupSliceCost(
+    std::uint16_t  /*unused*/,
+    std::uint16_t  /*unused*/,
+    std::uint16_t  /*unused*/) const {
+    return {};
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculate(const ControlsInputInstance*  /*unused*/,
+                                                                                        JointsOutputInstance*  /*unused*/,
+                                                                                        std::uint16_t  /*unused*/,
+                                                                                        std::uint16_t  /*unused*/,
+                                                                                        std::uint16_t  /*unused*/) const {
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculate(
+    ConstArrayView<const ControlsInputInstance*> inputs,
+    ConstArrayView<JointsOutputInstance*> outputs,
+    std::uint16_t lod) const {
+    assert(inputs.size() == outputs.size());
+    for (std::size_t i = {}; i < inputs.size(); ++i) {
+        calculate(inputs[i], outputs[i], lod);
+    }
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculateUngrouped(
+    const ControlsInputInstance* inputs,
+    JointsOutputInstance* outputs,
+    std::uint16_t lod) const {
+    calculate(inputs, outputs, lod);
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+std::uint16_t TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::getUngroupedPartitionCount(
+    std::uint16_t lod) const {
+    return (lod < lods.size() ? lods[lod].getPartitionCount() : static_cast<std::uint16_t>(0));
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::calculateUngrouped(
+    const ControlsInputInstance* inputs,
+    JointsOutputInstance* outputs,
+    std::uint16_t lod,
+    std::uint16_t partitionIndex) const {
+    assert(partitionIndex < getUngroupedPartitionCount(lod));
+    const auto& blocks = lods[lod];
+    const auto inputBuffer = inputs->getInputBuffer();
+    auto outputBuffer = outputs->getOutputBuffer();
+    const std::uint32_t blockEnd = blocks.partitionOffsets[partitionIndex + 1ul];
+    for (std::uint32_t blockIndex = blocks.partitionOffsets[partitionIndex]; blockIndex < blockEnd; ++blockIndex) {
+        calculateBlock(blocks, blockIndex, inputBuffer, outputBuffer);
+    }
+}
+
+template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
+void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::collectJointGroupInputIndices(
+    std::uint16_t  /*unused*/,
+    std::uint16_t  /*unused*/,
+    Vector<std::uint16_t>&  /*unused*/) const {
+}
+
 template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
 void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::load(
     terse::BinaryInputArchive<BoundedIOStream>& archive) {
-    archive(setups);
+    archive(lods);
 }
 
 template<typename TValue, typename TFVec256, typename TFVec128, class TRotationAdapter>
 void TwistSwingJointsEvaluator<TValue, TFVec256, TFVec128, TRotationAdapter>::save(
     terse::BinaryOutputArchive<BoundedIOStream>& archive) {
-    archive(setups);
+    archive(lods);
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
@@ -3,9 +3,12 @@
 #pragma once
 
 #include "riglogic/TypeDefs.h"
+#include "riglogic/system/simd/SIMD.h"
 
 namespace rl4 {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 struct TwistSwingSetup {
     dna::TwistAxis twistTwistAxis;
     Vector<float> twistBlendWeights;
@@ -41,4 +44,6 @@ struct TwistSwingSetup {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
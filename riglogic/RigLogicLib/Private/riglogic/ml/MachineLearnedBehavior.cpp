@@ -30,6 +30,18 @@ ConstArrayView<std::uint32_t> MachineLearnedBehavior::getNeuralNetworkIndicesFor
     return evaluator->getNeuralNetworkIndicesForLOD(lod);
 }
 
+float MachineLearnedBehavior::getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const {
+    return evaluator->getNeuralNetworkQuantizationError(neuralNetIndex);
+}
+
+ConstArrayView<std::uint16_t> MachineLearnedBehavior::getNeuralNetworkInputIndices(std::uint16_t neuralNetIndex) const {
+    return evaluator->getNeuralNetworkInputIndices(neuralNetIndex);
+}
+
+ConstArrayView<std::uint16_t> MachineLearnedBehavior::getNeuralNetworkOutputIndices(std::uint16_t neuralNetIndex) const {
+    return evaluator->getNeuralNetworkOutputIndices(neuralNetIndex);
+}
+
 void MachineLearnedBehavior::calculate(ControlsInputInstance* inputs,
                                        MachineLearnedBehaviorOutputInstance* intermediateOutputs,
                                        std::uint16_t lod) const {
@@ -43,6 +55,12 @@ void MachineLearnedBehavior::calculate(ControlsInputInstance* inputs,
     evaluator->calculate(inputs, intermediateOutputs, lod, neuralNetIndex);
 }
 
+void MachineLearnedBehavior::calculate(ConstArrayView<ControlsInputInstance*> inputs,
+                                       ConstArrayView<MachineLearnedBehaviorOutputInstance*> intermediateOutputs,
+                                       std::uint16_t lod) const {
+    evaluator->calculate(inputs, intermediateOutputs, lod);
+}
+
 std::uint16_t MachineLearnedBehavior::getMeshCount() const {
     return static_cast<std::uint16_t>(neuralNetworkIndicesPerMeshRegion.size());
 }
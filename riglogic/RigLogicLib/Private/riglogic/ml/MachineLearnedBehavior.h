@@ -25,12 +25,18 @@ class MachineLearnedBehavior {
 
         MachineLearnedBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const;
         ConstArrayView<std::uint32_t> getNeuralNetworkIndicesForLOD(std::uint16_t lod) const;
+        float getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const;
+        ConstArrayView<std::uint16_t> getNeuralNetworkInputIndices(std::uint16_t neuralNetIndex) const;
+        ConstArrayView<std::uint16_t> getNeuralNetworkOutputIndices(std::uint16_t neuralNetIndex) const;
         void calculate(ControlsInputInstance* inputs, MachineLearnedBehaviorOutputInstance* intermediateOutputs,
                        std::uint16_t lod) const;
         void calculate(ControlsInputInstance* inputs,
                        MachineLearnedBehaviorOutputInstance* intermediateOutputs,
                        std::uint16_t lod,
                        std::uint16_t neuralNetIndex) const;
+        void calculate(ConstArrayView<ControlsInputInstance*> inputs,
+                       ConstArrayView<MachineLearnedBehaviorOutputInstance*> intermediateOutputs,
+                       std::uint16_t lod) const;
 
         template<class Archive>
         void load(Archive& archive) {
@@ -19,6 +19,10 @@ class MachineLearnedBehaviorEvaluator {
     public:
         virtual MachineLearnedBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const = 0;
         virtual ConstArrayView<std::uint32_t> getNeuralNetworkIndicesForLOD(std::uint16_t lod) const = 0;
+        virtual float getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const = 0;
+        // Indices of the controls read and written by the given neural network
+        virtual ConstArrayView<std::uint16_t> getNeuralNetworkInputIndices(std::uint16_t neuralNetIndex) const = 0;
+        virtual ConstArrayView<std::uint16_t> getNeuralNetworkOutputIndices(std::uint16_t neuralNetIndex) const = 0;
         virtual void calculate(ControlsInputInstance* inputs,
                                MachineLearnedBehaviorOutputInstance* intermediateOutputs,
                                std::uint16_t lod) const = 0;
@@ -26,6 +30,10 @@ class MachineLearnedBehaviorEvaluator {
                                MachineLearnedBehaviorOutputInstance* intermediateOutputs,
                                std::uint16_t lod,
                                std::uint16_t neuralNetIndex) const = 0;
+        // Evaluates the same LOD for a batch of rig instances
+        virtual void calculate(ConstArrayView<ControlsInputInstance*> inputs,
+                               ConstArrayView<MachineLearnedBehaviorOutputInstance*> intermediateOutputs,
+                               std::uint16_t lod) const = 0;
         virtual void load(terse::BinaryInputArchive<BoundedIOStream>& archive) = 0;
         virtual void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) = 0;
 };
@@ -9,7 +9,7 @@
 #include "riglogic/ml/cpu/CPUMachineLearnedBehaviorFactory.h"
 #include "riglogic/riglogic/Configuration.h"
 #include "riglogic/riglogic/RigMetrics.h"
-#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/system/simd/Utils.h"
 
 #include <cstdint>
 
@@ -17,67 +17,64 @@ namespace rl4 {
 
 MachineLearnedBehaviorEvaluator::Pointer createMLEvaluator(const Configuration& config,
                                                            const dna::MachineLearnedBehaviorReader* reader,
+                                                           ConstArrayView<ConstArrayView<float> > calibrationInputs,
                                                            MemoryResource* memRes) {
-    auto features = trimd::getCPUFeatures();
+    const ActiveFeatures features = getActiveFeatures(config);
     RL_UNUSED(features);
-    RL_UNUSED(config);
-    #ifdef RL_BUILD_WITH_SSE
-        #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-            features.SSE2 = true;
-        #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-        if (features.SSE2 &&
-            ((config.calculationType == CalculationType::SSE) || (config.calculationType == CalculationType::AnyVector))) {
-            #ifdef RL_BUILD_WITH_HALF_FLOATS
-                #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                    features.F16C = true;
-                #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                if (features.F16C) {
-                    return ml::cpu::Factory<std::uint16_t, trimd::sse::F256, trimd::sse::F128>::create(reader, memRes);
-                }
-            #endif  // RL_BUILD_WITH_HALF_FLOATS
-            return ml::cpu::Factory<float, trimd::sse::F256, trimd::sse::F128>::create(reader, memRes);
+    #ifdef RL_BUILD_WITH_AVX512
+        if (features.calculationType == CalculationType::AVX512) {
+            return ml::cpu::createAVX512Evaluator(reader,
+                                                  features.floatingPointType,
+                                                  config.neuralNetworkWeightQuantization,
+                                                  config.activationFunctionAccuracy,
+                                                  calibrationInputs,
+                                                  memRes);
         }
-    #endif  // RL_BUILD_WITH_SSE
+    #endif  // RL_BUILD_WITH_AVX512
     #ifdef RL_BUILD_WITH_AVX
-        #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-            features.AVX = true;
-        #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-        if (features.AVX &&
-            ((config.calculationType == CalculationType::AVX) || (config.calculationType == CalculationType::AnyVector))) {
-            // Use 256-bit AVX registers and whatever 128-bit width type is available
-            #ifdef RL_BUILD_WITH_HALF_FLOATS
-                #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                    features.F16C = true;
-                #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                if (features.F16C) {
-                    return ml::cpu::Factory<std::uint16_t, trimd::avx::F256, trimd::sse::F128>::create(reader, memRes);
-                }
-            #endif  // RL_BUILD_WITH_HALF_FLOATS
-            return ml::cpu::Factory<float, trimd::avx::F256, trimd::sse::F128>::create(reader, memRes);
+        if (features.calculationType == CalculationType::AVX) {
+            return ml::cpu::createAVXEvaluator(reader,
+                                               features.floatingPointType,
+                                               config.neuralNetworkWeightQuantization,
+                                               config.activationFunctionAccuracy,
+                                               calibrationInputs,
+                                               memRes);
         }
     #endif  // RL_BUILD_WITH_AVX
+    #ifdef RL_BUILD_WITH_SSE
+        if (features.calculationType == CalculationType::SSE) {
+            return ml::cpu::createSSEEvaluator(reader,
+                                               features.floatingPointType,
+                                               config.neuralNetworkWeightQuantization,
+                                               config.activationFunctionAccuracy,
+                                               calibrationInputs,
+                                               memRes);
+        }
+    #endif  // RL_BUILD_WITH_SSE
     #ifdef RL_BUILD_WITH_NEON
-        #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-            features.NEON = true;
-        #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-        if (features.NEON &&
-            ((config.calculationType == CalculationType::NEON) || (config.calculationType == CalculationType::AnyVector))) {
+        // There are no NEON integer kernels, so weights are not quantized
+        if (features.calculationType == CalculationType::NEON) {
             #ifdef RL_BUILD_WITH_HALF_FLOATS
-                #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                    features.FP16 = true;
-                #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                if (features.FP16) {
-                    return ml::cpu::Factory<std::uint16_t, trimd::neon::F256, trimd::neon::F128>::create(reader, memRes);
+                if (features.floatingPointType == FloatingPointType::HalfFloat) {
+                    using Factory = ml::cpu::Factory<std::uint16_t, trimd::neon::F256, trimd::neon::F128>;
+                    return Factory::create(reader, config.activationFunctionAccuracy, calibrationInputs, memRes);
                 }
             #endif  // RL_BUILD_WITH_HALF_FLOATS
-            return ml::cpu::Factory<float, trimd::neon::F256, trimd::neon::F128>::create(reader, memRes);
+            using Factory = ml::cpu::Factory<float, trimd::neon::F256, trimd::neon::F128>;
+            return Factory::create(reader, config.activationFunctionAccuracy, calibrationInputs, memRes);
         }
     #endif  // RL_BUILD_WITH_NEON
-    return ml::cpu::Factory<float, trimd::scalar::F256, trimd::scalar::F128>::create(reader, memRes);
+    if (config.neuralNetworkWeightQuantization == WeightQuantization::Int8) {
+        using QuantizedFactory = ml::cpu::Factory<std::int8_t, trimd::scalar::F256, trimd::scalar::F128>;
+        return QuantizedFactory::create(reader, config.activationFunctionAccuracy, calibrationInputs, memRes);
+    }
+    using Factory = ml::cpu::Factory<float, trimd::scalar::F256, trimd::scalar::F128>;
+    return Factory::create(reader, config.activationFunctionAccuracy, calibrationInputs, memRes);
 }
 
 MachineLearnedBehavior::Pointer MachineLearnedBehaviorFactory::create(const Configuration& config,
                                                                       const dna::MachineLearnedBehaviorReader* reader,
+                                                                      ConstArrayView<ConstArrayView<float> > calibrationInputs,
                                                                       MemoryResource* memRes) {
     auto moduleFactory = UniqueInstance<MachineLearnedBehavior>::with(memRes);
     if (!config.loadMachineLearnedBehavior || (reader->getNeuralNetworkCount() == 0u)) {
@@ -96,7 +93,8 @@ MachineLearnedBehavior::Pointer MachineLearnedBehaviorFactory::create(const Conf
         }
     }
 
-    return moduleFactory.create(createMLEvaluator(config, reader, memRes), std::move(neuralNetworkIndicesPerMeshRegion));
+    return moduleFactory.create(createMLEvaluator(config, reader, calibrationInputs, memRes),
+                                std::move(neuralNetworkIndicesPerMeshRegion));
 }
 
 MachineLearnedBehavior::Pointer MachineLearnedBehaviorFactory::create(const Configuration& config,
@@ -108,7 +106,12 @@ MachineLearnedBehavior::Pointer MachineLearnedBehaviorFactory::create(const Conf
             UniqueInstance<MachineLearnedBehaviorNullEvaluator, MachineLearnedBehaviorEvaluator>::with(memRes).create();
         return moduleFactory.create(std::move(evaluator), memRes);
     }
-    return moduleFactory.create(createMLEvaluator(config, nullptr, memRes), memRes);
+    return moduleFactory.create(createMLEvaluator(config, nullptr, {}, memRes), memRes);
+}
+
+bool MachineLearnedBehaviorFactory::quantizesWeights(const Configuration& config, CalculationType calculationType) {
+    // There are no NEON integer kernels (see createMLEvaluator)
+    return (config.neuralNetworkWeightQuantization == WeightQuantization::Int8) && (calculationType != CalculationType::NEON);
 }
 
 }  // namespace rl4
@@ -4,17 +4,21 @@
 
 #include "riglogic/TypeDefs.h"
 #include "riglogic/ml/MachineLearnedBehavior.h"
+#include "riglogic/riglogic/Configuration.h"
 
 namespace rl4 {
 
-struct Configuration;
 struct RigMetrics;
 
 struct MachineLearnedBehaviorFactory {
+    // Calibration inputs are sample inputs per neural network, used only if weights are quantized
     static MachineLearnedBehavior::Pointer create(const Configuration& config,
                                                   const dna::MachineLearnedBehaviorReader* reader,
+                                                  ConstArrayView<ConstArrayView<float> > calibrationInputs,
                                                   MemoryResource* memRes);
     static MachineLearnedBehavior::Pointer create(const Configuration& config, const RigMetrics& metrics, MemoryResource* memRes);
+    // Whether the evaluator of the given (active) calculation type stores quantized weights
+    static bool quantizesWeights(const Configuration& config, CalculationType calculationType);
 
 };
 
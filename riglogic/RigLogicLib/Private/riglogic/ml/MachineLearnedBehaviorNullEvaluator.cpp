@@ -17,6 +17,20 @@ ConstArrayView<std::uint32_t> MachineLearnedBehaviorNullEvaluator::getNeuralNetw
     return {};
 }
 
+float MachineLearnedBehaviorNullEvaluator::getNeuralNetworkQuantizationError(std::uint16_t  /*unused*/) const {
+    return 0.0f;
+}
+
+ConstArrayView<std::uint16_t> MachineLearnedBehaviorNullEvaluator::getNeuralNetworkInputIndices(std::uint16_t  /*unused*/) const
+{
+    return {};
+}
+
+ConstArrayView<std::uint16_t> MachineLearnedBehaviorNullEvaluator::getNeuralNetworkOutputIndices(std::uint16_t  /*unused*/) const
+{
+    return {};
+}
+
 void MachineLearnedBehaviorNullEvaluator::calculate(ControlsInputInstance*  /*unused*/,
                                                     MachineLearnedBehaviorOutputInstance*  /*unused*/,
                                                     std::uint16_t  /*unused*/) const {
@@ -28,6 +42,11 @@ void MachineLearnedBehaviorNullEvaluator::calculate(ControlsInputInstance*  /*un
                                                     std::uint16_t  /*unused*/) const {
 }
 
+void MachineLearnedBehaviorNullEvaluator::calculate(ConstArrayView<ControlsInputInstance*>  /*unused*/,
+                                                    ConstArrayView<MachineLearnedBehaviorOutputInstance*>  /*unused*/,
+                                                    std::uint16_t  /*unused*/) const {
+}
+
 void MachineLearnedBehaviorNullEvaluator::load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) {
 }
 
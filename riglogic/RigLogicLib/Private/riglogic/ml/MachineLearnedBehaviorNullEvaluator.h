@@ -14,12 +14,18 @@ class MachineLearnedBehaviorNullEvaluator : public MachineLearnedBehaviorEvaluat
     public:
         MachineLearnedBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         ConstArrayView<std::uint32_t> getNeuralNetworkIndicesForLOD(std::uint16_t  /*unused*/) const override;
+        float getNeuralNetworkQuantizationError(std::uint16_t  /*unused*/) const override;
+        ConstArrayView<std::uint16_t> getNeuralNetworkInputIndices(std::uint16_t  /*unused*/) const override;
+        ConstArrayView<std::uint16_t> getNeuralNetworkOutputIndices(std::uint16_t  /*unused*/) const override;
         void calculate(ControlsInputInstance*  /*unused*/, MachineLearnedBehaviorOutputInstance*  /*unused*/,
                        std::uint16_t  /*unused*/) const override;
         void calculate(ControlsInputInstance*  /*unused*/,
                        MachineLearnedBehaviorOutputInstance*  /*unused*/,
                        std::uint16_t  /*unused*/,
                        std::uint16_t  /*unused*/) const override;
+        void calculate(ConstArrayView<ControlsInputInstance*>  /*unused*/,
+                       ConstArrayView<MachineLearnedBehaviorOutputInstance*>  /*unused*/,
+                       std::uint16_t  /*unused*/) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>&  /*unused*/) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>&  /*unused*/) override;
 
@@ -7,10 +7,19 @@
 #include "riglogic/ml/MachineLearnedBehaviorEvaluator.h"
 #include "riglogic/ml/cpu/CPUMachineLearnedBehaviorOutputInstance.h"
 #include "riglogic/ml/cpu/Inference.h"
+#include "riglogic/ml/cpu/LayerBuffers.h"
 #include "riglogic/ml/cpu/NeuralNet.h"
+#include "riglogic/ml/cpu/Quantization.h"
+#include "riglogic/riglogic/Configuration.h"
 #include "riglogic/types/LODSpec.h"
+#include "riglogic/types/StorageLayout.h"
+#include "riglogic/utils/Extd.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace rl4 {
 
@@ -18,10 +27,13 @@ namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T, typename TF256, typename TF128>
 class Evaluator : public MachineLearnedBehaviorEvaluator {
     public:
         using NeuralNetVectorType = Vector<NeuralNetInference<T, TF256, TF128> >;
+        static constexpr std::size_t instanceChunkSize = 4ul * NeuralNetInference<T, TF256, TF128>::maxBatchSize;
 
         struct Accessor;
         friend Accessor;
@@ -30,11 +42,15 @@ class Evaluator : public MachineLearnedBehaviorEvaluator {
         Evaluator(LODSpec<std::uint32_t>&& lods_,
                   NeuralNetVectorType&& neuralNets_,
                   Vector<std::uint32_t>&& maxLayerOutputCounts_,
-                  OutputInstance::Factory instanceFactory_) :
+                  Vector<float>&& quantizationErrors_,
+                  OutputInstance::Factory instanceFactory_,
+                  ActivationFunctionAccuracy activationFunctionAccuracy_) :
             lods{std::move(lods_)},
             neuralNets{std::move(neuralNets_)},
             maxLayerOutputCounts{std::move(maxLayerOutputCounts_)},
-            instanceFactory{instanceFactory_} {
+            quantizationErrors{std::move(quantizationErrors_)},
+            instanceFactory{instanceFactory_},
+            activationFunctionAccuracy{activationFunctionAccuracy_} {
         }
 
         MachineLearnedBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override {
@@ -46,20 +62,44 @@ class Evaluator : public MachineLearnedBehaviorEvaluator {
             return lods.indicesPerLOD[lod];
         }
 
+        float getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const override {
+            return (neuralNetIndex < quantizationErrors.size() ? quantizationErrors[neuralNetIndex] : 0.0f);
+        }
+
+        ConstArrayView<std::uint16_t> getNeuralNetworkInputIndices(std::uint16_t neuralNetIndex) const override {
+            assert(neuralNetIndex < neuralNets.size());
+            return ConstArrayView<std::uint16_t>{neuralNets[neuralNetIndex].neuralNet.inputIndices};
+        }
+
+        ConstArrayView<std::uint16_t> getNeuralNetworkOutputIndices(std::uint16_t neuralNetIndex) const override {
+            assert(neuralNetIndex < neuralNets.size());
+            return ConstArrayView<std::uint16_t>{neuralNets[neuralNetIndex].neuralNet.outputIndices};
+        }
+
         void calculate(ControlsInputInstance* inputs, MachineLearnedBehaviorOutputInstance* intermediateOutputs,
                        std::uint16_t lod) const override {
             assert(lod < lods.indicesPerLOD.size());
             const auto& netIndices = lods.indicesPerLOD[lod];
+            if (netIndices.size() == 0ul) {
+                return;
+            }
+            auto outputInstance = static_cast<OutputInstance*>(intermediateOutputs);
             const auto inputBuffer = inputs->getInputBuffer();
-            const auto masks = intermediateOutputs->getMaskBuffer();
+            const auto masks = outputInstance->getMaskBuffer();
+            // Networks are evaluated one after another, so they all share the layer buffers of the widest one
+            const std::uint32_t widestNeuralNetIndex = getWidestNeuralNetIndex(netIndices);
+            LayerBuffers layerBuffers{maxLayerOutputCounts[widestNeuralNetIndex],
+                                      outputInstance->getLayerBufferStorage(widestNeuralNetIndex)};
             for (const auto neuralNetIndex : netIndices) {
                 assert(neuralNetIndex < masks.size());
                 assert(neuralNetIndex < neuralNets.size());
                 const float weight = masks[neuralNetIndex];
-                auto layerBuffer1 = static_cast<OutputInstance*>(intermediateOutputs)->getOutputBuffer1(neuralNetIndex);
-                auto layerBuffer2 = static_cast<OutputInstance*>(intermediateOutputs)->getOutputBuffer2(neuralNetIndex);
                 // inputBuffer is also outputBuffer
-                neuralNets[neuralNetIndex].calculate(inputBuffer, layerBuffer1, layerBuffer2, inputBuffer, weight);
+                neuralNets[neuralNetIndex].calculate(inputBuffer,
+                                                     layerBuffers.getBuffer1(),
+                                                     layerBuffers.getBuffer2(),
+                                                     inputBuffer,
+                                                     weight);
             }
         }
 
@@ -70,32 +110,249 @@ class Evaluator : public MachineLearnedBehaviorEvaluator {
             assert(lod < lods.indicesPerLOD.size());
             static_cast<void>(lod);
 
-            const auto masks = intermediateOutputs->getMaskBuffer();
+            auto outputInstance = static_cast<OutputInstance*>(intermediateOutputs);
+            const auto masks = outputInstance->getMaskBuffer();
             assert(neuralNetIndex < masks.size());
             assert(neuralNetIndex < neuralNets.size());
             const float weight = masks[neuralNetIndex];
             auto inputBuffer = inputs->getInputBuffer();
-            auto layerBuffer1 = static_cast<OutputInstance*>(intermediateOutputs)->getOutputBuffer1(neuralNetIndex);
-            auto layerBuffer2 = static_cast<OutputInstance*>(intermediateOutputs)->getOutputBuffer2(neuralNetIndex);
+            // Networks of the same instance may be evaluated concurrently, so each uses its own layer buffers
+            LayerBuffers layerBuffers{maxLayerOutputCounts[neuralNetIndex],
+                                      outputInstance->getLayerBufferStorage(neuralNetIndex)};
             // inputBuffer is also outputBuffer
-            neuralNets[neuralNetIndex].calculate(inputBuffer, layerBuffer1, layerBuffer2, inputBuffer, weight);
+            neuralNets[neuralNetIndex].calculate(inputBuffer,
+                                                 layerBuffers.getBuffer1(),
+                                                 layerBuffers.getBuffer2(),
+                                                 inputBuffer,
+                                                 weight);
+        }
+
+        void calculate(ConstArrayView<ControlsInputInstance*> inputs,
+                       ConstArrayView<MachineLearnedBehaviorOutputInstance*> intermediateOutputs,
+                       std::uint16_t lod) const override {
+            assert(lod < lods.indicesPerLOD.size());
+            assert(inputs.size() == intermediateOutputs.size());
+            const auto& netIndices = lods.indicesPerLOD[lod];
+            // Instances are processed in chunks, so their buffers and weights can be gathered on the stack, and batches
+            // of each network are limited to as many layer outputs as the inline layer buffers can hold
+            ArrayView<float> ioBuffers[instanceChunkSize];
+            float weights[instanceChunkSize];
+            LayerBuffers layerBuffers{LayerBuffers::inlineCapacity, {}};
+            for (std::size_t chunkStart = {}; chunkStart < inputs.size(); chunkStart += instanceChunkSize) {
+                const std::size_t remaining = inputs.size() - chunkStart;
+                const std::size_t chunkSize = (remaining < instanceChunkSize ? remaining : instanceChunkSize);
+                for (std::size_t i = {}; i < chunkSize; ++i) {
+                    // inputBuffer is also outputBuffer
+                    ioBuffers[i] = inputs[chunkStart + i]->getInputBuffer();
+                }
+                for (const auto neuralNetIndex : netIndices) {
+                    assert(neuralNetIndex < neuralNets.size());
+                    const std::size_t batchCapacity = getBatchCapacity(neuralNetIndex);
+                    if (batchCapacity < 2ul) {
+                        for (std::size_t i = {}; i < chunkSize; ++i) {
+                            calculate(inputs[chunkStart + i], intermediateOutputs[chunkStart + i], lod,
+                                      static_cast<std::uint16_t>(neuralNetIndex));
+                        }
+                        continue;
+                    }
+                    for (std::size_t i = {}; i < chunkSize; ++i) {
+                        const auto masks = intermediateOutputs[chunkStart + i]->getMaskBuffer();
+                        assert(neuralNetIndex < masks.size());
+                        weights[i] = masks[neuralNetIndex];
+                    }
+                    neuralNets[neuralNetIndex].calculate(ArrayView<ArrayView<float> >{ioBuffers, chunkSize},
+                                                         ConstArrayView<float>{weights, chunkSize},
+                                                         layerBuffers.getBuffer1(),
+                                                         layerBuffers.getBuffer2(),
+                                                         batchCapacity);
+                }
+            }
         }
 
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override {
-            archive(lods, neuralNets, maxLayerOutputCounts);
+            StorageLayout dumpedLayout{};
+            archive(dumpedLayout, lods);
+            const bool converted = (dumpedLayout != getStorageLayout());
+            if (converted) {
+                loadConverted(archive, dumpedLayout, std::is_same<T, std::int8_t>{});
+            } else {
+                archive(neuralNets);
+            }
+            archive(maxLayerOutputCounts, quantizationErrors);
+            for (std::size_t i = 0ul; i < neuralNets.size(); ++i) {
+                if (converted) {
+                    // Layer outputs were re-padded, so the buffers they need may have changed as well
+                    const auto& neuralNet = neuralNets[i].neuralNet;
+                    maxLayerOutputCounts[i] = static_cast<std::uint32_t>(neuralNet.inputIndices.size());
+                    for (const auto& layer : neuralNet.layers) {
+                        maxLayerOutputCounts[i] = std::max(maxLayerOutputCounts[i], layer.weights.padded.rows);
+                    }
+                }
+                neuralNets[i].createLayerEvaluators(activationFunctionAccuracy);
+            }
         }
 
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override {
-            archive(lods, neuralNets, maxLayerOutputCounts);
+            StorageLayout layout = getStorageLayout();
+            archive(layout, lods, neuralNets, maxLayerOutputCounts, quantizationErrors);
+        }
+
+    private:
+        static StorageLayout getStorageLayout() {
+            return StorageLayout{static_cast<std::uint32_t>(TF256::size()),
+                                 static_cast<std::uint32_t>(TF128::size()),
+                                 1u,
+                                 StorageValueTypeOf<T>::value};
+        }
+
+        // Networks dumped by a variant of a different vector width (or floating point type) are re-arranged into the
+        // layout of this one. Quantized networks are only restored by variants which quantize as well (see
+        // RigLogic::restore), the value type of which does not depend on the floating point type.
+        void loadConverted(terse::BinaryInputArchive<BoundedIOStream>& archive,
+                           const StorageLayout& dumpedLayout,
+                           std::true_type  /*unused*/) {
+            assert(dumpedLayout.valueType == StorageValueType::Int8);
+            loadConverted<std::int8_t>(archive, dumpedLayout);
+        }
+
+        void loadConverted(terse::BinaryInputArchive<BoundedIOStream>& archive,
+                           const StorageLayout& dumpedLayout,
+                           std::false_type  /*unused*/) {
+            assert(dumpedLayout.valueType != StorageValueType::Int8);
+            if (dumpedLayout.valueType == StorageValueType::HalfFloat) {
+                loadConverted<std::uint16_t>(archive, dumpedLayout);
+            } else {
+                loadConverted<float>(archive, dumpedLayout);
+            }
+        }
+
+        template<typename TSource>
+        void loadConverted(terse::BinaryInputArchive<BoundedIOStream>& archive, const StorageLayout& dumpedLayout) {
+            auto memRes = neuralNets.get_allocator().getMemoryResource();
+            // Only the networks themselves are serialized for each inference object
+            Vector<NeuralNet<TSource> > dumped{memRes};
+            archive(dumped);
+
+            const StorageLayout layout = getStorageLayout();
+            neuralNets.clear();
+            neuralNets.reserve(dumped.size());
+            for (const auto& source : dumped) {
+                neuralNets.emplace_back(memRes);
+                auto& neuralNet = neuralNets.back().neuralNet;
+                neuralNet.inputIndices.assign(source.inputIndices.begin(), source.inputIndices.end());
+                neuralNet.outputIndices.assign(source.outputIndices.begin(), source.outputIndices.end());
+                neuralNet.layers.reserve(source.layers.size());
+                for (const auto& layer : source.layers) {
+                    neuralNet.layers.push_back(convertLayer(layer, dumpedLayout, layout, memRes));
+                }
+            }
+        }
+
+        template<typename TSource>
+        static NeuralNetLayer<T> convertLayer(const NeuralNetLayer<TSource>& source,
+                                              const StorageLayout& sourceLayout,
+                                              const StorageLayout& layout,
+                                              MemoryResource* memRes) {
+            NeuralNetLayer<T> layer{memRes};
+            const std::uint32_t rowCount = source.weights.original.rows;
+            layer.weights.original = source.weights.original;
+            layer.weights.padded = {extd::roundUp(rowCount, layout.padTo), source.weights.padded.cols};
+            layer.weights.rows = PaddedBlockView{rowCount, layer.weights.padded.rows, layout.blockHeight, layout.padTo};
+            layer.weights.cols = source.weights.cols;
+            layer.weights.values.resize(layer.weights.padded.size());
+            convertBlockedMatrix(layer.weights.values.data(),
+                                 layout,
+                                 source.weights.values.data(),
+                                 sourceLayout,
+                                 source.weights.original,
+                                 rowCount,
+                                 memRes);
+
+            // Biases are blocked as a single column, which leaves them in order, followed by padding
+            layer.biases.resize(layer.weights.padded.rows);
+            for (std::uint32_t row = {}; row < rowCount; ++row) {
+                layer.biases[row] = convertStoredValue(source.biases[row], static_cast<T*>(nullptr));
+            }
+
+            layer.activationFunction = source.activationFunction;
+            layer.activationFunctionParameters.assign(source.activationFunctionParameters.begin(),
+                                                      source.activationFunctionParameters.end());
+            return layer;
+        }
+
+        static NeuralNetLayer<std::int8_t> convertLayer(const NeuralNetLayer<std::int8_t>& source,
+                                                        const StorageLayout& sourceLayout,
+                                                        const StorageLayout& layout,
+                                                        MemoryResource* memRes) {
+            NeuralNetLayer<std::int8_t> layer{memRes};
+            const std::uint32_t rowCount = source.weights.original.rows;
+            const std::uint32_t paddedRowCount = extd::roundUp(rowCount, layout.padTo);
+            const std::uint32_t paddedColumnCount = source.weights.padded.cols;
+            layer.weights.original = source.weights.original;
+            layer.weights.padded = {paddedRowCount, paddedColumnCount};
+            layer.weights.rows = PaddedBlockView{rowCount, paddedRowCount, layout.blockHeight, layout.padTo};
+            layer.weights.cols = source.weights.cols;
+
+            Vector<std::int8_t> values{static_cast<std::size_t>(rowCount) * paddedColumnCount, {}, memRes};
+            forEachQuantizedWeight(source.weights, sourceLayout.blockHeight, sourceLayout.padTo,
+                                   [&](std::uint32_t offset, std::uint32_t row, std::uint32_t col) {
+                    if (row < rowCount) {
+                        values[row * paddedColumnCount + col] = source.weights.values[offset];
+                    }
+                });
+            layer.weights.values.resize(layer.weights.padded.size());
+            std::int8_t* block = layer.weights.values.data();
+            forEachQuantizedWeight(layer.weights, layout.blockHeight, layout.padTo,
+                                   [&](std::uint32_t offset, std::uint32_t row, std::uint32_t col) {
+                    block[offset] = (row < rowCount ? values[row * paddedColumnCount + col] : std::int8_t{});
+                });
+
+            // Padded rows keep the neutral quantization parameters they are computed with
+            layer.scales.resize(paddedRowCount);
+            layer.zeroPoints.resize(paddedRowCount);
+            layer.biases.resize(paddedRowCount);
+            std::fill(layer.scales.begin(), layer.scales.end(), 1.0f);
+            std::fill(layer.zeroPoints.begin(), layer.zeroPoints.end(), 0.0f);
+            std::copy_n(source.scales.begin(), rowCount, layer.scales.begin());
+            std::copy_n(source.zeroPoints.begin(), rowCount, layer.zeroPoints.begin());
+            std::copy_n(source.biases.begin(), rowCount, layer.biases.begin());
+
+            layer.activationFunction = source.activationFunction;
+            layer.activationFunctionParameters.assign(source.activationFunctionParameters.begin(),
+                                                      source.activationFunctionParameters.end());
+            return layer;
+        }
+
+        std::uint32_t getWidestNeuralNetIndex(ConstArrayView<std::uint32_t> netIndices) const {
+            assert(netIndices.size() != 0ul);
+            std::uint32_t widestNeuralNetIndex = netIndices[0];
+            for (const auto neuralNetIndex : netIndices) {
+                assert(neuralNetIndex < maxLayerOutputCounts.size());
+                if (maxLayerOutputCounts[neuralNetIndex] > maxLayerOutputCounts[widestNeuralNetIndex]) {
+                    widestNeuralNetIndex = neuralNetIndex;
+                }
+            }
+            return widestNeuralNetIndex;
+        }
+
+        std::size_t getBatchCapacity(std::uint32_t neuralNetIndex) const {
+            assert(neuralNetIndex < maxLayerOutputCounts.size());
+            const std::size_t maxBatchSize = NeuralNetInference<T, TF256, TF128>::maxBatchSize;
+            const std::size_t maxLayerOutputCount = std::max(maxLayerOutputCounts[neuralNetIndex], std::uint32_t{1u});
+            return std::min(maxBatchSize, LayerBuffers::inlineCapacity / maxLayerOutputCount);
         }
 
     private:
         LODSpec<std::uint32_t> lods;
         NeuralNetVectorType neuralNets;
         Vector<std::uint32_t> maxLayerOutputCounts;
+        Vector<float> quantizationErrors;
         OutputInstance::Factory instanceFactory;
+        ActivationFunctionAccuracy activationFunctionAccuracy;
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
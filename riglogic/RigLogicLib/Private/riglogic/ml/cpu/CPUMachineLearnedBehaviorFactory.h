@@ -8,23 +8,34 @@
 #include "riglogic/ml/cpu/CPUMachineLearnedBehaviorOutputInstance.h"
 #include "riglogic/ml/cpu/Inference.h"
 #include "riglogic/ml/cpu/NeuralNet.h"
+#include "riglogic/ml/cpu/Quantization.h"
+#include "riglogic/riglogic/Configuration.h"
 #include "riglogic/types/bpcm/Optimizer.h"
 #include "riglogic/types/LODSpec.h"
 #include "riglogic/utils/Extd.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
 namespace rl4 {
 
 namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T, typename TF256, typename TF128>
 class Factory {
     public:
         static MachineLearnedBehaviorEvaluator::Pointer create(const dna::MachineLearnedBehaviorReader* reader,
+                                                               ActivationFunctionAccuracy activationFunctionAccuracy,
+                                                               ConstArrayView<ConstArrayView<float> > calibrationInputs,
                                                                MemoryResource* memRes) {
             Vector<NeuralNetInference<T, TF256, TF128> > neuralNets{memRes};
             Vector<std::uint32_t> maxLayerOutputCountPerNet{memRes};
+            Vector<float> quantizationErrors{memRes};
             auto instanceFactory = [](ConstArrayView<std::uint32_t> maxLayerOutputCounts, MemoryResource* instanceMemRes) {
                     using OutputInstancePointer = UniqueInstance<OutputInstance, MachineLearnedBehaviorOutputInstance>;
                     return OutputInstancePointer::with(instanceMemRes).create(maxLayerOutputCounts, instanceMemRes);
@@ -35,35 +46,63 @@ class Factory {
                 return factory.create(LODSpec<std::uint32_t>{memRes},
                                       std::move(neuralNets),
                                       std::move(maxLayerOutputCountPerNet),
-                                      instanceFactory);
+                                      std::move(quantizationErrors),
+                                      instanceFactory,
+                                      activationFunctionAccuracy);
             }
 
             auto lods = computeLODs(reader, memRes);
             maxLayerOutputCountPerNet.resize(lods.count);
+            quantizationErrors.resize(lods.count);
             neuralNets.reserve(lods.count);
 
             for (std::uint16_t neuralNetIdx = {}; neuralNetIdx < lods.count; ++neuralNetIdx) {
                 const auto layerCount = reader->getNeuralNetworkLayerCount(neuralNetIdx);
                 if (layerCount != 0u) {
+                    // Quantized weights are calibrated on the given inputs of the network, if there are any, and
+                    // measured on them (or on pseudo-random inputs without them)
+                    Vector<float> samples{memRes};
+                    Vector<Vector<float> > layerInputs{memRes};
+                    if (std::is_same<T, std::int8_t>::value) {
+                        const auto inputCount = reader->getNeuralNetworkInputIndices(neuralNetIdx).size();
+                        const auto givenSamples =
+                            (neuralNetIdx < calibrationInputs.size() ? calibrationInputs[neuralNetIdx] : ConstArrayView<float>{});
+                        samples = getCalibrationSamples(givenSamples, inputCount, memRes);
+                        if ((inputCount != 0ul) && (givenSamples.size() >= inputCount)) {
+                            layerInputs = computeLayerInputs(reader, neuralNetIdx, ConstArrayView<float>{samples}, memRes);
+                        }
+                    }
                     auto net = createNeuralNet(reader,
                                                neuralNetIdx,
                                                layerCount,
+                                               layerInputs,
                                                &maxLayerOutputCountPerNet[neuralNetIdx],
                                                memRes);
-                    neuralNets.emplace_back(std::move(net), memRes);
+                    neuralNets.emplace_back(std::move(net), activationFunctionAccuracy, memRes);
+                    if (std::is_same<T, std::int8_t>::value) {
+                        quantizationErrors[neuralNetIdx] = measureNeuralNetError(reader,
+                                                                                 neuralNetIdx,
+                                                                                 neuralNets.back(),
+                                                                                 ConstArrayView<float>{samples},
+                                                                                 maxLayerOutputCountPerNet[neuralNetIdx],
+                                                                                 memRes);
+                    }
                 }
             }
 
             return factory.create(std::move(lods),
                                   std::move(neuralNets),
                                   std::move(maxLayerOutputCountPerNet),
-                                  instanceFactory);
+                                  std::move(quantizationErrors),
+                                  instanceFactory,
+                                  activationFunctionAccuracy);
         }
 
     private:
         static NeuralNet<T> createNeuralNet(const dna::MachineLearnedBehaviorReader* reader,
                                             std::uint16_t neuralNetIdx,
                                             std::uint16_t layerCount,
+                                            const Vector<Vector<float> >& layerInputs,
                                             std::uint32_t* maxLayerOutputCount,
                                             MemoryResource* memRes) {
             const auto inputIndices = reader->getNeuralNetworkInputIndices(neuralNetIdx);
@@ -80,13 +119,17 @@ class Factory {
                 const auto activationFunctionParams = reader->getNeuralNetworkLayerActivationFunctionParameters(neuralNetIdx,
                                                                                                                 layerIdx);
                 const auto outputCount = static_cast<std::uint32_t>(biases.size());
+                const auto layerCalibrationInputs =
+                    (layerIdx < layerInputs.size() ? ConstArrayView<float>{layerInputs[layerIdx]} : ConstArrayView<float>{});
                 const auto layer = createLayer(inputCount,
                                                outputCount,
                                                weights,
                                                biases,
                                                activationFunction,
                                                activationFunctionParams,
-                                               memRes);
+                                               layerCalibrationInputs,
+                                               memRes,
+                                               std::is_same<T, std::int8_t>{});
                 // Keep track of the layer with the largest number of outputs
                 // In the next layer, the current output count becomes the input count
                 * maxLayerOutputCount = std::max(*maxLayerOutputCount, layer.weights.padded.rows);
@@ -105,7 +148,9 @@ class Factory {
                                              ConstArrayView<float> biases,
                                              dna::ActivationFunction activationFunction,
                                              ConstArrayView<float> activationFunctionParams,
-                                             MemoryResource* memRes) {
+                                             ConstArrayView<float>  /*unused*/,
+                                             MemoryResource* memRes,
+                                             std::false_type  /*unused*/) {
             NeuralNetLayer<T> layer{memRes};
 
             layer.weights.original = {outputCount, inputCount};
@@ -139,6 +184,43 @@ class Factory {
             return layer;
         }
 
+        static NeuralNetLayer<T> createLayer(std::uint32_t inputCount,
+                                             std::uint32_t outputCount,
+                                             ConstArrayView<float> weights,
+                                             ConstArrayView<float> biases,
+                                             dna::ActivationFunction activationFunction,
+                                             ConstArrayView<float> activationFunctionParams,
+                                             ConstArrayView<float> calibrationInputs,
+                                             MemoryResource* memRes,
+                                             std::true_type  /*unused*/) {
+            NeuralNetLayer<T> layer{memRes};
+
+            layer.weights.original = {outputCount, inputCount};
+            const std::uint32_t padding =
+                extd::roundUp(layer.weights.original.rows,
+                              static_cast<std::uint32_t>(TF128::size())) - layer.weights.original.rows;
+            // Columns are consumed in pairs by the integer multiply-adds
+            layer.weights.padded = {layer.weights.original.rows + padding, extd::roundUp(inputCount, 2u)};
+            layer.weights.rows = PaddedBlockView{
+                layer.weights.original.rows,
+                layer.weights.padded.rows,
+                static_cast<std::uint32_t>(TF256::size()), static_cast<std::uint32_t>(TF128::size())
+            };
+            layer.weights.cols = PaddedBlockView{inputCount, inputCount, inputCount};
+            computeQuantizationParameters(weights, calibrationInputs, layer, memRes);
+            quantizeWeights(weights,
+                            static_cast<std::uint32_t>(TF256::size()),
+                            static_cast<std::uint32_t>(TF128::size()),
+                            layer);
+
+            layer.biases.resize(layer.weights.padded.rows);
+            std::copy(biases.begin(), biases.end(), layer.biases.begin());
+
+            layer.activationFunction = activationFunction;
+            layer.activationFunctionParameters.assign(activationFunctionParams.begin(), activationFunctionParams.end());
+            return layer;
+        }
+
         static LODSpec<std::uint32_t> computeLODs(const dna::MachineLearnedBehaviorReader* reader, MemoryResource* memRes) {
             LODSpec<std::uint32_t> lods{memRes};
             const auto lodCount = reader->getLODCount();
@@ -153,6 +235,30 @@ class Factory {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
+// Instruction set specific instantiations of the above, each defined in its own translation unit
+// (CPUMachineLearnedBehaviorFactory<ISA>.cpp), where they are compiled for that instruction set
+// (see system/simd/SIMD.h)
+MachineLearnedBehaviorEvaluator::Pointer createSSEEvaluator(const dna::MachineLearnedBehaviorReader* reader,
+                                                            FloatingPointType floatingPointType,
+                                                            WeightQuantization weightQuantization,
+                                                            ActivationFunctionAccuracy activationFunctionAccuracy,
+                                                            ConstArrayView<ConstArrayView<float> > calibrationInputs,
+                                                            MemoryResource* memRes);
+MachineLearnedBehaviorEvaluator::Pointer createAVXEvaluator(const dna::MachineLearnedBehaviorReader* reader,
+                                                            FloatingPointType floatingPointType,
+                                                            WeightQuantization weightQuantization,
+                                                            ActivationFunctionAccuracy activationFunctionAccuracy,
+                                                            ConstArrayView<ConstArrayView<float> > calibrationInputs,
+                                                            MemoryResource* memRes);
+MachineLearnedBehaviorEvaluator::Pointer createAVX512Evaluator(const dna::MachineLearnedBehaviorReader* reader,
+                                                               FloatingPointType floatingPointType,
+                                                               WeightQuantization weightQuantization,
+                                                               ActivationFunctionAccuracy activationFunctionAccuracy,
+                                                               ConstArrayView<ConstArrayView<float> > calibrationInputs,
+                                                               MemoryResource* memRes);
+
 }  // namespace cpu
 
 }  // namespace ml
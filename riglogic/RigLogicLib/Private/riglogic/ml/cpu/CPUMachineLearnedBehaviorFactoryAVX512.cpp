@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX512
+#include "trimd/Isolate.h"
+
+#include "riglogic/ml/cpu/CPUMachineLearnedBehaviorFactory.h"
+
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+namespace ml {
+
+namespace cpu {
+
+#ifdef RL_BUILD_WITH_AVX512
+// AVX-512 variant (AVX-512F)
+MachineLearnedBehaviorEvaluator::Pointer createAVX512Evaluator(const dna::MachineLearnedBehaviorReader* reader,
+                                                               FloatingPointType floatingPointType,
+                                                               WeightQuantization weightQuantization,
+                                                               ActivationFunctionAccuracy activationFunctionAccuracy,
+                                                               ConstArrayView<ConstArrayView<float> > calibrationInputs,
+                                                               MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    if (weightQuantization == WeightQuantization::Int8) {
+        // There are no 512-bit integer kernels, quantized layers are evaluated with the AVX2 ones
+        using ISAFactory = Factory<std::int8_t, trimd::avx::F256, trimd::sse::F128>;
+        return ISAFactory::create(reader, activationFunctionAccuracy, calibrationInputs, memRes);
+    }
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using ISAFactory = Factory<std::uint16_t, trimd::avx512::F512, trimd::avx::F256>;
+            return ISAFactory::create(reader, activationFunctionAccuracy, calibrationInputs, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using ISAFactory = Factory<float, trimd::avx512::F512, trimd::avx::F256>;
+    return ISAFactory::create(reader, activationFunctionAccuracy, calibrationInputs, memRes);
+}
+#endif  // RL_BUILD_WITH_AVX512
+
+}  // namespace cpu
+
+}  // namespace ml
+
+}  // namespace rl4
@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/ml/cpu/CPUMachineLearnedBehaviorFactory.h"
+
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+namespace ml {
+
+namespace cpu {
+
+#ifdef RL_BUILD_WITH_SSE
+// SSE variant (SSE2, and F16C for half floats)
+MachineLearnedBehaviorEvaluator::Pointer createSSEEvaluator(const dna::MachineLearnedBehaviorReader* reader,
+                                                            FloatingPointType floatingPointType,
+                                                            WeightQuantization weightQuantization,
+                                                            ActivationFunctionAccuracy activationFunctionAccuracy,
+                                                            ConstArrayView<ConstArrayView<float> > calibrationInputs,
+                                                            MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    if (weightQuantization == WeightQuantization::Int8) {
+        using ISAFactory = Factory<std::int8_t, trimd::sse::F256, trimd::sse::F128>;
+        return ISAFactory::create(reader, activationFunctionAccuracy, calibrationInputs, memRes);
+    }
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using ISAFactory = Factory<std::uint16_t, trimd::sse::F256, trimd::sse::F128>;
+            return ISAFactory::create(reader, activationFunctionAccuracy, calibrationInputs, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using ISAFactory = Factory<float, trimd::sse::F256, trimd::sse::F128>;
+    return ISAFactory::create(reader, activationFunctionAccuracy, calibrationInputs, memRes);
+}
+#endif  // RL_BUILD_WITH_SSE
+
+}  // namespace cpu
+
+}  // namespace ml
+
+}  // namespace rl4
@@ -2,7 +2,10 @@
 
 #include "riglogic/ml/cpu/CPUMachineLearnedBehaviorOutputInstance.h"
 
+#include "riglogic/ml/cpu/LayerBuffers.h"
+
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 namespace rl4 {
@@ -12,26 +15,18 @@ namespace ml {
 namespace cpu {
 
 OutputInstance::OutputInstance(ConstArrayView<std::uint32_t> maxLayerOutputCounts, MemoryResource* memRes) :
-    outputBuffer1{memRes},
-    outputBuffer2{memRes},
+    layerBufferStorage{memRes},
     maskBuffer{maxLayerOutputCounts.size(), 1.0f, memRes} {
 
-    outputBuffer1.resize(maxLayerOutputCounts.size());
-    outputBuffer2.resize(maxLayerOutputCounts.size());
+    layerBufferStorage.resize(maxLayerOutputCounts.size());
     for (std::size_t neuralNetIdx = 0ul; neuralNetIdx < maxLayerOutputCounts.size(); ++neuralNetIdx) {
-        outputBuffer1[neuralNetIdx].resize(maxLayerOutputCounts[neuralNetIdx]);
-        outputBuffer2[neuralNetIdx].resize(maxLayerOutputCounts[neuralNetIdx]);
+        layerBufferStorage[neuralNetIdx].resize(LayerBuffers::getStorageSize(maxLayerOutputCounts[neuralNetIdx]));
     }
 }
 
-ArrayView<float> OutputInstance::getOutputBuffer1(std::uint32_t neuralNetIndex) {
-    assert(neuralNetIndex < outputBuffer1.size());
-    return ArrayView<float>{outputBuffer1[neuralNetIndex]};
-}
-
-ArrayView<float> OutputInstance::getOutputBuffer2(std::uint32_t neuralNetIndex) {
-    assert(neuralNetIndex < outputBuffer2.size());
-    return ArrayView<float>{outputBuffer2[neuralNetIndex]};
+ArrayView<float> OutputInstance::getLayerBufferStorage(std::uint32_t neuralNetIndex) {
+    assert(neuralNetIndex < layerBufferStorage.size());
+    return ArrayView<float>{layerBufferStorage[neuralNetIndex]};
 }
 
 ArrayView<float> OutputInstance::getMaskBuffer() {
@@ -9,6 +9,8 @@
     #pragma warning(push)
     #pragma warning(disable : 4365 4987)
 #endif
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #ifdef _MSC_VER
     #pragma warning(pop)
@@ -25,15 +27,14 @@ class OutputInstance : public MachineLearnedBehaviorOutputInstance {
         using Factory = std::function<Pointer(ConstArrayView<std::uint32_t>, MemoryResource*)>;
 
     public:
+        // Layer outputs are kept per instance only for networks too wide for LayerBuffers to keep inline
         OutputInstance(ConstArrayView<std::uint32_t> maxLayerOutputCounts, MemoryResource* memRes);
-        ArrayView<float> getOutputBuffer1(std::uint32_t neuralNetIndex);
-        ArrayView<float> getOutputBuffer2(std::uint32_t neuralNetIndex);
+        ArrayView<float> getLayerBufferStorage(std::uint32_t neuralNetIndex);
         ArrayView<float> getMaskBuffer() override;
         ConstArrayView<float> getMaskBuffer() const override;
 
     private:
-        Vector<AlignedVector<float> > outputBuffer1;
-        Vector<AlignedVector<float> > outputBuffer2;
+        Vector<AlignedVector<float> > layerBufferStorage;
         Vector<float> maskBuffer;
 
 };
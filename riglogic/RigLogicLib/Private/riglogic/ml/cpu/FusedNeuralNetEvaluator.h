@@ -0,0 +1,166 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/ml/cpu/NeuralNet.h"
+#include "riglogic/ml/cpu/layers/LayerEvaluator.h"
+#include "riglogic/ml/cpu/layers/LeakyReLULayerEvaluator.h"
+#include "riglogic/ml/cpu/layers/LinearLayerEvaluator.h"
+#include "riglogic/ml/cpu/layers/ReLULayerEvaluator.h"
+#include "riglogic/ml/cpu/layers/SigmoidLayerEvaluator.h"
+#include "riglogic/ml/cpu/layers/TanHLayerEvaluator.h"
+#include "riglogic/riglogic/Configuration.h"
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace rl4 {
+
+namespace ml {
+
+namespace cpu {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+template<typename T>
+class NeuralNetEvaluator {
+    public:
+        using Pointer = typename UniqueInstance<NeuralNetEvaluator>::PointerType;
+
+    public:
+        virtual ~NeuralNetEvaluator() = default;
+
+        // Evaluates all layers of the network, reading its inputs from inputBuffer, and writing its outputs
+        // (multiplied by weight) into outputBuffer (which may be the same buffer)
+        virtual void calculate(const NeuralNet<T>& neuralNet,
+                               ConstArrayView<float> inputBuffer,
+                               ArrayView<float> outputBuffer,
+                               float weight) const = 0;
+};
+
+/*
+ * Evaluates small networks without going through a layer evaluator per layer
+ *
+ * The activation functions of hidden layers and of the output layer are compile-time
+ * parameters, so all layers are evaluated by inlined kernels, and the outputs of each
+ * layer are passed on to the next one through two tiles on the stack, which stay in
+ * the L1 cache.
+ */
+template<typename T, typename TF256, typename TF128, template<class ...> class THiddenActivationFunction,
+         template<class ...> class TOutputActivationFunction>
+class FusedNeuralNetEvaluator : public NeuralNetEvaluator<T> {
+    public:
+        static constexpr std::size_t maxLayerCount = 4ul;
+        // Both the inputs and the (padded) outputs of each layer must fit into a tile
+        static constexpr std::size_t maxLayerWidth = 256ul;
+
+    public:
+        void calculate(const NeuralNet<T>& neuralNet,
+                       ConstArrayView<float> inputBuffer,
+                       ArrayView<float> outputBuffer,
+                       float weight) const override {
+            assert(!neuralNet.layers.empty());
+            assert(neuralNet.layers.size() <= maxLayerCount);
+            assert(neuralNet.inputIndices.size() <= maxLayerWidth);
+
+            alignas(cacheLineAlignment) float tile1[maxLayerWidth];
+            alignas(cacheLineAlignment) float tile2[maxLayerWidth];
+            ArrayView<float> layerInputs{tile1, maxLayerWidth};
+            ArrayView<float> layerOutputs{tile2, maxLayerWidth};
+
+            for (std::size_t i = 0ul; i < neuralNet.inputIndices.size(); ++i) {
+                layerInputs[i] = inputBuffer[neuralNet.inputIndices[i]];
+            }
+
+            const std::size_t hiddenLayerCount = neuralNet.layers.size() - 1ul;
+            for (std::size_t layerIndex = 0ul; layerIndex < hiddenLayerCount; ++layerIndex) {
+                assert(neuralNet.layers[layerIndex].weights.padded.rows <= maxLayerWidth);
+                calculateBlock4<TF256, TF128, THiddenActivationFunction>(neuralNet.layers[layerIndex], layerInputs, layerOutputs);
+                std::swap(layerInputs, layerOutputs);
+            }
+            assert(neuralNet.layers[hiddenLayerCount].weights.padded.rows <= maxLayerWidth);
+            calculateBlock4<TF256, TF128, TOutputActivationFunction>(neuralNet.layers[hiddenLayerCount], layerInputs, layerOutputs);
+
+            for (std::size_t i = 0ul; i < neuralNet.outputIndices.size(); ++i) {
+                outputBuffer[neuralNet.outputIndices[i]] = layerOutputs[i] * weight;
+            }
+        }
+
+};
+
+template<typename T, typename TF256, typename TF128>
+struct FusedNeuralNetEvaluatorFactory {
+
+    // Returns nullptr for networks that are not supported by the fused evaluator, which are networks with more than
+    // maxLayerCount layers, or wider than maxLayerWidth, or whose hidden layers do not share the same activation function,
+    // or whose output layer has an activation function other than linear or the one of the hidden layers
+    static typename NeuralNetEvaluator<T>::Pointer create(const NeuralNet<T>& neuralNet,
+                                                          ActivationFunctionAccuracy accuracy,
+                                                          MemoryResource* memRes) {
+        using Limits = FusedNeuralNetEvaluator<T, TF256, TF128, LinearActivationFunction, LinearActivationFunction>;
+        const auto& layers = neuralNet.layers;
+        if (layers.empty() || (layers.size() > Limits::maxLayerCount) ||
+            (neuralNet.inputIndices.size() > Limits::maxLayerWidth)) {
+            return nullptr;
+        }
+        for (const auto& layer : layers) {
+            if (layer.weights.padded.rows > Limits::maxLayerWidth) {
+                return nullptr;
+            }
+        }
+
+        const auto outputActivationFunction = layers.back().activationFunction;
+        const auto hiddenActivationFunction = (layers.size() == 1ul ? outputActivationFunction : layers[0].activationFunction);
+        for (std::size_t layerIndex = 1ul; layerIndex + 1ul < layers.size(); ++layerIndex) {
+            if (layers[layerIndex].activationFunction != hiddenActivationFunction) {
+                return nullptr;
+            }
+        }
+        if ((outputActivationFunction != hiddenActivationFunction) &&
+            (outputActivationFunction != dna::ActivationFunction::linear)) {
+            return nullptr;
+        }
+        const bool linearOutput = (outputActivationFunction == dna::ActivationFunction::linear);
+
+        switch (hiddenActivationFunction) {
+            case dna::ActivationFunction::linear:
+                return create<LinearActivationFunction>(linearOutput, memRes);
+            case dna::ActivationFunction::relu:
+                return create<ReLUActivationFunction>(linearOutput, memRes);
+            case dna::ActivationFunction::leakyrelu:
+                return create<LeakyReLUActivationFunction>(linearOutput, memRes);
+            case dna::ActivationFunction::tanh:
+                if (accuracy == ActivationFunctionAccuracy::Fast) {
+                    return create<FastTanHActivationFunction>(linearOutput, memRes);
+                }
+                return create<TanHActivationFunction>(linearOutput, memRes);
+            case dna::ActivationFunction::sigmoid:
+                if (accuracy == ActivationFunctionAccuracy::Fast) {
+                    return create<FastSigmoidActivationFunction>(linearOutput, memRes);
+                }
+                return create<SigmoidActivationFunction>(linearOutput, memRes);
+        }
+        return nullptr;
+    }
+
+    template<template<class ...> class THiddenActivationFunction>
+    static typename NeuralNetEvaluator<T>::Pointer create(bool linearOutput, MemoryResource* memRes) {
+        if (linearOutput) {
+            using Evaluator = FusedNeuralNetEvaluator<T, TF256, TF128, THiddenActivationFunction, LinearActivationFunction>;
+            return UniqueInstance<Evaluator, NeuralNetEvaluator<T> >::with(memRes).create();
+        }
+        using Evaluator = FusedNeuralNetEvaluator<T, TF256, TF128, THiddenActivationFunction, THiddenActivationFunction>;
+        return UniqueInstance<Evaluator, NeuralNetEvaluator<T> >::with(memRes).create();
+    }
+
+};
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace cpu
+
+}  // namespace ml
+
+}  // namespace rl4
@@ -3,12 +3,17 @@
 #pragma once
 
 #include "riglogic/TypeDefs.h"
+#include "riglogic/ml/cpu/FusedNeuralNetEvaluator.h"
 #include "riglogic/ml/cpu/NeuralNet.h"
 #include "riglogic/ml/cpu/layers/LeakyReLULayerEvaluator.h"
 #include "riglogic/ml/cpu/layers/LinearLayerEvaluator.h"
 #include "riglogic/ml/cpu/layers/ReLULayerEvaluator.h"
 #include "riglogic/ml/cpu/layers/SigmoidLayerEvaluator.h"
 #include "riglogic/ml/cpu/layers/TanHLayerEvaluator.h"
+#include "riglogic/riglogic/Configuration.h"
+
+#include <cassert>
+#include <cstddef>
 
 namespace rl4 {
 
@@ -16,10 +21,14 @@ namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T, typename TF256, typename TF128>
 struct LayerEvaluatorFactory {
 
-    static typename LayerEvaluator<T>::Pointer create(dna::ActivationFunction activationFunction, MemoryResource* memRes) {
+    static typename LayerEvaluator<T>::Pointer create(dna::ActivationFunction activationFunction,
+                                                      ActivationFunctionAccuracy accuracy,
+                                                      MemoryResource* memRes) {
         switch (activationFunction) {
             case dna::ActivationFunction::linear:
                 return UniqueInstance<LinearLayerEvaluator<T, TF256, TF128>, LayerEvaluator<T> >::with(memRes).create();
@@ -28,8 +37,16 @@ struct LayerEvaluatorFactory {
             case dna::ActivationFunction::leakyrelu:
                 return UniqueInstance<LeakyReLULayerEvaluator<T, TF256, TF128>, LayerEvaluator<T> >::with(memRes).create();
             case dna::ActivationFunction::tanh:
+                if (accuracy == ActivationFunctionAccuracy::Fast) {
+                    using FastTanHLayerEvaluator = TanHLayerEvaluator<T, TF256, TF128, FastTanHActivationFunction>;
+                    return UniqueInstance<FastTanHLayerEvaluator, LayerEvaluator<T> >::with(memRes).create();
+                }
                 return UniqueInstance<TanHLayerEvaluator<T, TF256, TF128>, LayerEvaluator<T> >::with(memRes).create();
             case dna::ActivationFunction::sigmoid:
+                if (accuracy == ActivationFunctionAccuracy::Fast) {
+                    using FastSigmoidLayerEvaluator = SigmoidLayerEvaluator<T, TF256, TF128, FastSigmoidActivationFunction>;
+                    return UniqueInstance<FastSigmoidLayerEvaluator, LayerEvaluator<T> >::with(memRes).create();
+                }
                 return UniqueInstance<SigmoidLayerEvaluator<T, TF256, TF128>, LayerEvaluator<T> >::with(memRes).create();
         }
         return nullptr;
@@ -39,15 +56,23 @@ struct LayerEvaluatorFactory {
 
 template<typename T, typename TF256, typename TF128>
 struct NeuralNetInference {
+    // Upper bound on the number of input vectors evaluated at once, so that the layer buffers of a batch of networks
+    // with 256-wide hidden layers (16 KiB each) stay in the L1 / L2 caches
+    static constexpr std::size_t maxBatchSize = 16ul;
+
     NeuralNet<T> neuralNet;
     Vector<typename LayerEvaluator<T>::Pointer> layerEvaluators;
+    // Evaluates single input vectors of small networks, if the network is supported by it
+    typename NeuralNetEvaluator<T>::Pointer fusedEvaluator;
 
-    explicit NeuralNetInference(MemoryResource* memRes) : neuralNet{memRes}, layerEvaluators{memRes} {
+    explicit NeuralNetInference(MemoryResource* memRes) : neuralNet{memRes}, layerEvaluators{memRes}, fusedEvaluator{} {
     }
 
-    NeuralNetInference(NeuralNet<T>&& neuralNet_, MemoryResource* memRes) : neuralNet{std::move(neuralNet_)},
-        layerEvaluators{memRes} {
-        createLayerEvaluators();
+    NeuralNetInference(NeuralNet<T>&& neuralNet_, ActivationFunctionAccuracy accuracy, MemoryResource* memRes) :
+        neuralNet{std::move(neuralNet_)},
+        layerEvaluators{memRes},
+        fusedEvaluator{} {
+        createLayerEvaluators(accuracy);
     }
 
     void calculate(ConstArrayView<float> inputBuffer, ArrayView<float> layerBuffer1, ArrayView<float> layerBuffer2,
@@ -66,6 +91,11 @@ struct NeuralNetInference {
             return;
         }
 
+        if (fusedEvaluator != nullptr) {
+            fusedEvaluator->calculate(neuralNet, inputBuffer, outputBuffer, weight);
+            return;
+        }
+
         for (std::size_t i = 0ul; i < neuralNet.inputIndices.size(); ++i) {
             layerBuffer1[i] = inputBuffer[neuralNet.inputIndices[i]];
         }
@@ -80,10 +110,74 @@ struct NeuralNetInference {
         }
     }
 
+    // Evaluates the network for many input vectors (e.g. of different rig instances), each read from and written into its
+    // own buffer (the same way as above), with their respective weights. Input vectors with non-zero weights are evaluated
+    // in batches of up to batchCapacity (at most maxBatchSize) vectors, so the weights of each layer are loaded only once
+    // for the whole batch. Layer buffers must be able to hold batchCapacity layer outputs.
+    void calculate(ArrayView<ArrayView<float> > ioBuffers, ConstArrayView<float> weights, ArrayView<float> layerBuffer1,
+                   ArrayView<float> layerBuffer2, std::size_t batchCapacity) const {
+        assert(ioBuffers.size() == weights.size());
+        assert((batchCapacity != 0ul) && (batchCapacity <= maxBatchSize));
+        std::size_t batchIndices[maxBatchSize];
+        std::size_t batchSize = {};
+        for (std::size_t i = 0ul; i < ioBuffers.size(); ++i) {
+            if (weights[i] == 0.0f) {
+                for (std::size_t j = 0ul; j < neuralNet.outputIndices.size(); ++j) {
+                    ioBuffers[i][neuralNet.outputIndices[j]] = 0.0f;
+                }
+                continue;
+            }
+            batchIndices[batchSize] = i;
+            if (++batchSize == batchCapacity) {
+                calculateBatch(ioBuffers, weights, ConstArrayView<std::size_t>{batchIndices, batchSize}, layerBuffer1,
+                               layerBuffer2);
+                batchSize = 0ul;
+            }
+        }
+        if (batchSize == 1ul) {
+            // A batch of one is laid out the same as a single input vector, which has its own (faster) kernels
+            const std::size_t i = batchIndices[0];
+            calculate(ioBuffers[i], layerBuffer1, layerBuffer2, ioBuffers[i], weights[i]);
+        } else if (batchSize != 0ul) {
+            calculateBatch(ioBuffers, weights, ConstArrayView<std::size_t>{batchIndices, batchSize}, layerBuffer1, layerBuffer2);
+        }
+    }
+
+    void calculateBatch(ArrayView<ArrayView<float> > ioBuffers, ConstArrayView<float> weights,
+                        ConstArrayView<std::size_t> batchIndices, ArrayView<float> layerBuffer1,
+                        ArrayView<float> layerBuffer2) const {
+        assert(batchIndices.size() <= maxBatchSize);
+        assert(layerEvaluators.size() == neuralNet.layers.size());
+        const std::size_t batchStride = batchIndices.size();
+        assert(neuralNet.inputIndices.size() * batchStride <= layerBuffer1.size());
+        assert(neuralNet.outputIndices.size() * batchStride <= layerBuffer1.size());
+
+        // Inputs of all batched vectors are laid out adjacently for each network input
+        for (std::size_t i = 0ul; i < neuralNet.inputIndices.size(); ++i) {
+            float* batchInputs = layerBuffer1.data() + i * batchStride;
+            for (std::size_t bi = 0ul; bi < batchIndices.size(); ++bi) {
+                batchInputs[bi] = ioBuffers[batchIndices[bi]][neuralNet.inputIndices[i]];
+            }
+        }
+
+        for (std::size_t layerIndex = 0u; layerIndex < neuralNet.layers.size(); ++layerIndex) {
+            layerEvaluators[layerIndex]->calculate(neuralNet.layers[layerIndex], layerBuffer1, layerBuffer2, batchStride);
+            std::swap(layerBuffer1, layerBuffer2);
+        }
+
+        for (std::size_t i = 0ul; i < neuralNet.outputIndices.size(); ++i) {
+            const float* batchOutputs = layerBuffer1.data() + i * batchStride;
+            for (std::size_t bi = 0ul; bi < batchIndices.size(); ++bi) {
+                const std::size_t vi = batchIndices[bi];
+                ioBuffers[vi][neuralNet.outputIndices[i]] = batchOutputs[bi] * weights[vi];
+            }
+        }
+    }
+
+    // Layer evaluators are not serialized, the owner recreates them (with the configured accuracy) after loading
     template<class Archive>
     void load(Archive& archive) {
         archive(neuralNet);
-        createLayerEvaluators();
     }
 
     template<class Archive>
@@ -91,18 +185,22 @@ struct NeuralNetInference {
         archive(neuralNet);
     }
 
-    void createLayerEvaluators() {
+    void createLayerEvaluators(ActivationFunctionAccuracy accuracy) {
         layerEvaluators.resize(neuralNet.layers.size());
         auto memRes = layerEvaluators.get_allocator().getMemoryResource();
         for (std::size_t layerIndex = 0ul; layerIndex < neuralNet.layers.size(); ++layerIndex) {
             layerEvaluators[layerIndex] = LayerEvaluatorFactory<T, TF256, TF128>::create(
                 neuralNet.layers[layerIndex].activationFunction,
+                accuracy,
                 memRes);
         }
+        fusedEvaluator = FusedNeuralNetEvaluatorFactory<T, TF256, TF128>::create(neuralNet, accuracy, memRes);
     }
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
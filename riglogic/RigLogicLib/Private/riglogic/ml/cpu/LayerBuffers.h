@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+
+#include <cassert>
+#include <cstddef>
+
+namespace rl4 {
+
+namespace ml {
+
+namespace cpu {
+
+/*
+ * Scratch space for the outputs of two consecutive layers, shared by all networks evaluated in one call
+ *
+ * Pairs of up to inlineCapacity floats are kept inline, on the stack of the thread evaluating the networks, so rig
+ * instances need not keep layer outputs of their own, and networks evaluated concurrently (by the executor or by the
+ * caller's threads) never share them. Wider pairs are placed into storage of getStorageSize floats, which the output
+ * instances reserve up front for each network that needs it, so evaluation itself never allocates.
+ */
+class LayerBuffers {
+    public:
+        static constexpr std::size_t inlineCapacity = 1024ul;
+
+    public:
+        static std::size_t getStorageSize(std::size_t size) {
+            return (size > inlineCapacity ? getStride(size) * 2ul : 0ul);
+        }
+
+        LayerBuffers(std::size_t size_, ArrayView<float> storage) :
+            size{size_},
+            stride{inlineCapacity},
+            data{inlineBuffer} {
+            if (size > inlineCapacity) {
+                assert(storage.size() >= getStorageSize(size));
+                stride = getStride(size);
+                data = storage.data();
+            }
+        }
+
+        LayerBuffers(const LayerBuffers&) = delete;
+        LayerBuffers& operator=(const LayerBuffers&) = delete;
+
+        LayerBuffers(LayerBuffers&&) = delete;
+        LayerBuffers& operator=(LayerBuffers&&) = delete;
+
+        ArrayView<float> getBuffer1() {
+            return ArrayView<float>{data, size};
+        }
+
+        ArrayView<float> getBuffer2() {
+            return ArrayView<float>{data + stride, size};
+        }
+
+    private:
+        // Keeps the second buffer aligned as well
+        static std::size_t getStride(std::size_t size) {
+            constexpr std::size_t floatsPerCacheLine = cacheLineAlignment / sizeof(float);
+            return (size + floatsPerCacheLine - 1ul) / floatsPerCacheLine * floatsPerCacheLine;
+        }
+
+    private:
+        alignas(cacheLineAlignment) float inlineBuffer[inlineCapacity * 2ul];
+        std::size_t size;
+        std::size_t stride;
+        float* data;
+
+};
+
+}  // namespace cpu
+
+}  // namespace ml
+
+}  // namespace rl4
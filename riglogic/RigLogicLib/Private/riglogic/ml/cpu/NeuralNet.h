@@ -3,8 +3,10 @@
 #pragma once
 
 #include "riglogic/TypeDefs.h"
+#include "riglogic/system/simd/SIMD.h"
 #include "riglogic/types/PaddedBlockView.h"
 #include "riglogic/types/Extent.h"
+#include "riglogic/types/MappableVector.h"
 
 #include <cstdint>
 
@@ -14,13 +16,15 @@ namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T>
 struct WeightMatrix {
     Extent original;
     Extent padded;
     PaddedBlockView rows;
     PaddedBlockView cols;
-    AlignedVector<T> values;
+    MappableVector<T> values;
 
     explicit WeightMatrix(MemoryResource* memRes) :
         original{},
@@ -40,7 +44,7 @@ struct WeightMatrix {
 template<typename T>
 struct NeuralNetLayer {
     WeightMatrix<T> weights;
-    AlignedVector<T> biases;
+    MappableVector<T> biases;
     Vector<float> activationFunctionParameters;
     dna::ActivationFunction activationFunction;
 
@@ -58,6 +62,36 @@ struct NeuralNetLayer {
 
 };
 
+// Weights quantized to 8-bit integers, with a scale and zero point per output (row), so that each weight is
+// approximately scale * (value - zeroPoint). Columns are padded to an even count and the values of each block of rows
+// are stored as pairs of adjacent columns, interleaved by rows (see Quantizer), which is the layout consumed by the
+// integer multiply-add instructions (pmaddwd). Zero points are integers too, but are stored as floats, as they are
+// only used after the integer dot products are converted to floats.
+template<>
+struct NeuralNetLayer<std::int8_t> {
+    WeightMatrix<std::int8_t> weights;
+    MappableVector<float> scales;
+    MappableVector<float> zeroPoints;
+    MappableVector<float> biases;
+    Vector<float> activationFunctionParameters;
+    dna::ActivationFunction activationFunction;
+
+    explicit NeuralNetLayer(MemoryResource* memRes) :
+        weights{memRes},
+        scales{memRes},
+        zeroPoints{memRes},
+        biases{memRes},
+        activationFunctionParameters{memRes},
+        activationFunction{} {
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(weights, scales, zeroPoints, biases, activationFunctionParameters, activationFunction);
+    }
+
+};
+
 template<typename T>
 struct NeuralNet {
     Vector<NeuralNetLayer<T> > layers;
@@ -81,6 +115,8 @@ struct NeuralNet {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
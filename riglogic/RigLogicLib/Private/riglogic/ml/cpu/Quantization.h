@@ -0,0 +1,341 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/ml/cpu/Inference.h"
+#include "riglogic/ml/cpu/NeuralNet.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace rl4 {
+
+namespace ml {
+
+namespace cpu {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+// Quantizes a weight into the integer range, given the scale and zero point of its row
+inline float quantizeWeight(float weight, float scale, float zeroPoint) {
+    return std::min(std::max(std::round(weight / scale) + zeroPoint, -128.0f), 127.0f);
+}
+
+/*
+ * Returns the inputs to calibrate and measure a network with, as one row of inputCount values per sample
+ *
+ * These are the complete rows of the given samples, or if there are none, a fixed set of pseudo-random
+ * inputs in range [-1, 1], which is the range of most raw controls.
+ */
+inline Vector<float> getCalibrationSamples(ConstArrayView<float> samples, std::size_t inputCount, MemoryResource* memRes) {
+    constexpr std::size_t defaultSampleCount = 32ul;
+    Vector<float> result{memRes};
+    if (inputCount == 0ul) {
+        return result;
+    }
+    const std::size_t sampleCount = samples.size() / inputCount;
+    if (sampleCount != 0ul) {
+        result.assign(samples.begin(), samples.begin() + sampleCount * inputCount);
+        return result;
+    }
+    result.resize(defaultSampleCount * inputCount);
+    std::uint32_t seed = 0x9E3779B9u;
+    for (auto& value : result) {
+        seed = seed * 1664525u + 1013904223u;
+        value = static_cast<float>(seed >> 8u) / 8388608.0f - 1.0f;
+    }
+    return result;
+}
+
+// Stores a sample into the input buffer, and returns the network inputs as read back from it into referenceInputs
+// (the same control may be used as multiple inputs, in which case the last of its values is used for all of them)
+inline void loadCalibrationSample(ConstArrayView<std::uint16_t> inputIndices,
+                                  const float* sample,
+                                  ArrayView<float> inputBuffer,
+                                  Vector<double>& referenceInputs) {
+    for (std::size_t i = 0ul; i < inputIndices.size(); ++i) {
+        inputBuffer[inputIndices[i]] = sample[i];
+    }
+    referenceInputs.resize(inputIndices.size());
+    for (std::size_t i = 0ul; i < inputIndices.size(); ++i) {
+        referenceInputs[i] = inputBuffer[inputIndices[i]];
+    }
+}
+
+/*
+ * Evaluates a network of the DNA in double precision (with exact activation functions)
+ *
+ * Values must contain the inputs of the network, and are replaced by its outputs. The visitor is
+ * called with the index and the inputs of each layer, before the layer is evaluated.
+ */
+template<typename TLayerInputVisitor>
+void evaluateReferenceNeuralNet(const dna::MachineLearnedBehaviorReader* reader,
+                                std::uint16_t neuralNetIdx,
+                                Vector<double>& values,
+                                Vector<double>& buffer,
+                                TLayerInputVisitor visitLayerInputs) {
+    const auto layerCount = reader->getNeuralNetworkLayerCount(neuralNetIdx);
+    for (std::uint16_t layerIdx = {}; layerIdx < layerCount; ++layerIdx) {
+        visitLayerInputs(layerIdx, static_cast<const Vector<double>&>(values));
+        const auto weights = reader->getNeuralNetworkLayerWeights(neuralNetIdx, layerIdx);
+        const auto biases = reader->getNeuralNetworkLayerBiases(neuralNetIdx, layerIdx);
+        const auto params = reader->getNeuralNetworkLayerActivationFunctionParameters(neuralNetIdx, layerIdx);
+        const auto activationFunction = reader->getNeuralNetworkLayerActivationFunction(neuralNetIdx, layerIdx);
+        const std::size_t inputCount = values.size();
+        buffer.resize(biases.size());
+        for (std::size_t row = 0ul; row < biases.size(); ++row) {
+            double sum = biases[row];
+            for (std::size_t col = 0ul; col < inputCount; ++col) {
+                sum += static_cast<double>(weights[row * inputCount + col]) * values[col];
+            }
+            switch (activationFunction) {
+                case dna::ActivationFunction::linear:
+                    break;
+                case dna::ActivationFunction::relu:
+                    sum = std::max(sum, 0.0);
+                    break;
+                case dna::ActivationFunction::leakyrelu:
+                    sum = (sum < 0.0 ? sum * (params.size() == 0ul ? 0.0 : params[0]) : sum);
+                    break;
+                case dna::ActivationFunction::tanh:
+                    sum = std::tanh(sum);
+                    break;
+                case dna::ActivationFunction::sigmoid:
+                    sum = 1.0 / (1.0 + std::exp(-sum));
+                    break;
+            }
+            buffer[row] = sum;
+        }
+        std::swap(values, buffer);
+    }
+}
+
+/*
+ * Records the inputs of each layer of a network of the DNA for the given samples
+ *
+ * The inputs of a layer are stored as a row-major matrix, with one row of inputCount values per sample.
+ */
+inline Vector<Vector<float> > computeLayerInputs(const dna::MachineLearnedBehaviorReader* reader,
+                                                 std::uint16_t neuralNetIdx,
+                                                 ConstArrayView<float> samples,
+                                                 MemoryResource* memRes) {
+    const auto inputIndices = reader->getNeuralNetworkInputIndices(neuralNetIdx);
+    const std::size_t inputCount = inputIndices.size();
+    Vector<Vector<float> > layerInputs{memRes};
+    if (inputCount == 0ul) {
+        return layerInputs;
+    }
+
+    std::size_t bufferSize = {};
+    for (const auto index : inputIndices) {
+        bufferSize = std::max(bufferSize, static_cast<std::size_t>(index) + 1ul);
+    }
+    Vector<float> inputBuffer{bufferSize, 0.0f, memRes};
+    Vector<double> values{memRes};
+    Vector<double> buffer{memRes};
+
+    layerInputs.resize(reader->getNeuralNetworkLayerCount(neuralNetIdx), Vector<float>{memRes});
+    for (std::size_t offset = 0ul; offset < samples.size(); offset += inputCount) {
+        loadCalibrationSample(inputIndices, samples.data() + offset, ArrayView<float>{inputBuffer}, values);
+        evaluateReferenceNeuralNet(reader, neuralNetIdx, values, buffer,
+                                   [&layerInputs](std::uint16_t layerIdx, const Vector<double>& inputs) {
+                layerInputs[layerIdx].insert(layerInputs[layerIdx].end(), inputs.begin(), inputs.end());
+            });
+    }
+    return layerInputs;
+}
+
+/*
+ * Computes the scale and zero point of each row of a layer
+ *
+ * The value range of each row is extended to include zero (so zero weights, which are common
+ * after pruning, and the padding are exact), and mapped onto [-128, 127]. If the inputs of the
+ * layer for a set of calibration samples are given (see computeLayerInputs), the range is narrowed
+ * to whichever of a few fractions of it gives the smallest largest error of the row's output over
+ * those samples, as clipping a few outlying weights lets the rest of them be resolved more finely.
+ */
+inline void computeQuantizationParameters(ConstArrayView<float> weights,
+                                          ConstArrayView<float> layerInputs,
+                                          NeuralNetLayer<std::int8_t>& layer,
+                                          MemoryResource* memRes) {
+    constexpr std::uint32_t rangeFractionCount = 9u;
+    constexpr float rangeFractionStep = 1.0f / 16.0f;
+    const std::uint32_t rowCount = layer.weights.original.rows;
+    const std::uint32_t columnCount = layer.weights.original.cols;
+    const std::uint32_t paddedRowCount = layer.weights.padded.rows;
+    assert(weights.size() == static_cast<std::size_t>(rowCount) * columnCount);
+    assert((columnCount == 0u) || ((layerInputs.size() % columnCount) == 0ul));
+
+    layer.scales.resize(paddedRowCount);
+    layer.zeroPoints.resize(paddedRowCount);
+    std::fill(layer.scales.begin(), layer.scales.end(), 1.0f);
+    std::fill(layer.zeroPoints.begin(), layer.zeroPoints.end(), 0.0f);
+
+    const bool calibrated = (columnCount != 0u) && (layerInputs.size() != 0ul);
+    Vector<double> errors{calibrated ? columnCount : 0ul, 0.0, memRes};
+    for (std::uint32_t row = {}; row < rowCount; ++row) {
+        const float* rowWeights = weights.data() + static_cast<std::size_t>(row) * columnCount;
+        const auto minMax = std::minmax_element(rowWeights, rowWeights + columnCount);
+        const float minWeight = std::min(*minMax.first, 0.0f);
+        const float maxWeight = std::max(*minMax.second, 0.0f);
+        if (maxWeight <= minWeight) {
+            continue;
+        }
+
+        double bestError = {};
+        for (std::uint32_t i = {}; i < (calibrated ? rangeFractionCount : 1u); ++i) {
+            const float fraction = 1.0f - static_cast<float>(i) * rangeFractionStep;
+            const float scale = fraction * (maxWeight - minWeight) / 255.0f;
+            const float zeroPoint = std::min(std::max(std::round(-128.0f - fraction * minWeight / scale), -128.0f), 127.0f);
+            if (calibrated) {
+                for (std::uint32_t col = {}; col < columnCount; ++col) {
+                    const float quantized = quantizeWeight(rowWeights[col], scale, zeroPoint);
+                    errors[col] = static_cast<double>(rowWeights[col]) - static_cast<double>((quantized - zeroPoint) * scale);
+                }
+                double error = {};
+                for (std::size_t offset = 0ul; offset < layerInputs.size(); offset += columnCount) {
+                    const float* inputs = layerInputs.data() + offset;
+                    double dot = {};
+                    for (std::uint32_t col = {}; col < columnCount; ++col) {
+                        dot += errors[col] * inputs[col];
+                    }
+                    error = std::max(error, std::fabs(dot));
+                }
+                if ((i != 0u) && (error >= bestError)) {
+                    continue;
+                }
+                bestError = error;
+            }
+            layer.scales[row] = scale;
+            layer.zeroPoints[row] = zeroPoint;
+        }
+    }
+}
+
+// Visits the quantized weights of a matrix (padding included), in the order in which quantizeWeights stores them,
+// calling func(offset, row, col) for each of them
+template<typename TFunc>
+void forEachQuantizedWeight(const WeightMatrix<std::int8_t>& weights,
+                            std::uint32_t fullBlockHeight,
+                            std::uint32_t remainderBlockHeight,
+                            TFunc func) {
+    std::uint32_t offset = {};
+    for (std::uint32_t blockStart = {}; blockStart < weights.padded.rows;) {
+        const std::uint32_t blockHeight =
+            (blockStart < weights.rows.sizePaddedToLastFullBlock ? fullBlockHeight : remainderBlockHeight);
+        for (std::uint32_t col = {}; col < weights.padded.cols; col += 2u) {
+            for (std::uint32_t i = {}; i < blockHeight; ++i) {
+                for (std::uint32_t j = {}; j < 2u; ++j, ++offset) {
+                    func(offset, blockStart + i, col + j);
+                }
+            }
+        }
+        blockStart += blockHeight;
+    }
+}
+
+/*
+ * Quantizes the (row-major) weights of a layer into 8-bit integers
+ *
+ * Weights are mapped onto [-128, 127] by the scale and zero point of their row, which must already
+ * be computed (see computeQuantizationParameters). Weights of each block of rows (of fullBlockHeight
+ * rows up to the last full block, and remainderBlockHeight rows after it) are stored as pairs of
+ * adjacent columns, with the pairs of all rows of the block stored next to each other:
+ *
+ *   [r0c0, r0c1, r1c0, r1c1, ..., rNc0, rNc1], [r0c2, r0c3, r1c2, r1c3, ...], ...
+ *
+ * The extents and row view of the layer's weight matrix must already be set up, with the
+ * number of columns padded to an even count.
+ */
+inline void quantizeWeights(ConstArrayView<float> weights,
+                            std::uint32_t fullBlockHeight,
+                            std::uint32_t remainderBlockHeight,
+                            NeuralNetLayer<std::int8_t>& layer) {
+    const std::uint32_t rowCount = layer.weights.original.rows;
+    const std::uint32_t columnCount = layer.weights.original.cols;
+    const std::uint32_t paddedRowCount = layer.weights.padded.rows;
+    const std::uint32_t paddedColumnCount = layer.weights.padded.cols;
+    assert((paddedColumnCount % 2u) == 0u);
+    assert(weights.size() == static_cast<std::size_t>(rowCount) * columnCount);
+    assert(layer.scales.size() == paddedRowCount);
+
+    layer.weights.values.resize(static_cast<std::size_t>(paddedRowCount) * paddedColumnCount);
+    std::int8_t* block = layer.weights.values.data();
+    forEachQuantizedWeight(layer.weights, fullBlockHeight, remainderBlockHeight,
+                           [&](std::uint32_t offset, std::uint32_t row, std::uint32_t col) {
+            float quantized = 0.0f;
+            if (row < rowCount) {
+                // Padded columns are stored as (exact) zero weights too
+                const float weight = (col < columnCount ? weights[row * columnCount + col] : 0.0f);
+                quantized = quantizeWeight(weight, layer.scales[row], layer.zeroPoints[row]);
+            }
+            block[offset] = static_cast<std::int8_t>(quantized);
+        });
+}
+
+/*
+ * Measures how closely the given network reproduces the network of the DNA
+ *
+ * The DNA network is evaluated in double precision (with exact activation functions), and
+ * compared with the given network at the given samples (see getCalibrationSamples). Returns
+ * the largest absolute difference of outputs.
+ */
+template<typename T, typename TF256, typename TF128>
+float measureNeuralNetError(const dna::MachineLearnedBehaviorReader* reader,
+                            std::uint16_t neuralNetIdx,
+                            const NeuralNetInference<T, TF256, TF128>& inference,
+                            ConstArrayView<float> samples,
+                            std::uint32_t maxLayerOutputCount,
+                            MemoryResource* memRes) {
+    const auto& net = inference.neuralNet;
+    const std::size_t inputCount = net.inputIndices.size();
+    std::size_t bufferSize = {};
+    for (const auto index : net.inputIndices) {
+        bufferSize = std::max(bufferSize, static_cast<std::size_t>(index) + 1ul);
+    }
+    for (const auto index : net.outputIndices) {
+        bufferSize = std::max(bufferSize, static_cast<std::size_t>(index) + 1ul);
+    }
+
+    AlignedVector<float> layerBuffer1{maxLayerOutputCount, {}, memRes};
+    AlignedVector<float> layerBuffer2{maxLayerOutputCount, {}, memRes};
+    Vector<float> inputBuffer{bufferSize, 0.0f, memRes};
+    Vector<float> outputBuffer{bufferSize, 0.0f, memRes};
+    Vector<double> referenceValues{memRes};
+    Vector<double> referenceBuffer{memRes};
+
+    float maxError = 0.0f;
+    for (std::size_t offset = 0ul; (inputCount != 0ul) && (offset < samples.size()); offset += inputCount) {
+        loadCalibrationSample(ConstArrayView<std::uint16_t>{net.inputIndices},
+                              samples.data() + offset,
+                              ArrayView<float>{inputBuffer},
+                              referenceValues);
+        evaluateReferenceNeuralNet(reader, neuralNetIdx, referenceValues, referenceBuffer,
+                                   [](std::uint16_t  /*unused*/, const Vector<double>&  /*unused*/) {
+            });
+
+        inference.calculate(ConstArrayView<float>{inputBuffer},
+                            ArrayView<float>{layerBuffer1},
+                            ArrayView<float>{layerBuffer2},
+                            ArrayView<float>{outputBuffer},
+                            1.0f);
+        for (std::size_t i = 0ul; i < net.outputIndices.size(); ++i) {
+            const double difference = std::fabs(outputBuffer[net.outputIndices[i]] - referenceValues[i]);
+            maxError = std::max(maxError, static_cast<float>(difference));
+        }
+    }
+    return maxError;
+}
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace cpu
+
+}  // namespace ml
+
+}  // namespace rl4
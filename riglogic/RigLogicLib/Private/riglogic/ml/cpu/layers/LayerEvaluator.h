@@ -4,14 +4,25 @@
 
 #include "riglogic/TypeDefs.h"
 #include "riglogic/ml/cpu/NeuralNet.h"
+#include "riglogic/ml/cpu/layers/Utils.h"
+#include "riglogic/system/simd/SIMD.h"
 #include "riglogic/utils/Macros.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 namespace rl4 {
 
 namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T>
 class LayerEvaluator {
     public:
@@ -21,6 +32,12 @@ class LayerEvaluator {
         virtual ~LayerEvaluator() = default;
 
         virtual void calculate(const NeuralNetLayer<T>& layer, ConstArrayView<float> inputs, ArrayView<float> outputs) const = 0;
+        // Evaluates the layer for a batch of input vectors, laid out row-major with batchStride (the batch size) values
+        // per row (i.e. each row holds the n-th input of all vectors in the batch), and the outputs are laid out the same way
+        virtual void calculate(const NeuralNetLayer<T>& layer,
+                               ConstArrayView<float> inputs,
+                               ArrayView<float> outputs,
+                               std::size_t batchStride) const = 0;
 };
 
 template<typename TF256, typename T>
@@ -34,7 +51,7 @@ static FORCE_INLINE void processBlocks8x1(const float* inputVectorEndAlignedTo4,
          ++inputVector, weights += TF256::size()) {
         const TF256 input{*inputVector};
         const TF256 blk = TF256::fromAlignedSource(weights);
-        remainder += (blk * input);
+        remainder = trimd::fmadd(blk, input, remainder);
     }
     sum += remainder;
 }
@@ -62,10 +79,10 @@ static FORCE_INLINE void processBlocks8x4(const float* inputVectorStart,
         const TF256 blk2 = TF256::fromAlignedSource(weights + TF256::size() * 1);
         const TF256 blk3 = TF256::fromAlignedSource(weights + TF256::size() * 2);
         const TF256 blk4 = TF256::fromAlignedSource(weights + TF256::size() * 3);
-        sum1 += (blk1 * input1);
-        sum2 += (blk2 * input2);
-        sum3 += (blk3 * input3);
-        sum4 += (blk4 * input4);
+        sum1 = trimd::fmadd(blk1, input1, sum1);
+        sum2 = trimd::fmadd(blk2, input2, sum2);
+        sum3 = trimd::fmadd(blk3, input3, sum3);
+        sum4 = trimd::fmadd(blk4, input4, sum4);
     }
     // Process 8x1 horizontal remainder portion after 8x4 blocks are consumed
     processBlocks8x1(inputVectorEndAlignedTo4, inputVectorEnd, weights, sum1);
@@ -94,7 +111,7 @@ static FORCE_INLINE void processBlocks4x1(const float* inputVectorEndAlignedTo8,
          ++inputVector, weights += TF128::size()) {
         const TF128 input{*inputVector};
         const TF128 blk = TF128::fromAlignedSource(weights);
-        remainder += (blk * input);
+        remainder = trimd::fmadd(blk, input, remainder);
     }
     sum1 += remainder;
 }
@@ -134,14 +151,14 @@ static FORCE_INLINE void processBlocks4x8(const float* inputVectorStart,
         const TF128 blk6 = TF128::fromAlignedSource(weights + TF128::size() * 5);
         const TF128 blk7 = TF128::fromAlignedSource(weights + TF128::size() * 6);
         const TF128 blk8 = TF128::fromAlignedSource(weights + TF128::size() * 7);
-        sum1 += (blk1 * input1);
-        sum2 += (blk2 * input2);
-        sum3 += (blk3 * input3);
-        sum4 += (blk4 * input4);
-        sum5 += (blk5 * input5);
-        sum6 += (blk6 * input6);
-        sum7 += (blk7 * input7);
-        sum8 += (blk8 * input8);
+        sum1 = trimd::fmadd(blk1, input1, sum1);
+        sum2 = trimd::fmadd(blk2, input2, sum2);
+        sum3 = trimd::fmadd(blk3, input3, sum3);
+        sum4 = trimd::fmadd(blk4, input4, sum4);
+        sum5 = trimd::fmadd(blk5, input5, sum5);
+        sum6 = trimd::fmadd(blk6, input6, sum6);
+        sum7 = trimd::fmadd(blk7, input7, sum7);
+        sum8 = trimd::fmadd(blk8, input8, sum8);
     }
     // Process 4x1 horizontal remainder portion after 4x8 blocks are consumed
     processBlocks4x1(inputVectorEndAlignedTo8, inputVectorEnd, weights, sum1);
@@ -203,6 +220,480 @@ static FORCE_INLINE void calculateBlock4(const NeuralNetLayer<T>& layer, ConstAr
     }
 }
 
+/*
+ * Process two adjacent blocks of rows for a batch of four input vectors
+ *
+ * Instead of multiplying the loaded weights against a single input vector, they are
+ * multiplied against four distinct input vectors, which are expected to be laid out
+ * adjacently for each input (see calculateBlock4Batch), so every weight of the blocks
+ * is loaded once for all four vectors. Two blocks of rows are consumed at once, so
+ * there are eight independent accumulators to hide the latency of the multiply-adds.
+ */
+template<typename TFVec, typename TActivationFunction, typename T>
+static FORCE_INLINE void processBlocks2x1Batch4(const float* batchInputs,
+                                                std::size_t batchStride,
+                                                std::size_t columnCount,
+                                                const T* weights,
+                                                const T* biases,
+                                                const float* activationParams,
+                                                float* outbuf) {
+    const T* weights2 = weights + columnCount * TFVec::size();
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    TFVec sum5{};
+    TFVec sum6{};
+    TFVec sum7{};
+    TFVec sum8{};
+    for (std::size_t col = 0ul; col < columnCount; ++col, batchInputs += batchStride, weights += TFVec::size(),
+         weights2 += TFVec::size()) {
+        const TFVec blk1 = TFVec::fromAlignedSource(weights);
+        const TFVec blk2 = TFVec::fromAlignedSource(weights2);
+        const TFVec inputVec1{batchInputs[0]};
+        const TFVec inputVec2{batchInputs[1]};
+        const TFVec inputVec3{batchInputs[2]};
+        const TFVec inputVec4{batchInputs[3]};
+        sum1 = trimd::fmadd(blk1, inputVec1, sum1);
+        sum2 = trimd::fmadd(blk2, inputVec1, sum2);
+        sum3 = trimd::fmadd(blk1, inputVec2, sum3);
+        sum4 = trimd::fmadd(blk2, inputVec2, sum4);
+        sum5 = trimd::fmadd(blk1, inputVec3, sum5);
+        sum6 = trimd::fmadd(blk2, inputVec3, sum6);
+        sum7 = trimd::fmadd(blk1, inputVec4, sum7);
+        sum8 = trimd::fmadd(blk2, inputVec4, sum8);
+    }
+
+    const TFVec bias1 = TFVec::fromAlignedSource(biases);
+    const TFVec bias2 = TFVec::fromAlignedSource(biases + TFVec::size());
+    sum1 += bias1;
+    sum2 += bias2;
+    sum3 += bias1;
+    sum4 += bias2;
+    sum5 += bias1;
+    sum6 += bias2;
+    sum7 += bias1;
+    sum8 += bias2;
+
+    TActivationFunction activation{};
+    activation(sum1, activationParams);
+    activation(sum2, activationParams);
+    activation(sum3, activationParams);
+    activation(sum4, activationParams);
+    activation(sum5, activationParams);
+    activation(sum6, activationParams);
+    activation(sum7, activationParams);
+    activation(sum8, activationParams);
+
+    sum1.alignedStore(outbuf);
+    sum2.alignedStore(outbuf + TFVec::size());
+    sum3.alignedStore(outbuf + TFVec::size() * 2);
+    sum4.alignedStore(outbuf + TFVec::size() * 3);
+    sum5.alignedStore(outbuf + TFVec::size() * 4);
+    sum6.alignedStore(outbuf + TFVec::size() * 5);
+    sum7.alignedStore(outbuf + TFVec::size() * 6);
+    sum8.alignedStore(outbuf + TFVec::size() * 7);
+}
+
+/*
+ * Process a single block of rows for a batch of four input vectors
+ *
+ * Same as the above, but for the last block of rows, when it has no pair.
+ */
+template<typename TFVec, typename TActivationFunction, typename T>
+static FORCE_INLINE void processBlocks1x1Batch4(const float* batchInputs,
+                                                std::size_t batchStride,
+                                                std::size_t columnCount,
+                                                const T* weights,
+                                                const T* biases,
+                                                const float* activationParams,
+                                                float* outbuf) {
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    for (std::size_t col = 0ul; col < columnCount; ++col, batchInputs += batchStride, weights += TFVec::size()) {
+        const TFVec blk = TFVec::fromAlignedSource(weights);
+        sum1 = trimd::fmadd(blk, TFVec{batchInputs[0]}, sum1);
+        sum2 = trimd::fmadd(blk, TFVec{batchInputs[1]}, sum2);
+        sum3 = trimd::fmadd(blk, TFVec{batchInputs[2]}, sum3);
+        sum4 = trimd::fmadd(blk, TFVec{batchInputs[3]}, sum4);
+    }
+
+    const TFVec bias = TFVec::fromAlignedSource(biases);
+    sum1 += bias;
+    sum2 += bias;
+    sum3 += bias;
+    sum4 += bias;
+
+    TActivationFunction activation{};
+    activation(sum1, activationParams);
+    activation(sum2, activationParams);
+    activation(sum3, activationParams);
+    activation(sum4, activationParams);
+
+    sum1.alignedStore(outbuf);
+    sum2.alignedStore(outbuf + TFVec::size());
+    sum3.alignedStore(outbuf + TFVec::size() * 2);
+    sum4.alignedStore(outbuf + TFVec::size() * 3);
+}
+
+/*
+ * Process a single block of rows for a single input vector of the batch
+ *
+ * Used for the (less than four) input vectors left after the groups of four, in which
+ * case four columns are consumed per iteration instead, just like processBlocks8x4.
+ */
+template<typename TFVec, typename TActivationFunction, typename T>
+static FORCE_INLINE void processBlocks1x4Batch1(const float* batchInputs,
+                                                std::size_t batchStride,
+                                                std::size_t columnCount,
+                                                const T* weights,
+                                                const T* biases,
+                                                const float* activationParams,
+                                                float* outbuf) {
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    const std::size_t columnCountAlignedTo4 = columnCount - (columnCount % 4ul);
+    std::size_t col = 0ul;
+    for (; col < columnCountAlignedTo4; col += 4ul, batchInputs += (batchStride * 4ul), weights += (TFVec::size() * 4ul)) {
+        sum1 = trimd::fmadd(TFVec::fromAlignedSource(weights), TFVec{batchInputs[0]}, sum1);
+        sum2 = trimd::fmadd(TFVec::fromAlignedSource(weights + TFVec::size()), TFVec{batchInputs[batchStride]}, sum2);
+        sum3 = trimd::fmadd(TFVec::fromAlignedSource(weights + TFVec::size() * 2), TFVec{batchInputs[batchStride * 2ul]}, sum3);
+        sum4 = trimd::fmadd(TFVec::fromAlignedSource(weights + TFVec::size() * 3), TFVec{batchInputs[batchStride * 3ul]}, sum4);
+    }
+    for (; col < columnCount; ++col, batchInputs += batchStride, weights += TFVec::size()) {
+        sum1 = trimd::fmadd(TFVec::fromAlignedSource(weights), TFVec{batchInputs[0]}, sum1);
+    }
+
+    sum1 += sum3;
+    sum2 += sum4;
+    sum1 += sum2;
+
+    sum1 += TFVec::fromAlignedSource(biases);
+
+    TActivationFunction{} (sum1, activationParams);
+
+    sum1.alignedStore(outbuf);
+}
+
+// Writes the outputs of BlockCount blocks of rows, computed for BatchWidth vectors (laid out as by the block processors
+// above, i.e. vector-major), into the row-major batch layout
+template<std::size_t BlockHeight, std::size_t BlockCount, std::size_t BatchWidth>
+static FORCE_INLINE void storeBatchOutputs(const float* outbuf, float* outputs, std::size_t batchStride) {
+    for (std::size_t b = 0ul; b < BlockCount; ++b) {
+        for (std::size_t i = 0ul; i < BlockHeight; ++i) {
+            float* outputRow = outputs + (b * BlockHeight + i) * batchStride;
+            for (std::size_t j = 0ul; j < BatchWidth; ++j) {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+                outputRow[j] = outbuf[(j * BlockCount + b) * BlockHeight + i];
+            }
+        }
+    }
+}
+
+/*
+ * Evaluates a block of rows (or a pair of them) for the whole batch
+ *
+ * The same weights are reused for all groups of four input vectors, so after the first
+ * group, they are served from the L1 cache (a pair of blocks of a layer with 256 inputs
+ * takes 16 KiB, or 8 KiB as half floats).
+ */
+template<typename TFVec, typename TActivationFunction, std::size_t BlockCount, typename T>
+static FORCE_INLINE void processRowsBatch(ConstArrayView<float> inputs,
+                                          float* outputs,
+                                          std::size_t batchStride,
+                                          std::size_t columnCount,
+                                          const T* weights,
+                                          const T* biases,
+                                          const float* activationParams) {
+    constexpr std::size_t batchWidth = 4ul;
+    const std::size_t batchStrideAlignedTo4 = batchStride - (batchStride % batchWidth);
+    std::size_t bi = 0ul;
+    for (; bi < batchStrideAlignedTo4; bi += batchWidth) {
+        alignas(TFVec::alignment()) float outbuf[TFVec::size() * BlockCount * batchWidth];
+        if (BlockCount == 2ul) {
+            processBlocks2x1Batch4<TFVec, TActivationFunction>(inputs.data() + bi, batchStride, columnCount, weights, biases,
+                                                               activationParams, static_cast<float*>(outbuf));
+        } else {
+            processBlocks1x1Batch4<TFVec, TActivationFunction>(inputs.data() + bi, batchStride, columnCount, weights, biases,
+                                                               activationParams, static_cast<float*>(outbuf));
+        }
+        storeBatchOutputs<TFVec::size(), BlockCount, batchWidth>(static_cast<float*>(outbuf), outputs + bi, batchStride);
+    }
+    for (; bi < batchStride; ++bi) {
+        for (std::size_t b = 0ul; b < BlockCount; ++b) {
+            alignas(TFVec::alignment()) float outbuf[TFVec::size()];
+            processBlocks1x4Batch1<TFVec, TActivationFunction>(inputs.data() + bi,
+                                                               batchStride,
+                                                               columnCount,
+                                                               weights + b * columnCount * TFVec::size(),
+                                                               biases + b * TFVec::size(),
+                                                               activationParams,
+                                                               static_cast<float*>(outbuf));
+            storeBatchOutputs<TFVec::size(), 1ul, 1ul>(static_cast<float*>(outbuf),
+                                                        outputs + b * TFVec::size() * batchStride + bi,
+                                                        batchStride);
+        }
+    }
+}
+
+/*
+ * Evaluates a whole layer for a batch of input vectors (see LayerEvaluator::calculate)
+ *
+ * Blocks of rows are visited in the outer loop (in pairs, while there are enough of them),
+ * so each weight is streamed from memory only once for the whole batch.
+ */
+template<typename TF256, typename TF128, template<class ...> class TActivationFunction, typename T>
+static FORCE_INLINE void calculateBlock4Batch(const NeuralNetLayer<T>& layer,
+                                              ConstArrayView<float> inputs,
+                                              ArrayView<float> outputs,
+                                              std::size_t batchStride) {
+    assert(inputs.size() >= layer.weights.cols.size * batchStride);
+    assert(outputs.size() >= layer.weights.padded.rows * batchStride);
+    const std::size_t columnCount = layer.weights.cols.size;
+    const T* weights = layer.weights.values.data();
+    const T* biases = layer.biases.data();
+    const float* activationParams = layer.activationFunctionParameters.data();
+    const std::size_t fullRowCount = layer.weights.rows.sizePaddedToLastFullBlock;
+    const std::size_t pairedRowCount = fullRowCount - (fullRowCount % (TF256::size() * 2ul));
+
+    std::size_t row = 0ul;
+    for (; row < pairedRowCount; row += TF256::size() * 2ul) {
+        processRowsBatch<TF256, TActivationFunction<TF256>, 2ul>(inputs, outputs.data() + row * batchStride, batchStride,
+                                                                 columnCount, weights, biases, activationParams);
+        weights += columnCount * TF256::size() * 2ul;
+        biases += TF256::size() * 2ul;
+    }
+    for (; row < fullRowCount; row += TF256::size()) {
+        processRowsBatch<TF256, TActivationFunction<TF256>, 1ul>(inputs, outputs.data() + row * batchStride, batchStride,
+                                                                 columnCount, weights, biases, activationParams);
+        weights += columnCount * TF256::size();
+        biases += TF256::size();
+    }
+    for (; row < layer.weights.rows.size; row += TF128::size()) {
+        processRowsBatch<TF128, TActivationFunction<TF128>, 1ul>(inputs, outputs.data() + row * batchStride, batchStride,
+                                                                 columnCount, weights, biases, activationParams);
+        weights += columnCount * TF128::size();
+        biases += TF128::size();
+    }
+}
+
+// Inputs of quantized layers are quantized to 13 bits, so the products of a whole chunk of them with the 8-bit weights
+// can be summed up in 32-bit integers (2048 * 127 * 4095 < 2^31)
+constexpr float quantizedInputRange = 4095.0f;
+constexpr std::size_t quantizedInputChunkSize = 2048ul;
+
+// Adding 1.5 * 2^23 rounds the scaled input to the nearest integer, which then lands in the low bits of the mantissa, so
+// the low 16 bits of the result are the (two's complement) quantized input (std::lrint is not inlined by all compilers)
+static FORCE_INLINE std::uint32_t quantizeInput(float value, float inverseScale) {
+    const float shifted = value * inverseScale + 12582912.0f;
+    std::uint32_t bits;
+    std::memcpy(&bits, &shifted, sizeof(bits));
+    return bits & 0xFFFFu;
+}
+
+static FORCE_INLINE float maxAbsInput(const float* inputs, std::size_t inputStride, std::size_t columnCount) {
+    // Independent maximums avoid stalling on the latency of each comparison
+    float max1 = 0.0f;
+    float max2 = 0.0f;
+    float max3 = 0.0f;
+    float max4 = 0.0f;
+    const std::size_t columnCountAlignedTo4 = columnCount - (columnCount % 4ul);
+    std::size_t col = 0ul;
+    for (; col < columnCountAlignedTo4; col += 4ul, inputs += (inputStride * 4ul)) {
+        max1 = std::max(max1, std::fabs(inputs[0]));
+        max2 = std::max(max2, std::fabs(inputs[inputStride]));
+        max3 = std::max(max3, std::fabs(inputs[inputStride * 2ul]));
+        max4 = std::max(max4, std::fabs(inputs[inputStride * 3ul]));
+    }
+    for (; col < columnCount; ++col, inputs += inputStride) {
+        max1 = std::max(max1, std::fabs(inputs[0]));
+    }
+    return std::max(std::max(max1, max2), std::max(max3, max4));
+}
+
+template<typename TFVec>
+static FORCE_INLINE TFVec loadStrided(const float* source, std::size_t stride) {
+    if (stride == 1ul) {
+        return TFVec::fromUnalignedSource(source);
+    }
+    alignas(TFVec::alignment()) float buffer[TFVec::size()];
+    for (std::size_t i = 0ul; i < TFVec::size(); ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        buffer[i] = source[i * stride];
+    }
+    return TFVec::fromAlignedSource(static_cast<const float*>(buffer));
+}
+
+template<typename TFVec>
+static FORCE_INLINE void storeStrided(const TFVec& value, float* dest, std::size_t stride) {
+    alignas(TFVec::alignment()) float buffer[TFVec::size()];
+    value.alignedStore(static_cast<float*>(buffer));
+    if (stride == 1ul) {
+        std::memcpy(dest, buffer, sizeof(buffer));
+        return;
+    }
+    for (std::size_t i = 0ul; i < TFVec::size(); ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        dest[i * stride] = buffer[i];
+    }
+}
+
+/*
+ * Integer dot products of a block of rows of quantized weights with a chunk of quantized inputs
+ *
+ * Inputs are packed as pairs of 16-bit integers (one pair per 32-bit integer), and each pair
+ * is multiplied against the matching pair of (sign extended) weights of all rows in the block
+ * at once. Two accumulators are used to hide the latency of the multiply-adds.
+ */
+template<typename TIVec>
+static FORCE_INLINE TIVec processQuantizedBlock(const std::int32_t* packedInputs, std::size_t pairCount,
+                                                const std::int8_t* weights) {
+    TIVec sum1{};
+    TIVec sum2{};
+    const std::size_t pairCountAlignedTo2 = pairCount - (pairCount % 2ul);
+    std::size_t pair = 0ul;
+    for (; pair < pairCountAlignedTo2; pair += 2ul, weights += (TIVec::size() * 4ul)) {
+        sum1 += trimd::madd8x2(weights, TIVec{packedInputs[pair]});
+        sum2 += trimd::madd8x2(weights + TIVec::size() * 2ul, TIVec{packedInputs[pair + 1ul]});
+    }
+    if (pair < pairCount) {
+        sum1 += trimd::madd8x2(weights, TIVec{packedInputs[pair]});
+    }
+    sum1 += sum2;
+    return sum1;
+}
+
+/*
+ * Evaluates the rows [rowStart, rowEnd) of a quantized layer for a chunk of inputs
+ *
+ * The results of all but the last chunk are partial sums, which are kept in the outputs until
+ * the last chunk, when they are dequantized, and the bias and activation function are applied.
+ */
+template<typename TFVec, typename TIVec, typename TActivationFunction>
+static FORCE_INLINE void processQuantizedRows(const NeuralNetLayer<std::int8_t>& layer,
+                                              std::size_t rowStart,
+                                              std::size_t rowEnd,
+                                              const std::int32_t* packedInputs,
+                                              std::size_t pairStart,
+                                              std::size_t pairCount,
+                                              float inputSum,
+                                              float inputScale,
+                                              bool firstChunk,
+                                              bool lastChunk,
+                                              float* outputs,
+                                              std::size_t outputStride) {
+    const std::size_t pairSize = TFVec::size() * 2ul;
+    for (std::size_t row = rowStart; row < rowEnd; row += TFVec::size()) {
+        const std::int8_t* weights = layer.weights.values.data() + row * layer.weights.padded.cols + pairStart * pairSize;
+        TFVec sum = trimd::toFloat(processQuantizedBlock<TIVec>(packedInputs, pairCount, weights));
+        // sum((value - zeroPoint) * input) = sum(value * input) - zeroPoint * sum(input)
+        sum = trimd::fnmadd(TFVec::fromAlignedSource(layer.zeroPoints.data() + row), TFVec{inputSum}, sum);
+        float* outputVector = outputs + row * outputStride;
+        if (!firstChunk) {
+            sum += loadStrided<TFVec>(outputVector, outputStride);
+        }
+        if (lastChunk) {
+            const TFVec scale = TFVec::fromAlignedSource(layer.scales.data() + row) * TFVec{inputScale};
+            sum = trimd::fmadd(sum, scale, TFVec::fromAlignedSource(layer.biases.data() + row));
+            TActivationFunction{} (sum, layer.activationFunctionParameters.data());
+        }
+        storeStrided(sum, outputVector, outputStride);
+    }
+}
+
+/*
+ * Evaluates a quantized layer for a single input vector
+ *
+ * Inputs are quantized on the fly, symmetrically, with a scale derived from the largest
+ * absolute input, so no calibration of the value range of inputs is needed. The strides
+ * allow reading and writing vectors of a batch (see LayerEvaluator::calculate) in place.
+ */
+template<typename TF256, typename TF128, template<class ...> class TActivationFunction>
+static FORCE_INLINE void calculateQuantized(const NeuralNetLayer<std::int8_t>& layer,
+                                            const float* inputs,
+                                            std::size_t inputStride,
+                                            float* outputs,
+                                            std::size_t outputStride) {
+    using TI256 = typename IntegerVector<TF256>::Type;
+    using TI128 = typename IntegerVector<TF128>::Type;
+
+    const std::size_t columnCount = layer.weights.cols.size;
+    assert(columnCount != 0ul);
+    const float maxInput = maxAbsInput(inputs, inputStride, columnCount);
+    const float inputScale = maxInput / quantizedInputRange;
+    const float inverseInputScale = (maxInput > 0.0f ? quantizedInputRange / maxInput : 0.0f);
+    const std::size_t fullRowCount = layer.weights.rows.sizePaddedToLastFullBlock;
+
+    alignas(TI256::alignment()) std::int32_t packedInputs[quantizedInputChunkSize / 2ul];
+    for (std::size_t chunkStart = 0ul; chunkStart < columnCount; chunkStart += quantizedInputChunkSize) {
+        const std::size_t chunkEnd = std::min(chunkStart + quantizedInputChunkSize, columnCount);
+        std::int32_t inputSum = {};
+        std::size_t pairCount = {};
+        for (std::size_t col = chunkStart; col < chunkEnd; col += 2ul, ++pairCount) {
+            const std::uint32_t low = quantizeInput(inputs[col * inputStride], inverseInputScale);
+            const std::uint32_t high =
+                (col + 1ul < chunkEnd ? quantizeInput(inputs[(col + 1ul) * inputStride], inverseInputScale) : 0u);
+            inputSum += static_cast<std::int16_t>(low) + static_cast<std::int16_t>(high);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            packedInputs[pairCount] = static_cast<std::int32_t>((high << 16u) | low);
+        }
+        const bool firstChunk = (chunkStart == 0ul);
+        const bool lastChunk = (chunkEnd == columnCount);
+        processQuantizedRows<TF256, TI256, TActivationFunction<TF256> >(layer,
+                                                                        0ul,
+                                                                        fullRowCount,
+                                                                        static_cast<const std::int32_t*>(packedInputs),
+                                                                        chunkStart / 2ul,
+                                                                        pairCount,
+                                                                        static_cast<float>(inputSum),
+                                                                        inputScale,
+                                                                        firstChunk,
+                                                                        lastChunk,
+                                                                        outputs,
+                                                                        outputStride);
+        processQuantizedRows<TF128, TI128, TActivationFunction<TF128> >(layer,
+                                                                        fullRowCount,
+                                                                        layer.weights.rows.size,
+                                                                        static_cast<const std::int32_t*>(packedInputs),
+                                                                        chunkStart / 2ul,
+                                                                        pairCount,
+                                                                        static_cast<float>(inputSum),
+                                                                        inputScale,
+                                                                        firstChunk,
+                                                                        lastChunk,
+                                                                        outputs,
+                                                                        outputStride);
+    }
+}
+
+template<typename TF256, typename TF128, template<class ...> class TActivationFunction>
+static FORCE_INLINE void calculateBlock4(const NeuralNetLayer<std::int8_t>& layer,
+                                         ConstArrayView<float> inputs,
+                                         ArrayView<float> outputs) {
+    calculateQuantized<TF256, TF128, TActivationFunction>(layer, inputs.data(), 1ul, outputs.data(), 1ul);
+}
+
+// Quantization of inputs is done per input vector, so the vectors of a batch are evaluated one by one (the weights
+// of a layer are small enough to be served from the cache for all but the first of them)
+template<typename TF256, typename TF128, template<class ...> class TActivationFunction>
+static FORCE_INLINE void calculateBlock4Batch(const NeuralNetLayer<std::int8_t>& layer,
+                                              ConstArrayView<float> inputs,
+                                              ArrayView<float> outputs,
+                                              std::size_t batchStride) {
+    assert(inputs.size() >= layer.weights.cols.size * batchStride);
+    assert(outputs.size() >= layer.weights.padded.rows * batchStride);
+    for (std::size_t bi = 0ul; bi < batchStride; ++bi) {
+        calculateQuantized<TF256, TF128, TActivationFunction>(layer, inputs.data() + bi, batchStride, outputs.data() + bi,
+                                                              batchStride);
+    }
+}
+
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace rl4
 
 }  // namespace ml
@@ -12,6 +12,8 @@ namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TFVec>
 struct LinearActivationFunction {
 
@@ -27,8 +29,17 @@ class LinearLayerEvaluator : public LayerEvaluator<T> {
             calculateBlock4<TF256, TF128, LinearActivationFunction>(layer, inputs, outputs);
         }
 
+        void calculate(const NeuralNetLayer<T>& layer,
+                       ConstArrayView<float> inputs,
+                       ArrayView<float> outputs,
+                       std::size_t batchStride) const override {
+            calculateBlock4Batch<TF256, TF128, LinearActivationFunction>(layer, inputs, outputs, batchStride);
+        }
+
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
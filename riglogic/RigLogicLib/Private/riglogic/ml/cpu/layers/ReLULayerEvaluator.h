@@ -13,6 +13,8 @@ namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TFVec>
 struct ReLUActivationFunction {
 
@@ -31,8 +33,17 @@ class ReLULayerEvaluator : public LayerEvaluator<T> {
             calculateBlock4<TF256, TF128, ReLUActivationFunction>(layer, inputs, outputs);
         }
 
+        void calculate(const NeuralNetLayer<T>& layer,
+                       ConstArrayView<float> inputs,
+                       ArrayView<float> outputs,
+                       std::size_t batchStride) const override {
+            calculateBlock4Batch<TF256, TF128, ReLUActivationFunction>(layer, inputs, outputs, batchStride);
+        }
+
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
@@ -4,72 +4,53 @@
 
 #include "riglogic/TypeDefs.h"
 #include "riglogic/ml/cpu/layers/LayerEvaluator.h"
-#include "riglogic/ml/cpu/layers/Utils.h"
+#include "riglogic/system/simd/SIMD.h"
 #include "riglogic/utils/Macros.h"
 
-#include <cmath>
-#include <type_traits>
-
 namespace rl4 {
 
 namespace ml {
 
 namespace cpu {
 
-template<typename TFVec, typename Enable = void>
-struct SigmoidActivationFunction;
-
-template<typename TF256>
-struct SigmoidActivationFunction<TF256, typename std::enable_if<HasSize<TF256, 8ul>::value>::type> {
-
-    void operator()(TF256& sum, const float*  /*unused*/) {
-        // FIXME: dangerously inefficient code
-        alignas(TF256::alignment()) float buf[TF256::size()];
+TRIMD_BEGIN_ISA_NAMESPACE
 
-        sum.alignedStore(buf);
+template<typename TFVec>
+struct SigmoidActivationFunction {
 
-        buf[0] = 1.0f / (1.0f + std::exp(-buf[0]));
-        buf[1] = 1.0f / (1.0f + std::exp(-buf[1]));
-        buf[2] = 1.0f / (1.0f + std::exp(-buf[2]));
-        buf[3] = 1.0f / (1.0f + std::exp(-buf[3]));
-        buf[4] = 1.0f / (1.0f + std::exp(-buf[4]));
-        buf[5] = 1.0f / (1.0f + std::exp(-buf[5]));
-        buf[6] = 1.0f / (1.0f + std::exp(-buf[6]));
-        buf[7] = 1.0f / (1.0f + std::exp(-buf[7]));
-
-        sum.alignedLoad(buf);
+    void operator()(TFVec& sum, const float*  /*unused*/) {
+        sum = trimd::sigmoid(sum);
     }
 
 };
 
-template<typename TF128>
-struct SigmoidActivationFunction<TF128, typename std::enable_if<HasSize<TF128, 4ul>::value>::type> {
-
-    void operator()(TF128& sum, const float*  /*unused*/) {
-        // FIXME: dangerously inefficient code
-        alignas(TF128::alignment()) float buf[TF128::size()];
+template<typename TFVec>
+struct FastSigmoidActivationFunction {
 
-        sum.alignedStore(buf);
-
-        buf[0] = 1.0f / (1.0f + std::exp(-buf[0]));
-        buf[1] = 1.0f / (1.0f + std::exp(-buf[1]));
-        buf[2] = 1.0f / (1.0f + std::exp(-buf[2]));
-        buf[3] = 1.0f / (1.0f + std::exp(-buf[3]));
-
-        sum.alignedLoad(buf);
+    void operator()(TFVec& sum, const float*  /*unused*/) {
+        sum = trimd::fastSigmoid(sum);
     }
 
 };
 
-template<typename T, typename TF256, typename TF128>
+template<typename T, typename TF256, typename TF128, template<class ...> class TActivationFunction = SigmoidActivationFunction>
 class SigmoidLayerEvaluator : public LayerEvaluator<T> {
     public:
         void calculate(const NeuralNetLayer<T>& layer, ConstArrayView<float> inputs, ArrayView<float> outputs) const override {
-            calculateBlock4<TF256, TF128, SigmoidActivationFunction>(layer, inputs, outputs);
+            calculateBlock4<TF256, TF128, TActivationFunction>(layer, inputs, outputs);
+        }
+
+        void calculate(const NeuralNetLayer<T>& layer,
+                       ConstArrayView<float> inputs,
+                       ArrayView<float> outputs,
+                       std::size_t batchStride) const override {
+            calculateBlock4Batch<TF256, TF128, TActivationFunction>(layer, inputs, outputs, batchStride);
         }
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "riglogic/system/simd/SIMD.h"
+
 #include <type_traits>
 
 namespace rl4 {
@@ -10,11 +12,43 @@ namespace ml {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TFVec, std::size_t Size>
 struct HasSize {
     static constexpr bool value = (TFVec::size() == Size);
 };
 
+// Vector of 32-bit integers with the same number of lanes as the given floating point vector type
+template<typename TFVec>
+struct IntegerVector;
+
+template<typename T128>
+struct IntegerVector<trimd::fallback::T256<T128> > {
+    using Type = trimd::fallback::T256<typename IntegerVector<T128>::Type>;
+};
+
+template<>
+struct IntegerVector<trimd::scalar::F128> {
+    using Type = trimd::scalar::I128;
+};
+
+#ifdef TRIMD_ENABLE_SSE
+    template<>
+    struct IntegerVector<trimd::sse::F128> {
+        using Type = trimd::sse::I128;
+    };
+#endif  // TRIMD_ENABLE_SSE
+
+#ifdef TRIMD_ENABLE_AVX
+    template<>
+    struct IntegerVector<trimd::avx::F256> {
+        using Type = trimd::avx::I256;
+    };
+#endif  // TRIMD_ENABLE_AVX
+
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace ml
@@ -23,6 +23,22 @@ ConstArrayView<std::uint16_t> RBFBehavior::getSolverIndicesForLOD(std::uint16_t
     return evaluator->getSolverIndicesForLOD(lod);
 }
 
+bool RBFBehavior::hasIndependentSolvers() const {
+    return evaluator->hasIndependentSolvers();
+}
+
+float RBFBehavior::getSolverHalfFloatError(std::uint16_t solverIndex) const {
+    return evaluator->getSolverHalfFloatError(solverIndex);
+}
+
+void RBFBehavior::collectSolverInputIndices(std::uint16_t solverIndex, Vector<std::uint16_t>& inputIndices) const {
+    evaluator->collectSolverInputIndices(solverIndex, inputIndices);
+}
+
+ConstArrayView<std::uint16_t> RBFBehavior::getSolverOutputIndices(std::uint16_t solverIndex) const {
+    return evaluator->getSolverOutputIndices(solverIndex);
+}
+
 void RBFBehavior::calculate(ControlsInputInstance* inputs, RBFBehaviorOutputInstance* intermediateOutputs,
                             std::uint16_t lod) const {
     evaluator->calculate(inputs, intermediateOutputs, lod);
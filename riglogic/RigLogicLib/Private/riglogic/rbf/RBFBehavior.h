@@ -23,6 +23,10 @@ class RBFBehavior {
 
         RBFBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const;
         ConstArrayView<std::uint16_t> getSolverIndicesForLOD(std::uint16_t lod) const;
+        bool hasIndependentSolvers() const;
+        float getSolverHalfFloatError(std::uint16_t solverIndex) const;
+        void collectSolverInputIndices(std::uint16_t solverIndex, Vector<std::uint16_t>& inputIndices) const;
+        ConstArrayView<std::uint16_t> getSolverOutputIndices(std::uint16_t solverIndex) const;
         void calculate(ControlsInputInstance* inputs, RBFBehaviorOutputInstance* intermediateOutputs, std::uint16_t lod) const;
         void calculate(ControlsInputInstance* inputs,
                        RBFBehaviorOutputInstance* intermediateOutputs,
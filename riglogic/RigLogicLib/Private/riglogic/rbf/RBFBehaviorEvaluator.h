@@ -19,6 +19,15 @@ class RBFBehaviorEvaluator {
     public:
         virtual RBFBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const = 0;
         virtual ConstArrayView<std::uint16_t> getSolverIndicesForLOD(std::uint16_t lod) const = 0;
+        // Whether solvers neither write the same controls nor read controls written by other solvers,
+        // i.e. whether they may be calculated concurrently (each with its own intermediate outputs)
+        virtual bool hasIndependentSolvers() const = 0;
+        // Largest error in pose weights introduced by storing solver values as half floats (zero if stored as floats)
+        virtual float getSolverHalfFloatError(std::uint16_t solverIndex) const = 0;
+        // Append the indices of the controls read by the given solver (duplicates are allowed)
+        virtual void collectSolverInputIndices(std::uint16_t solverIndex, Vector<std::uint16_t>& inputIndices) const = 0;
+        // Indices of the controls written by the given solver
+        virtual ConstArrayView<std::uint16_t> getSolverOutputIndices(std::uint16_t solverIndex) const = 0;
         virtual void calculate(ControlsInputInstance* inputs, RBFBehaviorOutputInstance* intermediateOutputs,
                                std::uint16_t lod) const = 0;
         virtual void calculate(ControlsInputInstance* inputs,
@@ -16,6 +16,21 @@ ConstArrayView<std::uint16_t> RBFBehaviorNullEvaluator::getSolverIndicesForLOD(s
     return {};
 }
 
+bool RBFBehaviorNullEvaluator::hasIndependentSolvers() const {
+    return true;
+}
+
+float RBFBehaviorNullEvaluator::getSolverHalfFloatError(std::uint16_t  /*unused*/) const {
+    return 0.0f;
+}
+
+void RBFBehaviorNullEvaluator::collectSolverInputIndices(std::uint16_t  /*unused*/, Vector<std::uint16_t>&  /*unused*/) const {
+}
+
+ConstArrayView<std::uint16_t> RBFBehaviorNullEvaluator::getSolverOutputIndices(std::uint16_t  /*unused*/) const {
+    return {};
+}
+
 void RBFBehaviorNullEvaluator::calculate(ControlsInputInstance*  /*unused*/, RBFBehaviorOutputInstance*  /*unused*/,
                                          std::uint16_t  /*unused*/) const {
 }
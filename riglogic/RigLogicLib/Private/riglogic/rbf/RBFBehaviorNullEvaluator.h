@@ -14,6 +14,10 @@ class RBFBehaviorNullEvaluator : public RBFBehaviorEvaluator {
     public:
         RBFBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override;
         ConstArrayView<std::uint16_t> getSolverIndicesForLOD(std::uint16_t  /*unused*/) const override;
+        bool hasIndependentSolvers() const override;
+        float getSolverHalfFloatError(std::uint16_t  /*unused*/) const override;
+        void collectSolverInputIndices(std::uint16_t  /*unused*/, Vector<std::uint16_t>&  /*unused*/) const override;
+        ConstArrayView<std::uint16_t> getSolverOutputIndices(std::uint16_t  /*unused*/) const override;
         void calculate(ControlsInputInstance*  /*unused*/, RBFBehaviorOutputInstance*  /*unused*/,
                        std::uint16_t  /*unused*/) const override;
         void calculate(ControlsInputInstance*  /*unused*/,
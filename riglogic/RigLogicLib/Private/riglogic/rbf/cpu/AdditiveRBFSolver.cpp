@@ -2,6 +2,18 @@
 
 #include "riglogic/rbf/cpu/AdditiveRBFSolver.h"
 
+#include "riglogic/rbf/cpu/RBFSolverKernel.h"
+#include "riglogic/utils/Extd.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <numeric>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
 namespace rl4 {
 
 AdditiveRBFSolver::AdditiveRBFSolver(MemoryResource* memRes) : RBFSolver(memRes) {
@@ -14,11 +26,12 @@ RBFSolverType AdditiveRBFSolver::getSolverType() const {
     return RBFSolverType::Additive;
 }
 
-void AdditiveRBFSolver::solve(ArrayView<float> input, ArrayView<float>  /*unused*/, ArrayView<float> outputWeights) const {
-    convertInput(input);
-    getDistanceWeight(targets, input, outputWeights, radius);
-
-    normalizeAndCutOff(outputWeights);
+void AdditiveRBFSolver::getPoseWeights(ConstArrayView<float> input,
+                                       ArrayView<float>  /*unused*/,
+                                       ArrayView<float> weights) const {
+    getDistanceWeights(input, weights);
+    const float sumWeight = std::accumulate(weights.begin(), extd::advanced(weights.begin(), targets.targetCount), 0.0f);
+    rbf::cpu::normalizeAndCutOff<trimd::scalar::F256, float>(*this, sumWeight, weights);
 }
 
 }  // namespace rl4
@@ -12,7 +12,11 @@ class AdditiveRBFSolver : public RBFSolver {
         AdditiveRBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes);
 
         RBFSolverType getSolverType() const override;
-        void solve(ArrayView<float> input, ArrayView<float> intermediateWeights, ArrayView<float> outputWeights) const override;
+
+    protected:
+        void getPoseWeights(ConstArrayView<float> input,
+                            ArrayView<float> intermediateWeights,
+                            ArrayView<float> weights) const override;
 };
 
 }  // namespace rl4
@@ -9,11 +9,20 @@
 #include "riglogic/rbf/cpu/AdditiveRBFSolver.h"
 #include "riglogic/rbf/cpu/InterpolativeRBFSolver.h"
 #include "riglogic/rbf/cpu/CPURBFBehaviorOutputInstance.h"
+#include "riglogic/rbf/cpu/PoseOutputMatrix.h"
 #include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/rbf/cpu/RBFSolverKernel.h"
+#include "riglogic/rbf/cpu/RBFTargets.h"
 #include "riglogic/types/LODSpec.h"
+#include "riglogic/types/StorageLayout.h"
+#include "riglogic/utils/Extd.h"
+#include "riglogic/utils/Macros.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <type_traits>
 
 namespace rl4 {
 
@@ -21,23 +30,38 @@ namespace rbf {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T, typename TF256, typename TF128>
 class Evaluator : public RBFBehaviorEvaluator {
     public:
-        using SolverVectorType = Vector<RBFSolver::Pointer>;
+        // Solvers are restored with the memory resource of this vector, so it must be one that honors the alignment of
+        // target blocks even if no memory resource was given (the default one would fall back to plain malloc)
+        using SolverVectorType = AlignedVector<RBFSolver::Pointer>;
 
         struct Accessor;
         friend Accessor;
 
+    private:
+        using GroupCalculator = void (Evaluator::*)(ConstArrayView<std::uint16_t>,
+                                                    ArrayView<float>,
+                                                    ArrayView<float>,
+                                                    ArrayView<float>,
+                                                    ArrayView<float>) const;
+
+        // Solvers of the same configuration (within a LOD), evaluated by the same specialized kernel
+        struct SolverGroup {
+            GroupCalculator calculate;
+            std::size_t offset;
+            std::size_t count;
+        };
+
     public:
         Evaluator(LODSpec<std::uint16_t>&& lods_,
                   SolverVectorType&& solvers_,
                   Matrix<std::uint16_t>&& solverRawControlInputIndices_,
                   Matrix<std::uint16_t>&& solverRawControlOutputIndices_,
-                  Matrix<std::uint16_t>&& solverPoseIndices_,
-                  Matrix<std::uint16_t>&& poseInputControlIndices_,
-                  Matrix<std::uint16_t>&& poseOutputControlIndices_,
-                  Matrix<float>&& poseOutputControlWeights_,
+                  PoseOutputMatrix&& poseOutputs_,
                   std::uint16_t maximumInputCount_,
                   std::uint16_t maxTargetCount_,
                   OutputInstance::Factory&& instanceFactory_) :
@@ -45,13 +69,15 @@ class Evaluator : public RBFBehaviorEvaluator {
             solvers{std::move(solvers_)},
             solverRawControlInputIndices{std::move(solverRawControlInputIndices_)},
             solverRawControlOutputIndices{std::move(solverRawControlOutputIndices_)},
-            solverPoseIndices{std::move(solverPoseIndices_)},
-            poseInputControlIndices{std::move(poseInputControlIndices_)},
-            poseOutputControlIndices{std::move(poseOutputControlIndices_)},
-            poseOutputControlWeights{std::move(poseOutputControlWeights_)},
+            poseOutputs{std::move(poseOutputs_)},
             instanceFactory{std::move(instanceFactory_)},
             maximumInputCount{maximumInputCount_},
-            maxTargetCount{maxTargetCount_} {
+            maxTargetCount{maxTargetCount_},
+            independentSolvers{determineSolverIndependence()},
+            solverCalculators{solvers.get_allocator()},
+            solverGroupsPerLOD{solvers.get_allocator()},
+            groupedSolverIndicesPerLOD{solvers.get_allocator()} {
+            groupSolvers();
         }
 
         RBFBehaviorOutputInstance::Pointer createInstance(MemoryResource* instanceMemRes) const override {
@@ -63,63 +89,43 @@ class Evaluator : public RBFBehaviorEvaluator {
             return lods.indicesPerLOD[lod];
         }
 
-        void calculate(std::uint16_t solverIndex,
-                       ArrayView<float> rawControls,
-                       ArrayView<float> inputBuffer,
-                       ArrayView<float> intermediateWeightsBuffer,
-                       ArrayView<float> outputWeightsBuffer) const {
+        bool hasIndependentSolvers() const override {
+            return independentSolvers;
+        }
 
+        float getSolverHalfFloatError(std::uint16_t solverIndex) const override {
             assert(solverIndex < solvers.size());
-            const auto& rawControlInputIndices = solverRawControlInputIndices[solverIndex];
-            const auto& rawControlOutputIndices = solverRawControlOutputIndices[solverIndex];
-            const auto rawControlInputCount = rawControlInputIndices.size();
-            inputBuffer = inputBuffer.subview(0u, rawControlInputCount);
-
-            const auto& poseIndices = solverPoseIndices[solverIndex];
-            const auto poseCount = poseIndices.size();
-            intermediateWeightsBuffer = intermediateWeightsBuffer.subview(0u, poseCount);
-            outputWeightsBuffer = outputWeightsBuffer.subview(0u, poseCount);
-
-            for (const auto outputIndex : rawControlOutputIndices) {
-                rawControls[outputIndex] = 0.0f;
-            }
+            return solvers[solverIndex]->getHalfFloatError();
+        }
 
-            for (std::uint16_t i = {}; i < rawControlInputCount; ++i) {
-                const std::uint16_t ri = rawControlInputIndices[i];
-                inputBuffer[i] = rawControls[ri];
+        void collectSolverInputIndices(std::uint16_t solverIndex, Vector<std::uint16_t>& inputIndices) const override {
+            assert(solverIndex < solverRawControlInputIndices.size());
+            const auto& rawControlInputIndices = solverRawControlInputIndices[solverIndex];
+            inputIndices.insert(inputIndices.end(), rawControlInputIndices.begin(), rawControlInputIndices.end());
+            // Pose weights are also scaled by the pose input controls
+            if (solverIndex < poseOutputs.getSolverCount()) {
+                const auto poseInputControlIndices = poseOutputs.getInputControlIndices(solverIndex);
+                inputIndices.insert(inputIndices.end(), poseInputControlIndices.begin(), poseInputControlIndices.end());
             }
+        }
 
-            solvers[solverIndex]->solve(inputBuffer, intermediateWeightsBuffer, outputWeightsBuffer);
-
-            for (std::uint16_t i = {}; i < poseCount; ++i) {
-                const std::uint16_t pi = poseIndices[i];
-                const auto& inputControlIndices = poseInputControlIndices[pi];
-                const auto& outputControlIndices = poseOutputControlIndices[pi];
-                const auto& outputControlWeights = poseOutputControlWeights[pi];
-                assert(outputControlIndices.size() == outputControlWeights.size());
-
-                float inputWeight = 1.0f;
-                for (const auto inputControlIndex : inputControlIndices) {
-                    inputWeight *= rawControls[inputControlIndex];
-                }
-
-                for (std::uint16_t ci = 0u; ci < outputControlIndices.size(); ci++) {
-                    rawControls[outputControlIndices[ci]] += outputControlWeights[ci] * outputWeightsBuffer[i] * inputWeight;
-                }
-            }
+        ConstArrayView<std::uint16_t> getSolverOutputIndices(std::uint16_t solverIndex) const override {
+            assert(solverIndex < solverRawControlOutputIndices.size());
+            return ConstArrayView<std::uint16_t>{solverRawControlOutputIndices[solverIndex]};
         }
 
         void calculate(ControlsInputInstance* inputs, RBFBehaviorOutputInstance* intermediateOutputs,
                        std::uint16_t lod) const override {
             assert(lod < lods.indicesPerLOD.size());
-            const auto& solverIndices = lods.indicesPerLOD[lod];
+            const auto& solverGroups = solverGroupsPerLOD[lod];
+            const auto& groupedSolverIndices = groupedSolverIndicesPerLOD[lod];
             auto rawControls = inputs->getInputBuffer();
             auto inputBuffer = static_cast<OutputInstance*>(intermediateOutputs)->getInputBuffer();
             auto intermediateWeightsBuffer = static_cast<OutputInstance*>(intermediateOutputs)->getIntermediateWeightsBuffer();
             auto outputWeightsBuffer = static_cast<OutputInstance*>(intermediateOutputs)->getOutputWeightsBuffer();
-            for (const auto solverIndex : solverIndices) {
-                assert(solverIndex < solvers.size());
-                calculate(solverIndex, rawControls, inputBuffer, intermediateWeightsBuffer, outputWeightsBuffer);
+            for (const auto& group : solverGroups) {
+                const ConstArrayView<std::uint16_t> solverIndices{groupedSolverIndices.data() + group.offset, group.count};
+                (this->*group.calculate)(solverIndices, rawControls, inputBuffer, intermediateWeightsBuffer, outputWeightsBuffer);
             }
         }
 
@@ -134,7 +140,9 @@ class Evaluator : public RBFBehaviorEvaluator {
             auto inputBuffer = static_cast<OutputInstance*>(intermediateOutputs)->getInputBuffer();
             auto intermediateWeightsBuffer = static_cast<OutputInstance*>(intermediateOutputs)->getIntermediateWeightsBuffer();
             auto outputWeightsBuffer = static_cast<OutputInstance*>(intermediateOutputs)->getOutputWeightsBuffer();
-            calculate(solverIndex, rawControls, inputBuffer, intermediateWeightsBuffer, outputWeightsBuffer);
+            const ConstArrayView<std::uint16_t> solverIndices{&solverIndex, 1ul};
+            (this->*solverCalculators[solverIndex])(solverIndices, rawControls, inputBuffer, intermediateWeightsBuffer,
+                                                    outputWeightsBuffer);
         }
 
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override {
@@ -154,15 +162,18 @@ class Evaluator : public RBFBehaviorEvaluator {
                     solvers.push_back(UniqueInstance<InterpolativeRBFSolver, RBFSolver>::with(memRes).create(memRes));
                 }
                 solvers[i]->load(archive);
+                // Solvers dumped by variants storing half floats are restored as floats by those which do not
+                if (!std::is_same<T, std::uint16_t>::value && solvers[i]->hasHalfFloatValues()) {
+                    solvers[i]->convertToFloats(HalfFloatConverter{&toHalfFloats, &toFloats}, memRes);
+                }
             }
             archive(solverRawControlInputIndices);
             archive(solverRawControlOutputIndices);
-            archive(solverPoseIndices);
-            archive(poseInputControlIndices);
-            archive(poseOutputControlIndices);
-            archive(poseOutputControlWeights);
+            archive(poseOutputs);
             archive(maximumInputCount);
             archive(maxTargetCount);
+            independentSolvers = determineSolverIndependence();
+            groupSolvers();
         }
 
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override {
@@ -176,28 +187,243 @@ class Evaluator : public RBFBehaviorEvaluator {
             }
             archive(solverRawControlInputIndices);
             archive(solverRawControlOutputIndices);
-            archive(solverPoseIndices);
-            archive(poseInputControlIndices);
-            archive(poseOutputControlIndices);
-            archive(poseOutputControlWeights);
+            archive(poseOutputs);
             archive(maximumInputCount);
             archive(maxTargetCount);
         }
 
+    private:
+        template<class TKernel>
+        FORCE_INLINE void calculate(std::uint16_t solverIndex,
+                                    ArrayView<float> rawControls,
+                                    ArrayView<float> inputBuffer,
+                                    ArrayView<float> intermediateWeightsBuffer,
+                                    ArrayView<float> outputWeightsBuffer) const {
+
+            assert(solverIndex < solvers.size());
+            const auto& rawControlInputIndices = solverRawControlInputIndices[solverIndex];
+            const auto& rawControlOutputIndices = solverRawControlOutputIndices[solverIndex];
+            const auto rawControlInputCount = rawControlInputIndices.size();
+            inputBuffer = inputBuffer.subview(0u, rawControlInputCount);
+
+            const auto& solver = *solvers[solverIndex];
+            // Kernels operate on whole target blocks
+            const auto paddedPoseCount = RBFTargets::getPaddedCount(solver.getTargets().targetCount);
+            intermediateWeightsBuffer = intermediateWeightsBuffer.subview(0u, paddedPoseCount);
+            outputWeightsBuffer = outputWeightsBuffer.subview(0u, paddedPoseCount);
+
+            for (const auto outputIndex : rawControlOutputIndices) {
+                rawControls[outputIndex] = 0.0f;
+            }
+
+            for (std::uint16_t i = {}; i < rawControlInputCount; ++i) {
+                const std::uint16_t ri = rawControlInputIndices[i];
+                inputBuffer[i] = rawControls[ri];
+            }
+
+            TKernel::solve(solver, inputBuffer, intermediateWeightsBuffer, outputWeightsBuffer);
+
+            poseOutputs.applyInputControls(solverIndex, rawControls, outputWeightsBuffer);
+            poseOutputs.calculate<TF256>(solverIndex, outputWeightsBuffer, rawControls);
+        }
+
+
+        template<typename TValue, RBFSolverType TSolverType, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType,
+                 TwistAxis TTwistAxis>
+        void calculateGroup(ConstArrayView<std::uint16_t> solverIndices,
+                            ArrayView<float> rawControls,
+                            ArrayView<float> inputBuffer,
+                            ArrayView<float> intermediateWeightsBuffer,
+                            ArrayView<float> outputWeightsBuffer) const {
+            using Kernel = RBFSolverKernel<TF256, TValue, TSolverType, TDistanceMethod, TFunctionType, TTwistAxis>;
+            for (const auto solverIndex : solverIndices) {
+                calculate<Kernel>(solverIndex, rawControls, inputBuffer, intermediateWeightsBuffer, outputWeightsBuffer);
+            }
+        }
+
+        template<typename TValue, RBFSolverType TSolverType, RBFDistanceMethod TDistanceMethod, TwistAxis TTwistAxis>
+        static GroupCalculator selectGroupCalculator(RBFFunctionType weightFunction) {
+            switch (weightFunction) {
+                case RBFFunctionType::Gaussian:
+                    return &Evaluator::calculateGroup<TValue, TSolverType, TDistanceMethod, RBFFunctionType::Gaussian, TTwistAxis>;
+                case RBFFunctionType::Exponential:
+                    return &Evaluator::calculateGroup<TValue, TSolverType, TDistanceMethod, RBFFunctionType::Exponential, TTwistAxis>;
+                case RBFFunctionType::Linear:
+                    return &Evaluator::calculateGroup<TValue, TSolverType, TDistanceMethod, RBFFunctionType::Linear, TTwistAxis>;
+                case RBFFunctionType::Cubic:
+                    return &Evaluator::calculateGroup<TValue, TSolverType, TDistanceMethod, RBFFunctionType::Cubic, TTwistAxis>;
+                default:
+                case RBFFunctionType::Quintic:
+                    return &Evaluator::calculateGroup<TValue, TSolverType, TDistanceMethod, RBFFunctionType::Quintic, TTwistAxis>;
+            }
+        }
+
+        template<typename TValue, RBFSolverType TSolverType, RBFDistanceMethod TDistanceMethod>
+        static GroupCalculator selectGroupCalculator(const RBFSolver& solver) {
+            switch (solver.getTwistAxis()) {
+                default:
+                case TwistAxis::X:
+                    return selectGroupCalculator<TValue, TSolverType, TDistanceMethod, TwistAxis::X>(solver.getWeightFunction());
+                case TwistAxis::Y:
+                    return selectGroupCalculator<TValue, TSolverType, TDistanceMethod, TwistAxis::Y>(solver.getWeightFunction());
+                case TwistAxis::Z:
+                    return selectGroupCalculator<TValue, TSolverType, TDistanceMethod, TwistAxis::Z>(solver.getWeightFunction());
+            }
+        }
+
+        template<typename TValue, RBFSolverType TSolverType>
+        static GroupCalculator selectGroupCalculator(const RBFSolver& solver) {
+            // The twist axis is relevant only for swing and twist angles, so it is not distinguished otherwise
+            switch (solver.getDistanceMethod()) {
+                case RBFDistanceMethod::Euclidean:
+                    return selectGroupCalculator<TValue, TSolverType, RBFDistanceMethod::Euclidean, TwistAxis::X>(solver.getWeightFunction());
+                case RBFDistanceMethod::Quaternion:
+                    return selectGroupCalculator<TValue, TSolverType, RBFDistanceMethod::Quaternion, TwistAxis::X>(solver.getWeightFunction());
+                case RBFDistanceMethod::TwistAngle:
+                    return selectGroupCalculator<TValue, TSolverType, RBFDistanceMethod::TwistAngle>(solver);
+                default:
+                case RBFDistanceMethod::SwingAngle:
+                    return selectGroupCalculator<TValue, TSolverType, RBFDistanceMethod::SwingAngle>(solver);
+            }
+        }
+
+        template<typename TValue>
+        static GroupCalculator selectGroupCalculator(const RBFSolver& solver) {
+            if (solver.getSolverType() == RBFSolverType::Interpolative) {
+                return selectGroupCalculator<TValue, RBFSolverType::Interpolative>(solver);
+            }
+            return selectGroupCalculator<TValue, RBFSolverType::Additive>(solver);
+        }
+
+        // Portable conversions, as evaluators which do not store half floats may not have the instructions for them
+        static void toHalfFloats(ConstArrayView<float> source, ArrayView<std::uint16_t> destination) {
+            std::transform(source.begin(), source.end(), destination.begin(), floatToHalf);
+        }
+
+        static void toFloats(ConstArrayView<std::uint16_t> source, ArrayView<float> destination) {
+            std::transform(source.begin(), source.end(), destination.begin(), halfToFloat);
+        }
+
+        // Only evaluators storing values as half floats (T) may have solvers with half float values, though some of their
+        // solvers may still keep floats (see RBFSolver::convertToHalfFloats)
+        static GroupCalculator selectGroupCalculator(const RBFSolver& solver) {
+            if (solver.hasHalfFloatValues()) {
+                return selectGroupCalculator<T>(solver);
+            }
+            return selectGroupCalculator<float>(solver);
+        }
+
+        // Not serialized, recreated from the solvers after loading
+        void groupSolvers() {
+            solverCalculators.clear();
+            solverCalculators.reserve(solvers.size());
+            for (const auto& solver : solvers) {
+                solverCalculators.push_back(selectGroupCalculator(*solver));
+            }
+
+            auto memRes = solvers.get_allocator().getMemoryResource();
+            solverGroupsPerLOD.clear();
+            solverGroupsPerLOD.resize(lods.indicesPerLOD.size());
+            groupedSolverIndicesPerLOD.clear();
+            groupedSolverIndicesPerLOD.resize(lods.indicesPerLOD.size());
+            for (std::size_t lod = {}; lod < lods.indicesPerLOD.size(); ++lod) {
+                auto& solverGroups = solverGroupsPerLOD[lod];
+                Matrix<std::uint16_t> groupSolverIndices{memRes};
+                for (const auto solverIndex : lods.indicesPerLOD[lod]) {
+                    const auto calculator = solverCalculators[solverIndex];
+                    // Solvers may be reordered only if they do not depend on each other's outputs,
+                    // otherwise only consecutive solvers of the same configuration are grouped together
+                    auto first = solverGroups.begin();
+                    if (!independentSolvers && !solverGroups.empty()) {
+                        first = extd::advanced(solverGroups.begin(), solverGroups.size() - 1ul);
+                    }
+                    auto it = std::find_if(first, solverGroups.end(), [calculator](const SolverGroup& group) {
+                            return group.calculate == calculator;
+                        });
+                    if (it == solverGroups.end()) {
+                        solverGroups.push_back(SolverGroup{calculator, {}, {}});
+                        groupSolverIndices.emplace_back();
+                        it = extd::advanced(solverGroups.begin(), solverGroups.size() - 1ul);
+                    }
+                    groupSolverIndices[static_cast<std::size_t>(it - solverGroups.begin())].push_back(solverIndex);
+                }
+
+                auto& groupedSolverIndices = groupedSolverIndicesPerLOD[lod];
+                for (std::size_t gi = {}; gi < solverGroups.size(); ++gi) {
+                    solverGroups[gi].offset = groupedSolverIndices.size();
+                    solverGroups[gi].count = groupSolverIndices[gi].size();
+                    groupedSolverIndices.insert(groupedSolverIndices.end(),
+                                                groupSolverIndices[gi].begin(),
+                                                groupSolverIndices[gi].end());
+                }
+            }
+        }
+
+        bool determineSolverIndependence() const {
+            std::size_t controlCount = {};
+            auto includeControls = [&controlCount](ConstArrayView<std::uint16_t> controlIndices) {
+                    for (const auto controlIndex : controlIndices) {
+                        controlCount = std::max(controlCount, static_cast<std::size_t>(controlIndex) + 1ul);
+                    }
+                };
+            for (const auto& controlIndices : solverRawControlInputIndices) {
+                includeControls(controlIndices);
+            }
+            for (const auto& controlIndices : solverRawControlOutputIndices) {
+                includeControls(controlIndices);
+            }
+            for (std::size_t si = {}; si < poseOutputs.getSolverCount(); ++si) {
+                includeControls(poseOutputs.getInputControlIndices(si));
+            }
+
+            constexpr auto noSolver = std::numeric_limits<std::size_t>::max();
+            Vector<std::size_t> controlWriters{controlCount, noSolver, solvers.get_allocator().getMemoryResource()};
+            for (std::size_t si = {}; si < solverRawControlOutputIndices.size(); ++si) {
+                for (const auto controlIndex : solverRawControlOutputIndices[si]) {
+                    if ((controlWriters[controlIndex] != noSolver) && (controlWriters[controlIndex] != si)) {
+                        return false;
+                    }
+                    controlWriters[controlIndex] = si;
+                }
+            }
+
+            auto isWrittenByOtherSolver = [&controlWriters, noSolver](std::uint16_t controlIndex, std::size_t si) {
+                    return (controlWriters[controlIndex] != noSolver) && (controlWriters[controlIndex] != si);
+                };
+            for (std::size_t si = {}; si < solverRawControlInputIndices.size(); ++si) {
+                for (const auto controlIndex : solverRawControlInputIndices[si]) {
+                    if (isWrittenByOtherSolver(controlIndex, si)) {
+                        return false;
+                    }
+                }
+            }
+            for (std::size_t si = {}; si < poseOutputs.getSolverCount(); ++si) {
+                for (const auto controlIndex : poseOutputs.getInputControlIndices(si)) {
+                    if (isWrittenByOtherSolver(controlIndex, si)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
     private:
         LODSpec<std::uint16_t> lods;
         SolverVectorType solvers;
         Matrix<std::uint16_t> solverRawControlInputIndices;
         Matrix<std::uint16_t> solverRawControlOutputIndices;
-        Matrix<std::uint16_t> solverPoseIndices;
-        Matrix<std::uint16_t> poseInputControlIndices;
-        Matrix<std::uint16_t> poseOutputControlIndices;
-        Matrix<float> poseOutputControlWeights;
+        PoseOutputMatrix poseOutputs;
         OutputInstance::Factory instanceFactory;
         std::uint16_t maximumInputCount;
         std::uint16_t maxTargetCount;
+        bool independentSolvers;
+        Vector<GroupCalculator> solverCalculators;
+        Matrix<SolverGroup> solverGroupsPerLOD;
+        Matrix<std::uint16_t> groupedSolverIndicesPerLOD;
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace cpu
 
 }  // namespace rbf
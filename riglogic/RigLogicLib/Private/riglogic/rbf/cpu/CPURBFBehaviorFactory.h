@@ -6,7 +6,10 @@
 #include "riglogic/rbf/RBFBehaviorEvaluator.h"
 #include "riglogic/rbf/cpu/CPURBFBehaviorEvaluator.h"
 #include "riglogic/rbf/cpu/CPURBFBehaviorOutputInstance.h"
+#include "riglogic/rbf/cpu/PoseOutputMatrix.h"
 #include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/rbf/cpu/RBFTargets.h"
+#include "riglogic/riglogic/Configuration.h"
 #include "riglogic/types/Aliases.h"
 #include "riglogic/types/bpcm/Optimizer.h"
 #include "riglogic/types/LODSpec.h"
@@ -14,17 +17,23 @@
 
 #include <tdm/Ang.h>
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
 namespace rl4 {
 
 namespace rbf {
 
 namespace cpu {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename T, typename TF256, typename TF128>
 class Factory {
     public:
         static RBFBehaviorEvaluator::Pointer create(const dna::Reader* reader, MemoryResource* memRes) {
-            Vector<RBFSolver::Pointer> solvers{memRes};
+            typename Evaluator<T, TF256, TF128>::SolverVectorType solvers{memRes};
             std::uint16_t maximumInputCount{};
             std::uint16_t maximumTargetCount{};
             Matrix<std::uint16_t> solverRawControlInputIndices{memRes};
@@ -33,6 +42,7 @@ class Factory {
             Matrix<std::uint16_t> poseInputControlIndices{memRes};
             Matrix<std::uint16_t> poseOutputControlIndices{memRes};
             Matrix<float> poseOutputControlWeights{memRes};
+            PoseOutputMatrix poseOutputs{memRes};
 
             auto instanceFactory = [](std::uint16_t maxInputCount, std::uint16_t maxTargetCount, MemoryResource* instanceMemRes) {
                     using OutputInstancePointer = UniqueInstance<OutputInstance, RBFBehaviorOutputInstance>;
@@ -45,10 +55,7 @@ class Factory {
                                       std::move(solvers),
                                       std::move(solverRawControlInputIndices),
                                       std::move(solverRawControlOutputIndices),
-                                      std::move(solverPoseIndices),
-                                      std::move(poseInputControlIndices),
-                                      std::move(poseOutputControlIndices),
-                                      std::move(poseOutputControlWeights),
+                                      std::move(poseOutputs),
                                       maximumInputCount,
                                       maximumTargetCount,
                                       std::move(instanceFactory));
@@ -116,7 +123,28 @@ class Factory {
                 recipe.targetValues = reader->getRBFSolverRawControlValues(solverIndex);
                 recipe.targetScales = ConstArrayView<float>{targetScales.data(), targetCount};
 
+                // Large solvers may have their targets reordered so that nearby targets share target blocks, in which case
+                // pose indices (and thus pose outputs) are permuted along with the target values and scales
+                const auto targetOrder = RBFSolver::getTargetOrder(recipe, memRes);
+                if (!targetOrder.empty()) {
+                    const auto controlCount = recipe.rawControlCount;
+                    Vector<float> orderedScales{targetCount, 0.0f, memRes};
+                    targetValues.resize(recipe.targetValues.size());
+                    auto& orderedPoseIndices = solverPoseIndices[solverIndex];
+                    for (std::uint16_t i = 0u; i < targetCount; ++i) {
+                        const std::uint16_t sourceIndex = targetOrder[i];
+                        orderedPoseIndices[i] = poseIndices[sourceIndex];
+                        orderedScales[i] = recipe.targetScales[sourceIndex];
+                        std::copy_n(extd::advanced(recipe.targetValues.begin(), sourceIndex * controlCount),
+                                    controlCount,
+                                    extd::advanced(targetValues.begin(), i * controlCount));
+                    }
+                    std::copy(orderedScales.begin(), orderedScales.end(), targetScales.begin());
+                    recipe.targetValues = ConstArrayView<float>{targetValues};
+                }
+
                 auto solver = RBFSolver::create(recipe, memRes);
+                convertValues(*solver, static_cast<T*>(nullptr), memRes);
                 solvers.emplace_back(std::move(solver));
             }
             const auto poseCount = reader->getRBFPoseCount();
@@ -132,21 +160,47 @@ class Factory {
                 poseOutputControlIndices[poseIndex].assign(outputControlIndices.begin(), outputControlIndices.end());
                 poseOutputControlWeights[poseIndex].assign(outputControlWeights.begin(), outputControlWeights.end());
             }
+            poseOutputs.assign(solverPoseIndices,
+                               poseInputControlIndices,
+                               poseOutputControlIndices,
+                               poseOutputControlWeights,
+                               memRes);
 
             return factory.create(std::move(lods),
                                   std::move(solvers),
                                   std::move(solverRawControlInputIndices),
                                   std::move(solverRawControlOutputIndices),
-                                  std::move(solverPoseIndices),
-                                  std::move(poseInputControlIndices),
-                                  std::move(poseOutputControlIndices),
-                                  std::move(poseOutputControlWeights),
+                                  std::move(poseOutputs),
                                   maximumInputCount,
                                   maximumTargetCount,
                                   std::move(instanceFactory));
         }
 
     private:
+        // Value arrays are padded to whole target blocks, which span exactly one SIMD register
+        static void toHalfFloats(ConstArrayView<float> source, ArrayView<std::uint16_t> destination) {
+            assert(source.size() == destination.size());
+            assert(source.size() % TF256::size() == 0ul);
+            for (std::size_t i = {}; i < source.size(); i += TF256::size()) {
+                TF256::fromAlignedSource(source.data() + i).alignedStore(destination.data() + i);
+            }
+        }
+
+        static void toFloats(ConstArrayView<std::uint16_t> source, ArrayView<float> destination) {
+            assert(source.size() == destination.size());
+            assert(source.size() % TF256::size() == 0ul);
+            for (std::size_t i = {}; i < source.size(); i += TF256::size()) {
+                TF256::fromAlignedSource(source.data() + i).alignedStore(destination.data() + i);
+            }
+        }
+
+        static void convertValues(RBFSolver&  /*unused*/, float*  /*unused*/, MemoryResource*  /*unused*/) {
+        }
+
+        static void convertValues(RBFSolver& solver, std::uint16_t*  /*unused*/, MemoryResource* memRes) {
+            solver.convertToHalfFloats(HalfFloatConverter{&toHalfFloats, &toFloats}, memRes);
+        }
+
         static LODSpec<std::uint16_t> computeLODs(const dna::RBFBehaviorReader* reader, MemoryResource* memRes) {
             LODSpec<std::uint16_t> lods{memRes};
             const auto lodCount = reader->getLODCount();
@@ -161,6 +215,17 @@ class Factory {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
+// Instruction set specific instantiations of the above, each defined in its own translation unit
+// (CPURBFBehaviorFactory<ISA>.cpp), where they are compiled for that instruction set (see system/simd/SIMD.h)
+RBFBehaviorEvaluator::Pointer createSSEEvaluator(const dna::Reader* reader,
+                                                 FloatingPointType floatingPointType,
+                                                 MemoryResource* memRes);
+RBFBehaviorEvaluator::Pointer createAVXEvaluator(const dna::Reader* reader,
+                                                 FloatingPointType floatingPointType,
+                                                 MemoryResource* memRes);
+
 }  // namespace cpu
 
 }  // namespace rbf
@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX2
+#include "trimd/Isolate.h"
+
+#include "riglogic/rbf/cpu/CPURBFBehaviorFactory.h"
+
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+namespace rbf {
+
+namespace cpu {
+
+#ifdef RL_BUILD_WITH_AVX
+// AVX variant (AVX2 and FMA, and F16C for half floats)
+RBFBehaviorEvaluator::Pointer createAVXEvaluator(const dna::Reader* reader,
+                                                 FloatingPointType floatingPointType,
+                                                 MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using ISAFactory = Factory<std::uint16_t, trimd::avx::F256, trimd::sse::F128>;
+            return ISAFactory::create(reader, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using ISAFactory = Factory<float, trimd::avx::F256, trimd::sse::F128>;
+    return ISAFactory::create(reader, memRes);
+}
+#endif  // RL_BUILD_WITH_AVX
+
+}  // namespace cpu
+
+}  // namespace rbf
+
+}  // namespace rl4
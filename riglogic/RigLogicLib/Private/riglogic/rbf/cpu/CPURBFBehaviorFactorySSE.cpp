@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/rbf/cpu/CPURBFBehaviorFactory.h"
+
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+namespace rbf {
+
+namespace cpu {
+
+#ifdef RL_BUILD_WITH_SSE
+// SSE variant (SSE2, and F16C for half floats)
+RBFBehaviorEvaluator::Pointer createSSEEvaluator(const dna::Reader* reader,
+                                                 FloatingPointType floatingPointType,
+                                                 MemoryResource* memRes) {
+    RL_UNUSED(floatingPointType);
+    #ifdef TRIMD_ENABLE_F16C
+        if (floatingPointType == FloatingPointType::HalfFloat) {
+            using ISAFactory = Factory<std::uint16_t, trimd::sse::F256, trimd::sse::F128>;
+            return ISAFactory::create(reader, memRes);
+        }
+    #endif  // TRIMD_ENABLE_F16C
+    using ISAFactory = Factory<float, trimd::sse::F256, trimd::sse::F128>;
+    return ISAFactory::create(reader, memRes);
+}
+#endif  // RL_BUILD_WITH_SSE
+
+}  // namespace cpu
+
+}  // namespace rbf
+
+}  // namespace rl4
@@ -2,6 +2,8 @@
 
 #include "riglogic/rbf/cpu/CPURBFBehaviorOutputInstance.h"
 
+#include "riglogic/rbf/cpu/RBFTargets.h"
+
 namespace rl4 {
 
 namespace rbf {
@@ -10,8 +12,9 @@ namespace cpu {
 
 OutputInstance::OutputInstance(std::uint16_t maximumInputCount, std::uint16_t maximumTargetCount, MemoryResource* memRes) :
     inputBuffer{maximumInputCount, {}, memRes},
-    intermediateWeightsBuffer{maximumTargetCount, {}, memRes},
-    outputWeightsBuffer{maximumTargetCount, {}, memRes} {
+    // Padded to whole target blocks, as solver kernels operate on those
+    intermediateWeightsBuffer{RBFTargets::getPaddedCount(maximumTargetCount), {}, memRes},
+    outputWeightsBuffer{RBFTargets::getPaddedCount(maximumTargetCount), {}, memRes} {
 }
 
 ArrayView<float> OutputInstance::getInputBuffer() {
@@ -0,0 +1,233 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/rbf/cpu/RBFTargets.h"
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace rl4 {
+
+namespace rbf {
+
+namespace cpu {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+// Each distance functor computes the distances between the input and all targets of a single target block,
+// one target per SIMD lane, so TFVec must be exactly as wide as a target block. Blocks may be stored as floats or
+// as half floats.
+template<typename TFVec, RBFDistanceMethod TDistanceMethod>
+struct DistanceMethodFunctor;
+
+template<typename TFVec>
+struct DistanceMethodFunctor<TFVec, RBFDistanceMethod::Euclidean> {
+    template<typename T>
+    static FORCE_INLINE TFVec getDistance(const T* block, ConstArrayView<float> input) {
+        TFVec sumSquaredDiff{};
+        for (std::size_t ci = {}; ci < input.size(); ++ci, block += TFVec::size()) {
+            const TFVec diff = TFVec::fromAlignedSource(block) - TFVec{input[ci]};
+            sumSquaredDiff = trimd::fmadd(diff, diff, sumSquaredDiff);
+        }
+        return trimd::sqrt(sumSquaredDiff);
+    }
+
+};
+
+template<typename TFVec>
+struct DistanceMethodFunctor<TFVec, RBFDistanceMethod::Quaternion> {
+    template<typename T>
+    static FORCE_INLINE TFVec getDistance(const T* block, ConstArrayView<float> input) {
+        assert(input.size() % 4ul == 0ul);
+        TFVec sumSquaredArcLength{};
+        for (std::size_t ci = {}; ci < input.size(); ci += 4ul, block += TFVec::size() * 4ul) {
+            TFVec dot = TFVec::fromAlignedSource(block) * TFVec{input[ci]};
+            dot = trimd::fmadd(TFVec::fromAlignedSource(block + TFVec::size()), TFVec{input[ci + 1ul]}, dot);
+            dot = trimd::fmadd(TFVec::fromAlignedSource(block + TFVec::size() * 2ul), TFVec{input[ci + 2ul]}, dot);
+            dot = trimd::fmadd(TFVec::fromAlignedSource(block + TFVec::size() * 3ul), TFVec{input[ci + 3ul]}, dot);
+            // acos saturates above 1.0, so squared dot products exceeding 1.0 (due to rounding) yield zero arc length
+            const TFVec arcLength = trimd::acos(trimd::fmadd(dot * dot, TFVec{2.0f}, TFVec{-1.0f}));
+            sumSquaredArcLength = trimd::fmadd(arcLength, arcLength, sumSquaredArcLength);
+        }
+        return trimd::sqrt(sumSquaredArcLength);
+    }
+
+};
+
+// Swing and twist angles are compared as quaternions, after the inputs are converted
+template<typename TFVec>
+struct DistanceMethodFunctor<TFVec, RBFDistanceMethod::SwingAngle> : DistanceMethodFunctor<TFVec, RBFDistanceMethod::Quaternion> {
+};
+
+template<typename TFVec>
+struct DistanceMethodFunctor<TFVec, RBFDistanceMethod::TwistAngle> : DistanceMethodFunctor<TFVec, RBFDistanceMethod::Quaternion> {
+};
+
+// Weight functions operate on distances premultiplied by the scale derived from the kernel width.
+// Those with compact support are zero for all distances beyond the kernel width.
+template<typename TFVec, RBFFunctionType TFunctionType>
+struct WeightMethodFunctor;
+
+template<typename TFVec>
+struct WeightMethodFunctor<TFVec, RBFFunctionType::Linear> {
+    static constexpr bool hasCompactSupport = true;
+
+    static float getScale(float kernelWidth) {
+        return 1.0f / kernelWidth;
+    }
+
+    static FORCE_INLINE TFVec getWeight(const TFVec& scaledDistance) {
+        const TFVec weight = TFVec{1.0f} - scaledDistance;
+        return weight & (weight > TFVec{});
+    }
+
+};
+
+template<typename TFVec>
+struct WeightMethodFunctor<TFVec, RBFFunctionType::Cubic> {
+    static constexpr bool hasCompactSupport = true;
+
+    static float getScale(float kernelWidth) {
+        return 1.0f / kernelWidth;
+    }
+
+    static FORCE_INLINE TFVec getWeight(const TFVec& scaledDistance) {
+        const TFVec weight = TFVec{1.0f} - scaledDistance * scaledDistance * scaledDistance;
+        return weight & (weight > TFVec{});
+    }
+
+};
+
+template<typename TFVec>
+struct WeightMethodFunctor<TFVec, RBFFunctionType::Quintic> {
+    static constexpr bool hasCompactSupport = true;
+
+    static float getScale(float kernelWidth) {
+        return 1.0f / kernelWidth;
+    }
+
+    static FORCE_INLINE TFVec getWeight(const TFVec& scaledDistance) {
+        const TFVec squared = scaledDistance * scaledDistance;
+        const TFVec weight = TFVec{1.0f} - squared * squared * scaledDistance;
+        return weight & (weight > TFVec{});
+    }
+
+};
+
+template<typename TFVec>
+struct WeightMethodFunctor<TFVec, RBFFunctionType::Gaussian> {
+    static constexpr bool hasCompactSupport = false;
+
+    static float getScale(float kernelWidth) {
+        return 1.0f / (kernelWidth * kernelWidth);
+    }
+
+    static FORCE_INLINE TFVec getWeight(const TFVec& scaledDistance) {
+        return trimd::exp(TFVec{} - scaledDistance);
+    }
+
+};
+
+template<typename TFVec>
+struct WeightMethodFunctor<TFVec, RBFFunctionType::Exponential> {
+    static constexpr bool hasCompactSupport = false;
+
+    static float getScale(float kernelWidth) {
+        return 2.0f / kernelWidth;
+    }
+
+    static FORCE_INLINE TFVec getWeight(const TFVec& scaledDistance) {
+        return trimd::exp(TFVec{} - scaledDistance);
+    }
+
+};
+
+// Evaluates all target blocks, storing only as many results as there are targets (padding lanes are discarded)
+template<typename TFVec, typename TBlockEvaluator>
+FORCE_INLINE void evaluateTargetBlocks(const RBFTargets& targets, ArrayView<float> output, TBlockEvaluator evaluateBlock) {
+    static_assert(TFVec::size() == RBFTargets::blockSize, "Target blocks must span exactly one SIMD register.");
+    assert(output.size() >= targets.targetCount);
+    const std::size_t fullBlockCount = targets.targetCount / TFVec::size();
+    for (std::size_t bi = {}; bi < fullBlockCount; ++bi) {
+        evaluateBlock(targets.getBlock(bi)).unalignedStore(output.data() + bi * TFVec::size());
+    }
+    const std::size_t remainder = targets.targetCount % TFVec::size();
+    if (remainder != 0ul) {
+        alignas(TFVec::alignment()) float buffer[TFVec::size()];
+        evaluateBlock(targets.getBlock(fullBlockCount)).alignedStore(buffer);
+        std::copy(buffer, buffer + remainder, output.data() + fullBlockCount * TFVec::size());
+    }
+}
+
+template<typename TFVec, RBFDistanceMethod TDistanceMethod>
+void getDistances(const RBFTargets& targets, ConstArrayView<float> input, ArrayView<float> distances) {
+    using D = DistanceMethodFunctor<TFVec, TDistanceMethod>;
+    evaluateTargetBlocks<TFVec>(targets, distances, [input](const float* block) {
+            return D::getDistance(block, input);
+        });
+}
+
+template<typename TFVec, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType>
+struct DistanceWeightFunctor {
+    void operator()(const RBFTargets& targets, ConstArrayView<float> input, ArrayView<float> weights, float kernelWidth) const {
+        using D = DistanceMethodFunctor<TFVec, TDistanceMethod>;
+        using W = WeightMethodFunctor<TFVec, TFunctionType>;
+        const TFVec scale{W::getScale(kernelWidth)};
+        evaluateTargetBlocks<TFVec>(targets, weights, [input, &scale](const float* block) {
+                return W::getWeight(D::getDistance(block, input) * scale);
+            });
+    }
+
+};
+
+template<typename TFVec, RBFDistanceMethod TDistanceMethod>
+void getDistanceWeights(RBFFunctionType weightFunction,
+                        const RBFTargets& targets,
+                        ConstArrayView<float> input,
+                        ArrayView<float> weights,
+                        float kernelWidth) {
+    switch (weightFunction) {
+        case RBFFunctionType::Gaussian:
+            return DistanceWeightFunctor<TFVec, TDistanceMethod, RBFFunctionType::Gaussian>{}(targets, input, weights, kernelWidth);
+        case RBFFunctionType::Exponential:
+            return DistanceWeightFunctor<TFVec, TDistanceMethod, RBFFunctionType::Exponential>{}(targets, input, weights,
+                                                                                                  kernelWidth);
+        case RBFFunctionType::Linear:
+            return DistanceWeightFunctor<TFVec, TDistanceMethod, RBFFunctionType::Linear>{}(targets, input, weights, kernelWidth);
+        case RBFFunctionType::Cubic:
+            return DistanceWeightFunctor<TFVec, TDistanceMethod, RBFFunctionType::Cubic>{}(targets, input, weights, kernelWidth);
+        case RBFFunctionType::Quintic:
+            return DistanceWeightFunctor<TFVec, TDistanceMethod, RBFFunctionType::Quintic>{}(targets, input, weights, kernelWidth);
+    }
+    assert(false);  // Should not reach this
+}
+
+// Runtime dispatched variant, only meant for use outside of the hot path (e.g. while constructing solvers)
+template<typename TFVec>
+void getDistanceWeights(RBFDistanceMethod distanceMethod,
+                        RBFFunctionType weightFunction,
+                        const RBFTargets& targets,
+                        ConstArrayView<float> input,
+                        ArrayView<float> weights,
+                        float kernelWidth) {
+    // Swing and twist angles are compared as quaternions, after the inputs are converted
+    if (distanceMethod == RBFDistanceMethod::Euclidean) {
+        getDistanceWeights<TFVec, RBFDistanceMethod::Euclidean>(weightFunction, targets, input, weights, kernelWidth);
+    } else {
+        getDistanceWeights<TFVec, RBFDistanceMethod::Quaternion>(weightFunction, targets, input, weights, kernelWidth);
+    }
+}
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace cpu
+
+}  // namespace rbf
+
+}  // namespace rl4
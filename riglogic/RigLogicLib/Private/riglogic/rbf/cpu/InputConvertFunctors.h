@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/utils/Macros.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+namespace rbf {
+
+namespace cpu {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+template<TwistAxis TTwistAxis>
+inline void getSwing(ArrayView<float> q);
+
+template<>
+inline void getSwing<TwistAxis::X>(ArrayView<float> q) {
+    const float x = q[0];
+    const float y = q[1];
+    const float z = q[2];
+    const float w = q[3];
+    q[3] = -std::sqrt(x * x + w * w);
+    q[2] = (w * z + x * y) / q[3];
+    q[1] = (w * y - x * z) / q[3];
+    q[0] = 0.0f;
+}
+
+template<>
+inline void getSwing<TwistAxis::Y>(ArrayView<float> q) {
+    const float x = q[0];
+    const float y = q[1];
+    const float z = q[2];
+    const float w = q[3];
+    q[3] = -std::sqrt(y * y + w * w);
+    q[2] = (w * z - y * x) / q[3];
+    q[1] = 0.0f;
+    q[0] = (w * x + y * z) / q[3];
+}
+
+template<>
+inline void getSwing<TwistAxis::Z>(ArrayView<float> q) {
+    const float x = q[0];
+    const float y = q[1];
+    const float z = q[2];
+    const float w = q[3];
+    q[3] = -std::sqrt(z * z + w * w);
+    q[2] = 0.0f;
+    q[1] = (w * y + z * x) / q[3];
+    q[0] = (w * x - z * y) / q[3];
+}
+
+template<TwistAxis TTwistAxis>
+inline void getTwist(ArrayView<float> q) {
+    constexpr auto twistIndex = static_cast<std::uint16_t>(TTwistAxis);
+    constexpr auto notTwistIndex0 = (twistIndex + 1u) % 3u;
+    constexpr auto notTwistIndex1 = (twistIndex + 2u) % 3u;
+    q[notTwistIndex0] = 0.0f;
+    q[notTwistIndex1] = 0.0f;
+    // normalize
+    float magnitude = std::sqrt(q[twistIndex] * q[twistIndex] + q[3] * q[3]);
+    q[twistIndex] /= magnitude;
+    q[3] /= magnitude;
+}
+
+// Swing and twist angle distances are computed between the respective components of the input quaternions,
+// so those inputs (and targets) are converted in-place before computing the distances
+template<RBFDistanceMethod TDistanceMethod, TwistAxis TTwistAxis>
+struct InputConvertFunctor {
+    static FORCE_INLINE void convert(ArrayView<float>  /*unused*/) {
+    }
+
+};
+
+template<TwistAxis TTwistAxis>
+struct InputConvertFunctor<RBFDistanceMethod::TwistAngle, TTwistAxis> {
+    static FORCE_INLINE void convert(ArrayView<float> input) {
+        assert(input.size() % 4 == 0);
+        for (std::size_t qi = {}; qi < input.size(); qi += 4ul) {
+            getTwist<TTwistAxis>(input.subview(qi, 4ul));
+        }
+    }
+
+};
+
+template<TwistAxis TTwistAxis>
+struct InputConvertFunctor<RBFDistanceMethod::SwingAngle, TTwistAxis> {
+    static FORCE_INLINE void convert(ArrayView<float> input) {
+        assert(input.size() % 4 == 0);
+        for (std::size_t qi = {}; qi < input.size(); qi += 4ul) {
+            getSwing<TTwistAxis>(input.subview(qi, 4ul));
+        }
+    }
+
+};
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace cpu
+
+}  // namespace rbf
+
+}  // namespace rl4
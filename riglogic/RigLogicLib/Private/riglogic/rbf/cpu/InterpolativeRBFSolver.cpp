@@ -3,37 +3,146 @@
 #include "riglogic/rbf/cpu/InterpolativeRBFSolver.h"
 
 #include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/rbf/cpu/RBFSolverKernel.h"
 #include "riglogic/types/Aliases.h"
-#include "riglogic/utils/Extd.h"
 
-#include <tdm/Types.h>
-#include <tdm/Computations.h>
-#include <tdm/Mat.h>
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
 
 namespace rl4 {
 
 namespace {
 
-inline bool decompose(Matrix<float>& a, Vector<std::size_t>& permute) {
-    constexpr float absmin = 1.0e-20f;
+// Square matrices are stored row-major in a single contiguous array
+class SquareMatrix {
+    public:
+        SquareMatrix(std::size_t size_, MemoryResource* memRes) : values{size_ * size_, 0.0, memRes}, size{size_} {
+        }
+
+        double* operator[](std::size_t row) {
+            return values.data() + row * size;
+        }
+
+        const double* operator[](std::size_t row) const {
+            return values.data() + row * size;
+        }
+
+        std::size_t getSize() const {
+            return size;
+        }
 
-    Vector<float> scale{a.size(), {}, permute.get_allocator()};
+    private:
+        Vector<double> values;
+        std::size_t size;
 
-    for (std::size_t i = {}; i < a.size(); ++i) {
-        float rowMax = {};
-        for (std::size_t j = {}; j < a.size(); ++j) {
+};
+
+// In-place LDL^T factorization of a symmetric matrix. Only the lower triangle is referenced, and it is overwritten
+// with L (below the diagonal, its unit diagonal is implicit) and D (on the diagonal).
+// Returns false if a pivot vanishes, which may happen without pivoting even if the matrix is not singular.
+inline bool factorizeLDLT(SquareMatrix& a, Vector<double>& work) {
+    const std::size_t n = a.getSize();
+    double maxDiagonal = {};
+    for (std::size_t i = {}; i < n; ++i) {
+        maxDiagonal = std::max(maxDiagonal, std::abs(a[i][i]));
+    }
+    const double minPivot = maxDiagonal * 1.0e-12;
+    if (minPivot == 0.0) {
+        return false;
+    }
+
+    for (std::size_t j = {}; j < n; ++j) {
+        double* rowJ = a[j];
+        // work[k] = L[j][k] * D[k]
+        double pivot = rowJ[j];
+        for (std::size_t k = {}; k < j; ++k) {
+            work[k] = rowJ[k] * a[k][k];
+            pivot -= rowJ[k] * work[k];
+        }
+        if (std::abs(pivot) < minPivot) {
+            return false;
+        }
+        rowJ[j] = pivot;
+
+        for (std::size_t i = j + 1ul; i < n; ++i) {
+            double* rowI = a[i];
+            double sum = rowI[j];
+            for (std::size_t k = {}; k < j; ++k) {
+                sum -= rowI[k] * work[k];
+            }
+            rowI[j] = sum / pivot;
+        }
+    }
+    return true;
+}
+
+// Computes A^-1 = L^-T * D^-1 * L^-1 from the factorized matrix, processing whole rows, so all accesses are sequential
+inline void invertLDLT(const SquareMatrix& ldlt, SquareMatrix& inverse, MemoryResource* memRes) {
+    const std::size_t n = ldlt.getSize();
+    // Unit lower-triangular L^-1, row i is e_i - sum(L[i][k] * row k) for all k < i
+    SquareMatrix lInv{n, memRes};
+    for (std::size_t i = {}; i < n; ++i) {
+        double* rowI = lInv[i];
+        rowI[i] = 1.0;
+        for (std::size_t k = {}; k < i; ++k) {
+            const double l = ldlt[i][k];
+            const double* rowK = lInv[k];
+            for (std::size_t j = {}; j <= k; ++j) {
+                rowI[j] -= l * rowK[j];
+            }
+        }
+    }
+    // inverse[i][j] = sum(L^-1[k][i] * L^-1[k][j] / D[k]) for all k >= max(i, j), accumulated into the lower triangle
+    for (std::size_t k = {}; k < n; ++k) {
+        const double* rowK = lInv[k];
+        const double reciprocalPivot = 1.0 / ldlt[k][k];
+        for (std::size_t i = {}; i <= k; ++i) {
+            const double scale = rowK[i] * reciprocalPivot;
+            double* rowI = inverse[i];
+            for (std::size_t j = {}; j <= i; ++j) {
+                rowI[j] += scale * rowK[j];
+            }
+        }
+    }
+    for (std::size_t i = {}; i < n; ++i) {
+        for (std::size_t j = i + 1ul; j < n; ++j) {
+            inverse[i][j] = inverse[j][i];
+        }
+    }
+}
+
+// Fallback for matrices that cannot be factorized without pivoting, LU decomposition with scaled partial pivoting
+inline bool decompose(SquareMatrix& a, Vector<std::size_t>& permute) {
+    constexpr double absmin = 1.0e-20;
+    const std::size_t n = a.getSize();
+
+    Vector<double> scale{n, {}, permute.get_allocator()};
+
+    for (std::size_t i = {}; i < n; ++i) {
+        double rowMax = {};
+        for (std::size_t j = {}; j < n; ++j) {
             rowMax = std::max(rowMax, std::abs(a[i][j]));
         }
 
-        if (rowMax == 0.0f) {
+        if (rowMax == 0.0) {
             return false;
         }
-        scale[i] = 1.0f / rowMax;
+        scale[i] = 1.0 / rowMax;
     }
 
-    for (std::size_t j = {}; j < a.size(); ++j) {
+    for (std::size_t j = {}; j < n; ++j) {
         for (std::size_t i = {}; i < j; ++i) {
-            float sum = a[i][j];
+            double sum = a[i][j];
             for (std::size_t k = {}; k < i; ++k) {
                 sum -= a[i][k] * a[k][j];
             }
@@ -41,15 +150,15 @@ inline bool decompose(Matrix<float>& a, Vector<std::size_t>& permute) {
         }
 
         std::size_t iMax = {};
-        float colMax = {};
-        for (std::size_t i = j; i < a.size(); ++i) {
-            float sum = a[i][j];
+        double colMax = {};
+        for (std::size_t i = j; i < n; ++i) {
+            double sum = a[i][j];
             for (std::size_t k = {}; k < j; ++k) {
                 sum -= a[i][k] * a[k][j];
             }
             a[i][j] = sum;
 
-            const float temp = scale[i] * std::abs(sum);
+            const double temp = scale[i] * std::abs(sum);
             if (temp >= colMax) {
                 colMax = temp;
                 iMax = i;
@@ -57,21 +166,19 @@ inline bool decompose(Matrix<float>& a, Vector<std::size_t>& permute) {
         }
 
         if (j != iMax) {
-            for (std::size_t k = {}; k < a.size(); ++k) {
-                std::swap(a[iMax][k], a[j][k]);
-            }
+            std::swap_ranges(a[iMax], a[iMax] + n, a[j]);
             scale[iMax] = scale[j];
         }
 
         permute[j] = iMax;
 
-        if (a[j][j] == 0.0f) {
+        if (a[j][j] == 0.0) {
             a[j][j] = absmin;
         }
 
-        if (j != (a.size() - 1)) {
-            const float temp = 1.0f / a[j][j];
-            for (std::size_t i = j + 1; i < a.size(); ++i) {
+        if (j != (n - 1)) {
+            const double temp = 1.0 / a[j][j];
+            for (std::size_t i = j + 1; i < n; ++i) {
                 a[i][j] *= temp;
             }
         }
@@ -80,104 +187,114 @@ inline bool decompose(Matrix<float>& a, Vector<std::size_t>& permute) {
     return true;
 }
 
-inline void substitute(const Matrix<float>& a, const Vector<std::size_t>& permute, Vector<float>& b) {
+inline void substitute(const SquareMatrix& a, const Vector<std::size_t>& permute, Vector<double>& b) {
+    const std::size_t n = a.getSize();
     std::size_t ii = {};
-    for (std::size_t i = {}; i < a.size(); ++i) {
+    for (std::size_t i = {}; i < n; ++i) {
         const std::size_t ip = permute[i];
-        float sum = b[ip];
+        double sum = b[ip];
         b[ip] = b[i];
         if (ii) {
             for (std::size_t j = (ii - 1); j < i; ++j) {
                 sum -= a[i][j] * b[j];
             }
-        } else if (sum != 0.0f) {
+        } else if (sum != 0.0) {
             ii = i + 1;
         }
         b[i] = sum;
     }
 
-    for (std::size_t ipo = a.size(); ipo > 0; --ipo) {
+    for (std::size_t ipo = n; ipo > 0; --ipo) {
         const std::size_t i = ipo - 1;
-        float sum = b[i];
-        for (std::size_t j = i + 1; j < a.size(); ++j) {
+        double sum = b[i];
+        for (std::size_t j = i + 1; j < n; ++j) {
             sum -= a[i][j] * b[j];
         }
         b[i] = sum / a[i][i];
     }
 }
 
-inline void invert(Matrix<float>& m) {
-    Vector<std::size_t> permute{m.size(), {}, m.get_allocator()};
-    if (!decompose(m, permute)) {
-        return;
+inline bool invertLU(SquareMatrix& lu, SquareMatrix& inverse, MemoryResource* memRes) {
+    const std::size_t n = lu.getSize();
+    Vector<std::size_t> permute{n, {}, memRes};
+    if (!decompose(lu, permute)) {
+        return false;
+    }
+
+    Vector<double> col{n, {}, memRes};
+    for (std::size_t j = {}; j < n; ++j) {
+        std::fill(col.begin(), col.end(), 0.0);
+        col[j] = 1.0;
+        substitute(lu, permute, col);
+        for (std::size_t i = {}; i < n; ++i) {
+            inverse[i][j] = col[i];
+        }
     }
+    return true;
+}
 
-    Matrix<float> inv{m.size(), Vector<float>{m.size(), {}, m.get_allocator()}, m.get_allocator()};
-    for (std::size_t j = {}; j < m.size(); ++j) {
-        Vector<float> col{m.size(), {}, m.get_allocator()};
-        col[j] = 1.0f;
-        substitute(m, permute, col);
-        for (std::size_t i = {}; i < m.size(); ++i) {
-            inv[i][j] = col[i];
+// Singular matrices (with an all-zero row) are left as they are, same as the kernel matrix was prior to inversion
+inline void invert(SquareMatrix& m, MemoryResource* memRes) {
+    const std::size_t n = m.getSize();
+    SquareMatrix factorized = m;
+    SquareMatrix inverse{n, memRes};
+    Vector<double> work{n, {}, memRes};
+    if (factorizeLDLT(factorized, work)) {
+        invertLDLT(factorized, inverse, memRes);
+    } else {
+        factorized = m;
+        if (!invertLU(factorized, inverse, memRes)) {
+            return;
         }
     }
-    m = std::move(inv);
+    m = std::move(inverse);
 }
 
 }  // namespace
 
-InterpolativeRBFSolver::InterpolativeRBFSolver(MemoryResource* memRes) : RBFSolver(memRes),
+InterpolativeRBFSolver::InterpolativeRBFSolver(MemoryResource* memRes) :
+    RBFSolver(memRes),
     coefficients{memRes} {
 }
 
-InterpolativeRBFSolver::InterpolativeRBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes) : RBFSolver(recipe, memRes),
+InterpolativeRBFSolver::InterpolativeRBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes) :
+    RBFSolver(recipe, memRes),
     coefficients{memRes} {
-    const auto targetCount = targets.size();
-    coefficients = Matrix<float>{targetCount, Vector<float>{targetCount, 0.0f, memRes}, memRes};
-    // This can also be optimized, we do not need the actual matrix what we are looking for the inverse matrix
+    const std::size_t targetCount = targets.targetCount;
     // We need to include the diagonal itself, since we can't guarantee that the weight
     // function returns 1.0 for nodes of the same coordinates.
-
+    // The matrix is symmetrical, but evaluating whole rows is cheaper with targets laid out in blocks.
+    SquareMatrix kernel{targetCount, memRes};
+    Vector<float> target{targets.controlCount, 0.0f, memRes};
+    Vector<float> weights{targetCount, 0.0f, memRes};
     for (std::size_t i = {}; i < targetCount; ++i) {
-        // matrix is symmetrical so we only need to calculate right side of the matrix and we ll copy it onto the left
-        ArrayView<float> outputWeights{coefficients[i].data() + i, coefficients[i].size() - i};
-        const auto& curTarget = targets[i];
-        ConstArrayView<AlignedVector<float> > targetView{targets.data() + i, targets.size() - i};
-        if (targetView.size() > 0ul) {
-            getDistanceWeight(targetView, curTarget, outputWeights, radius);
-        }
-        // copying
-        for (std::size_t j = i + 1ul; j < targetCount; ++j) {
-            coefficients[j][i] = coefficients[i][j];
+        targets.getTarget(i, target);
+        getDistanceWeights(target, weights);
+        std::copy(weights.begin(), weights.end(), kernel[i]);
+    }
+    // Factorized and inverted in double precision, as kernel matrices of large solvers are often poorly conditioned
+    invert(kernel, memRes);
+
+    // Coefficients that would be denormal as floats are flushed to zero, they are of no consequence to the results
+    // but would slow down every multiply-add that involves them
+    constexpr std::size_t blockSize = RBFTargets::blockSize;
+    constexpr double minCoefficient = static_cast<double>(std::numeric_limits<float>::min());
+    auto& values = coefficients.floats;
+    values.resize(targets.getBlockCount() * targetCount * blockSize);
+    std::fill(values.begin(), values.end(), 0.0f);
+    for (std::size_t i = {}; i < targetCount; ++i) {
+        float* block = values.data() + (i / blockSize) * targetCount * blockSize;
+        for (std::size_t j = {}; j < targetCount; ++j) {
+            const double coefficient = kernel[i][j];
+            block[j * blockSize + i % blockSize] = (std::abs(coefficient) < minCoefficient ? 0.0f : static_cast<float>(coefficient));
         }
     }
-    // there are optimized ways of getting inverse of symmetrical matrix
-    // but since this is not in a hot path rather one time call i am not sure if it is
-    // worth it
-    invert(coefficients);
 }
 
 RBFSolverType InterpolativeRBFSolver::getSolverType() const {
     return RBFSolverType::Interpolative;
 }
 
-void InterpolativeRBFSolver::solve(ArrayView<float> input, ArrayView<float> intermediateWeights,
-                                   ArrayView<float> outputWeights) const {
-    convertInput(input);
-    const std::size_t targetSize = targets.size();
-    getDistanceWeight(targets, input, intermediateWeights, radius);
-
-    for (std::size_t i = {}; i < targetSize; ++i) {
-        float weight = 0.0f;
-        const auto& targetCoeff = coefficients[i];
-        for (std::size_t j = {}; j < targetSize; ++j) {
-            weight += targetCoeff[j] * intermediateWeights[j];  // Vectorize TODO
-        }
-        outputWeights[i] = extd::clamp(weight, 0.0f, 1.0f);
-    }
-    normalizeAndCutOff(outputWeights);
-}
-
 void InterpolativeRBFSolver::load(terse::BinaryInputArchive<BoundedIOStream>& archive) {
     RBFSolver::load(archive);
     archive(coefficients);
@@ -188,8 +305,21 @@ void InterpolativeRBFSolver::save(terse::BinaryOutputArchive<BoundedIOStream>& a
     archive(coefficients);
 }
 
-const Matrix<float>& InterpolativeRBFSolver::getCoefficients() const {
-    return coefficients;
+ConstArrayView<float> InterpolativeRBFSolver::getCoefficients() const {
+    return {coefficients.floats.data(), coefficients.floats.size()};
+}
+
+void InterpolativeRBFSolver::getPoseWeights(ConstArrayView<float> input,
+                                            ArrayView<float> intermediateWeights,
+                                            ArrayView<float> weights) const {
+    getDistanceWeights(input, intermediateWeights);
+    const float sumWeight = rbf::cpu::interpolateWeights<trimd::scalar::F256, float>(*this, intermediateWeights, weights);
+    rbf::cpu::normalizeAndCutOff<trimd::scalar::F256, float>(*this, sumWeight, weights);
+}
+
+void InterpolativeRBFSolver::collectValues(Vector<RBFValues*>& values) {
+    RBFSolver::collectValues(values);
+    values.push_back(&coefficients);
 }
 
 }  // namespace rl4
@@ -3,23 +3,39 @@
 #pragma once
 
 #include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/types/MappableVector.h"
+
+#include <cstddef>
 
 namespace rl4 {
 
 class InterpolativeRBFSolver : public RBFSolver {
     public:
-        explicit InterpolativeRBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes);
+        InterpolativeRBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes);
         explicit InterpolativeRBFSolver(MemoryResource* memRes);
 
         RBFSolverType getSolverType() const override;
-        void solve(ArrayView<float> input, ArrayView<float> intermediateWeights, ArrayView<float> outputWeights) const override;
         void load(terse::BinaryInputArchive<BoundedIOStream>& archive) override;
         void save(terse::BinaryOutputArchive<BoundedIOStream>& archive) override;
 
-        const Matrix<float>& getCoefficients() const;
+        // Rows of the inverted kernel matrix are stored in blocks of RBFTargets::blockSize rows (the last block is zero-padded),
+        // with the values of a single column (for all rows of the block) being contiguous, so each block can be multiplied
+        // with the intermediate weights one SIMD register at a time.
+        // Empty if values are stored as half floats.
+        ConstArrayView<float> getCoefficients() const;
+        template<typename T = float>
+        const T* getCoefficientBlock(std::size_t blockIndex) const {
+            return coefficients.data<T>() + blockIndex * targets.targetCount * RBFTargets::blockSize;
+        }
+
+    protected:
+        void getPoseWeights(ConstArrayView<float> input,
+                            ArrayView<float> intermediateWeights,
+                            ArrayView<float> weights) const override;
+        void collectValues(Vector<RBFValues*>& values) override;
 
     private:
-        Matrix<float> coefficients;
+        RBFValues coefficients;
 };
 
 }  // namespace rl4
@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/rbf/cpu/PoseOutputMatrix.h"
+
+#include "riglogic/types/Aliases.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+namespace {
+
+template<typename T>
+void assignValues(MappableVector<T>& destination, const Vector<T>& source) {
+    destination.resize(source.size());
+    std::copy(source.begin(), source.end(), destination.begin());
+}
+
+}  // namespace
+
+PoseOutputMatrix::PoseOutputMatrix(MemoryResource* memRes) :
+    solverBlockOffsets{memRes},
+    blockColumnOffsets{memRes},
+    outputIndices{memRes},
+    weights{memRes},
+    solverInputPoseOffsets{memRes},
+    inputPoseIndices{memRes},
+    inputControlOffsets{memRes},
+    inputControlIndices{memRes} {
+}
+
+void PoseOutputMatrix::assign(const Matrix<std::uint16_t>& solverPoseIndices,
+                              const Matrix<std::uint16_t>& poseInputControlIndices,
+                              const Matrix<std::uint16_t>& poseOutputControlIndices,
+                              const Matrix<float>& poseOutputControlWeights,
+                              MemoryResource* memRes) {
+    Vector<std::uint32_t> solverBlocks{1ul, 0u, memRes};
+    Vector<std::uint32_t> blockColumns{1ul, 0u, memRes};
+    Vector<std::uint16_t> entryOutputs{memRes};
+    Vector<float> entryWeights{memRes};
+    Vector<std::uint32_t> solverInputPoses{1ul, 0u, memRes};
+    Vector<std::uint16_t> inputPoses{memRes};
+    Vector<std::uint32_t> inputControls{1ul, 0u, memRes};
+    Vector<std::uint16_t> inputControlValues{memRes};
+
+    for (const auto& poses : solverPoseIndices) {
+        for (std::size_t firstPose = {}; firstPose < poses.size(); firstPose += blockSize) {
+            const std::size_t lastPose = std::min(firstPose + blockSize, poses.size());
+            std::size_t columnCount = {};
+            // Any output control of the block will do for padding poses, as their weights are zero
+            std::uint16_t paddingOutput = {};
+            for (std::size_t pi = firstPose; pi < lastPose; ++pi) {
+                const auto& outputIndices = poseOutputControlIndices[poses[pi]];
+                assert(outputIndices.size() == poseOutputControlWeights[poses[pi]].size());
+                columnCount = std::max(columnCount, outputIndices.size());
+                if (!outputIndices.empty()) {
+                    paddingOutput = outputIndices.back();
+                }
+            }
+            for (std::size_t column = {}; column < columnCount; ++column) {
+                for (std::size_t pi = firstPose; pi < firstPose + blockSize; ++pi) {
+                    if (pi >= lastPose) {
+                        entryOutputs.push_back(paddingOutput);
+                        entryWeights.push_back(0.0f);
+                        continue;
+                    }
+                    const auto& outputIndices = poseOutputControlIndices[poses[pi]];
+                    const auto& outputWeights = poseOutputControlWeights[poses[pi]];
+                    if (column < outputIndices.size()) {
+                        entryOutputs.push_back(outputIndices[column]);
+                        entryWeights.push_back(outputWeights[column]);
+                    } else {
+                        // Padding must not touch an output control the pose would otherwise not drive (its weight
+                        // may not be finite)
+                        entryOutputs.push_back(outputIndices.empty() ? paddingOutput : outputIndices.back());
+                        entryWeights.push_back(0.0f);
+                    }
+                }
+            }
+            blockColumns.push_back(static_cast<std::uint32_t>(blockColumns.back() + columnCount));
+        }
+        solverBlocks.push_back(static_cast<std::uint32_t>(blockColumns.size() - 1ul));
+
+        for (std::size_t pi = {}; pi < poses.size(); ++pi) {
+            const auto& inputIndices = poseInputControlIndices[poses[pi]];
+            if (!inputIndices.empty()) {
+                inputPoses.push_back(static_cast<std::uint16_t>(pi));
+                inputControlValues.insert(inputControlValues.end(), inputIndices.begin(), inputIndices.end());
+                inputControls.push_back(static_cast<std::uint32_t>(inputControlValues.size()));
+            }
+        }
+        solverInputPoses.push_back(static_cast<std::uint32_t>(inputPoses.size()));
+    }
+
+    assignValues(solverBlockOffsets, solverBlocks);
+    assignValues(blockColumnOffsets, blockColumns);
+    assignValues(outputIndices, entryOutputs);
+    assignValues(weights, entryWeights);
+    assignValues(solverInputPoseOffsets, solverInputPoses);
+    assignValues(inputPoseIndices, inputPoses);
+    assignValues(inputControlOffsets, inputControls);
+    assignValues(inputControlIndices, inputControlValues);
+}
+
+}  // namespace rl4
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/system/simd/SIMD.h"
+#include "riglogic/types/MappableVector.h"
+#include "riglogic/utils/Macros.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+// Pose outputs of all solvers, compiled into a sparse matrix (poses x output controls) per solver. Poses are grouped
+// into blocks of blockSize poses, matching the blocks of pose weights computed by the solvers, and all poses of a block
+// are padded to the output count of the largest one, so the output contributions of a whole block are computed by a
+// single SIMD multiplication per column. Within a block, entries are laid out column-major (the n-th outputs of all
+// poses are contiguous). Padding entries have zero weight, and refer to an output control that the pose already drives.
+// Blocks whose pose weights are all zero (e.g. poses out of reach) are skipped altogether.
+struct PoseOutputMatrix {
+    static constexpr std::size_t blockSize = 8ul;
+
+    // Pose blocks of each solver, solverCount + 1 offsets into blockColumnOffsets
+    MappableVector<std::uint32_t> solverBlockOffsets;
+    // Columns of each pose block, blockCount + 1 offsets (in units of columns, each being blockSize entries)
+    MappableVector<std::uint32_t> blockColumnOffsets;
+    // Output control and weight of each entry
+    MappableVector<std::uint16_t> outputIndices;
+    MappableVector<float> weights;
+    // Only few poses are scaled by the product of their input controls, so those are listed separately:
+    // solverCount + 1 offsets into inputPoseIndices, and inputPoseCount + 1 offsets into inputControlIndices
+    MappableVector<std::uint32_t> solverInputPoseOffsets;
+    MappableVector<std::uint16_t> inputPoseIndices;
+    MappableVector<std::uint32_t> inputControlOffsets;
+    MappableVector<std::uint16_t> inputControlIndices;
+
+    explicit PoseOutputMatrix(MemoryResource* memRes);
+
+    // Pose data is given per pose of the whole rig (as laid out in DNA)
+    void assign(const Matrix<std::uint16_t>& solverPoseIndices,
+                const Matrix<std::uint16_t>& poseInputControlIndices,
+                const Matrix<std::uint16_t>& poseOutputControlIndices,
+                const Matrix<float>& poseOutputControlWeights,
+                MemoryResource* memRes);
+
+    std::size_t getSolverCount() const {
+        return (solverBlockOffsets.empty() ? 0ul : solverBlockOffsets.size() - 1ul);
+    }
+
+    ConstArrayView<std::uint16_t> getInputControlIndices(std::size_t solverIndex) const {
+        assert(solverIndex < getSolverCount());
+        const std::uint32_t begin = inputControlOffsets[solverInputPoseOffsets[solverIndex]];
+        const std::uint32_t end = inputControlOffsets[solverInputPoseOffsets[solverIndex + 1ul]];
+        return {inputControlIndices.data() + begin, end - begin};
+    }
+
+    // Scales pose weights of a solver by the product of their input controls
+    void applyInputControls(std::size_t solverIndex, ConstArrayView<float> rawControls, ArrayView<float> poseWeights) const {
+        assert(solverIndex < getSolverCount());
+        for (std::uint32_t ipi = solverInputPoseOffsets[solverIndex]; ipi < solverInputPoseOffsets[solverIndex + 1ul]; ++ipi) {
+            float inputWeight = 1.0f;
+            for (std::uint32_t ici = inputControlOffsets[ipi]; ici < inputControlOffsets[ipi + 1ul]; ++ici) {
+                inputWeight *= rawControls[inputControlIndices[ici]];
+            }
+            poseWeights[inputPoseIndices[ipi]] *= inputWeight;
+        }
+    }
+
+    // Accumulates the weighted pose weights of a solver into its output controls, which are expected to be zeroed already.
+    // Pose weights must be padded to whole blocks.
+    template<typename TFVec>
+    FORCE_INLINE void calculate(std::size_t solverIndex, ConstArrayView<float> poseWeights, ArrayView<float> rawControls) const {
+        static_assert(TFVec::size() == blockSize, "Pose blocks must span exactly one SIMD register.");
+        assert(solverIndex < getSolverCount());
+        const std::uint32_t firstBlock = solverBlockOffsets[solverIndex];
+        const std::uint32_t lastBlock = solverBlockOffsets[solverIndex + 1ul];
+        assert(poseWeights.size() >= (lastBlock - firstBlock) * blockSize);
+        const TFVec zero{};
+        const TFVec one{1.0f};
+        alignas(TFVec::alignment()) float outputs[TFVec::size()];
+        const float* blockWeights = poseWeights.data();
+        for (std::uint32_t bi = firstBlock; bi < lastBlock; ++bi, blockWeights += blockSize) {
+            const TFVec poseWeight = TFVec::fromAlignedSource(blockWeights);
+            if ((one & (poseWeight != zero)).sum() == 0.0f) {
+                continue;
+            }
+            for (std::size_t ei = blockColumnOffsets[bi] * blockSize; ei < blockColumnOffsets[bi + 1ul] * blockSize;
+                 ei += blockSize) {
+                (poseWeight * TFVec::fromAlignedSource(weights.data() + ei)).alignedStore(outputs);
+                // Poses of a block may drive the same output control, so the scatter is not vectorized
+                const std::uint16_t* oi = outputIndices.data() + ei;
+                for (std::size_t pi = {}; pi < blockSize; ++pi) {
+                    rawControls[oi[pi]] += outputs[pi];
+                }
+            }
+        }
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(solverBlockOffsets,
+                blockColumnOffsets,
+                outputIndices,
+                weights,
+                solverInputPoseOffsets,
+                inputPoseIndices,
+                inputControlOffsets,
+                inputControlIndices);
+    }
+
+};
+
+}  // namespace rl4
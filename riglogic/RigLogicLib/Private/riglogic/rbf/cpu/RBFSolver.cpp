@@ -3,8 +3,12 @@
 #include "riglogic/rbf/cpu/RBFSolver.h"
 
 #include "riglogic/rbf/cpu/AdditiveRBFSolver.h"
+#include "riglogic/rbf/cpu/DistanceWeightFunctors.h"
+#include "riglogic/rbf/cpu/InputConvertFunctors.h"
 #include "riglogic/rbf/cpu/InterpolativeRBFSolver.h"
+#include "riglogic/rbf/cpu/RBFSolverKernel.h"
 #include "riglogic/types/Aliases.h"
+#include "riglogic/utils/Extd.h"
 
 #ifdef _MSC_VER
     #pragma warning(push)
@@ -12,8 +16,10 @@
 #endif
 #include <cstdint>
 #include <cassert>
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <limits>
 #include <numeric>
 #ifdef _MSC_VER
     #pragma warning(pop)
@@ -23,283 +29,98 @@ namespace rl4 {
 
 namespace {
 
-template<std::size_t Exponent>
-float pow(float base);
-
-template<>
-inline float pow<1u>(float base) {
-    return base;
-}
-
-template<std::size_t Exponent>
-inline float pow(float base) {
-    return base * pow<Exponent - 1u>(base);
-}
-
-inline float dotProduct(ConstArrayView<float> qA, ConstArrayView<float> qB) {
-    return qA[0] * qB[0] + qA[1] * qB[1] + qA[2] * qB[2] + qA[3] * qB[3];
-}
-
-inline float getArcLength(ConstArrayView<float> qA, ConstArrayView<float> qB) {
-    assert(qA.size() == qB.size() && qB.size() == 4u);
-    float dotSqr = pow<2>(dotProduct(qA, qB));
-    if (dotSqr > 1.0f) {
-        return 0.0f;
-    }
-    return std::acos((2 * dotSqr) - 1.0f);
-}
-
 template<TwistAxis TTwistAxis>
-inline void getSwing(ArrayView<float> q);
-
-template<>
-inline void getSwing<TwistAxis::X>(ArrayView<float> q) {
-    const float x = q[0];
-    const float y = q[1];
-    const float z = q[2];
-    const float w = q[3];
-    q[3] = -std::sqrt(x * x + w * w);
-    q[2] = (w * z + x * y) / q[3];
-    q[1] = (w * y - x * z) / q[3];
-    q[0] = 0.0f;
-}
-
-template<>
-inline void getSwing<TwistAxis::Y>(ArrayView<float> q) {
-    const float x = q[0];
-    const float y = q[1];
-    const float z = q[2];
-    const float w = q[3];
-    q[3] = -std::sqrt(y * y + w * w);
-    q[2] = (w * z - y * x) / q[3];
-    q[1] = 0.0f;
-    q[0] = (w * x + y * z) / q[3];
+void convertInput(RBFDistanceMethod distanceMethod, ArrayView<float> input) {
+    switch (distanceMethod) {
+        case RBFDistanceMethod::Quaternion:
+        case RBFDistanceMethod::Euclidean:
+            break;
+        case RBFDistanceMethod::TwistAngle:
+            rbf::cpu::InputConvertFunctor<RBFDistanceMethod::TwistAngle, TTwistAxis>::convert(input);
+            break;
+        default:
+        case RBFDistanceMethod::SwingAngle:
+            rbf::cpu::InputConvertFunctor<RBFDistanceMethod::SwingAngle, TTwistAxis>::convert(input);
+            break;
+    }
 }
 
-template<>
-inline void getSwing<TwistAxis::Z>(ArrayView<float> q) {
-    const float x = q[0];
-    const float y = q[1];
-    const float z = q[2];
-    const float w = q[3];
-    q[3] = -std::sqrt(z * z + w * w);
-    q[2] = 0.0f;
-    q[1] = (w * y + z * x) / q[3];
-    q[0] = (w * x - z * y) / q[3];
+void convertInput(RBFDistanceMethod distanceMethod, TwistAxis axis, ArrayView<float> input) {
+    switch (axis) {
+        default:
+        case TwistAxis::X:
+            return convertInput<TwistAxis::X>(distanceMethod, input);
+        case TwistAxis::Y:
+            return convertInput<TwistAxis::Y>(distanceMethod, input);
+        case TwistAxis::Z:
+            return convertInput<TwistAxis::Z>(distanceMethod, input);
+    }
 }
 
-template<TwistAxis TTwistAxis>
-inline void getTwist(ArrayView<float> q) {
-    constexpr auto twistIndex = static_cast<std::uint16_t>(TTwistAxis);
-    constexpr auto notTwistIndex0 = (twistIndex + 1u) % 3u;
-    constexpr auto notTwistIndex1 = (twistIndex + 2u) % 3u;
-    q[notTwistIndex0] = 0.0f;
-    q[notTwistIndex1] = 0.0f;
-    // normalize
-    float magnitude = std::sqrt(q[twistIndex] * q[twistIndex] + q[3] * q[3]);
-    q[twistIndex] /= magnitude;
-    q[3] /= magnitude;
+// Below this many targets, visiting the target bounds costs more than evaluating all targets
+constexpr std::size_t minBoundedTargetCount = 64ul;
+// Upper bound on the number of targets evaluated to find the error caused by half float conversion, as evaluating
+// interpolative solvers at all of their targets costs as much as factorizing their kernel matrix
+constexpr std::size_t maxHalfFloatSampleCount = 32ul;
+// Largest error in pose weights that half float conversion may cause (about twice the rounding error of half floats
+// close to one). Interpolative solvers with poorly conditioned kernel matrices amplify rounding errors of their
+// coefficients way beyond that, and are kept as floats.
+constexpr float maxHalfFloatError = 1.0e-3f;
+
+bool usesTargetBounds(RBFFunctionType weightFunction, std::size_t targetCount) {
+    const bool hasCompactSupport = (weightFunction == RBFFunctionType::Linear) ||
+        (weightFunction == RBFFunctionType::Cubic) ||
+        (weightFunction == RBFFunctionType::Quintic);
+    return hasCompactSupport && (targetCount >= minBoundedTargetCount);
 }
 
-template<RBFDistanceMethod TDistanceMethod>
-struct DistanceMethodFunctor;
-
-template<>
-struct DistanceMethodFunctor<RBFDistanceMethod::Euclidean> {
-    static inline void getDistance(ConstArrayView<AlignedVector<float> > targets,
-                                   ConstArrayView<float> rawControlValues,
-                                   ArrayView<float> intermediateWeights) {
-        for (std::size_t ti = 0u; ti < targets.size(); ++ti) {
-            auto target = ConstArrayView<float>{targets[ti]};
-            float sumSquaredDiff = 0.0f;
-            for (std::size_t i = 0u; i < rawControlValues.size(); ++i) {
-                sumSquaredDiff += pow<2u>(target[i] - rawControlValues[i]);
-            }
-            intermediateWeights[ti] = std::sqrt(sumSquaredDiff);
-        }
+Vector<float> getConvertedTargetValues(const RBFSolverRecipe& recipe, MemoryResource* memRes) {
+    Vector<float> targetValues{recipe.targetValues.begin(), recipe.targetValues.end(), memRes};
+    for (std::size_t offset = {}; offset < targetValues.size(); offset += recipe.rawControlCount) {
+        convertInput(recipe.distanceMethod, recipe.twistAxis, ArrayView<float>{targetValues.data() + offset, recipe.rawControlCount});
     }
-
-};
-
-template<>
-struct DistanceMethodFunctor<RBFDistanceMethod::Quaternion> {
-    static inline void getDistance(ConstArrayView<AlignedVector<float> > targets,
-                                   ConstArrayView<float> rawControlValues,
-                                   ArrayView<float> intermediateWeights) {
-
-        auto quaternionCount = static_cast<std::uint16_t>(rawControlValues.size() / 4u);
-        for (std::size_t ti = 0u; ti < targets.size(); ++ti) {
-            auto target = ConstArrayView<float>{targets[ti]};
-            assert(target.size() % 4u == 0);
-            float distance = 0.0f;
-            // quaternion count is same for each iteration TODO
-            for (std::size_t i = 0u; i < quaternionCount; ++i) {
-                auto aQ = target.subview(i * 4u, 4u);
-                auto bQ = rawControlValues.subview(i * 4u, 4u);
-                // quaternions need to be normalized for this
-                distance += pow<2u>(getArcLength(aQ, bQ));
-            }
-            intermediateWeights[ti] = std::sqrt(distance);
-        }
-    }
-
-};
-
-template<RBFFunctionType TFunctionType>
-struct WeightMethodFunctor;
-
-template<>
-struct WeightMethodFunctor<RBFFunctionType::Linear> {
-    static inline float getWeight(float value, float kernelWidth) {
-        value = 1.0f - (value / kernelWidth);
-        return value > 0.0f ? value : 0.0f;
-    }
-
-};
-
-template<>
-struct WeightMethodFunctor<RBFFunctionType::Cubic> {
-    static inline float getWeight(float value, float kernelWidth) {
-        value = 1.0f - pow<3>(value / kernelWidth);
-        return value > 0.0f ? value : 0.0f;
-    }
-
-};
-
-template<>
-struct WeightMethodFunctor<RBFFunctionType::Quintic> {
-    static inline float getWeight(float value, float kernelWidth) {
-        value = 1.0f - pow<5>(value / kernelWidth);
-        return value > 0.0f ? value : 0.0f;
-    }
-
-};
-
-template<>
-struct WeightMethodFunctor<RBFFunctionType::Gaussian> {
-    static inline float getWeight(float value, float kernelWidth) {
-        return std::exp(-value / pow<2>(kernelWidth));
-    }
-
-};
-
-template<>
-struct WeightMethodFunctor<RBFFunctionType::Exponential> {
-    static inline float getWeight(float value, float kernelWidth) {
-        return std::exp(-2.0f * value / kernelWidth);
-    }
-
-};
-
-template<RBFDistanceMethod TDistanceMethod>
-using D = DistanceMethodFunctor<TDistanceMethod>;
-
-template<RBFFunctionType TFunctionType>
-using W = WeightMethodFunctor<TFunctionType>;
-
-using DistanceWeightFun = RBFSolver::DistanceWeightFun;
-using InputConvertFun = RBFSolver::InputConvertFun;
-using DistanceFun = decltype(&D<RBFDistanceMethod::Euclidean>::getDistance);
-
-DistanceFun getDistanceFun(RBFDistanceMethod distanceMethod) {
-    if (distanceMethod == RBFDistanceMethod::Euclidean) {
-        return D<RBFDistanceMethod::Euclidean>::getDistance;
-    }
-    return D<RBFDistanceMethod::Quaternion>::getDistance;
+    return targetValues;
 }
 
-template<typename TDistanceFunctionProvider, typename TWeightFunctionProvider>
-struct DistanceWeightFunctor {
-    void inline operator()(ConstArrayView<AlignedVector<float> > targets,
-                           ConstArrayView<float> input,
-                           ArrayView<float> intermediateWeights,
-                           float kernelWidth) {
-        TDistanceFunctionProvider::getDistance(targets, input, intermediateWeights);
-        for (std::size_t ti = 0u; ti < targets.size(); ++ti) {
-            intermediateWeights[ti] = TWeightFunctionProvider::getWeight(intermediateWeights[ti], kernelWidth);
-        }
+// Recursively splits targets at the median of the coordinate with the widest spread (like a kd-tree), with each split
+// falling on a block boundary, so the resulting blocks contain targets close to each other
+void orderTargets(ConstArrayView<float> targetValues, std::size_t controlCount, std::uint16_t* begin, std::uint16_t* end) {
+    const auto count = static_cast<std::size_t>(end - begin);
+    if (count <= RBFTargets::blockSize) {
+        return;
     }
 
-};
-
-DistanceWeightFun getDistanceWeightFun(RBFFunctionType weightMethod, RBFDistanceMethod distanceMethod) {
-    constexpr auto Gaussian = RBFFunctionType::Gaussian;
-    constexpr auto Cubic = RBFFunctionType::Cubic;
-    constexpr auto Exponential = RBFFunctionType::Exponential;
-    constexpr auto Linear = RBFFunctionType::Linear;
-    constexpr auto Quintic = RBFFunctionType::Quintic;
-
-    constexpr auto Euclidean = RBFDistanceMethod::Euclidean;
-    constexpr auto Quaternion = RBFDistanceMethod::Quaternion;
-
-    if (distanceMethod == Euclidean) {
-        switch (weightMethod) {
-            case Gaussian:
-                return DistanceWeightFunctor<D<Euclidean>, W<Gaussian> >();
-            case Cubic:
-                return DistanceWeightFunctor<D<Euclidean>, W<Cubic> >();
-            case Exponential:
-                return DistanceWeightFunctor<D<Euclidean>, W<Exponential> >();
-            case Linear:
-                return DistanceWeightFunctor<D<Euclidean>, W<Linear> >();
-            case Quintic:
-                return DistanceWeightFunctor<D<Euclidean>, W<Quintic> >();
+    std::size_t splitControl = {};
+    float widestSpread = -1.0f;
+    for (std::size_t ci = {}; ci < controlCount; ++ci) {
+        auto minMax = std::minmax_element(begin, end, [&targetValues, controlCount, ci](std::uint16_t lhs, std::uint16_t rhs) {
+                return targetValues[lhs * controlCount + ci] < targetValues[rhs * controlCount + ci];
+            });
+        const float spread = targetValues[*minMax.second * controlCount + ci] - targetValues[*minMax.first * controlCount + ci];
+        if (spread > widestSpread) {
+            widestSpread = spread;
+            splitControl = ci;
         }
     }
 
-    switch (weightMethod) {
-        case Gaussian:
-            return DistanceWeightFunctor<D<Quaternion>, W<Gaussian> >();
-        case Cubic:
-            return DistanceWeightFunctor<D<Quaternion>, W<Cubic> >();
-        case Exponential:
-            return DistanceWeightFunctor<D<Quaternion>, W<Exponential> >();
-        case Linear:
-            return DistanceWeightFunctor<D<Quaternion>, W<Linear> >();
-        case Quintic:
-            return DistanceWeightFunctor<D<Quaternion>, W<Quintic> >();
-    }
-
-    assert(false);  // Should not reach this
-    return nullptr;
-}
-
-template<TwistAxis TTwistAxis>
-InputConvertFun getInputConvertFun(RBFDistanceMethod distanceMethod) {
-    switch (distanceMethod) {
-        case RBFDistanceMethod::Quaternion:
-        case RBFDistanceMethod::Euclidean:
-            return [](ArrayView<float> input) {
-                       return input;
-            };
-        case RBFDistanceMethod::TwistAngle:
-            return [](ArrayView<float> input) {
-                       assert(input.size() % 4 == 0);
-                       for (std::size_t qi = {}; qi < input.size(); qi += 4ul) {
-                           getTwist<TTwistAxis>(input.subview(qi, 4ul));
-                       }
-
-            };
-        default:
-        case RBFDistanceMethod::SwingAngle:
-            return [](ArrayView<float> input) {
-                       assert(input.size() % 4 == 0);
-                       for (std::size_t qi = {}; qi < input.size(); qi += 4ul) {
-                           getSwing<TTwistAxis>(input.subview(qi, 4ul));
-                       }
-            };
-    }
+    std::uint16_t* middle = begin + RBFTargets::getPaddedCount(count / 2ul);
+    std::nth_element(begin, middle, end, [&targetValues, controlCount, splitControl](std::uint16_t lhs, std::uint16_t rhs) {
+            return targetValues[lhs * controlCount + splitControl] < targetValues[rhs * controlCount + splitControl];
+        });
+    orderTargets(targetValues, controlCount, begin, middle);
+    orderTargets(targetValues, controlCount, middle, end);
 }
 
-InputConvertFun getInputConvertFun(RBFDistanceMethod distanceMethod, TwistAxis axis) {
-    switch (axis) {
-        default:
-        case TwistAxis::X:
-            return getInputConvertFun<TwistAxis::X>(distanceMethod);
-        case TwistAxis::Y:
-            return getInputConvertFun<TwistAxis::Y>(distanceMethod);
-        case TwistAxis::Z:
-            return getInputConvertFun<TwistAxis::Z>(distanceMethod);
+void getDistances(const RBFTargets& targets,
+                  RBFDistanceMethod distanceMethod,
+                  ConstArrayView<float> input,
+                  ArrayView<float> distances) {
+    // Only used during construction, so the portable implementation is sufficient
+    using TFVec = trimd::scalar::F256;
+    if (distanceMethod == RBFDistanceMethod::Euclidean) {
+        rbf::cpu::getDistances<TFVec, RBFDistanceMethod::Euclidean>(targets, input, distances);
+    } else {
+        rbf::cpu::getDistances<TFVec, RBFDistanceMethod::Quaternion>(targets, input, distances);
     }
 }
 
@@ -307,11 +128,10 @@ InputConvertFun getInputConvertFun(RBFDistanceMethod distanceMethod, TwistAxis a
 
 RBFSolver::RBFSolver(MemoryResource* memRes) :
     targets{memRes},
-    targetScale{memRes},
-    getDistanceWeight{},
-    convertInput{},
+    targetBounds{memRes},
     radius{},
     weightThreshold{},
+    halfFloatError{},
     distanceMethod{},
     weightFunction{},
     normalizeMethod{},
@@ -320,11 +140,10 @@ RBFSolver::RBFSolver(MemoryResource* memRes) :
 
 RBFSolver::RBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes) :
     targets{memRes},
-    targetScale{recipe.targetScales.begin(), recipe.targetScales.end(), memRes},
-    getDistanceWeight{getDistanceWeightFun(recipe.weightFunction, recipe.distanceMethod)},
-    convertInput{getInputConvertFun(recipe.distanceMethod, recipe.twistAxis)},
+    targetBounds{memRes},
     radius{recipe.radius},
     weightThreshold{recipe.weightThreshold},
+    halfFloatError{},
     distanceMethod{recipe.distanceMethod},
     weightFunction{recipe.weightFunction},
     normalizeMethod{recipe.normalizeMethod},
@@ -332,83 +151,197 @@ RBFSolver::RBFSolver(const RBFSolverRecipe& recipe, MemoryResource* memRes) :
 
     assert(recipe.targetValues.size() % recipe.rawControlCount == 0u);
     const auto targetCount = static_cast<std::uint16_t>(recipe.targetValues.size() / recipe.rawControlCount);
-    targets.resize(targetCount);
 
-    for (std::uint16_t ti = 0u; ti < targetCount; ti++) {
-        const auto offset = static_cast<std::size_t>(ti) * static_cast<std::size_t>(recipe.rawControlCount);
-        const auto targetValues = recipe.targetValues.subview(offset, recipe.rawControlCount);
-        targets[ti].assign(targetValues.begin(), targetValues.end());
-        convertInput(targets[ti]);
-    }
+    const Vector<float> targetValues = getConvertedTargetValues(recipe, memRes);
+    targets.assign(targetValues, recipe.targetScales, targetCount, recipe.rawControlCount);
 
     if (recipe.isAutomaticRadius) {
-        auto getDistance = getDistanceFun(recipe.distanceMethod);
-        ConstArrayView<AlignedVector<float> > targetsView{targets};
-        Vector<float> bufferVec {targets.size(), 0.0f, memRes};
+        Vector<float> target{recipe.rawControlCount, 0.0f, memRes};
+        Vector<float> distances{targetCount, 0.0f, memRes};
 
         float sumDistance = 0.0f;
         for (std::size_t i = {}; i < targetCount; ++i) {
-            const std::size_t offset = i + 1ul;
-            const std::size_t count = targetCount - offset;
-            ArrayView<float> buffer{bufferVec.data() + offset, count};
-            getDistance(targetsView.subview(offset, count), targets[i], buffer);
-            sumDistance = std::accumulate(buffer.begin(), buffer.end(), sumDistance);
+            targets.getTarget(i, target);
+            getDistances(targets, distanceMethod, target, distances);
+            // Each pair of targets is counted only once
+            sumDistance = std::accumulate(extd::advanced(distances.begin(), i + 1ul), distances.end(), sumDistance);
         }
         const float distancesCount = static_cast<float>(targetCount) * static_cast<float>(targetCount - 1ul) / 2.0f;
         radius = sumDistance / distancesCount;
     }
+
+    if (usesTargetBounds(weightFunction, targetCount)) {
+        computeTargetBounds(memRes);
+    }
+}
+
+void RBFSolver::computeTargetBounds(MemoryResource* memRes) {
+    const std::size_t controlCount = targets.controlCount;
+    const std::size_t blockCount = targets.getBlockCount();
+    Vector<float> centerValues{blockCount * controlCount, 0.0f, memRes};
+    Vector<float> radii{blockCount, 0.0f, memRes};
+
+    RBFTargets block{memRes};
+    Vector<float> blockValues{RBFTargets::blockSize * controlCount, 0.0f, memRes};
+    const Vector<float> blockScales{RBFTargets::blockSize, 0.0f, memRes};
+    Vector<float> distances{RBFTargets::blockSize, 0.0f, memRes};
+    for (std::size_t bi = {}; bi < blockCount; ++bi) {
+        const std::size_t firstTarget = bi * RBFTargets::blockSize;
+        const std::size_t blockTargetCount = std::min(RBFTargets::blockSize, targets.targetCount - firstTarget);
+        for (std::size_t ti = {}; ti < blockTargetCount; ++ti) {
+            targets.getTarget(firstTarget + ti, ArrayView<float>{blockValues.data() + ti * controlCount, controlCount});
+        }
+        block.assign(ConstArrayView<float>{blockValues.data(), blockTargetCount * controlCount},
+                     ConstArrayView<float>{blockScales.data(), blockTargetCount},
+                     static_cast<std::uint16_t>(blockTargetCount),
+                     targets.controlCount);
+
+        // The target with the smallest distance to the farthest other target of the block becomes its center
+        std::size_t center = {};
+        float blockRadius = std::numeric_limits<float>::max();
+        for (std::size_t ti = {}; ti < blockTargetCount; ++ti) {
+            const ConstArrayView<float> target{blockValues.data() + ti * controlCount, controlCount};
+            getDistances(block, distanceMethod, target, distances);
+            const float farthest = *std::max_element(distances.begin(), extd::advanced(distances.begin(), blockTargetCount));
+            if (farthest < blockRadius) {
+                blockRadius = farthest;
+                center = ti;
+            }
+        }
+        std::copy_n(extd::advanced(blockValues.begin(), center * controlCount), controlCount,
+                    extd::advanced(centerValues.begin(), bi * controlCount));
+        radii[bi] = blockRadius;
+    }
+
+    const Vector<float> centerScales{blockCount, 0.0f, memRes};
+    targetBounds.centers.assign(centerValues, centerScales, static_cast<std::uint16_t>(blockCount), targets.controlCount);
+    targetBounds.radii.resize(RBFTargets::getPaddedCount(blockCount));
+    std::fill(targetBounds.radii.begin(), targetBounds.radii.end(), 0.0f);
+    std::copy(radii.begin(), radii.end(), targetBounds.radii.begin());
 }
 
 void RBFSolver::load(terse::BinaryInputArchive<BoundedIOStream>& archive) {
     archive(targets);
-    archive(targetScale);
+    archive(targetBounds);
     archive(radius);
     archive(weightThreshold);
+    archive(halfFloatError);
     archive(distanceMethod);
     archive(weightFunction);
     archive(normalizeMethod);
     archive(twistAxis);
-    getDistanceWeight = getDistanceWeightFun(weightFunction, distanceMethod);
-    convertInput = getInputConvertFun(distanceMethod, twistAxis);
 }
 
 void RBFSolver::save(terse::BinaryOutputArchive<BoundedIOStream>& archive) {
     archive(targets);
-    archive(targetScale);
+    archive(targetBounds);
     archive(radius);
     archive(weightThreshold);
+    archive(halfFloatError);
     archive(distanceMethod);
     archive(weightFunction);
     archive(normalizeMethod);
     archive(twistAxis);
 }
 
-void RBFSolver::normalizeAndCutOff(ArrayView<float> outputWeights) const {
-    float sumWeight = 0.0f;
-    for (float weight : outputWeights) {
-        sumWeight += weight;
+void RBFSolver::collectValues(Vector<RBFValues*>& values) {
+    values.push_back(&targets.values);
+    values.push_back(&targets.scales);
+}
+
+void RBFSolver::convertToHalfFloats(const HalfFloatConverter& converter, MemoryResource* memRes) {
+    Vector<RBFValues*> values{memRes};
+    collectValues(values);
+    // E.g. coefficients of poorly conditioned kernel matrices may not fit, in which case the solver is left as it is
+    if (!std::all_of(values.begin(), values.end(), [](const RBFValues* v) {
+            return v->fitsHalfFloats();
+        })) {
+        return;
     }
-    float normalizationRatio = 1.0f;
-    if ((sumWeight > 1.0f) || (normalizeMethod == RBFNormalizeMethod::AlwaysNormalize)) {
-        normalizationRatio = 1.0f / sumWeight;
+
+    const std::size_t targetCount = targets.targetCount;
+    const std::size_t controlCount = targets.controlCount;
+    const std::size_t paddedCount = RBFTargets::getPaddedCount(targetCount);
+    const std::size_t stride = std::max((targetCount + maxHalfFloatSampleCount - 1ul) / maxHalfFloatSampleCount, 1ul);
+    Vector<float> samples{memRes};
+    Vector<float> expectedWeights{memRes};
+    Vector<float> intermediateWeights{paddedCount, 0.0f, memRes};
+    Vector<float> weights{paddedCount, 0.0f, memRes};
+    for (std::size_t ti = {}; ti < targetCount; ti += stride) {
+        samples.resize(samples.size() + controlCount);
+        const ArrayView<float> sample{samples.data() + samples.size() - controlCount, controlCount};
+        targets.getTarget(ti, sample);
+        getPoseWeights(sample, intermediateWeights, weights);
+        expectedWeights.insert(expectedWeights.end(), weights.begin(), extd::advanced(weights.begin(), targetCount));
     }
-    // vectorize TODO
-    for (std::uint16_t i = 0u; i < outputWeights.size(); i++) {
-        float weight = outputWeights[i] * normalizationRatio * targetScale[i];
-        if (weight > weightThreshold) {
-            outputWeights[i] = weight;
-        } else {
-            outputWeights[i] = 0.0f;
+
+    Matrix<float> originalValues{values.size(), Vector<float>{memRes}, memRes};
+    for (std::size_t vi = {}; vi < values.size(); ++vi) {
+        auto v = values[vi];
+        originalValues[vi].assign(v->floats.begin(), v->floats.end());
+        v->roundToHalfFloats(converter, memRes);
+    }
+    // Bounds must enclose the targets as evaluated
+    if (!targetBounds.empty()) {
+        computeTargetBounds(memRes);
+    }
+
+    float maxError = 0.0f;
+    for (std::size_t si = {}; si < samples.size() / controlCount; ++si) {
+        getPoseWeights(ConstArrayView<float>{samples.data() + si * controlCount, controlCount}, intermediateWeights, weights);
+        for (std::size_t ti = {}; ti < targetCount; ++ti) {
+            maxError = std::max(maxError, std::abs(weights[ti] - expectedWeights[si * targetCount + ti]));
+        }
+    }
+
+    if (maxError > maxHalfFloatError) {
+        for (std::size_t vi = {}; vi < values.size(); ++vi) {
+            std::copy(originalValues[vi].begin(), originalValues[vi].end(), values[vi]->floats.begin());
         }
+        if (!targetBounds.empty()) {
+            computeTargetBounds(memRes);
+        }
+        return;
     }
+
+    for (auto v : values) {
+        v->convertToHalfFloats(converter);
+    }
+    halfFloatError = maxError;
+}
+
+void RBFSolver::convertToFloats(const HalfFloatConverter& converter, MemoryResource* memRes) {
+    Vector<RBFValues*> values{memRes};
+    collectValues(values);
+    for (auto v : values) {
+        if (v->isHalfFloat()) {
+            v->convertToFloats(converter, memRes);
+        }
+    }
+}
+
+bool RBFSolver::hasHalfFloatValues() const {
+    return targets.values.isHalfFloat();
 }
 
-ConstArrayView<AlignedVector<float> > RBFSolver::getTargets() const {
+float RBFSolver::getHalfFloatError() const {
+    return halfFloatError;
+}
+
+void RBFSolver::getDistanceWeights(ConstArrayView<float> input, ArrayView<float> weights) const {
+    rbf::cpu::getDistanceWeights<trimd::scalar::F256>(distanceMethod, weightFunction, targets, input, weights, radius);
+}
+
+const RBFTargets& RBFSolver::getTargets() const {
     return targets;
 }
 
+const RBFTargetBounds& RBFSolver::getTargetBounds() const {
+    return targetBounds;
+}
+
 ConstArrayView<float> RBFSolver::getTargetScales() const {
-    return targetScale;
+    return {targets.scales.floats.data(), targets.scales.isHalfFloat() ? 0ul : targets.targetCount};
 }
 
 float RBFSolver::getRadius() const {
@@ -437,6 +370,33 @@ TwistAxis RBFSolver::getTwistAxis() const {
 
 RBFSolver::~RBFSolver() = default;
 
+Vector<std::uint16_t> RBFSolver::getTargetOrder(const RBFSolverRecipe& recipe, MemoryResource* memRes) {
+    assert(recipe.targetValues.size() % recipe.rawControlCount == 0u);
+    const std::size_t targetCount = recipe.targetValues.size() / recipe.rawControlCount;
+    Vector<std::uint16_t> order{memRes};
+    if (!usesTargetBounds(recipe.weightFunction, targetCount)) {
+        return order;
+    }
+
+    Vector<float> targetValues = getConvertedTargetValues(recipe, memRes);
+    if (recipe.distanceMethod != RBFDistanceMethod::Euclidean) {
+        // q and -q represent the same rotation, so quaternions are brought into the same hemisphere before
+        // being compared by their components
+        for (std::size_t qi = {}; qi < targetValues.size(); qi += 4ul) {
+            if (targetValues[qi + 3ul] < 0.0f) {
+                std::transform(extd::advanced(targetValues.begin(), qi), extd::advanced(targetValues.begin(), qi + 4ul),
+                               extd::advanced(targetValues.begin(), qi), [](float value) {
+                        return -value;
+                    });
+            }
+        }
+    }
+    order.resize(targetCount);
+    std::iota(order.begin(), order.end(), static_cast<std::uint16_t>(0u));
+    orderTargets(targetValues, recipe.rawControlCount, order.data(), order.data() + order.size());
+    return order;
+}
+
 RBFSolver::Pointer RBFSolver::create(RBFSolverRecipe recipe, MemoryResource* memRes) {
     const auto solverType = recipe.solverType;
 
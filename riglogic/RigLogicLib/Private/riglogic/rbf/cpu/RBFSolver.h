@@ -3,13 +3,13 @@
 #pragma once
 
 #include "riglogic/TypeDefs.h"
+#include "riglogic/rbf/cpu/RBFTargets.h"
 
 #ifdef _MSC_VER
     #pragma warning(push)
     #pragma warning(disable : 4365 4987)
 #endif
 #include <cstdint>
-#include <functional>
 #ifdef _MSC_VER
     #pragma warning(pop)
 #endif
@@ -36,16 +36,18 @@ struct RBFSolverRecipe {
     ConstArrayView<float> targetScales;
 };
 
+// Solvers only hold the data, they are evaluated by the RBF behavior evaluator with kernels specialized
+// for each solver configuration (see RBFSolverKernel.h)
 class RBFSolver {
     public:
         using Pointer = UniqueInstance<RBFSolver>::PointerType;
-        using DistanceWeightFun = std::function<void (ConstArrayView<AlignedVector<float> >, ConstArrayView<float>,
-                                                      ArrayView<float>,
-                                                      float)>;
-        using InputConvertFun = std::function<void (ArrayView<float>)>;
 
     public:
         static Pointer create(RBFSolverRecipe recipe, MemoryResource* memRes);
+        // Solvers that skip targets out of reach of their weight function expect nearby targets to be adjacent,
+        // so the returned order is to be applied to the recipe (and all per-target data) before creating the solver.
+        // Empty if the solver evaluates all targets, in which case targets are used in the order given.
+        static Vector<std::uint16_t> getTargetOrder(const RBFSolverRecipe& recipe, MemoryResource* memRes);
 
     public:
         explicit RBFSolver(MemoryResource* memRes);
@@ -54,14 +56,25 @@ class RBFSolver {
         virtual ~RBFSolver();
 
         virtual RBFSolverType getSolverType() const = 0;
-        virtual void solve(ArrayView<float> input, ArrayView<float> intermediateWeights,
-                           ArrayView<float> outputWeights) const = 0;
-
 
         virtual void load(terse::BinaryInputArchive<BoundedIOStream>& archive);
         virtual void save(terse::BinaryOutputArchive<BoundedIOStream>& archive);
 
-        ConstArrayView<AlignedVector<float> > getTargets() const;
+        // Stores the values read by the kernels as half floats, unless some of them are out of the range of half floats.
+        // Pose weights are evaluated at (a sample of) the targets before and after the conversion, and the largest
+        // difference between them is kept as the error caused by the conversion, unless it is too large, in which case
+        // values remain stored as floats.
+        void convertToHalfFloats(const HalfFloatConverter& converter, MemoryResource* memRes);
+        // Stores half float values as floats again, for evaluators which do not evaluate half floats (the error of
+        // their conversion is kept, as the values remain rounded to half floats)
+        void convertToFloats(const HalfFloatConverter& converter, MemoryResource* memRes);
+        bool hasHalfFloatValues() const;
+        // Zero if values are stored as floats
+        float getHalfFloatError() const;
+
+        const RBFTargets& getTargets() const;
+        const RBFTargetBounds& getTargetBounds() const;
+        // Empty if values are stored as half floats
         ConstArrayView<float> getTargetScales() const;
         float getRadius() const;
         float getWeightThreshold() const;
@@ -70,16 +83,25 @@ class RBFSolver {
         RBFNormalizeMethod getNormalizeMethod() const;
         TwistAxis getTwistAxis() const;
 
+    private:
+        void computeTargetBounds(MemoryResource* memRes);
+
     protected:
-        void normalizeAndCutOff(ArrayView<float> outputWeights) const;
+        // Not vectorized with the instruction set the solver is evaluated with, so only meant for use during construction
+        // (while values are still stored as floats). Inputs are expected to be converted already, as targets are.
+        void getDistanceWeights(ConstArrayView<float> input, ArrayView<float> weights) const;
+        // Weights are padded to whole target blocks
+        virtual void getPoseWeights(ConstArrayView<float> input,
+                                    ArrayView<float> intermediateWeights,
+                                    ArrayView<float> weights) const = 0;
+        virtual void collectValues(Vector<RBFValues*>& values);
 
     protected:
-        Vector<AlignedVector<float> > targets;
-        Vector<float> targetScale;
-        DistanceWeightFun getDistanceWeight;
-        InputConvertFun convertInput;
+        RBFTargets targets;
+        RBFTargetBounds targetBounds;
         float radius;
         float weightThreshold;
+        float halfFloatError;
         RBFDistanceMethod distanceMethod;
         RBFFunctionType weightFunction;
         RBFNormalizeMethod normalizeMethod;
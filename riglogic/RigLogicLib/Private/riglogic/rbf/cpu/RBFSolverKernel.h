@@ -0,0 +1,223 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/rbf/cpu/DistanceWeightFunctors.h"
+#include "riglogic/rbf/cpu/InputConvertFunctors.h"
+#include "riglogic/rbf/cpu/InterpolativeRBFSolver.h"
+#include "riglogic/rbf/cpu/RBFSolver.h"
+#include "riglogic/rbf/cpu/RBFTargets.h"
+#include "riglogic/utils/Macros.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace rl4 {
+
+namespace rbf {
+
+namespace cpu {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+template<typename TFVec>
+FORCE_INLINE TFVec getTailMask(std::size_t laneCount) {
+    alignas(TFVec::alignment()) static const float laneIndices[] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+    static_assert(sizeof(laneIndices) / sizeof(float) == TFVec::size(), "Lane indices must span exactly one SIMD register.");
+    return TFVec::fromAlignedSource(laneIndices) < TFVec{static_cast<float>(laneCount)};
+}
+
+// Computes the weights of all target blocks, zeroing the padding lanes of the last block, and returns their sum,
+// so the weights need not be traversed again just to find the normalization ratio.
+// T is the type that solver values are stored as (float or half float).
+template<typename TFVec, typename T, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType>
+FORCE_INLINE float calculateDistanceWeights(const RBFTargets& targets,
+                                            ConstArrayView<float> input,
+                                            ArrayView<float> weights,
+                                            float kernelWidth) {
+    static_assert(TFVec::size() == RBFTargets::blockSize, "Target blocks must span exactly one SIMD register.");
+    assert(weights.size() >= RBFTargets::getPaddedCount(targets.targetCount));
+    using D = DistanceMethodFunctor<TFVec, TDistanceMethod>;
+    using W = WeightMethodFunctor<TFVec, TFunctionType>;
+    const TFVec scale{W::getScale(kernelWidth)};
+    const std::size_t fullBlockCount = targets.targetCount / TFVec::size();
+    float* destination = weights.data();
+    TFVec sumWeight{};
+    for (std::size_t bi = {}; bi < fullBlockCount; ++bi, destination += TFVec::size()) {
+        const TFVec weight = W::getWeight(D::getDistance(targets.getBlock<T>(bi), input) * scale);
+        weight.alignedStore(destination);
+        sumWeight += weight;
+    }
+    const std::size_t remainder = targets.targetCount % TFVec::size();
+    if (remainder != 0ul) {
+        const TFVec weight = W::getWeight(D::getDistance(targets.getBlock<T>(fullBlockCount), input) * scale) &
+            getTailMask<TFVec>(remainder);
+        weight.alignedStore(destination);
+        sumWeight += weight;
+    }
+    return sumWeight.sum();
+}
+
+// Same as above, except that blocks whose bounding ball lies entirely beyond the kernel width are skipped (their weights
+// are all zero when the weight function has compact support), which is decided for eight blocks at a time.
+// Target bounds are always stored as floats.
+template<typename TFVec, typename T, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType>
+FORCE_INLINE float calculatePrunedDistanceWeights(const RBFTargets& targets,
+                                                  const RBFTargetBounds& bounds,
+                                                  ConstArrayView<float> input,
+                                                  ArrayView<float> weights,
+                                                  float kernelWidth) {
+    assert(weights.size() >= RBFTargets::getPaddedCount(targets.targetCount));
+    using D = DistanceMethodFunctor<TFVec, TDistanceMethod>;
+    using W = WeightMethodFunctor<TFVec, TFunctionType>;
+    const TFVec scale{W::getScale(kernelWidth)};
+    // Leaves room for rounding errors in the distances, which are the largest (~sqrt(epsilon)) for arc lengths close to zero
+    const float reach = kernelWidth * 1.001f + 1.0e-3f;
+    const std::size_t blockCount = targets.getBlockCount();
+    const std::size_t remainder = targets.targetCount % TFVec::size();
+    alignas(TFVec::alignment()) float lowerBounds[TFVec::size()];
+    TFVec sumWeight{};
+    for (std::size_t cbi = {}; cbi < bounds.centers.getBlockCount(); ++cbi) {
+        const TFVec centerDistance = D::getDistance(bounds.centers.getBlock(cbi), input);
+        (centerDistance - TFVec::fromAlignedSource(bounds.radii.data() + cbi * TFVec::size())).alignedStore(lowerBounds);
+        const std::size_t firstBlock = cbi * TFVec::size();
+        const std::size_t lastBlock = std::min(firstBlock + TFVec::size(), blockCount);
+        for (std::size_t bi = firstBlock; bi < lastBlock; ++bi) {
+            float* destination = weights.data() + bi * TFVec::size();
+            if (lowerBounds[bi - firstBlock] > reach) {
+                TFVec{}.alignedStore(destination);
+                continue;
+            }
+            TFVec weight = W::getWeight(D::getDistance(targets.getBlock<T>(bi), input) * scale);
+            if ((remainder != 0ul) && (bi == blockCount - 1ul)) {
+                weight = weight & getTailMask<TFVec>(remainder);
+            }
+            weight.alignedStore(destination);
+            sumWeight += weight;
+        }
+    }
+    return sumWeight.sum();
+}
+
+template<typename TFVec, typename T, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType>
+FORCE_INLINE float calculateDistanceWeights(const RBFSolver& solver, ConstArrayView<float> input, ArrayView<float> weights) {
+    if (WeightMethodFunctor<TFVec, TFunctionType>::hasCompactSupport && !solver.getTargetBounds().empty()) {
+        return calculatePrunedDistanceWeights<TFVec, T, TDistanceMethod, TFunctionType>(solver.getTargets(),
+                                                                                      solver.getTargetBounds(),
+                                                                                      input,
+                                                                                      weights,
+                                                                                      solver.getRadius());
+    }
+    return calculateDistanceWeights<TFVec, T, TDistanceMethod, TFunctionType>(solver.getTargets(), input, weights,
+                                                                              solver.getRadius());
+}
+
+// Normalization, target scaling and weight threshold cut-off in a single pass over the (zero-padded) target blocks
+template<typename TFVec, typename T>
+FORCE_INLINE void normalizeAndCutOff(const RBFSolver& solver, float sumWeight, ArrayView<float> weights) {
+    float normalizationRatio = 1.0f;
+    if ((sumWeight > 1.0f) || (solver.getNormalizeMethod() == RBFNormalizeMethod::AlwaysNormalize)) {
+        normalizationRatio = 1.0f / sumWeight;
+    }
+    const TFVec ratio{normalizationRatio};
+    const TFVec threshold{solver.getWeightThreshold()};
+    const T* scales = solver.getTargets().scales.data<T>();
+    const std::size_t paddedCount = RBFTargets::getPaddedCount(solver.getTargets().targetCount);
+    assert(weights.size() >= paddedCount);
+    for (std::size_t i = {}; i < paddedCount; i += TFVec::size()) {
+        const TFVec weight = TFVec::fromAlignedSource(weights.data() + i) * ratio * TFVec::fromAlignedSource(scales + i);
+        (weight & (weight > threshold)).alignedStore(weights.data() + i);
+    }
+}
+
+// Solver configuration is fixed at compile time, so that input conversion, distance, weight function and normalization
+// are all inlined into the evaluator, without any indirect calls per solver
+template<typename TFVec, typename T, RBFSolverType TSolverType, RBFDistanceMethod TDistanceMethod,
+         RBFFunctionType TFunctionType, TwistAxis TTwistAxis>
+struct RBFSolverKernel;
+
+template<typename TFVec, typename T, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType, TwistAxis TTwistAxis>
+struct RBFSolverKernel<TFVec, T, RBFSolverType::Additive, TDistanceMethod, TFunctionType, TTwistAxis> {
+    static FORCE_INLINE void solve(const RBFSolver& solver,
+                                   ArrayView<float> input,
+                                   ArrayView<float>  /*unused*/,
+                                   ArrayView<float> outputWeights) {
+        InputConvertFunctor<TDistanceMethod, TTwistAxis>::convert(input);
+        const float sumWeight = calculateDistanceWeights<TFVec, T, TDistanceMethod, TFunctionType>(solver, input, outputWeights);
+        normalizeAndCutOff<TFVec, T>(solver, sumWeight, outputWeights);
+    }
+
+};
+
+// Multiplies a block of coefficient rows with the intermediate weights. Like the BPCM joint kernels, four columns
+// are consumed per iteration, into independent accumulators, to hide the latency of the multiply-adds.
+template<typename TFVec, typename T>
+FORCE_INLINE TFVec multiplyCoefficientBlock(const T* block, const float* weights, std::size_t columnCount) {
+    TFVec sum1{};
+    TFVec sum2{};
+    TFVec sum3{};
+    TFVec sum4{};
+    const std::size_t columnCountAlignedTo4 = columnCount - (columnCount % 4ul);
+    std::size_t ci = {};
+    for (; ci < columnCountAlignedTo4; ci += 4ul, block += (4ul * TFVec::size())) {
+        sum1 = trimd::fmadd(TFVec::fromAlignedSource(block), TFVec{weights[ci]}, sum1);
+        sum2 = trimd::fmadd(TFVec::fromAlignedSource(block + TFVec::size()), TFVec{weights[ci + 1ul]}, sum2);
+        sum3 = trimd::fmadd(TFVec::fromAlignedSource(block + TFVec::size() * 2ul), TFVec{weights[ci + 2ul]}, sum3);
+        sum4 = trimd::fmadd(TFVec::fromAlignedSource(block + TFVec::size() * 3ul), TFVec{weights[ci + 3ul]}, sum4);
+    }
+    for (; ci < columnCount; ++ci, block += TFVec::size()) {
+        sum1 = trimd::fmadd(TFVec::fromAlignedSource(block), TFVec{weights[ci]}, sum1);
+    }
+    sum1 += sum2;
+    sum3 += sum4;
+    return sum1 + sum3;
+}
+
+// Interpolates the output weights from the distance weights, and returns their sum
+template<typename TFVec, typename T>
+FORCE_INLINE float interpolateWeights(const InterpolativeRBFSolver& solver,
+                                      ConstArrayView<float> intermediateWeights,
+                                      ArrayView<float> outputWeights) {
+    // Padding rows of the coefficient blocks are all zeros, so padding lanes of the output weights end up as zero too
+    const auto& targets = solver.getTargets();
+    const TFVec zero{};
+    const TFVec one{1.0f};
+    TFVec sumWeight{};
+    for (std::size_t bi = {}; bi < targets.getBlockCount(); ++bi) {
+        TFVec weight = multiplyCoefficientBlock<TFVec>(solver.getCoefficientBlock<T>(bi),
+                                                       intermediateWeights.data(),
+                                                       targets.targetCount);
+        // Clamp to [0, 1]
+        weight = weight & (weight > zero);
+        const TFVec aboveOne = (weight > one);
+        weight = andnot(aboveOne, weight) | (one & aboveOne);
+        weight.alignedStore(outputWeights.data() + bi * TFVec::size());
+        sumWeight += weight;
+    }
+    return sumWeight.sum();
+}
+
+template<typename TFVec, typename T, RBFDistanceMethod TDistanceMethod, RBFFunctionType TFunctionType, TwistAxis TTwistAxis>
+struct RBFSolverKernel<TFVec, T, RBFSolverType::Interpolative, TDistanceMethod, TFunctionType, TTwistAxis> {
+    static FORCE_INLINE void solve(const RBFSolver& solver,
+                                   ArrayView<float> input,
+                                   ArrayView<float> intermediateWeights,
+                                   ArrayView<float> outputWeights) {
+        InputConvertFunctor<TDistanceMethod, TTwistAxis>::convert(input);
+        calculateDistanceWeights<TFVec, T, TDistanceMethod, TFunctionType>(solver, input, intermediateWeights);
+        const auto& interpolativeSolver = static_cast<const InterpolativeRBFSolver&>(solver);
+        const float sumWeight = interpolateWeights<TFVec, T>(interpolativeSolver, intermediateWeights, outputWeights);
+        normalizeAndCutOff<TFVec, T>(solver, sumWeight, outputWeights);
+    }
+
+};
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace cpu
+
+}  // namespace rbf
+
+}  // namespace rl4
@@ -0,0 +1,175 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/types/MappableVector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace rl4 {
+
+// Conversions between floats and half floats, done with the instruction set the solvers are evaluated with (see
+// CPURBFBehaviorFactory.h). Value counts are always multiples of RBFTargets::blockSize.
+struct HalfFloatConverter {
+    void (* toHalfFloats)(ConstArrayView<float> source, ArrayView<std::uint16_t> destination);
+    void (* toFloats)(ConstArrayView<std::uint16_t> source, ArrayView<float> destination);
+};
+
+// Values read by the solver kernels, stored as floats, or once converted, as half floats (the floats are released then)
+struct RBFValues {
+    static constexpr float maxHalfFloat = 65504.0f;
+
+    MappableVector<float> floats;
+    MappableVector<std::uint16_t> halfFloats;
+
+    explicit RBFValues(MemoryResource* memRes) : floats{memRes}, halfFloats{memRes} {
+    }
+
+    bool isHalfFloat() const {
+        return !halfFloats.empty();
+    }
+
+    template<typename T>
+    const T* data() const;
+
+    bool fitsHalfFloats() const {
+        return std::all_of(floats.begin(), floats.end(), [](float value) {
+                return (value >= -maxHalfFloat) && (value <= maxHalfFloat);
+            });
+    }
+
+    // Values remain stored as floats, but are rounded to the nearest half floats
+    void roundToHalfFloats(const HalfFloatConverter& converter, MemoryResource* memRes) {
+        Vector<std::uint16_t> rounded{floats.size(), {}, memRes};
+        converter.toHalfFloats({floats.data(), floats.size()}, rounded);
+        converter.toFloats(rounded, {floats.data(), floats.size()});
+    }
+
+    void convertToHalfFloats(const HalfFloatConverter& converter) {
+        halfFloats.resize(floats.size());
+        converter.toHalfFloats({floats.data(), floats.size()}, {halfFloats.data(), halfFloats.size()});
+        floats.clear();
+    }
+
+    // Values stored as half floats are stored as floats again (the half floats may be mapped, so they are replaced)
+    void convertToFloats(const HalfFloatConverter& converter, MemoryResource* memRes) {
+        MappableVector<float> converted{memRes};
+        converted.resize(halfFloats.size());
+        converter.toFloats({halfFloats.data(), halfFloats.size()}, {converted.data(), converted.size()});
+        floats = std::move(converted);
+        halfFloats = MappableVector<std::uint16_t>{memRes};
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(floats, halfFloats);
+    }
+
+};
+
+template<>
+inline const float* RBFValues::data<float>() const {
+    assert(!isHalfFloat());
+    return floats.data();
+}
+
+template<>
+inline const std::uint16_t* RBFValues::data<std::uint16_t>() const {
+    assert(isHalfFloat());
+    return halfFloats.data();
+}
+
+// Targets are split into blocks of blockSize targets, and within a block the values are laid out control-major,
+// i.e. the values of a single control for all targets of the block are contiguous, so each block can be evaluated
+// with targets spread across SIMD lanes. The last block is zero-padded to a full block, and so are the target scales,
+// so padding lanes always end up with zero weight.
+// Values and scales may be converted to half floats once the solver is constructed, after which only the kernels may
+// access them (with the matching value type).
+struct RBFTargets {
+    static constexpr std::size_t blockSize = 8ul;
+
+    RBFValues values;
+    RBFValues scales;
+    std::uint16_t targetCount;
+    std::uint16_t controlCount;
+
+    explicit RBFTargets(MemoryResource* memRes) : values{memRes}, scales{memRes}, targetCount{}, controlCount{} {
+    }
+
+    static std::size_t getPaddedCount(std::size_t count) {
+        return ((count + blockSize - 1ul) / blockSize) * blockSize;
+    }
+
+    std::size_t getBlockCount() const {
+        return (static_cast<std::size_t>(targetCount) + blockSize - 1ul) / blockSize;
+    }
+
+    template<typename T = float>
+    const T* getBlock(std::size_t blockIndex) const {
+        return values.data<T>() + blockIndex * controlCount * blockSize;
+    }
+
+    // Target values are given target-major, as laid out in DNA
+    void assign(ConstArrayView<float> targetValues,
+                ConstArrayView<float> targetScales,
+                std::uint16_t targetCount_,
+                std::uint16_t controlCount_) {
+        assert(targetValues.size() == static_cast<std::size_t>(targetCount_) * controlCount_);
+        assert(targetScales.size() == targetCount_);
+        targetCount = targetCount_;
+        controlCount = controlCount_;
+        values.floats.resize(getBlockCount() * controlCount * blockSize);
+        std::fill(values.floats.begin(), values.floats.end(), 0.0f);
+        scales.floats.resize(getPaddedCount(targetCount));
+        std::fill(scales.floats.begin(), scales.floats.end(), 0.0f);
+        std::copy(targetScales.begin(), targetScales.end(), scales.floats.begin());
+        for (std::size_t ti = {}; ti < targetCount; ++ti) {
+            float* block = values.floats.data() + (ti / blockSize) * controlCount * blockSize;
+            for (std::size_t ci = {}; ci < controlCount; ++ci) {
+                block[ci * blockSize + ti % blockSize] = targetValues[ti * controlCount + ci];
+            }
+        }
+    }
+
+    void getTarget(std::size_t targetIndex, ArrayView<float> destination) const {
+        assert(destination.size() >= controlCount);
+        const float* block = getBlock(targetIndex / blockSize);
+        for (std::size_t ci = {}; ci < controlCount; ++ci) {
+            destination[ci] = block[ci * blockSize + targetIndex % blockSize];
+        }
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(values, scales, targetCount, controlCount);
+    }
+
+};
+
+// Bounding balls of the target blocks, each centered at one of the targets of the block (the one closest to all others),
+// so blocks entirely out of reach of weight functions with compact support can be skipped. The centers are themselves
+// laid out in blocks, so the distances to eight of them are computed at once. Empty if the solver does not use them.
+struct RBFTargetBounds {
+    RBFTargets centers;
+    MappableVector<float> radii;
+
+    explicit RBFTargetBounds(MemoryResource* memRes) : centers{memRes}, radii{memRes} {
+    }
+
+    bool empty() const {
+        return (centers.targetCount == 0u);
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(centers, radii);
+    }
+
+};
+
+}  // namespace rl4
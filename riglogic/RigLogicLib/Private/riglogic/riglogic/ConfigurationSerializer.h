@@ -18,7 +18,10 @@ void serialize(Archive& archive, Configuration& config) {
             config.translationType,
             config.rotationType,
             config.rotationOrder,
-            config.scaleType);
+            config.scaleType,
+            config.activationFunctionAccuracy,
+            config.neuralNetworkWeightQuantization,
+            config.floatingPointType);
 }
 
 }  // namespace rl4
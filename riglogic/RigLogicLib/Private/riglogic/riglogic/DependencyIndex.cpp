@@ -0,0 +1,209 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/riglogic/DependencyIndex.h"
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/animatedmaps/AnimatedMaps.h"
+#include "riglogic/blendshapes/BlendShapes.h"
+#include "riglogic/controls/Controls.h"
+#include "riglogic/joints/Joints.h"
+#include "riglogic/ml/MachineLearnedBehavior.h"
+#include "riglogic/rbf/RBFBehavior.h"
+#include "riglogic/utils/Extd.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+DependencyMap::DependencyMap(MemoryResource* memRes) :
+    offsets{memRes},
+    dependents{memRes} {
+}
+
+void DependencyMap::assign(std::size_t controlCount,
+                           ConstArrayView<std::uint16_t> controls,
+                           ConstArrayView<std::uint16_t> dependents_) {
+    assert(controls.size() == dependents_.size());
+    offsets.assign(controlCount + 1ul, 0u);
+    for (auto control : controls) {
+        assert(control < controlCount);
+        ++offsets[control + 1ul];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    Vector<std::uint32_t> positions{offsets.begin(), offsets.end() - 1, offsets.get_allocator()};
+    dependents.resize(controls.size());
+    for (std::size_t i = {}; i < controls.size(); ++i) {
+        dependents[positions[controls[i]]++] = dependents_[i];
+    }
+
+    // Remove duplicate dependents of each control, compacting the storage in place
+    std::uint32_t writeOffset = {};
+    for (std::size_t control = {}; control < controlCount; ++control) {
+        const auto first = dependents.begin() + static_cast<std::ptrdiff_t>(offsets[control]);
+        auto last = dependents.begin() + static_cast<std::ptrdiff_t>(offsets[control + 1ul]);
+        std::sort(first, last);
+        last = std::unique(first, last);
+        offsets[control] = writeOffset;
+        std::copy(first, last, dependents.begin() + static_cast<std::ptrdiff_t>(writeOffset));
+        writeOffset += static_cast<std::uint32_t>(last - first);
+    }
+    offsets[controlCount] = writeOffset;
+    dependents.resize(writeOffset);
+    dependents.shrink_to_fit();
+}
+
+void DependencyMap::collect(ConstArrayView<std::uint16_t> controls, Vector<std::uint16_t>& result) const {
+    result.clear();
+    for (auto control : controls) {
+        if (static_cast<std::size_t>(control) + 1ul < offsets.size()) {
+            result.insert(result.end(),
+                          dependents.begin() + static_cast<std::ptrdiff_t>(offsets[control]),
+                          dependents.begin() + static_cast<std::ptrdiff_t>(offsets[control + 1ul]));
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+DependencyIndex::DependencyIndex(std::uint16_t lodCount,
+                                 std::size_t controlCount,
+                                 const Controls* controls,
+                                 const MachineLearnedBehavior* machineLearnedBehavior,
+                                 const RBFBehavior* rbfBehavior,
+                                 const Joints* joints,
+                                 const BlendShapes* blendShapes,
+                                 const AnimatedMaps* animatedMaps,
+                                 MemoryResource* memRes) :
+    guiToRawControls{memRes},
+    neuralNetworks{lodCount, DependencyMap{memRes}, memRes},
+    rbfSolvers{lodCount, DependencyMap{memRes}, memRes},
+    psds{lodCount, DependencyMap{memRes}, memRes},
+    jointGroups{lodCount, DependencyMap{memRes}, memRes},
+    blendShapeChannelMappings{lodCount, DependencyMap{memRes}, memRes},
+    animatedMapRows{lodCount, DependencyMap{memRes}, memRes} {
+
+    Vector<std::uint16_t> pairControls{memRes};
+    Vector<std::uint16_t> pairDependents{memRes};
+    Vector<std::uint16_t> indices{memRes};
+    auto addPair = [&pairControls, &pairDependents](std::uint16_t control, std::size_t dependent) {
+            pairControls.push_back(control);
+            pairDependents.push_back(static_cast<std::uint16_t>(dependent));
+        };
+
+    const auto guiControlIndices = controls->getGUIToRawInputIndices();
+    const std::size_t guiControlCount = (guiControlIndices.size() == 0ul ? 0ul : extd::maxOf(guiControlIndices) + 1ul);
+    guiToRawControls.assign(guiControlCount, guiControlIndices, controls->getGUIToRawOutputIndices());
+
+    for (std::uint16_t lod = {}; lod < lodCount; ++lod) {
+        pairControls.clear();
+        pairDependents.clear();
+        for (auto neuralNetIndex : machineLearnedBehavior->getNeuralNetworkIndicesForLOD(lod)) {
+            const auto inputIndices = machineLearnedBehavior->getNeuralNetworkInputIndices(static_cast<std::uint16_t>(neuralNetIndex));
+            for (auto inputIndex : inputIndices) {
+                addPair(inputIndex, neuralNetIndex);
+            }
+        }
+        neuralNetworks[lod].assign(controlCount, pairControls, pairDependents);
+
+        pairControls.clear();
+        pairDependents.clear();
+        for (auto solverIndex : rbfBehavior->getSolverIndicesForLOD(lod)) {
+            indices.clear();
+            rbfBehavior->collectSolverInputIndices(solverIndex, indices);
+            for (auto inputIndex : indices) {
+                addPair(inputIndex, solverIndex);
+            }
+        }
+        rbfSolvers[lod].assign(controlCount, pairControls, pairDependents);
+
+        pairControls.clear();
+        pairDependents.clear();
+        for (auto psdIndex : controls->getPSDIndicesForLOD(lod)) {
+            for (auto inputIndex : controls->getPSDInputIndices(psdIndex)) {
+                addPair(inputIndex, psdIndex);
+            }
+        }
+        psds[lod].assign(controlCount, pairControls, pairDependents);
+
+        pairControls.clear();
+        pairDependents.clear();
+        for (std::uint16_t jointGroupIndex = {}; jointGroupIndex < joints->getJointGroupCount(); ++jointGroupIndex) {
+            indices.clear();
+            joints->collectJointGroupInputIndices(lod, jointGroupIndex, indices);
+            for (auto inputIndex : indices) {
+                addPair(inputIndex, jointGroupIndex);
+            }
+        }
+        jointGroups[lod].assign(controlCount, pairControls, pairDependents);
+
+        pairControls.clear();
+        pairDependents.clear();
+        const auto blendShapeInputIndices = blendShapes->getBlendShapeChannelInputIndicesForLOD(lod);
+        for (std::size_t mappingIndex = {}; mappingIndex < blendShapeInputIndices.size(); ++mappingIndex) {
+            addPair(blendShapeInputIndices[mappingIndex], mappingIndex);
+        }
+        blendShapeChannelMappings[lod].assign(controlCount, pairControls, pairDependents);
+
+        // An animated map is recalculated from all of its rows, so a control that is read by any of them
+        // makes all rows of that animated map dependent on it
+        const auto rowInputIndices = animatedMaps->getAnimatedMapInputIndicesForLOD(lod);
+        const auto rowOutputIndices = animatedMaps->getAnimatedMapIndicesForLOD(lod);
+        const std::size_t animatedMapCount = (rowOutputIndices.size() == 0ul ? 0ul : extd::maxOf(rowOutputIndices) + 1ul);
+        Vector<std::uint16_t> rows{rowOutputIndices.size(), {}, memRes};
+        std::iota(rows.begin(), rows.end(), static_cast<std::uint16_t>(0u));
+        DependencyMap rowsPerAnimatedMap{memRes};
+        rowsPerAnimatedMap.assign(animatedMapCount, rowOutputIndices, rows);
+
+        pairControls.clear();
+        pairDependents.clear();
+        for (std::size_t row = {}; row < rowInputIndices.size(); ++row) {
+            rowsPerAnimatedMap.collect(rowOutputIndices.subview(row, 1ul), indices);
+            for (auto dependentRow : indices) {
+                addPair(rowInputIndices[row], dependentRow);
+            }
+        }
+        animatedMapRows[lod].assign(controlCount, pairControls, pairDependents);
+    }
+}
+
+const DependencyMap& DependencyIndex::getGUIToRawControls() const {
+    return guiToRawControls;
+}
+
+const DependencyMap& DependencyIndex::getNeuralNetworks(std::uint16_t lod) const {
+    return neuralNetworks[lod];
+}
+
+const DependencyMap& DependencyIndex::getRBFSolvers(std::uint16_t lod) const {
+    return rbfSolvers[lod];
+}
+
+const DependencyMap& DependencyIndex::getPSDs(std::uint16_t lod) const {
+    return psds[lod];
+}
+
+const DependencyMap& DependencyIndex::getJointGroups(std::uint16_t lod) const {
+    return jointGroups[lod];
+}
+
+const DependencyMap& DependencyIndex::getBlendShapeChannelMappings(std::uint16_t lod) const {
+    return blendShapeChannelMappings[lod];
+}
+
+const DependencyMap& DependencyIndex::getAnimatedMapRows(std::uint16_t lod) const {
+    return animatedMapRows[lod];
+}
+
+}  // namespace rl4
@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rl4 {
+
+class AnimatedMaps;
+class BlendShapes;
+class Controls;
+class Joints;
+class MachineLearnedBehavior;
+class RBFBehavior;
+
+// Maps each control (an index into the input buffer) to the items of an evaluation stage that depend on it
+class DependencyMap {
+    public:
+        explicit DependencyMap(MemoryResource* memRes);
+
+        // Build from parallel arrays of (control, dependent) pairs
+        void assign(std::size_t controlCount, ConstArrayView<std::uint16_t> controls, ConstArrayView<std::uint16_t> dependents_);
+        // Gather the dependents of all given controls, in ascending order and without duplicates
+        void collect(ConstArrayView<std::uint16_t> controls, Vector<std::uint16_t>& result) const;
+
+    private:
+        Vector<std::uint32_t> offsets;
+        Vector<std::uint16_t> dependents;
+
+};
+
+// Precomputed dependencies of the outputs of all evaluation stages on the controls, for each LOD
+class DependencyIndex {
+    public:
+        DependencyIndex(std::uint16_t lodCount,
+                        std::size_t controlCount,
+                        const Controls* controls,
+                        const MachineLearnedBehavior* machineLearnedBehavior,
+                        const RBFBehavior* rbfBehavior,
+                        const Joints* joints,
+                        const BlendShapes* blendShapes,
+                        const AnimatedMaps* animatedMaps,
+                        MemoryResource* memRes);
+
+        // Raw controls mapped from GUI controls (indexed by GUI control instead of control)
+        const DependencyMap& getGUIToRawControls() const;
+        // Neural network indices
+        const DependencyMap& getNeuralNetworks(std::uint16_t lod) const;
+        // RBF solver indices
+        const DependencyMap& getRBFSolvers(std::uint16_t lod) const;
+        // Output indices of PSDs
+        const DependencyMap& getPSDs(std::uint16_t lod) const;
+        // Joint group indices
+        const DependencyMap& getJointGroups(std::uint16_t lod) const;
+        // Positions of blend shape channel mappings
+        const DependencyMap& getBlendShapeChannelMappings(std::uint16_t lod) const;
+        // Conditional table rows of the animated maps, including all rows of each dependent animated map
+        const DependencyMap& getAnimatedMapRows(std::uint16_t lod) const;
+
+    private:
+        DependencyMap guiToRawControls;
+        Vector<DependencyMap> neuralNetworks;
+        Vector<DependencyMap> rbfSolvers;
+        Vector<DependencyMap> psds;
+        Vector<DependencyMap> jointGroups;
+        Vector<DependencyMap> blendShapeChannelMappings;
+        Vector<DependencyMap> animatedMapRows;
+
+};
+
+}  // namespace rl4
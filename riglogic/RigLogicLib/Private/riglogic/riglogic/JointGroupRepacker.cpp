@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/riglogic/JointGroupRepacker.h"
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/joints/JointGroupRepacking.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+void JointGroupRepacker::repack(const dna::Reader* source,
+                                dna::Writer* destination,
+                                CalculationType calculationType,
+                                JointGroupRepackingReport* report,
+                                MemoryResource* memRes) {
+    Configuration config;
+    config.calculationType = calculationType;
+    const auto rowAlignment = JointGroupRepacking::getRowAlignment(config);
+    const auto jointGroups = JointGroupRepacking::repack(source, rowAlignment, report, memRes);
+
+    destination->clearJointGroups();
+    for (std::uint16_t jgi = {}; jgi < static_cast<std::uint16_t>(jointGroups.size()); ++jgi) {
+        const auto& group = jointGroups[jgi];
+        destination->setJointGroupLODs(jgi, group.lods.data(), static_cast<std::uint16_t>(group.lods.size()));
+        destination->setJointGroupInputIndices(jgi,
+                                               group.inputIndices.data(),
+                                               static_cast<std::uint16_t>(group.inputIndices.size()));
+        destination->setJointGroupOutputIndices(jgi,
+                                                group.outputIndices.data(),
+                                                static_cast<std::uint16_t>(group.outputIndices.size()));
+        destination->setJointGroupValues(jgi, group.values.data(), static_cast<std::uint32_t>(group.values.size()));
+        destination->setJointGroupJointIndices(jgi,
+                                               group.jointIndices.data(),
+                                               static_cast<std::uint16_t>(group.jointIndices.size()));
+    }
+}
+
+}  // namespace rl4
@@ -53,8 +53,9 @@ void RigInstance::destroy(RigInstance* instance) {
 
 RigInstance::~RigInstance() = default;
 
-RigInstanceImpl::RigInstanceImpl(const RigMetrics& metrics, RigLogicImpl* rigLogic, MemoryResource* memRes_) :
+RigInstanceImpl::RigInstanceImpl(const RigMetrics& metrics, RigLogicImpl* rigLogic_, MemoryResource* memRes_) :
     memRes{memRes_},
+    rigLogic{rigLogic_},
     lodMaxLevel{getMaxLODLevel(metrics.lodCount)},
     lodLevel{},
     guiControlCount{metrics.guiControlCount},
@@ -66,9 +67,23 @@ RigInstanceImpl::RigInstanceImpl(const RigMetrics& metrics, RigLogicImpl* rigLog
     controlsInstance{rigLogic->createControlsInstance(memRes)},
     machineLearnedBehaviorInstance{rigLogic->createMachineLearnedBehaviorInstance(memRes)},
     rbfBehaviorInstance{rigLogic->createRBFBehaviorInstance(memRes)},
+    rbfBehaviorWorkerInstances{memRes},
     jointsInstance{rigLogic->createJointsInstance(memRes)},
     blendShapesInstance{rigLogic->createBlendShapesInstance(memRes)},
-    animatedMapsInstance{rigLogic->createAnimatedMapsInstance(memRes)} {
+    animatedMapsInstance{rigLogic->createAnimatedMapsInstance(memRes)},
+    calculatedControls{controlsInstance->getInputBuffer().size(), {}, memRes},
+    changedControls{memRes},
+    dependentOutputs{memRes},
+    calculatedControlsValid{false},
+    incrementalCalculationCount{},
+    dirtyRawControls{memRes},
+    rawControlDirtyFlags(rawControlCount, false, memRes),
+    dirtyGUIControls{memRes},
+    guiControlDirtyFlags(guiControlCount, false, memRes),
+    rawControlsOverridden{false} {
+    changedControls.reserve(calculatedControls.size());
+    dirtyRawControls.reserve(rawControlCount);
+    dirtyGUIControls.reserve(guiControlCount);
 }
 
 std::uint16_t RigInstanceImpl::getGUIControlCount() const {
@@ -81,6 +96,10 @@ float RigInstanceImpl::getGUIControl(std::uint16_t index) const {
 
 void RigInstanceImpl::setGUIControl(std::uint16_t index, float value) {
     auto guiControlBuffer = controlsInstance->getGUIControlBuffer();
+    if ((guiControlBuffer[index] != value) && !guiControlDirtyFlags[index]) {
+        guiControlDirtyFlags[index] = true;
+        dirtyGUIControls.push_back(index);
+    }
     guiControlBuffer[index] = value;
 }
 
@@ -90,6 +109,12 @@ ConstArrayView<float> RigInstanceImpl::getGUIControlValues() const {
 
 void RigInstanceImpl::setGUIControlValues(const float* values) {
     auto guiControlBuffer = controlsInstance->getGUIControlBuffer();
+    for (std::uint16_t i = {}; i < guiControlCount; ++i) {
+        if ((guiControlBuffer[i] != values[i]) && !guiControlDirtyFlags[i]) {
+            guiControlDirtyFlags[i] = true;
+            dirtyGUIControls.push_back(i);
+        }
+    }
     #if defined(_MSC_VER) && !defined(__clang__) && (_MSC_VER < 1938)
         #if (_MSC_VER >= 1900) && (__cplusplus >= 202002L)
             std::copy(values,
@@ -115,7 +140,11 @@ float RigInstanceImpl::getRawControl(std::uint16_t index) const {
 
 void RigInstanceImpl::setRawControl(std::uint16_t index, float value) {
     auto inputBuffer = controlsInstance->getInputBuffer();
+    if (inputBuffer[index] != value) {
+        markRawControlDirty(index);
+    }
     inputBuffer[index] = value;
+    rawControlsOverridden = true;
 }
 
 ConstArrayView<float> RigInstanceImpl::getRawControlValues() const {
@@ -124,6 +153,12 @@ ConstArrayView<float> RigInstanceImpl::getRawControlValues() const {
 
 void RigInstanceImpl::setRawControlValues(const float* values) {
     auto inputBuffer = controlsInstance->getInputBuffer();
+    for (std::uint16_t i = {}; i < rawControlCount; ++i) {
+        if (inputBuffer[i] != values[i]) {
+            markRawControlDirty(i);
+        }
+    }
+    rawControlsOverridden = true;
     #if defined(_MSC_VER) && !defined(__clang__) && (_MSC_VER < 1938)
         #if (_MSC_VER >= 1900) && (__cplusplus >= 202002L)
             std::copy(values,
@@ -192,6 +227,8 @@ void RigInstanceImpl::setNeuralNetworkMask(std::uint16_t neuralNetIndex, float v
     assert(neuralNetIndex < neuralNetworkCount);
     auto maskBuffer = machineLearnedBehaviorInstance->getMaskBuffer();
     maskBuffer[neuralNetIndex] = value;
+    // Masks are not compared against their previously calculated values
+    invalidateCalculatedControls();
 }
 
 std::uint16_t RigInstanceImpl::getLOD() const {
@@ -204,6 +241,7 @@ void RigInstanceImpl::setLOD(std::uint16_t level) {
         jointsInstance->resetOutputBuffer();
         blendShapesInstance->resetOutputBuffer();
         animatedMapsInstance->resetOutputBuffer();
+        invalidateCalculatedControls();
     }
     lodLevel = extd::clamp(level, static_cast<std::uint16_t>(0), lodMaxLevel);
 }
@@ -232,6 +270,20 @@ RBFBehaviorOutputInstance* RigInstanceImpl::getRBFBehaviorOutputInstance() {
     return rbfBehaviorInstance.get();
 }
 
+void RigInstanceImpl::reserveRBFBehaviorOutputInstances(std::size_t workerCount) {
+    while (rbfBehaviorWorkerInstances.size() + 1ul < workerCount) {
+        rbfBehaviorWorkerInstances.push_back(rigLogic->createRBFBehaviorInstance(memRes));
+    }
+}
+
+RBFBehaviorOutputInstance* RigInstanceImpl::getRBFBehaviorOutputInstance(std::size_t workerIndex) {
+    if (workerIndex == 0ul) {
+        return rbfBehaviorInstance.get();
+    }
+    assert(workerIndex <= rbfBehaviorWorkerInstances.size());
+    return rbfBehaviorWorkerInstances[workerIndex - 1ul].get();
+}
+
 JointsOutputInstance* RigInstanceImpl::getJointsOutputInstance() {
     return jointsInstance.get();
 }
@@ -244,6 +296,81 @@ AnimatedMapsOutputInstance* RigInstanceImpl::getAnimatedMapOutputInstance() {
     return animatedMapsInstance.get();
 }
 
+bool RigInstanceImpl::hasCalculatedControls() const {
+    return calculatedControlsValid;
+}
+
+ArrayView<float> RigInstanceImpl::getCalculatedControls() {
+    return ArrayView<float>{calculatedControls};
+}
+
+void RigInstanceImpl::updateCalculatedControls() {
+    const auto inputBuffer = controlsInstance->getInputBuffer();
+    std::copy(inputBuffer.begin(), inputBuffer.end(), calculatedControls.begin());
+    calculatedControlsValid = true;
+    incrementalCalculationCount = {};
+    clearDirtyRawControls();
+}
+
+void RigInstanceImpl::invalidateCalculatedControls() {
+    calculatedControlsValid = false;
+}
+
+std::uint32_t RigInstanceImpl::getIncrementalCalculationCount() const {
+    return incrementalCalculationCount;
+}
+
+void RigInstanceImpl::countIncrementalCalculation() {
+    ++incrementalCalculationCount;
+}
+
+ConstArrayView<std::uint16_t> RigInstanceImpl::getDirtyRawControls() const {
+    return ConstArrayView<std::uint16_t>{dirtyRawControls};
+}
+
+void RigInstanceImpl::markRawControlDirty(std::uint16_t index) {
+    assert(index < rawControlCount);
+    if (!rawControlDirtyFlags[index]) {
+        rawControlDirtyFlags[index] = true;
+        dirtyRawControls.push_back(index);
+    }
+}
+
+void RigInstanceImpl::clearDirtyRawControls() {
+    for (auto index : dirtyRawControls) {
+        rawControlDirtyFlags[index] = false;
+    }
+    dirtyRawControls.clear();
+}
+
+ConstArrayView<std::uint16_t> RigInstanceImpl::getDirtyGUIControls() const {
+    return ConstArrayView<std::uint16_t>{dirtyGUIControls};
+}
+
+bool RigInstanceImpl::areRawControlsOverridden() const {
+    return rawControlsOverridden;
+}
+
+void RigInstanceImpl::markRawControlsOverridden() {
+    rawControlsOverridden = true;
+}
+
+void RigInstanceImpl::clearDirtyGUIControls() {
+    for (auto index : dirtyGUIControls) {
+        guiControlDirtyFlags[index] = false;
+    }
+    dirtyGUIControls.clear();
+    rawControlsOverridden = false;
+}
+
+Vector<std::uint16_t>& RigInstanceImpl::getChangedControls() {
+    return changedControls;
+}
+
+Vector<std::uint16_t>& RigInstanceImpl::getDependentOutputs() {
+    return dependentOutputs;
+}
+
 MemoryResource* RigInstanceImpl::getMemoryResource() {
     return memRes;
 }
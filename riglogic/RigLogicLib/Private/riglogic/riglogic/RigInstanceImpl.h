@@ -12,6 +12,7 @@
 #include "riglogic/riglogic/RigInstance.h"
 #include "riglogic/riglogic/RigMetrics.h"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace rl4 {
@@ -20,7 +21,7 @@ class RigLogicImpl;
 
 class RigInstanceImpl : public RigInstance {
     public:
-        RigInstanceImpl(const RigMetrics& metrics, RigLogicImpl* rigLogic, MemoryResource* memRes_);
+        RigInstanceImpl(const RigMetrics& metrics, RigLogicImpl* rigLogic_, MemoryResource* memRes_);
 
         std::uint16_t getGUIControlCount() const override;
         float getGUIControl(std::uint16_t index) const override;
@@ -60,14 +61,41 @@ class RigInstanceImpl : public RigInstance {
         ControlsInputInstance* getControlsInputInstance();
         MachineLearnedBehaviorOutputInstance* getMachineLearnedBehaviorOutputInstance();
         RBFBehaviorOutputInstance* getRBFBehaviorOutputInstance();
+        // Intermediate outputs for concurrently calculated RBF solvers, worker zero shares the default instance
+        void reserveRBFBehaviorOutputInstances(std::size_t workerCount);
+        RBFBehaviorOutputInstance* getRBFBehaviorOutputInstance(std::size_t workerIndex);
         JointsOutputInstance* getJointsOutputInstance();
         BlendShapesOutputInstance* getBlendShapesOutputInstance();
         AnimatedMapsOutputInstance* getAnimatedMapOutputInstance();
+        // Control values from which the current outputs were calculated, if they are still valid
+        bool hasCalculatedControls() const;
+        ArrayView<float> getCalculatedControls();
+        void updateCalculatedControls();
+        void invalidateCalculatedControls();
+        // Number of calculations of only the outputs of changed controls, since all outputs were last calculated
+        std::uint32_t getIncrementalCalculationCount() const;
+        void countIncrementalCalculation();
+        // Raw controls changed through the setters (or by mapping changed GUI controls) since they were last calculated,
+        // without duplicates
+        ConstArrayView<std::uint16_t> getDirtyRawControls() const;
+        void markRawControlDirty(std::uint16_t index);
+        void clearDirtyRawControls();
+        // GUI controls changed through the setters since they were last mapped to raw controls, without duplicates
+        ConstArrayView<std::uint16_t> getDirtyGUIControls() const;
+        // Whether raw controls may differ from what the GUI controls map to (as they were set directly, or mapped to GUI
+        // controls since GUI controls were last mapped to them), in which case mapping may change any of them
+        bool areRawControlsOverridden() const;
+        void markRawControlsOverridden();
+        void clearDirtyGUIControls();
+        // Intermediate buffers for recalculating only the outputs of changed controls
+        Vector<std::uint16_t>& getChangedControls();
+        Vector<std::uint16_t>& getDependentOutputs();
 
         MemoryResource* getMemoryResource();
 
     private:
         MemoryResource* memRes;
+        RigLogicImpl* rigLogic;
 
         std::uint16_t lodMaxLevel;
         std::uint16_t lodLevel;
@@ -81,10 +109,22 @@ class RigInstanceImpl : public RigInstance {
         ControlsInputInstance::Pointer controlsInstance;
         MachineLearnedBehaviorOutputInstance::Pointer machineLearnedBehaviorInstance;
         RBFBehaviorOutputInstance::Pointer rbfBehaviorInstance;
+        Vector<RBFBehaviorOutputInstance::Pointer> rbfBehaviorWorkerInstances;
         JointsOutputInstance::Pointer jointsInstance;
         BlendShapesOutputInstance::Pointer blendShapesInstance;
         AnimatedMapsOutputInstance::Pointer animatedMapsInstance;
 
+        Vector<float> calculatedControls;
+        Vector<std::uint16_t> changedControls;
+        Vector<std::uint16_t> dependentOutputs;
+        bool calculatedControlsValid;
+        std::uint32_t incrementalCalculationCount;
+        Vector<std::uint16_t> dirtyRawControls;
+        Vector<bool> rawControlDirtyFlags;
+        Vector<std::uint16_t> dirtyGUIControls;
+        Vector<bool> guiControlDirtyFlags;
+        bool rawControlsOverridden;
+
 };
 
 }  // namespace rl4
@@ -11,17 +11,21 @@
 #include "riglogic/rbf/RBFBehaviorFactory.h"
 #include "riglogic/rbf/RBFBehaviorOutputInstance.h"
 #include "riglogic/riglogic/ConfigurationSerializer.h"
+#include "riglogic/riglogic/Executor.h"
 #include "riglogic/riglogic/RigInstanceImpl.h"
 #include "riglogic/riglogic/RigMetrics.h"
 #include "riglogic/riglogic/Stats.h"
 #include "riglogic/system/simd/Utils.h"
+#include "riglogic/types/MappedDump.h"
 #include "riglogic/utils/Extd.h"
 
 #ifdef _MSC_VER
     #pragma warning(push)
     #pragma warning(disable : 4365 4987)
 #endif
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <utility>
@@ -31,11 +35,38 @@
 
 namespace rl4 {
 
+// Out-of-line definition for the ODR-used array (std::begin / std::end), required before C++17
+constexpr char MappedDumpHeader::expectedMagic[4];
+
 static RigInstanceImpl* castInstance(RigInstance* instance) {
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
     return static_cast<RigInstanceImpl*>(instance);
 }
 
+// Deltas applied to joint outputs accumulate rounding errors, so all outputs are periodically recalculated in full
+static constexpr std::uint32_t maxIncrementalCalculationCount = 256u;
+
+static void collectChangedControls(ConstArrayView<float> controls,
+                                   ConstArrayView<float> calculatedControls,
+                                   ConstArrayView<std::uint16_t> controlIndices,
+                                   Vector<std::uint16_t>& changedControls) {
+    for (auto controlIndex : controlIndices) {
+        if (controls[controlIndex] != calculatedControls[controlIndex]) {
+            changedControls.push_back(controlIndex);
+        }
+    }
+}
+
+template<typename TTask>
+static void parallelFor(Executor* executor, std::size_t taskCount, TTask& task) {
+    if (taskCount == 0ul) {
+        return;
+    }
+    executor->parallelFor([](void* context, std::size_t taskIndex, std::size_t workerIndex) {
+            (*static_cast<TTask*>(context))(taskIndex, workerIndex);
+        }, &task, taskCount);
+}
+
 static RigMetrics::Pointer computeRigMetrics(const dna::Reader* reader, const Configuration& config, MemoryResource* memRes) {
     RigMetrics::Pointer metrics = UniqueInstance<RigMetrics>::with(memRes).create(memRes);
     metrics->lodCount = reader->getLODCount();
@@ -58,11 +89,21 @@ static RigMetrics::Pointer computeRigMetrics(const dna::Reader* reader, const Co
 RigLogic::~RigLogic() = default;
 
 RigLogic* RigLogic::create(const dna::Reader* reader, const Configuration& config, MemoryResource* memRes) {
+    return create(reader, config, {}, memRes);
+}
+
+RigLogic* RigLogic::create(const dna::Reader* reader,
+                           const Configuration& config,
+                           ConstArrayView<ConstArrayView<float> > neuralNetworkCalibrationInputs,
+                           MemoryResource* memRes) {
     const ActiveFeatures activeFeatures = getActiveFeatures(config);
     auto metrics = computeRigMetrics(reader, config, memRes);
 
     auto controls = ControlsFactory::create(config, reader, memRes);
-    auto machineLearnedBlendShapes = MachineLearnedBehaviorFactory::create(config, reader, memRes);
+    auto machineLearnedBlendShapes = MachineLearnedBehaviorFactory::create(config,
+                                                                           reader,
+                                                                           neuralNetworkCalibrationInputs,
+                                                                           memRes);
     auto rbfBehavior = RBFBehaviorFactory::create(config, reader, memRes);
     auto joints = JointsFactory::create(config, reader, controls.get(), memRes);
     auto blendShapes = BlendShapesFactory::create(config, reader, controls.get(), memRes);
@@ -88,25 +129,49 @@ void RigLogic::destroy(RigLogic* instance) {
     alloc.deleteObject(ptr);
 }
 
-RigLogic* RigLogic::restore(BoundedIOStream* source, MemoryResource* memRes) {
+// Written at the start of each dump (and of the state of mapped dumps), so dumps of a different layout are rejected on restore
+// (dumps without it start with the calculation type, which never matches the magic)
+static constexpr std::uint32_t dumpMagic = 0x524C4450u;  // RLDP
+static constexpr std::uint32_t dumpVersion = 3u;
+
+static RigLogicImpl* restoreFrom(terse::BinaryInputArchive<BoundedIOStream>& archive, MemoryResource* memRes) {
     PolyAllocator<RigLogicImpl> alloc{memRes};
 
-    terse::BinaryInputArchive<BoundedIOStream> archive{source};
+    std::uint32_t magic = {};
+    std::uint32_t version = {};
+    archive >> magic >> version;
+    if ((magic != dumpMagic) || (version != dumpVersion)) {
+        return nullptr;
+    }
 
     Configuration config;
     archive >> config;
 
-    const ActiveFeatures activeFeatures = getActiveFeatures(config);
+    // The storage layout depends on the variant that was active when dumping (e.g. the block height of joint storage on the
+    // vector width). That variant is restored if it is supported here, otherwise the one the configuration resolves to is,
+    // and storage is re-arranged into its layout while loading. Neural network weights can only be re-arranged though,
+    // not quantized (nor recovered from quantized weights), so those must be quantized by both variants or by neither.
+    ActiveFeatures dumpedFeatures = {};
+    archive >> dumpedFeatures.calculationType >> dumpedFeatures.floatingPointType;
+    const ActiveFeatures activeFeatures = (isSupported(dumpedFeatures) ? dumpedFeatures : getActiveFeatures(config));
+    Configuration variantConfig = config;
+    variantConfig.calculationType = activeFeatures.calculationType;
+    variantConfig.floatingPointType = activeFeatures.floatingPointType;
 
     RigMetrics::Pointer metrics = UniqueInstance<RigMetrics>::with(memRes).create(memRes);
     archive >> *metrics;
-
-    auto controls = ControlsFactory::create(config, *metrics, memRes);
-    auto machineLearnedBehavior = MachineLearnedBehaviorFactory::create(config, *metrics, memRes);
-    auto rbfBehavior = RBFBehaviorFactory::create(config, *metrics, memRes);
-    auto joints = JointsFactory::create(config, *metrics, memRes);
-    auto blendShapes = BlendShapesFactory::create(config, *metrics, memRes);
-    auto animatedMaps = AnimatedMapsFactory::create(config, *metrics, memRes);
+    if (config.loadMachineLearnedBehavior && (metrics->neuralNetworkCount != 0u) &&
+        (MachineLearnedBehaviorFactory::quantizesWeights(config, dumpedFeatures.calculationType) !=
+         MachineLearnedBehaviorFactory::quantizesWeights(config, activeFeatures.calculationType))) {
+        return nullptr;
+    }
+
+    auto controls = ControlsFactory::create(variantConfig, *metrics, memRes);
+    auto machineLearnedBehavior = MachineLearnedBehaviorFactory::create(variantConfig, *metrics, memRes);
+    auto rbfBehavior = RBFBehaviorFactory::create(variantConfig, *metrics, memRes);
+    auto joints = JointsFactory::create(variantConfig, *metrics, memRes);
+    auto blendShapes = BlendShapesFactory::create(variantConfig, *metrics, memRes);
+    auto animatedMaps = AnimatedMapsFactory::create(variantConfig, *metrics, memRes);
 
     terse::VirtualSerializerProxy<AnimatedMaps> animatedMapsProxy{animatedMaps.get()};
     terse::VirtualSerializerProxy<BlendShapes> blendShapesProxy{blendShapes.get()};
@@ -124,6 +189,78 @@ RigLogic* RigLogic::restore(BoundedIOStream* source, MemoryResource* memRes) {
                            memRes);
 }
 
+static bool isValidMappedDump(const MappedDumpHeader& header, std::uint64_t fileSize) {
+    const std::uint64_t sectionTableEnd = sizeof(MappedDumpHeader) +
+        static_cast<std::uint64_t>(header.sectionCount) * sizeof(MappedDumpSection);
+    return std::equal(std::begin(header.magic), std::end(header.magic), std::begin(MappedDumpHeader::expectedMagic)) &&
+           (header.version == MappedDumpHeader::currentVersion) &&
+           (header.byteOrderMark == MappedDumpHeader::nativeByteOrderMark) &&
+           (sectionTableEnd <= header.stateOffset) &&
+           (header.stateOffset <= fileSize) &&
+           (header.stateSize <= fileSize - header.stateOffset);
+}
+
+static bool isValidMappedDumpSection(const MappedDumpSection& section, std::uint64_t fileSize) {
+    return ((section.offset % cacheLineAlignment) == 0ul) && (section.offset <= fileSize) &&
+           (section.size <= fileSize - section.offset);
+}
+
+RigLogic* RigLogic::restore(BoundedIOStream* source, MemoryResource* memRes) {
+    terse::BinaryInputArchive<BoundedIOStream> archive{source};
+    return restoreFrom(archive, memRes);
+}
+
+RigLogic* RigLogic::restoreMapped(MemoryMappedFileStream* source, MemoryResource* memRes) {
+    const std::uint64_t fileSize = source->size();
+    if (fileSize < sizeof(MappedDumpHeader)) {
+        return nullptr;
+    }
+
+    MappedDumpHeader header{};
+    source->seek(0ul);
+    source->read(reinterpret_cast<char*>(&header), sizeof(MappedDumpHeader));
+    if (!isValidMappedDump(header, fileSize)) {
+        return nullptr;
+    }
+
+    Vector<MappedDumpSection> sections{header.sectionCount, {}, memRes};
+    if (!sections.empty()) {
+        source->read(reinterpret_cast<char*>(sections.data()), sections.size() * sizeof(MappedDumpSection));
+    }
+    const bool validSections = std::all_of(sections.begin(), sections.end(), [fileSize](const MappedDumpSection& section) {
+            return isValidMappedDumpSection(section, fileSize);
+        });
+    if (!validSections) {
+        return nullptr;
+    }
+
+    // If the stream cannot provide a single view over the whole file, the contents are copied into an
+    // aligned buffer instead, which is then kept alive by the restored instance
+    AlignedVector<char> dumpCopy{memRes};
+    const char* base = source->getMappedData();
+    if (base == nullptr) {
+        dumpCopy.resize(static_cast<std::size_t>(fileSize));
+        source->seek(0ul);
+        source->read(dumpCopy.data(), dumpCopy.size());
+        base = dumpCopy.data();
+    }
+
+    MappedDumpReader reader{base, ConstArrayView<MappedDumpSection>{sections.data(), sections.size()}};
+    source->seek(header.stateOffset);
+    terse::BinaryInputArchive<BoundedIOStream> archive{source};
+    archive.setUserData(&reader);
+    RigLogicImpl* instance = restoreFrom(archive, memRes);
+    if ((instance != nullptr) && reader.hasFailed()) {
+        // Sections that do not match the state would leave storage empty or short, so the instance is unusable
+        RigLogic::destroy(instance);
+        return nullptr;
+    }
+    if (instance != nullptr) {
+        instance->retainDumpData(std::move(dumpCopy));
+    }
+    return instance;
+}
+
 RigLogicImpl::RigLogicImpl(const Configuration& config_,
                            ActiveFeatures activeFeatures_,
                            RigMetrics::Pointer metrics_,
@@ -143,15 +280,80 @@ RigLogicImpl::RigLogicImpl(const Configuration& config_,
     rbfBehavior{std::move(rbfBehavior_)},
     joints{std::move(joints_)},
     blendShapes{std::move(blendShapes_)},
-    animatedMaps{std::move(animatedMaps_)} {
+    animatedMaps{std::move(animatedMaps_)},
+    dependencies{metrics->lodCount,
+                 static_cast<std::size_t>(metrics->rawControlCount) + metrics->psdControlCount + metrics->mlControlCount +
+                 metrics->rbfControlCount,
+                 controls.get(),
+                 machineLearnedBehavior.get(),
+                 rbfBehavior.get(),
+                 joints.get(),
+                 blendShapes.get(),
+                 animatedMaps.get(),
+                 memRes_},
+    dumpCopy{memRes_} {
 }
 
 void RigLogicImpl::dump(BoundedIOStream* destination) const {
     terse::BinaryOutputArchive<BoundedIOStream> archive{destination};
+    dump(archive);
+}
+
+void RigLogicImpl::dumpMapped(BoundedIOStream* destination) const {
+    MappedDumpWriter writer{memRes};
+    auto state = makeScoped<MemoryStream>(memRes);
+    terse::BinaryOutputArchive<BoundedIOStream> archive{state.get()};
+    archive.setUserData(&writer);
+    dump(archive);
+
+    const auto sources = writer.getSections();
+    MappedDumpHeader header{};
+    std::copy(std::begin(MappedDumpHeader::expectedMagic), std::end(MappedDumpHeader::expectedMagic), std::begin(header.magic));
+    header.version = MappedDumpHeader::currentVersion;
+    header.byteOrderMark = MappedDumpHeader::nativeByteOrderMark;
+    header.sectionCount = static_cast<std::uint32_t>(sources.size());
+    header.stateOffset = sizeof(MappedDumpHeader) + sources.size() * sizeof(MappedDumpSection);
+    header.stateSize = state->size();
+
+    Vector<MappedDumpSection> sections{sources.size(), {}, memRes};
+    std::uint64_t offset = header.stateOffset + header.stateSize;
+    for (std::size_t i = 0ul; i < sources.size(); ++i) {
+        sections[i].offset = extd::roundUp(offset, static_cast<std::uint64_t>(cacheLineAlignment));
+        sections[i].size = sources[i].size();
+        offset = sections[i].offset + sections[i].size;
+    }
+
+    destination->write(reinterpret_cast<const char*>(&header), sizeof(MappedDumpHeader));
+    if (!sections.empty()) {
+        destination->write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(MappedDumpSection));
+    }
+    state->seek(0ul);
+    destination->write(state.get(), static_cast<std::size_t>(header.stateSize));
+
+    const char padding[cacheLineAlignment] = {};
+    offset = header.stateOffset + header.stateSize;
+    for (std::size_t i = 0ul; i < sources.size(); ++i) {
+        const auto paddingSize = static_cast<std::size_t>(sections[i].offset - offset);
+        if (paddingSize != 0ul) {
+            destination->write(padding, paddingSize);
+        }
+        // Empty arrays may not have any storage allocated at all
+        if (sources[i].size() != 0ul) {
+            destination->write(sources[i].data(), sources[i].size());
+        }
+        offset = sections[i].offset + sections[i].size;
+    }
+}
+
+void RigLogicImpl::dump(terse::BinaryOutputArchive<BoundedIOStream>& archive) const {
     terse::VirtualSerializerProxy<AnimatedMaps> animatedMapsProxy{animatedMaps.get()};
     terse::VirtualSerializerProxy<BlendShapes> blendShapesProxy{blendShapes.get()};
     // *INDENT-OFF*
-    archive << config
+    archive << dumpMagic
+            << dumpVersion
+            << config
+            << activeFeatures.calculationType
+            << activeFeatures.floatingPointType
             << *metrics
             << *controls
             << *machineLearnedBehavior
@@ -162,6 +364,10 @@ void RigLogicImpl::dump(BoundedIOStream* destination) const {
     // *INDENT-ON*
 }
 
+void RigLogicImpl::retainDumpData(AlignedVector<char>&& dumpCopy_) {
+    dumpCopy = std::move(dumpCopy_);
+}
+
 const Configuration& RigLogicImpl::getConfiguration() const {
     return config;
 }
@@ -206,14 +412,26 @@ std::uint16_t RigLogicImpl::getJointGroupCount() const {
     return joints->getJointGroupCount();
 }
 
+std::uint16_t RigLogicImpl::getJointWorkItemCount(std::uint16_t lod) const {
+    return joints->getWorkItemCount(lod);
+}
+
 std::uint16_t RigLogicImpl::getNeuralNetworkCount() const {
     return metrics->neuralNetworkCount;
 }
 
+float RigLogicImpl::getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const {
+    return machineLearnedBehavior->getNeuralNetworkQuantizationError(neuralNetIndex);
+}
+
 std::uint16_t RigLogicImpl::getRBFSolverCount() const {
     return metrics->rbfSolverCount;
 }
 
+float RigLogicImpl::getRBFSolverHalfFloatError(std::uint16_t solverIndex) const {
+    return rbfBehavior->getSolverHalfFloatError(solverIndex);
+}
+
 std::uint16_t RigLogicImpl::getMeshCount() const {
     return machineLearnedBehavior->getMeshCount();
 }
@@ -255,20 +473,36 @@ AnimatedMapsOutputInstance::Pointer RigLogicImpl::createAnimatedMapsInstance(Mem
 void RigLogicImpl::mapGUIToRawControls(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
     controls->mapGUIToRaw(pRigInstance->getControlsInputInstance());
+    if (pRigInstance->areRawControlsOverridden()) {
+        // Mapping resets all raw controls it writes, not only those mapped from changed GUI controls
+        for (std::uint16_t rawControlIndex = {}; rawControlIndex < metrics->rawControlCount; ++rawControlIndex) {
+            pRigInstance->markRawControlDirty(rawControlIndex);
+        }
+    } else {
+        auto& mappedControls = pRigInstance->getDependentOutputs();
+        dependencies.getGUIToRawControls().collect(pRigInstance->getDirtyGUIControls(), mappedControls);
+        for (auto rawControlIndex : mappedControls) {
+            pRigInstance->markRawControlDirty(rawControlIndex);
+        }
+    }
+    pRigInstance->clearDirtyGUIControls();
 }
 
 void RigLogicImpl::mapRawToGUIControls(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
     controls->mapRawToGUI(pRigInstance->getControlsInputInstance());
+    pRigInstance->markRawControlsOverridden();
 }
 
 void RigLogicImpl::calculateControls(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     controls->calculate(pRigInstance->getControlsInputInstance(), pRigInstance->getLOD());
 }
 
 void RigLogicImpl::calculateMachineLearnedBehaviorControls(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     machineLearnedBehavior->calculate(pRigInstance->getControlsInputInstance(),
                                       pRigInstance->getMachineLearnedBehaviorOutputInstance(),
                                       pRigInstance->getLOD());
@@ -276,6 +510,7 @@ void RigLogicImpl::calculateMachineLearnedBehaviorControls(RigInstance* instance
 
 void RigLogicImpl::calculateMachineLearnedBehaviorControls(RigInstance* instance, std::uint16_t neuralNetIndex) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     machineLearnedBehavior->calculate(pRigInstance->getControlsInputInstance(),
                                       pRigInstance->getMachineLearnedBehaviorOutputInstance(),
                                       pRigInstance->getLOD(),
@@ -284,6 +519,7 @@ void RigLogicImpl::calculateMachineLearnedBehaviorControls(RigInstance* instance
 
 void RigLogicImpl::calculateRBFControls(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     rbfBehavior->calculate(pRigInstance->getControlsInputInstance(),
                            pRigInstance->getRBFBehaviorOutputInstance(),
                            pRigInstance->getLOD());
@@ -291,6 +527,7 @@ void RigLogicImpl::calculateRBFControls(RigInstance* instance) const {
 
 void RigLogicImpl::calculateRBFControls(RigInstance* instance, std::uint16_t solverIndex) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     rbfBehavior->calculate(pRigInstance->getControlsInputInstance(),
                            pRigInstance->getRBFBehaviorOutputInstance(),
                            pRigInstance->getLOD(),
@@ -299,19 +536,31 @@ void RigLogicImpl::calculateRBFControls(RigInstance* instance, std::uint16_t sol
 
 void RigLogicImpl::calculateJoints(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     joints->calculate(pRigInstance->getControlsInputInstance(), pRigInstance->getJointsOutputInstance(), pRigInstance->getLOD());
 }
 
 void RigLogicImpl::calculateJoints(RigInstance* instance, std::uint16_t jointGroupIndex) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     joints->calculate(pRigInstance->getControlsInputInstance(),
                       pRigInstance->getJointsOutputInstance(),
                       pRigInstance->getLOD(),
                       jointGroupIndex);
 }
 
+void RigLogicImpl::calculateJointWorkItem(RigInstance* instance, std::uint16_t workItemIndex) const {
+    auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
+    joints->calculateWorkItem(pRigInstance->getControlsInputInstance(),
+                              pRigInstance->getJointsOutputInstance(),
+                              pRigInstance->getLOD(),
+                              workItemIndex);
+}
+
 void RigLogicImpl::calculateBlendShapes(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     blendShapes->calculate(pRigInstance->getControlsInputInstance(),
                            pRigInstance->getBlendShapesOutputInstance(),
                            pRigInstance->getLOD());
@@ -319,22 +568,304 @@ void RigLogicImpl::calculateBlendShapes(RigInstance* instance) const {
 
 void RigLogicImpl::calculateAnimatedMaps(RigInstance* instance) const {
     auto pRigInstance = castInstance(instance);
+    pRigInstance->invalidateCalculatedControls();
     animatedMaps->calculate(pRigInstance->getControlsInputInstance(),
                             pRigInstance->getAnimatedMapOutputInstance(),
                             pRigInstance->getLOD());
 }
 
 void RigLogicImpl::calculate(RigInstance* instance) const {
+    auto pRigInstance = castInstance(instance);
+    if (pRigInstance->hasCalculatedControls() && calculateChangedOutputs(pRigInstance)) {
+        return;
+    }
     calculateMachineLearnedBehaviorControls(instance);
     calculateRBFControls(instance);
     calculateControls(instance);
     calculateJoints(instance);
     calculateBlendShapes(instance);
     calculateAnimatedMaps(instance);
+    pRigInstance->updateCalculatedControls();
 }
 
-void RigLogicImpl::collectCalculationStats(const RigInstance* instance, Stats* stats) const {
+bool RigLogicImpl::calculateChangedOutputs(RigInstanceImpl* instance) const {
     const auto lod = instance->getLOD();
+    auto inputs = instance->getControlsInputInstance();
+    const auto inputBuffer = inputs->getInputBuffer();
+    auto calculatedControls = instance->getCalculatedControls();
+    auto& changedControls = instance->getChangedControls();
+    auto& dependentOutputs = instance->getDependentOutputs();
+
+    // Only raw controls changed through the setters (or by mapping changed GUI controls) are compared
+    changedControls.clear();
+    collectChangedControls(inputBuffer, calculatedControls, instance->getDirtyRawControls(), changedControls);
+    instance->clearDirtyRawControls();
+    if (changedControls.empty()) {
+        return true;
+    }
+    // When a large portion of the rig is affected, gathering the dependent outputs costs more than it saves
+    if ((changedControls.size() > metrics->rawControlCount / 4ul) ||
+        (instance->getIncrementalCalculationCount() >= maxIncrementalCalculationCount)) {
+        return false;
+    }
+    instance->countIncrementalCalculation();
+
+    // Only neural networks and RBF solvers reading changed controls are evaluated, and only the controls they changed
+    // are propagated further
+    auto mlOutputs = instance->getMachineLearnedBehaviorOutputInstance();
+    dependencies.getNeuralNetworks(lod).collect(changedControls, dependentOutputs);
+    for (auto neuralNetIndex : dependentOutputs) {
+        machineLearnedBehavior->calculate(inputs, mlOutputs, lod, neuralNetIndex);
+        collectChangedControls(inputBuffer,
+                               calculatedControls,
+                               machineLearnedBehavior->getNeuralNetworkOutputIndices(neuralNetIndex),
+                               changedControls);
+    }
+
+    // RBF solvers may be driven by ML controls, so they are gathered after all neural networks
+    dependencies.getRBFSolvers(lod).collect(changedControls, dependentOutputs);
+    if (rbfBehavior->hasIndependentSolvers()) {
+        for (auto solverIndex : dependentOutputs) {
+            rbfBehavior->calculate(inputs, instance->getRBFBehaviorOutputInstance(), lod, solverIndex);
+            collectChangedControls(inputBuffer, calculatedControls, rbfBehavior->getSolverOutputIndices(solverIndex),
+                                   changedControls);
+        }
+    } else if (!dependentOutputs.empty()) {
+        // Solvers sharing output controls are evaluated together
+        rbfBehavior->calculate(inputs, instance->getRBFBehaviorOutputInstance(), lod);
+        for (auto solverIndex : rbfBehavior->getSolverIndicesForLOD(lod)) {
+            collectChangedControls(inputBuffer, calculatedControls, rbfBehavior->getSolverOutputIndices(solverIndex),
+                                   changedControls);
+        }
+    }
+    std::sort(changedControls.begin(), changedControls.end());
+    changedControls.erase(std::unique(changedControls.begin(), changedControls.end()), changedControls.end());
+
+    dependencies.getPSDs(lod).collect(changedControls, dependentOutputs);
+    controls->calculate(inputs, dependentOutputs);
+    collectChangedControls(inputBuffer, calculatedControls, dependentOutputs, changedControls);
+
+    // Joint groups are updated from their previous outputs, by the deltas of only the changed controls
+    auto jointOutputs = instance->getJointsOutputInstance();
+    dependencies.getJointGroups(lod).collect(changedControls, dependentOutputs);
+    for (auto jointGroupIndex : dependentOutputs) {
+        joints->calculateChanged(inputs, calculatedControls, jointOutputs, lod, jointGroupIndex);
+    }
+    // Twist and swing setups overwrite joint group results, so they are always recalculated
+    joints->calculateUngrouped(inputs, jointOutputs, lod);
+
+    dependencies.getBlendShapeChannelMappings(lod).collect(changedControls, dependentOutputs);
+    blendShapes->calculate(inputs, instance->getBlendShapesOutputInstance(), dependentOutputs);
+
+    dependencies.getAnimatedMapRows(lod).collect(changedControls, dependentOutputs);
+    animatedMaps->calculate(inputs, instance->getAnimatedMapOutputInstance(), dependentOutputs);
+
+    for (auto controlIndex : changedControls) {
+        calculatedControls[controlIndex] = inputBuffer[controlIndex];
+    }
+    return true;
+}
+
+void RigLogicImpl::calculate(RigInstance* instance, Executor* executor) const {
+    if (executor == nullptr) {
+        calculate(instance);
+        return;
+    }
+
+    auto pRigInstance = castInstance(instance);
+    const auto lod = pRigInstance->getLOD();
+    auto inputs = pRigInstance->getControlsInputInstance();
+
+    // Neural networks write disjoint ranges of ML controls, and layer outputs are kept on the stack of each worker
+    // (or for wide networks, in storage that the instance keeps for each network separately)
+    auto mlOutputs = pRigInstance->getMachineLearnedBehaviorOutputInstance();
+    const auto neuralNetIndices = machineLearnedBehavior->getNeuralNetworkIndicesForLOD(lod);
+    auto calculateNeuralNet = [this, inputs, mlOutputs, lod, neuralNetIndices](std::size_t taskIndex,
+                                                                               std::size_t  /*unused*/) {
+            machineLearnedBehavior->calculate(inputs, mlOutputs, lod, static_cast<std::uint16_t>(neuralNetIndices[taskIndex]));
+        };
+    parallelFor(executor, neuralNetIndices.size(), calculateNeuralNet);
+
+    // RBF solvers are evaluated after all neural networks, as they may be driven by ML controls
+    if (rbfBehavior->hasIndependentSolvers()) {
+        pRigInstance->reserveRBFBehaviorOutputInstances(executor->getWorkerCount());
+        const auto solverIndices = rbfBehavior->getSolverIndicesForLOD(lod);
+        auto calculateSolver = [this, pRigInstance, inputs, lod, solverIndices](std::size_t taskIndex, std::size_t workerIndex) {
+                rbfBehavior->calculate(inputs, pRigInstance->getRBFBehaviorOutputInstance(workerIndex), lod, solverIndices[taskIndex]);
+            };
+        parallelFor(executor, solverIndices.size(), calculateSolver);
+    } else {
+        rbfBehavior->calculate(inputs, pRigInstance->getRBFBehaviorOutputInstance(), lod);
+    }
+
+    controls->calculate(inputs, lod);
+
+    // Joint work items, blend shapes and animated maps only read controls, and write disjoint outputs
+    auto jointOutputs = pRigInstance->getJointsOutputInstance();
+    auto blendShapeOutputs = pRigInstance->getBlendShapesOutputInstance();
+    auto animatedMapOutputs = pRigInstance->getAnimatedMapOutputInstance();
+    const std::size_t jointWorkItemCount = joints->getWorkItemCount(lod);
+    auto calculateOutputs = [this, inputs, jointOutputs, blendShapeOutputs, animatedMapOutputs, lod, jointWorkItemCount](
+        std::size_t taskIndex, std::size_t  /*unused*/) {
+            if (taskIndex < jointWorkItemCount) {
+                joints->calculateWorkItem(inputs, jointOutputs, lod, static_cast<std::uint16_t>(taskIndex));
+            } else if (taskIndex == jointWorkItemCount) {
+                blendShapes->calculate(inputs, blendShapeOutputs, lod);
+            } else {
+                animatedMaps->calculate(inputs, animatedMapOutputs, lod);
+            }
+        };
+    parallelFor(executor, jointWorkItemCount + 2ul, calculateOutputs);
+
+    // Twist and swing setups overwrite joint group results, so they run only after all joint groups, split into
+    // partitions with disjoint outputs
+    auto calculateUngroupedPartition = [this, inputs, jointOutputs, lod](std::size_t taskIndex, std::size_t  /*unused*/) {
+            joints->calculateUngrouped(inputs, jointOutputs, lod, static_cast<std::uint16_t>(taskIndex));
+        };
+    parallelFor(executor, joints->getUngroupedPartitionCount(lod), calculateUngroupedPartition);
+    pRigInstance->updateCalculatedControls();
+}
+
+template<typename TBatchCalculator>
+void RigLogicImpl::calculateInLODBatches(RigInstance** instances, std::size_t count, TBatchCalculator calculateBatch) const {
+    Vector<RigInstanceImpl*> batch{memRes};
+    batch.reserve(count);
+    for (std::size_t i = {}; i < count; ++i) {
+        batch.push_back(castInstance(instances[i]));
+    }
+    // Instances on the same LOD traverse the same portion of the rig data, so they are evaluated together
+    std::stable_sort(batch.begin(), batch.end(), [](const RigInstanceImpl* lhs, const RigInstanceImpl* rhs) {
+            return lhs->getLOD() < rhs->getLOD();
+        });
+    for (auto start = batch.begin(); start != batch.end();) {
+        const auto lod = (*start)->getLOD();
+        const auto end = std::find_if(start, batch.end(), [lod](const RigInstanceImpl* instance) {
+                return instance->getLOD() != lod;
+            });
+        calculateBatch(ConstArrayView<RigInstanceImpl*>{&(*start), static_cast<std::size_t>(end - start)}, lod);
+        start = end;
+    }
+}
+
+void RigLogicImpl::calculateControls(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const {
+    Vector<ControlsInputInstance*> inputs{memRes};
+    inputs.reserve(batch.size());
+    for (auto instance : batch) {
+        instance->invalidateCalculatedControls();
+        inputs.push_back(instance->getControlsInputInstance());
+    }
+    controls->calculate(ConstArrayView<ControlsInputInstance*>{inputs}, lod);
+}
+
+void RigLogicImpl::calculateMachineLearnedBehaviorControls(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const {
+    Vector<ControlsInputInstance*> inputs{memRes};
+    Vector<MachineLearnedBehaviorOutputInstance*> outputs{memRes};
+    inputs.reserve(batch.size());
+    outputs.reserve(batch.size());
+    for (auto instance : batch) {
+        instance->invalidateCalculatedControls();
+        inputs.push_back(instance->getControlsInputInstance());
+        outputs.push_back(instance->getMachineLearnedBehaviorOutputInstance());
+    }
+    machineLearnedBehavior->calculate(ConstArrayView<ControlsInputInstance*>{inputs},
+                                      ConstArrayView<MachineLearnedBehaviorOutputInstance*>{outputs},
+                                      lod);
+}
+
+void RigLogicImpl::calculateJoints(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const {
+    Vector<const ControlsInputInstance*> inputs{memRes};
+    Vector<JointsOutputInstance*> outputs{memRes};
+    inputs.reserve(batch.size());
+    outputs.reserve(batch.size());
+    for (auto instance : batch) {
+        instance->invalidateCalculatedControls();
+        inputs.push_back(instance->getControlsInputInstance());
+        outputs.push_back(instance->getJointsOutputInstance());
+    }
+    joints->calculate(ConstArrayView<const ControlsInputInstance*>{inputs}, ConstArrayView<JointsOutputInstance*>{outputs}, lod);
+}
+
+void RigLogicImpl::calculateBlendShapes(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const {
+    Vector<const ControlsInputInstance*> inputs{memRes};
+    Vector<BlendShapesOutputInstance*> outputs{memRes};
+    inputs.reserve(batch.size());
+    outputs.reserve(batch.size());
+    for (auto instance : batch) {
+        instance->invalidateCalculatedControls();
+        inputs.push_back(instance->getControlsInputInstance());
+        outputs.push_back(instance->getBlendShapesOutputInstance());
+    }
+    blendShapes->calculate(ConstArrayView<const ControlsInputInstance*>{inputs},
+                           ConstArrayView<BlendShapesOutputInstance*>{outputs},
+                           lod);
+}
+
+void RigLogicImpl::calculateAnimatedMaps(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const {
+    Vector<const ControlsInputInstance*> inputs{memRes};
+    Vector<AnimatedMapsOutputInstance*> outputs{memRes};
+    inputs.reserve(batch.size());
+    outputs.reserve(batch.size());
+    for (auto instance : batch) {
+        instance->invalidateCalculatedControls();
+        inputs.push_back(instance->getControlsInputInstance());
+        outputs.push_back(instance->getAnimatedMapOutputInstance());
+    }
+    animatedMaps->calculate(ConstArrayView<const ControlsInputInstance*>{inputs},
+                            ConstArrayView<AnimatedMapsOutputInstance*>{outputs},
+                            lod);
+}
+
+void RigLogicImpl::calculateControls(RigInstance** instances, std::size_t count) const {
+    calculateInLODBatches(instances, count, [this](ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) {
+            calculateControls(batch, lod);
+        });
+}
+
+void RigLogicImpl::calculateMachineLearnedBehaviorControls(RigInstance** instances, std::size_t count) const {
+    calculateInLODBatches(instances, count, [this](ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) {
+            calculateMachineLearnedBehaviorControls(batch, lod);
+        });
+}
+
+void RigLogicImpl::calculateJoints(RigInstance** instances, std::size_t count) const {
+    calculateInLODBatches(instances, count, [this](ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) {
+            calculateJoints(batch, lod);
+        });
+}
+
+void RigLogicImpl::calculateBlendShapes(RigInstance** instances, std::size_t count) const {
+    calculateInLODBatches(instances, count, [this](ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) {
+            calculateBlendShapes(batch, lod);
+        });
+}
+
+void RigLogicImpl::calculateAnimatedMaps(RigInstance** instances, std::size_t count) const {
+    calculateInLODBatches(instances, count, [this](ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) {
+            calculateAnimatedMaps(batch, lod);
+        });
+}
+
+void RigLogicImpl::calculate(RigInstance** instances, std::size_t count) const {
+    calculateMachineLearnedBehaviorControls(instances, count);
+    for (std::size_t i = {}; i < count; ++i) {
+        calculateRBFControls(instances[i]);
+    }
+    calculateInLODBatches(instances, count, [this](ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) {
+            calculateControls(batch, lod);
+            calculateJoints(batch, lod);
+            calculateBlendShapes(batch, lod);
+            calculateAnimatedMaps(batch, lod);
+            for (auto instance : batch) {
+                instance->updateCalculatedControls();
+            }
+        });
+}
+
+void RigLogicImpl::collectCalculationStats(const RigInstance* instance, Stats* stats) const {
+    collectCalculationStats(instance->getLOD(), stats);
+}
+
+void RigLogicImpl::collectCalculationStats(std::uint16_t lod, Stats* stats) const {
     stats->calculationType = activeFeatures.calculationType;
     stats->floatingPointType = activeFeatures.floatingPointType;
     stats->rbfSolverCount = static_cast<std::uint16_t>(rbfBehavior->getSolverIndicesForLOD(lod).size());
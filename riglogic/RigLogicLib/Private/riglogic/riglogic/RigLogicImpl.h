@@ -15,12 +15,18 @@
 #include "riglogic/ml/MachineLearnedBehaviorOutputInstance.h"
 #include "riglogic/rbf/RBFBehavior.h"
 #include "riglogic/riglogic/Configuration.h"
+#include "riglogic/riglogic/DependencyIndex.h"
 #include "riglogic/riglogic/RigLogic.h"
 #include "riglogic/riglogic/RigMetrics.h"
 #include "riglogic/system/simd/Utils.h"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace rl4 {
 
+class RigInstanceImpl;
+
 class RigLogicImpl : public RigLogic {
     public:
         RigLogicImpl(const Configuration& config_,
@@ -35,6 +41,7 @@ class RigLogicImpl : public RigLogic {
                      MemoryResource* memRes_);
 
         void dump(BoundedIOStream* destination) const override;
+        void dumpMapped(BoundedIOStream* destination) const override;
         const Configuration& getConfiguration() const override;
         const RigMetrics& getRigMetrics() const;
         std::uint16_t getLODCount() const override;
@@ -46,8 +53,11 @@ class RigLogicImpl : public RigLogic {
         ConstArrayView<float> getNeutralJointValues() const override;
         ConstArrayView<std::uint16_t> getJointVariableAttributeIndices(std::uint16_t lod) const override;
         std::uint16_t getJointGroupCount() const override;
+        std::uint16_t getJointWorkItemCount(std::uint16_t lod) const override;
         std::uint16_t getNeuralNetworkCount() const override;
+        float getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const override;
         std::uint16_t getRBFSolverCount() const override;
+        float getRBFSolverHalfFloatError(std::uint16_t solverIndex) const override;
         std::uint16_t getMeshCount() const override;
         std::uint16_t getMeshRegionCount(std::uint16_t meshIndex) const override;
         ConstArrayView<std::uint16_t> getNeuralNetworkIndices(std::uint16_t meshIndex, std::uint16_t regionIndex) const override;
@@ -68,12 +78,33 @@ class RigLogicImpl : public RigLogic {
         void calculateRBFControls(RigInstance* instance, std::uint16_t solverIndex) const override;
         void calculateJoints(RigInstance* instance) const override;
         void calculateJoints(RigInstance* instance, std::uint16_t jointGroupIndex) const override;
+        void calculateJointWorkItem(RigInstance* instance, std::uint16_t workItemIndex) const override;
         void calculateBlendShapes(RigInstance* instance) const override;
         void calculateAnimatedMaps(RigInstance* instance) const override;
         void calculate(RigInstance* instance) const override;
+        void calculate(RigInstance* instance, Executor* executor) const override;
+        void calculateControls(RigInstance** instances, std::size_t count) const override;
+        void calculateMachineLearnedBehaviorControls(RigInstance** instances, std::size_t count) const override;
+        void calculateJoints(RigInstance** instances, std::size_t count) const override;
+        void calculateBlendShapes(RigInstance** instances, std::size_t count) const override;
+        void calculateAnimatedMaps(RigInstance** instances, std::size_t count) const override;
+        void calculate(RigInstance** instances, std::size_t count) const override;
         void collectCalculationStats(const RigInstance* instance, Stats* stats) const override;
+        void collectCalculationStats(std::uint16_t lod, Stats* stats) const;
 
         MemoryResource* getMemoryResource();
+        void retainDumpData(AlignedVector<char>&& dumpCopy_);
+
+    private:
+        void dump(terse::BinaryOutputArchive<BoundedIOStream>& archive) const;
+        template<typename TBatchCalculator>
+        void calculateInLODBatches(RigInstance** instances, std::size_t count, TBatchCalculator calculateBatch) const;
+        void calculateControls(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const;
+        void calculateMachineLearnedBehaviorControls(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const;
+        void calculateJoints(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const;
+        void calculateBlendShapes(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const;
+        void calculateAnimatedMaps(ConstArrayView<RigInstanceImpl*> batch, std::uint16_t lod) const;
+        bool calculateChangedOutputs(RigInstanceImpl* instance) const;
 
     private:
         MemoryResource* memRes;
@@ -86,6 +117,9 @@ class RigLogicImpl : public RigLogic {
         Joints::Pointer joints;
         BlendShapes::Pointer blendShapes;
         AnimatedMaps::Pointer animatedMaps;
+        DependencyIndex dependencies;
+        // Copy of a mapped dump's contents, for streams that could not map it in a single view
+        AlignedVector<char> dumpCopy;
 
 };
 
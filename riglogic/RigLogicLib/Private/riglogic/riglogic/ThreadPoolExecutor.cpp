@@ -0,0 +1,165 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/riglogic/ThreadPoolExecutor.h"
+
+#include "riglogic/TypeDefs.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+namespace {
+
+inline std::uint16_t getDefaultThreadCount() {
+    const unsigned int hardwareThreadCount = std::thread::hardware_concurrency();
+    return static_cast<std::uint16_t>(hardwareThreadCount > 1u ? hardwareThreadCount - 1u : 0u);
+}
+
+// The executor whose tasks the current thread is running (if any), and the worker index it runs them as
+struct CurrentWorker {
+    const ThreadPoolExecutor* executor;
+    std::size_t workerIndex;
+};
+
+thread_local CurrentWorker currentWorker = {nullptr, 0ul};
+
+}  // namespace
+
+Executor* Executor::create(std::uint16_t threadCount, MemoryResource* memRes) {
+    PolyAllocator<ThreadPoolExecutor> alloc{memRes};
+    return alloc.newObject(threadCount, memRes);
+}
+
+void Executor::destroy(Executor* instance) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+    auto ptr = static_cast<ThreadPoolExecutor*>(instance);
+    PolyAllocator<ThreadPoolExecutor> alloc{ptr->getMemoryResource()};
+    alloc.deleteObject(ptr);
+}
+
+Executor::~Executor() = default;
+
+ThreadPoolExecutor::ThreadPoolExecutor(std::uint16_t threadCount, MemoryResource* memRes_) :
+    memRes{memRes_},
+    threads{memRes_},
+    jobTask{nullptr},
+    jobContext{nullptr},
+    jobTaskCount{},
+    jobGeneration{},
+    jobOpen{false},
+    stopping{false},
+    activeWorkerCount{},
+    nextTaskIndex{},
+    remainingTaskCount{} {
+
+    const std::uint16_t spawnCount = (threadCount == 0u ? getDefaultThreadCount() : threadCount);
+    threads.reserve(spawnCount);
+    for (std::size_t i = {}; i < spawnCount; ++i) {
+        // Worker index 0 is reserved for the thread calling parallelFor
+        threads.emplace_back(&ThreadPoolExecutor::work, this, i + 1ul);
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    {
+        std::lock_guard<std::mutex> lock{jobMutex};
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPoolExecutor::getWorkerCount() const {
+    return threads.size() + 1ul;
+}
+
+void ThreadPoolExecutor::parallelFor(TaskFunction task, void* context, std::size_t taskCount) {
+    // A task of this executor calling back into it would wait for a job that can only start once its own job
+    // completes, so nested calls are executed inline, as the worker that makes them
+    const bool nested = (currentWorker.executor == this);
+    if ((taskCount < 2ul) || threads.empty() || nested) {
+        const std::size_t workerIndex = (nested ? currentWorker.workerIndex : 0ul);
+        for (std::size_t i = {}; i < taskCount; ++i) {
+            task(context, i, workerIndex);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock{submitMutex};
+    {
+        std::lock_guard<std::mutex> lock{jobMutex};
+        jobTask = task;
+        jobContext = context;
+        jobTaskCount = taskCount;
+        nextTaskIndex.store(0ul);
+        remainingTaskCount.store(taskCount);
+        ++jobGeneration;
+        jobOpen = true;
+    }
+    jobAvailable.notify_all();
+
+    const CurrentWorker callerWorker = currentWorker;
+    currentWorker = {this, 0ul};
+    execute(0ul);
+    currentWorker = callerWorker;
+
+    std::unique_lock<std::mutex> lock{jobMutex};
+    // Workers that already joined the job still hold on to its state, so it may be closed only after they leave
+    jobFinished.wait(lock, [this]() {
+            return (remainingTaskCount.load() == 0ul) && (activeWorkerCount == 0ul);
+        });
+    jobOpen = false;
+}
+
+MemoryResource* ThreadPoolExecutor::getMemoryResource() {
+    return memRes;
+}
+
+void ThreadPoolExecutor::work(std::size_t workerIndex) {
+    currentWorker = {this, workerIndex};
+    std::uint64_t lastGeneration = {};
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{jobMutex};
+            jobAvailable.wait(lock, [this, lastGeneration]() {
+                    return stopping || (jobOpen && (jobGeneration != lastGeneration));
+                });
+            if (stopping) {
+                return;
+            }
+            lastGeneration = jobGeneration;
+            ++activeWorkerCount;
+        }
+
+        execute(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock{jobMutex};
+            --activeWorkerCount;
+        }
+        jobFinished.notify_all();
+    }
+}
+
+void ThreadPoolExecutor::execute(std::size_t workerIndex) {
+    for (std::size_t i = nextTaskIndex.fetch_add(1ul); i < jobTaskCount; i = nextTaskIndex.fetch_add(1ul)) {
+        jobTask(jobContext, i, workerIndex);
+        if (remainingTaskCount.fetch_sub(1ul) == 1ul) {
+            std::lock_guard<std::mutex> lock{jobMutex};
+            jobFinished.notify_all();
+        }
+    }
+}
+
+}  // namespace rl4
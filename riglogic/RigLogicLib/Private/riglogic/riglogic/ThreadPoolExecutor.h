@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/riglogic/Executor.h"
+
+#ifdef _MSC_VER
+    #pragma warning(push)
+    #pragma warning(disable : 4365 4987)
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+namespace rl4 {
+
+class ThreadPoolExecutor : public Executor {
+    public:
+        ThreadPoolExecutor(std::uint16_t threadCount, MemoryResource* memRes_);
+        ~ThreadPoolExecutor();
+
+        ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+        ThreadPoolExecutor(ThreadPoolExecutor&&) = delete;
+        ThreadPoolExecutor& operator=(ThreadPoolExecutor&&) = delete;
+
+        std::size_t getWorkerCount() const override;
+        void parallelFor(TaskFunction task, void* context, std::size_t taskCount) override;
+
+        MemoryResource* getMemoryResource();
+
+    private:
+        void work(std::size_t workerIndex);
+        void execute(std::size_t workerIndex);
+
+    private:
+        MemoryResource* memRes;
+        Vector<std::thread> threads;
+        // Serializes concurrent parallelFor calls, as only one job can be in flight at a time
+        std::mutex submitMutex;
+        std::mutex jobMutex;
+        std::condition_variable jobAvailable;
+        std::condition_variable jobFinished;
+        TaskFunction jobTask;
+        void* jobContext;
+        std::size_t jobTaskCount;
+        std::uint64_t jobGeneration;
+        bool jobOpen;
+        bool stopping;
+        std::size_t activeWorkerCount;
+        std::atomic<std::size_t> nextTaskIndex;
+        std::atomic<std::size_t> remainingTaskCount;
+};
+
+}  // namespace rl4
@@ -16,6 +16,21 @@
     #endif
 #endif  // RL_AUTODETECT_SSE
 
+#if defined(RL_AUTODETECT_AVX512) && !defined(RL_BUILD_WITH_AVX512)
+    #if defined(TRIMD_PLATFORM_X86) && defined(__AVX512F__)
+        #define RL_BUILD_WITH_AVX512 1
+        #if defined(RL_AUTODETECT_HALF_FLOATS) && !defined(RL_BUILD_WITH_HALF_FLOATS)
+            // F16C is implied by AVX-512F
+            #define RL_BUILD_WITH_HALF_FLOATS 1
+        #endif  // RL_AUTODETECT_HALF_FLOATS
+    #endif
+#endif  // RL_AUTODETECT_AVX512
+
+// The AVX-512 kernels use 256-bit vectors for their remainder blocks, so AVX is always built alongside
+#if defined(RL_BUILD_WITH_AVX512) && !defined(RL_BUILD_WITH_AVX)
+    #define RL_BUILD_WITH_AVX 1
+#endif  // RL_BUILD_WITH_AVX512
+
 #if defined(RL_AUTODETECT_AVX) && !defined(RL_BUILD_WITH_AVX)
     #if defined(TRIMD_PLATFORM_X86) && defined(__AVX__)
         #define RL_BUILD_WITH_AVX 1
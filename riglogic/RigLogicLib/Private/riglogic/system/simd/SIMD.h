@@ -10,20 +10,46 @@
 
 #include "riglogic/system/simd/Detect.h"
 
-#if defined(RL_BUILD_WITH_AVX)
-    #if defined(RL_BUILD_WITH_HALF_FLOATS) && !defined(TRIMD_ENABLE_F16C)
+// All enabled variants are built into one library and selected at runtime (see getActiveFeatures). Compilers that
+// accept the intrinsics without code generation flags (MSVC) compile every variant with the flags of the rest of the
+// library, while under GCC each <Factory><ISA>.cpp (and system/simd/Utils<ISA>.cpp) selects the instruction sets of its
+// variant through trimd/Isolate.h, which are then used only for the code in the ISA-tagged namespace (trimd and the
+// kernels declared between TRIMD_BEGIN_ISA_NAMESPACE and TRIMD_END_ISA_NAMESPACE):
+//   SSE    - none (SSE2), half floats are available only if the whole library is compiled with -mf16c
+//   AVX    - AVX2, FMA and F16C
+//   AVX512 - AVX-512F, AVX2, FMA and F16C
+// All translation units are given the same code generation flags. Compilers that cannot select instruction sets within a
+// translation unit (Clang) have to enable only the variants that those flags cover (e.g. through RL_AUTODETECT_*).
+// Instruction sets are therefore enabled only where the compiler generates them, not in every translation unit.
+
+#if defined(RL_BUILD_WITH_AVX512) && !defined(TRIMD_ENABLE_AVX512) && (defined(TRIMD_TARGET_AVX512F) || defined(_MSC_VER))
+    #define TRIMD_ENABLE_AVX512
+#endif  // RL_BUILD_WITH_AVX512
+
+#if defined(RL_BUILD_WITH_AVX) && (defined(TRIMD_TARGET_AVX) || defined(_MSC_VER))
+    #if defined(RL_BUILD_WITH_HALF_FLOATS) && !defined(TRIMD_ENABLE_F16C) && (defined(TRIMD_TARGET_F16C) || defined(_MSC_VER))
         #define TRIMD_ENABLE_F16C
     #endif  // RL_BUILD_WITH_HALF_FLOATS
     #if !defined(TRIMD_ENABLE_AVX)
         #define TRIMD_ENABLE_AVX
     #endif
+    // 256-bit integer instructions are used only where the compiler generates them (MSVC accepts the intrinsics without
+    // flags), otherwise the integer kernels work on 128-bit halves
+    #if !defined(TRIMD_ENABLE_AVX2) && (defined(TRIMD_TARGET_AVX2) || defined(_MSC_VER))
+        #define TRIMD_ENABLE_AVX2
+    #endif
+    // Fused instructions are used only where the compiler generates them (MSVC accepts the intrinsics without flags),
+    // otherwise fmadd is emulated with a separate multiply and add
+    #if !defined(TRIMD_ENABLE_FMA) && (defined(TRIMD_TARGET_FMA) || defined(_MSC_VER))
+        #define TRIMD_ENABLE_FMA
+    #endif
     #if !defined(TRIMD_ENABLE_SSE)
         #define TRIMD_ENABLE_SSE
     #endif
 #endif  // RL_BUILD_WITH_AVX
 
 #if defined(RL_BUILD_WITH_SSE) && !defined(TRIMD_ENABLE_SSE)
-    #if defined(RL_BUILD_WITH_HALF_FLOATS) && !defined(TRIMD_ENABLE_F16C)
+    #if defined(RL_BUILD_WITH_HALF_FLOATS) && !defined(TRIMD_ENABLE_F16C) && (defined(TRIMD_TARGET_F16C) || defined(_MSC_VER))
         #define TRIMD_ENABLE_F16C
     #endif  // RL_BUILD_WITH_HALF_FLOATS
     #define TRIMD_ENABLE_SSE
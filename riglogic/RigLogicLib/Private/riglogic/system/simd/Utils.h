@@ -21,49 +21,78 @@ inline bool operator!=(const ActiveFeatures& lhs, const ActiveFeatures& rhs) {
     return !(lhs == rhs);
 }
 
+// Whether the CPU supports all instruction sets that a variant is compiled for (which depends on the compiler and on what
+// its translation units select, see SIMD.h), each defined in a translation unit of the variant (Utils<ISA>.cpp)
+#ifdef RL_BUILD_WITH_AVX512
+    bool isAVX512VariantSupported(const trimd::CPUFeatures& features, FloatingPointType floatingPointType);
+#endif  // RL_BUILD_WITH_AVX512
+#ifdef RL_BUILD_WITH_AVX
+    bool isAVXVariantSupported(const trimd::CPUFeatures& features, FloatingPointType floatingPointType);
+#endif  // RL_BUILD_WITH_AVX
+#ifdef RL_BUILD_WITH_SSE
+    bool isSSEVariantSupported(const trimd::CPUFeatures& features, FloatingPointType floatingPointType);
+#endif  // RL_BUILD_WITH_SSE
+
 inline ActiveFeatures getActiveFeatures(const Configuration& config) {
     ActiveFeatures result = {};
 
     auto features = trimd::getCPUFeatures();
     RL_UNUSED(features);
-    #ifdef RL_BUILD_WITH_SSE
+    RL_UNUSED(config);
+    // Variants are tried from the widest to the narrowest, so AnyVector resolves to the fastest one the CPU supports
+    #ifdef RL_BUILD_WITH_AVX512
         #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-            features.SSE2 = true;
+            features.AVX512F = true;
+            features.AVX = true;
+            features.AVX2 = true;
+            features.FMA = true;
+            features.F16C = true;
         #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-        if (features.SSE2 &&
-            ((config.calculationType == CalculationType::SSE) || (config.calculationType == CalculationType::AnyVector))) {
-            result.calculationType = CalculationType::SSE;
+        if (isAVX512VariantSupported(features, FloatingPointType::Float) &&
+            ((config.calculationType == CalculationType::AVX512) || (config.calculationType == CalculationType::AnyVector))) {
+            result.calculationType = CalculationType::AVX512;
             result.floatingPointType = FloatingPointType::Float;
-            #ifdef RL_BUILD_WITH_HALF_FLOATS
-                #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                    features.F16C = true;
-                #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                if (features.F16C) {
-                    result.floatingPointType = FloatingPointType::HalfFloat;
-                }
-            #endif  // RL_BUILD_WITH_HALF_FLOATS
+            if ((config.floatingPointType == FloatingPointType::HalfFloat) &&
+                isAVX512VariantSupported(features, FloatingPointType::HalfFloat)) {
+                result.floatingPointType = FloatingPointType::HalfFloat;
+            }
             return result;
         }
-    #endif  // RL_BUILD_WITH_SSE
+    #endif  // RL_BUILD_WITH_AVX512
     #ifdef RL_BUILD_WITH_AVX
         #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
             features.AVX = true;
+            features.AVX2 = true;
+            features.FMA = true;
+            features.F16C = true;
         #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-        if (features.AVX &&
+        if (isAVXVariantSupported(features, FloatingPointType::Float) &&
             ((config.calculationType == CalculationType::AVX) || (config.calculationType == CalculationType::AnyVector))) {
             result.calculationType = CalculationType::AVX;
             result.floatingPointType = FloatingPointType::Float;
-            #ifdef RL_BUILD_WITH_HALF_FLOATS
-                #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                    features.F16C = true;
-                #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                if (features.F16C) {
-                    result.floatingPointType = FloatingPointType::HalfFloat;
-                }
-            #endif  // RL_BUILD_WITH_HALF_FLOATS
+            if ((config.floatingPointType == FloatingPointType::HalfFloat) &&
+                isAVXVariantSupported(features, FloatingPointType::HalfFloat)) {
+                result.floatingPointType = FloatingPointType::HalfFloat;
+            }
             return result;
         }
     #endif  // RL_BUILD_WITH_AVX
+    #ifdef RL_BUILD_WITH_SSE
+        #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
+            features.SSE2 = true;
+            features.F16C = true;
+        #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
+        if (isSSEVariantSupported(features, FloatingPointType::Float) &&
+            ((config.calculationType == CalculationType::SSE) || (config.calculationType == CalculationType::AnyVector))) {
+            result.calculationType = CalculationType::SSE;
+            result.floatingPointType = FloatingPointType::Float;
+            if ((config.floatingPointType == FloatingPointType::HalfFloat) &&
+                isSSEVariantSupported(features, FloatingPointType::HalfFloat)) {
+                result.floatingPointType = FloatingPointType::HalfFloat;
+            }
+            return result;
+        }
+    #endif  // RL_BUILD_WITH_SSE
     #ifdef RL_BUILD_WITH_NEON
         #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
             features.NEON = true;
@@ -76,7 +105,7 @@ inline ActiveFeatures getActiveFeatures(const Configuration& config) {
                 #ifdef RL_DISABLE_RUNTIME_FEATURE_DETECTION
                     features.FP16 = true;
                 #endif  // RL_DISABLE_RUNTIME_FEATURE_DETECTION
-                if (features.FP16) {
+                if (features.FP16 && (config.floatingPointType == FloatingPointType::HalfFloat)) {
                     result.floatingPointType = FloatingPointType::HalfFloat;
                 }
             #endif  // RL_BUILD_WITH_HALF_FLOATS
@@ -89,4 +118,12 @@ inline ActiveFeatures getActiveFeatures(const Configuration& config) {
     return result;
 }
 
+// Whether the given variant is built in and supported by the CPU, i.e. whether requesting it explicitly resolves to it
+inline bool isSupported(const ActiveFeatures& features) {
+    Configuration config;
+    config.calculationType = features.calculationType;
+    config.floatingPointType = features.floatingPointType;
+    return getActiveFeatures(config) == features;
+}
+
 }  // namespace rl4
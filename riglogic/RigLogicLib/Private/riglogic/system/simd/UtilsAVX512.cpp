@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+// Must precede all other includes, as it selects the instruction sets of what they declare
+#define TRIMD_ISOLATE_AVX512
+#include "trimd/Isolate.h"
+
+#include "riglogic/system/simd/Utils.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_AVX512
+bool isAVX512VariantSupported(const trimd::CPUFeatures& features, FloatingPointType floatingPointType) {
+    bool supported = features.AVX512F && features.AVX;
+    #ifdef TRIMD_ENABLE_AVX2
+        supported = supported && features.AVX2;
+    #endif  // TRIMD_ENABLE_AVX2
+    #ifdef TRIMD_ENABLE_FMA
+        supported = supported && features.FMA;
+    #endif  // TRIMD_ENABLE_FMA
+    if (floatingPointType == FloatingPointType::HalfFloat) {
+        #ifdef TRIMD_ENABLE_F16C
+            supported = supported && features.F16C;
+        #else
+            supported = false;
+        #endif  // TRIMD_ENABLE_F16C
+    }
+    return supported;
+}
+#endif  // RL_BUILD_WITH_AVX512
+
+}  // namespace rl4
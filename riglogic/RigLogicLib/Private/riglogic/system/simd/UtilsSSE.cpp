@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "riglogic/system/simd/Utils.h"
+
+namespace rl4 {
+
+#ifdef RL_BUILD_WITH_SSE
+bool isSSEVariantSupported(const trimd::CPUFeatures& features, FloatingPointType floatingPointType) {
+    bool supported = features.SSE2;
+    if (floatingPointType == FloatingPointType::HalfFloat) {
+        #ifdef TRIMD_ENABLE_F16C
+            supported = supported && features.F16C;
+        #else
+            supported = false;
+        #endif  // TRIMD_ENABLE_F16C
+    }
+    return supported;
+}
+#endif  // RL_BUILD_WITH_SSE
+
+}  // namespace rl4
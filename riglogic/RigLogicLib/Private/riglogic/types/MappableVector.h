@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/types/MappedDump.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace rl4 {
+
+// Cache-line aligned array that either owns its elements, or when restored from a mapped dump,
+// refers to read-only memory within the mapped file (in which case it cannot be modified)
+template<typename T>
+class MappableVector {
+    public:
+        explicit MappableVector(MemoryResource* memRes) : owned{memRes}, mapped{} {
+        }
+
+        bool isMapped() const {
+            return (mapped.data() != nullptr);
+        }
+
+        std::size_t size() const {
+            return (isMapped() ? mapped.size() : owned.size());
+        }
+
+        bool empty() const {
+            return (size() == 0ul);
+        }
+
+        const T* data() const {
+            return (isMapped() ? mapped.data() : owned.data());
+        }
+
+        T* data() {
+            assert(!isMapped());
+            return owned.data();
+        }
+
+        const T* begin() const {
+            return data();
+        }
+
+        const T* end() const {
+            return data() + size();
+        }
+
+        T* begin() {
+            return data();
+        }
+
+        T* end() {
+            return data() + size();
+        }
+
+        const T& operator[](std::size_t index) const {
+            return data()[index];
+        }
+
+        T& operator[](std::size_t index) {
+            return data()[index];
+        }
+
+        void resize(std::size_t size) {
+            assert(!isMapped());
+            owned.resize(size);
+        }
+
+        // Removes all elements, releasing their storage as well
+        void clear() {
+            assert(!isMapped());
+            owned.clear();
+            owned.shrink_to_fit();
+        }
+
+        template<class Archive>
+        void load(Archive& archive) {
+            auto reader = static_cast<MappedDumpReader*>(archive.getUserData());
+            if (reader == nullptr) {
+                mapped = {};
+                archive(owned);
+                return;
+            }
+            std::uint32_t section{};
+            std::uint64_t count{};
+            archive(section, count);
+            owned.clear();
+            owned.shrink_to_fit();
+            mapped = reader->template getSection<T>(section, count);
+        }
+
+        template<class Archive>
+        void save(Archive& archive) {
+            auto writer = static_cast<MappedDumpWriter*>(archive.getUserData());
+            if (writer != nullptr) {
+                std::uint32_t section = writer->addSection(static_cast<const MappableVector&>(*this).data(), size() * sizeof(T));
+                std::uint64_t count = size();
+                archive(section, count);
+            } else if (isMapped()) {
+                // Regular dumps must remain loadable without the mapped file, so mapped contents are copied out
+                AlignedVector<T> copy{mapped.begin(), mapped.end(), owned.get_allocator()};
+                archive(copy);
+            } else {
+                archive(owned);
+            }
+        }
+
+    private:
+        AlignedVector<T> owned;
+        ConstArrayView<T> mapped;
+
+};
+
+}  // namespace rl4
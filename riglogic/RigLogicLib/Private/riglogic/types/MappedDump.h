@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rl4 {
+
+// Layout of a mapped dump:
+//   MappedDumpHeader
+//   MappedDumpSection[sectionCount]
+//   regular (network byte order) dump of all the state, where bulk arrays are replaced by section indices and
+//   element counts
+//   section data, each section starting at an offset aligned to cacheLineAlignment, in native byte order
+struct MappedDumpHeader {
+    static constexpr char expectedMagic[4] = {'R', 'L', 'M', 'D'};
+    static constexpr std::uint32_t currentVersion = 3u;
+    static constexpr std::uint32_t nativeByteOrderMark = 0x01020304u;
+
+    char magic[4];
+    std::uint32_t version;
+    // Written in native byte order, so a mismatch identifies dumps created on a different architecture
+    std::uint32_t byteOrderMark;
+    std::uint32_t sectionCount;
+    std::uint64_t stateOffset;
+    std::uint64_t stateSize;
+};
+
+struct MappedDumpSection {
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+// Set as archive user data while writing a mapped dump, collects the memory regions that are stored as separate sections
+class MappedDumpWriter {
+    public:
+        explicit MappedDumpWriter(MemoryResource* memRes) : sections{memRes} {
+        }
+
+        std::uint32_t addSection(const void* data, std::size_t size) {
+            sections.emplace_back(static_cast<const char*>(data), size);
+            return static_cast<std::uint32_t>(sections.size() - 1ul);
+        }
+
+        ConstArrayView<ConstArrayView<char> > getSections() const {
+            return {sections.data(), sections.size()};
+        }
+
+    private:
+        Vector<ConstArrayView<char> > sections;
+
+};
+
+// Set as archive user data while restoring from a mapped dump, resolves section indices into views over the mapped file
+class MappedDumpReader {
+    public:
+        MappedDumpReader(const char* base_, ConstArrayView<MappedDumpSection> sections_) :
+            base{base_},
+            sections{sections_},
+            failed{false} {
+        }
+
+        // Sections that do not exist, or do not hold exactly the expected number of suitably aligned elements,
+        // resolve to an empty view and mark the whole restore as failed
+        template<typename T>
+        ConstArrayView<T> getSection(std::uint32_t index, std::uint64_t count) {
+            if (index >= sections.size()) {
+                failed = true;
+                return {};
+            }
+            const auto& section = sections[index];
+            const char* data = base + section.offset;
+            if ((section.size / sizeof(T) != count) || ((section.size % sizeof(T)) != 0ul) ||
+                ((reinterpret_cast<std::uintptr_t>(data) % alignof(T)) != 0ul)) {
+                failed = true;
+                return {};
+            }
+            return {reinterpret_cast<const T*>(data), static_cast<std::size_t>(count)};
+        }
+
+        bool hasFailed() const {
+            return failed;
+        }
+
+    private:
+        const char* base;
+        ConstArrayView<MappedDumpSection> sections;
+        bool failed;
+
+};
+
+}  // namespace rl4
@@ -0,0 +1,202 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/TypeDefs.h"
+#include "riglogic/types/Extent.h"
+#include "riglogic/utils/Extd.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace rl4 {
+
+enum class StorageValueType : std::uint8_t {
+    Float,
+    HalfFloat,
+    Int8
+};
+
+template<typename T>
+struct StorageValueTypeOf;
+
+template<>
+struct StorageValueTypeOf<float> {
+    static constexpr StorageValueType value = StorageValueType::Float;
+};
+
+template<>
+struct StorageValueTypeOf<std::uint16_t> {
+    static constexpr StorageValueType value = StorageValueType::HalfFloat;
+};
+
+template<>
+struct StorageValueTypeOf<std::int8_t> {
+    static constexpr StorageValueType value = StorageValueType::Int8;
+};
+
+/*
+ * Describes how a matrix was arranged into blocks of rows (see bpcm::Optimizer)
+ *
+ * The block heights depend on the vector width of the instruction set the storage was built for, and
+ * the value type on the floating point type, so dumps record the layout of their matrices, which lets
+ * instances restored by a different variant re-arrange them for their own (see convertBlockedMatrix).
+ */
+struct StorageLayout {
+    std::uint32_t blockHeight;
+    std::uint32_t padTo;
+    std::uint32_t stride;
+    StorageValueType valueType;
+
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(blockHeight, padTo, stride, valueType);
+    }
+
+};
+
+inline bool operator==(const StorageLayout& lhs, const StorageLayout& rhs) {
+    return (lhs.blockHeight == rhs.blockHeight) && (lhs.padTo == rhs.padTo) && (lhs.stride == rhs.stride) &&
+           (lhs.valueType == rhs.valueType);
+}
+
+inline bool operator!=(const StorageLayout& lhs, const StorageLayout& rhs) {
+    return !(lhs == rhs);
+}
+
+// Portable (round-to-nearest-even) half float conversions, for when the half float instructions of
+// the active variant may not be used
+inline float halfToFloat(std::uint16_t half) {
+    const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16u;
+    const std::uint32_t exponent = (half >> 10u) & 0x1Fu;
+    std::uint32_t mantissa = half & 0x3FFu;
+    std::uint32_t bits = sign;
+    if (exponent == 0x1Fu) {
+        bits |= 0x7F800000u | (mantissa << 13u);
+    } else if (exponent != 0u) {
+        bits |= ((exponent + 112u) << 23u) | (mantissa << 13u);
+    } else if (mantissa != 0u) {
+        // Subnormal half floats are normal floats
+        std::uint32_t shift = {};
+        while ((mantissa & 0x400u) == 0u) {
+            mantissa <<= 1u;
+            ++shift;
+        }
+        bits |= ((113u - shift) << 23u) | ((mantissa & 0x3FFu) << 13u);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline std::uint16_t floatToHalf(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const auto sign = static_cast<std::uint16_t>((bits >> 16u) & 0x8000u);
+    const std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {
+        // Infinities stay infinities, and NaNs stay (quiet) NaNs
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+    }
+    if (magnitude >= 0x477FF000u) {
+        // Rounds to a magnitude beyond the largest half float
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+    }
+    if (magnitude < 0x38800000u) {
+        // Subnormal half floats (or zero), rounded to nearest even by shifting in the implicit bit
+        if (magnitude < 0x33000000u) {
+            return sign;
+        }
+        const std::uint32_t exponent = magnitude >> 23u;
+        const std::uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const std::uint32_t shift = 126u - exponent;
+        const std::uint32_t halfway = 1u << (shift - 1u);
+        std::uint32_t result = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        if ((remainder > halfway) || ((remainder == halfway) && ((result & 1u) != 0u))) {
+            ++result;
+        }
+        return static_cast<std::uint16_t>(sign | result);
+    }
+    // Rebias the exponent, and round the mantissa to nearest even (a carry correctly increments the exponent)
+    const std::uint32_t rebiased = magnitude - 0x38000000u;
+    const std::uint32_t roundingBias = 0xFFFu + ((rebiased >> 13u) & 1u);
+    return static_cast<std::uint16_t>(sign | ((rebiased + roundingBias) >> 13u));
+}
+
+inline float convertStoredValue(float value, float*  /*unused*/) {
+    return value;
+}
+
+inline float convertStoredValue(std::uint16_t value, float*  /*unused*/) {
+    return halfToFloat(value);
+}
+
+inline std::uint16_t convertStoredValue(float value, std::uint16_t*  /*unused*/) {
+    return floatToHalf(value);
+}
+
+inline std::uint16_t convertStoredValue(std::uint16_t value, std::uint16_t*  /*unused*/) {
+    return value;
+}
+
+// Visits the values of a (row-major) matrix of the given dimensions, in the order in which they are
+// stored by bpcm::Optimizer with the given layout, calling func(offset, row, col) for each of them
+template<typename TFunc>
+void forEachBlockedValue(const StorageLayout& layout, Extent dimensions, TFunc func) {
+    const std::uint32_t remainder = dimensions.rows % layout.blockHeight;
+    const std::uint32_t target = dimensions.rows - remainder;
+    std::uint32_t offset = {};
+    for (std::uint32_t row = {}; row < target; row += layout.blockHeight) {
+        for (std::uint32_t col = {}; col < dimensions.cols; ++col) {
+            for (std::uint32_t base = {}; base < layout.stride; ++base) {
+                for (std::uint32_t blkIdx = base; blkIdx < layout.blockHeight; blkIdx += layout.stride, ++offset) {
+                    func(offset, row + blkIdx, col);
+                }
+            }
+        }
+    }
+    if (remainder != 0u) {
+        const std::uint32_t paddedBlockHeight = extd::roundUp(remainder, layout.padTo);
+        for (std::uint32_t col = {}; col < dimensions.cols; ++col) {
+            for (std::uint32_t base = {}; base < layout.stride; ++base) {
+                for (std::uint32_t blkIdx = base; blkIdx < remainder; blkIdx += layout.stride, ++offset) {
+                    func(offset, target + blkIdx, col);
+                }
+                offset += (paddedBlockHeight - remainder) / layout.stride;
+            }
+        }
+    }
+}
+
+/*
+ * Re-arranges a matrix stored by bpcm::Optimizer with one layout, into the layout of another
+ *
+ * Only the first rowCount rows are kept, which may be fewer than the source was built with (rows beyond
+ * those are then treated as padding). The destination must hold rowCount rows padded to the padTo of its
+ * layout, and is zero filled before the values are copied.
+ */
+template<typename TDest, typename TSource>
+void convertBlockedMatrix(TDest* dest,
+                          const StorageLayout& destLayout,
+                          const TSource* source,
+                          const StorageLayout& sourceLayout,
+                          Extent sourceDimensions,
+                          std::uint32_t rowCount,
+                          MemoryResource* memRes) {
+    const Extent destDimensions{rowCount, sourceDimensions.cols};
+    std::fill_n(dest, static_cast<std::size_t>(extd::roundUp(rowCount, destLayout.padTo)) * destDimensions.cols, TDest{});
+    Vector<TDest> values{destDimensions.size(), TDest{}, memRes};
+    forEachBlockedValue(sourceLayout, sourceDimensions, [&](std::uint32_t offset, std::uint32_t row, std::uint32_t col) {
+            if (row < rowCount) {
+                values[row * destDimensions.cols + col] = convertStoredValue(source[offset], static_cast<TDest*>(nullptr));
+            }
+        });
+    forEachBlockedValue(destLayout, destDimensions, [&](std::uint32_t offset, std::uint32_t row, std::uint32_t col) {
+            dest[offset] = values[row * destDimensions.cols + col];
+        });
+}
+
+}  // namespace rl4
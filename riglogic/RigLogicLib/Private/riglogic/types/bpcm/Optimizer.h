@@ -12,6 +12,8 @@ namespace rl4 {
 
 namespace bpcm {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TFVec, std::uint32_t BlockHeight, std::uint32_t PadTo, std::uint32_t Stride>
 struct Optimizer {
     static_assert(BlockHeight % TFVec::size() == 0, "BlockHeight must be a multiple of TFVec::size()");
@@ -121,6 +123,8 @@ struct Optimizer {
 
 };
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace bpcm
 
 }  // namespace rl4
@@ -32,4 +32,8 @@ void MemoryMappedFileStream::destroy(MemoryMappedFileStream* instance) {
 
 MemoryMappedFileStream::~MemoryMappedFileStream() = default;
 
+const char* MemoryMappedFileStream::getMappedData() {
+    return nullptr;
+}
+
 }  // namespace trio
@@ -68,6 +68,10 @@ std::uint64_t MemoryMappedFileStreamFallback::size() {
     return stream->size();
 }
 
+const char* MemoryMappedFileStreamFallback::getMappedData() {
+    return nullptr;
+}
+
 MemoryResource* MemoryMappedFileStreamFallback::getMemoryResource() {
     return memRes;
 }
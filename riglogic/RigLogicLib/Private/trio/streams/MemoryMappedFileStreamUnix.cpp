@@ -122,6 +122,13 @@ MemoryMappedFileStreamUnix::~MemoryMappedFileStreamUnix() {
     MemoryMappedFileStreamUnix::close();
 }
 
+const char* MemoryMappedFileStreamUnix::getMappedData() {
+    if ((data == nullptr) || (viewOffset != 0ul) || (viewSize != fileSize)) {
+        return nullptr;
+    }
+    return static_cast<const char*>(data);
+}
+
 MemoryResource* MemoryMappedFileStreamUnix::getMemoryResource() {
     return memRes;
 }
@@ -118,6 +118,13 @@ MemoryMappedFileStreamWindows::~MemoryMappedFileStreamWindows() {
     closeFile();
 }
 
+const char* MemoryMappedFileStreamWindows::getMappedData() {
+    if ((data == nullptr) || (viewOffset != 0ul) || (viewSize != fileSize)) {
+        return nullptr;
+    }
+    return static_cast<const char*>(data);
+}
+
 MemoryResource* MemoryMappedFileStreamWindows::getMemoryResource() {
     return memRes;
 }
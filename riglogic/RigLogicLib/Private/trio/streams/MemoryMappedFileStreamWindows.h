@@ -40,6 +40,7 @@ class MemoryMappedFileStreamWindows : public MemoryMappedFileStream {
         std::size_t write(Readable* source, std::size_t size) override;
         void flush() override;
         void resize(std::uint64_t size) override;
+        const char* getMappedData() override;
 
         MemoryResource* getMemoryResource();
 
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include "riglogic/riglogic/CrowdEvaluator.h"
+#include "riglogic/riglogic/Executor.h"
+#include "riglogic/riglogic/JointGroupRepacker.h"
 #include "riglogic/riglogic/RigInstance.h"
 #include "riglogic/riglogic/RigLogic.h"
 #include "riglogic/types/Aliases.h"
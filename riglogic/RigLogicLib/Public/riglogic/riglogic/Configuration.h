@@ -16,15 +16,35 @@ enum class CalculationType : std::uint8_t {
           ///< otherwise it falls back to using the Scalar version)
     NEON,  ///< vectorized (NEON) CPU algorithm (RigLogic must be built with NEON support,
            ///< otherwise it falls back to using the Scalar version)
-    AnyVector  ///< Pick any available vectorization
+    AnyVector,  ///< Pick the widest vectorization that RigLogic was built with and the CPU supports
+    AVX512  ///< vectorized (AVX-512) CPU algorithm (RigLogic must be built with AVX-512 support,
+            ///< otherwise it falls back to using the Scalar version)
 };
 
 /**
     @brief Floating point type used in vectorized calculations.
 */
 enum class FloatingPointType : std::uint8_t {
-    Float,
-    HalfFloat
+    Float,  ///< values are stored as floats, even when half float storage would be available
+    HalfFloat  ///< values are stored as half floats and converted on load (RigLogic must be built with half float
+               ///< support and the CPU must support the conversions, otherwise it falls back to using Float)
+};
+
+/**
+    @brief Accuracy of the tanh and sigmoid activation functions used by neural networks.
+*/
+enum class ActivationFunctionAccuracy : std::uint8_t {
+    Precise,  ///< rational approximation, max absolute error of tanh ~3.3e-7
+    Fast  ///< lower order rational approximation, max absolute error of tanh ~7.1e-5
+};
+
+/**
+    @brief Storage type of neural network weights.
+*/
+enum class WeightQuantization : std::uint8_t {
+    None,  ///< weights are stored in the floating point type used by the vectorized calculations
+    Int8  ///< weights are stored as 8-bit integers with a scale and zero point per output, and layers are evaluated
+          ///< using integer dot products (see RigLogic::getNeuralNetworkQuantizationError)
 };
 
 /**
@@ -62,7 +82,7 @@ enum class ScaleType : std::uint8_t {
 };
 
 struct Configuration {
-    CalculationType calculationType = CalculationType::SSE;
+    CalculationType calculationType = CalculationType::AnyVector;
     bool loadJoints = true;
     bool loadBlendShapes = true;
     bool loadAnimatedMaps = true;
@@ -76,6 +96,10 @@ struct Configuration {
     float translationPruningThreshold = 0.0f;  // Reasonably safe to try 0.0001f;
     float rotationPruningThreshold = 0.0f;  // Reasonably safe to try 0.1f
     float scalePruningThreshold = 0.0f;  // Reasonably safe to try 0.001f;
+    ActivationFunctionAccuracy activationFunctionAccuracy = ActivationFunctionAccuracy::Precise;
+    WeightQuantization neuralNetworkWeightQuantization = WeightQuantization::None;
+    bool repackJointGroups = false;  // Recluster joint group rows by shared inputs on creation (see JointGroupRepacker)
+    FloatingPointType floatingPointType = FloatingPointType::HalfFloat;  // Used only where supported, Float opts out
 };
 
 }  // namespace rl4
@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/Defs.h"
+#include "riglogic/types/Aliases.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rl4 {
+
+class RigInstance;
+class RigLogic;
+
+/**
+    @brief CrowdEvaluator calculates a large number of rig instances in parallel on its own pool of threads.
+    @note
+        Instances are distributed between threads based on the estimated cost of evaluating them on their
+        current LOD (joint delta values, RBF solvers, neural networks, blend shapes and animated maps), and
+        threads that run out of work steal the remaining instances of other threads.
+    @note
+        Each instance is evaluated exactly as by RigLogic::calculate, and no allocations are performed
+        during evaluation once the internal scheduling buffers have grown to the largest crowd size.
+    @see RigLogic
+*/
+class RLAPI CrowdEvaluator {
+    protected:
+        virtual ~CrowdEvaluator();
+
+    public:
+        /**
+            @brief Factory method for the creation of CrowdEvaluator.
+            @param rigLogic
+                The RigLogic instance from which all evaluated rig instances were created.
+            @param threadCount
+                Number of background threads to spawn.
+                If zero is given, the number of hardware threads minus one is used.
+            @param memRes
+                A custom memory resource to be used for allocations.
+            @note
+                If a custom memory resource is not given, a default allocation mechanism will be used.
+            @warning
+                The RigLogic instance must outlive the created CrowdEvaluator.
+            @warning
+                User is responsible for releasing the returned pointer by calling destroy.
+            @see destroy
+        */
+        static CrowdEvaluator* create(const RigLogic* rigLogic, std::uint16_t threadCount = 0u, MemoryResource* memRes = nullptr);
+        /**
+            @brief Method for freeing CrowdEvaluator.
+            @note
+                Waits for any previously submitted work to complete.
+            @param instance
+                Instance of CrowdEvaluator to be freed.
+            @see create
+        */
+        static void destroy(CrowdEvaluator* instance);
+        /**
+            @brief Number of background threads that evaluate the submitted instances.
+        */
+        virtual std::uint16_t getThreadCount() const = 0;
+        /**
+            @brief Calculate outputs for joints, blend shapes, and animated maps of all given rig instances.
+            @note
+                Equivalent to calling submit followed by wait, with the calling thread taking part in the evaluation.
+            @param instances
+                The rig instances whose outputs are to be calculated, each on its own current LOD.
+            @param count
+                The number of rig instances.
+            @warning
+                Each rig instance may appear only once in the given array.
+        */
+        virtual void calculate(RigInstance** instances, std::size_t count) = 0;
+        /**
+            @brief Start calculating the given rig instances in the background, and return immediately.
+            @note
+                The instance pointers are copied, so the array itself need not outlive this call.
+                If work submitted earlier is still in progress, this call waits for it to complete first.
+            @param instances
+                The rig instances whose outputs are to be calculated, each on its own current LOD.
+            @param count
+                The number of rig instances.
+            @warning
+                Until wait returns, the submitted rig instances must not be accessed or destroyed.
+            @see wait
+        */
+        virtual void submit(RigInstance** instances, std::size_t count) = 0;
+        /**
+            @brief Block until all previously submitted rig instances are calculated.
+            @note
+                The calling thread helps evaluate the remaining instances while waiting.
+            @see submit
+        */
+        virtual void wait() = 0;
+
+};
+
+}  // namespace rl4
+
+namespace pma {
+
+template<>
+struct DefaultInstanceCreator<rl4::CrowdEvaluator> {
+    using type = FactoryCreate<rl4::CrowdEvaluator>;
+};
+
+template<>
+struct DefaultInstanceDestroyer<rl4::CrowdEvaluator> {
+    using type = FactoryDestroy<rl4::CrowdEvaluator>;
+};
+
+}  // namespace pma
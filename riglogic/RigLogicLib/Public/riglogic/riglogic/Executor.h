@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/Defs.h"
+#include "riglogic/types/Aliases.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rl4 {
+
+/**
+    @brief Executor distributes independent units of work of a single rig evaluation across multiple threads.
+    @note
+        Users may implement this interface to route RigLogic's work into their own job system,
+        or use the default thread pool implementation obtained through create.
+    @see RigLogic::calculate
+*/
+class RLAPI Executor {
+    public:
+        /**
+            @brief Signature of a single unit of work.
+            @param context
+                Opaque pointer passed through unchanged from parallelFor.
+            @param taskIndex
+                Index of the task to execute, in range [0, taskCount).
+            @param workerIndex
+                Index of the worker executing the task, in range [0, getWorkerCount()).
+                No two tasks of the same parallelFor call may run concurrently with the same worker index.
+        */
+        using TaskFunction = void (*)(void* context, std::size_t taskIndex, std::size_t workerIndex);
+
+    protected:
+        virtual ~Executor();
+
+    public:
+        /**
+            @brief Factory method for the creation of the default thread pool executor.
+            @param threadCount
+                Number of background threads to spawn. The thread calling parallelFor participates
+                in the work as well, so the total number of workers is threadCount + 1.
+                If zero is given, the number of hardware threads minus one is used.
+            @param memRes
+                A custom memory resource to be used for allocations.
+            @note
+                If a custom memory resource is not given, a default allocation mechanism will be used.
+            @warning
+                User is responsible for releasing the returned pointer by calling destroy.
+            @see destroy
+        */
+        static Executor* create(std::uint16_t threadCount = 0u, MemoryResource* memRes = nullptr);
+        /**
+            @brief Method for freeing an executor created through create.
+            @param instance
+                Instance of Executor to be freed.
+            @see create
+        */
+        static void destroy(Executor* instance);
+        /**
+            @brief Maximum number of workers that may execute tasks concurrently.
+            @note
+                RigLogic uses this to size per-worker scratch storage, so worker indices passed to
+                tasks must always be less than the returned value.
+        */
+        virtual std::size_t getWorkerCount() const = 0;
+        /**
+            @brief Execute task(context, i, workerIndex) for every i in range [0, taskCount).
+            @note
+                Tasks may be executed in any order and on any worker, but the function must not return
+                before all of them have completed.
+            @note
+                Tasks may call parallelFor on the same executor again (e.g. a task of a job system that calls
+                RigLogic::calculate with the executor that runs it), so implementations must not block such nested
+                calls on the completion of the outer call. The default thread pool executes the tasks of nested
+                calls inline, one after another, on the worker that makes the call, with its worker index.
+            @param task
+                The function to invoke for each task index.
+            @param context
+                Opaque pointer to be passed to each invocation of task.
+            @param taskCount
+                Number of tasks to execute.
+        */
+        virtual void parallelFor(TaskFunction task, void* context, std::size_t taskCount) = 0;
+
+};
+
+}  // namespace rl4
+
+namespace pma {
+
+template<>
+struct DefaultInstanceCreator<rl4::Executor> {
+    using type = FactoryCreate<rl4::Executor>;
+};
+
+template<>
+struct DefaultInstanceDestroyer<rl4::Executor> {
+    using type = FactoryDestroy<rl4::Executor>;
+};
+
+}  // namespace pma
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "riglogic/Defs.h"
+#include "riglogic/riglogic/Configuration.h"
+#include "riglogic/types/Aliases.h"
+
+#include <cstdint>
+
+namespace rl4 {
+
+/**
+    @brief Size and evaluation cost of a joint group layout at LOD 0.
+    @note
+        Only rows and columns with at least one non-zero value are counted, as those are the only ones RigLogic keeps.
+*/
+struct JointGroupLayoutStats {
+    std::uint32_t jointGroupCount;
+    std::uint32_t rowCount;
+    std::uint32_t columnCount;
+    // Values stored (and multiply-adds performed) after rows are padded to the vector width
+    std::uint32_t paddedValueCount;
+    // Inputs loaded and broadcast across vector lanes, once per column for each block of rows
+    std::uint32_t inputBroadcastCount;
+};
+
+struct JointGroupRepackingReport {
+    JointGroupLayoutStats before;
+    JointGroupLayoutStats after;
+};
+
+/**
+    @brief JointGroupRepacker redistributes the rows of joint groups between groups, to reduce padding and input broadcasts.
+    @note
+        Joints whose rows depend on largely the same inputs are clustered into the same group, so their shared columns
+        are loaded and broadcast once, and fewer, fuller groups waste less of the vector width on padding rows.
+    @note
+        All rows of a joint stay in the same group, and the rows of each group are ordered so that the rows of each LOD
+        remain a prefix of the group. The evaluated joint outputs are the same as for the original layout.
+    @note
+        If the clustering does not improve on the existing layout, the joint groups are left unchanged.
+    @see Configuration::repackJointGroups
+*/
+class RLAPI JointGroupRepacker {
+    public:
+        /**
+            @brief Computes the repacked joint groups of a DNA and writes them into the given writer.
+            @param source
+                The DNA whose joint groups are repacked.
+            @param destination
+                The writer into which the repacked joint groups are written, replacing all joint groups it contains.
+            @param calculationType
+                The calculation type whose vector width the layout is optimized for.
+            @param report
+                Optional output, receiving the layout stats before and after repacking.
+            @param memRes
+                A custom memory resource to be used for temporary allocations.
+            @note
+                All other data is left untouched, so destination is expected to be already populated from source,
+                e.g. by calling setFrom(source) on it.
+        */
+        static void repack(const dna::Reader* source,
+                           dna::Writer* destination,
+                           CalculationType calculationType = CalculationType::AnyVector,
+                           JointGroupRepackingReport* report = nullptr,
+                           MemoryResource* memRes = nullptr);
+
+};
+
+}  // namespace rl4
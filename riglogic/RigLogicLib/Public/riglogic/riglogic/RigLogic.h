@@ -7,10 +7,12 @@
 #include "riglogic/riglogic/Stats.h"
 #include "riglogic/types/Aliases.h"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace rl4 {
 
+class Executor;
 class RigInstance;
 
 /**
@@ -44,6 +46,33 @@ class RLAPI RigLogic {
             @see destroy
         */
         static RigLogic* create(const dna::Reader* reader, const Configuration& config = {}, MemoryResource* memRes = nullptr);
+        /**
+            @brief Factory method for the creation of RigLogic, calibrating quantized neural networks on the given inputs.
+            @param reader
+                Source from which to copy and optimize DNA data, which is used for rig evaluation
+            @param config
+                Determines which algorithm implementation is used for rig evaluation and which submodules to load (affects memory allocations)
+            @param neuralNetworkCalibrationInputs
+                Sample inputs for each neural network (indexed by neural network index), each a row-major matrix with
+                one row per sample, and one column per input of the network (in the order of the input indices of the
+                network in the DNA). Only used if Configuration::neuralNetworkWeightQuantization quantizes weights.
+            @param memRes
+                A custom memory resource to be used for allocations.
+            @note
+                The scales and zero points of quantized weights are chosen to minimize the largest error of each layer
+                output over the given samples, and getNeuralNetworkQuantizationError reports the error measured on them.
+                Networks without (at least one complete row of) samples fall back to the behavior of the other overload.
+            @note
+                The samples are only read during this call, they are not referenced by the created instance.
+            @warning
+                User is responsible for releasing the returned pointer by calling destroy.
+            @see destroy
+            @see getNeuralNetworkQuantizationError
+        */
+        static RigLogic* create(const dna::Reader* reader,
+                                const Configuration& config,
+                                ConstArrayView<ConstArrayView<float> > neuralNetworkCalibrationInputs,
+                                MemoryResource* memRes = nullptr);
         /**
             @brief Method for freeing RigLogic.
             @param instance
@@ -63,12 +92,52 @@ class RLAPI RigLogic {
                 A custom memory resource to be used for allocations.
             @note
                 If a custom memory resource is not given, a default allocation mechanism will be used.
+            @note
+                The instance is restored with the same calculation and floating point type that were in use when
+                it was dumped, as the stored data is laid out for them, even if the CPU supports a wider variant.
+                If the CPU (or build) does not support those, the calculation and floating point type the dumped
+                configuration resolves to are used instead, and the stored data is re-arranged for them.
+            @return
+                Nullptr if the source does not contain a dump of this version of RigLogic, or if neural network
+                weights were quantized when dumping but would not be with the calculation type restored here (or
+                vice versa), otherwise the restored RigLogic instance.
             @warning
                 User is responsible for releasing the returned pointer by calling destroy.
             @see dump
             @see destroy
         */
         static RigLogic* restore(BoundedIOStream* source, MemoryResource* memRes = nullptr);
+        /**
+            @brief Factory method for restoring an instance of RigLogic from a mapped memory dump.
+            @note
+                The bulk data (joint, neural network weights, etc.) is not copied, but referenced directly
+                within the memory-mapped file, so multiple RigLogic instances restored from the same file
+                share the same physical pages.
+            @param source
+                Source stream from which to restore the state, obtained by calling dumpMapped.
+                The stream must be open when calling this function, and must remain open (and alive)
+                for the entire lifetime of the restored RigLogic instance.
+            @param memRes
+                A custom memory resource to be used for allocations.
+            @note
+                If the source stream is not able to map the whole file into memory at once, its contents
+                are copied into memory instead.
+            @note
+                If a custom memory resource is not given, a default allocation mechanism will be used.
+            @return
+                Nullptr if the source does not contain a mapped dump of this version of RigLogic created on an
+                architecture with the same byte order, any of its sections does not match the element count or
+                alignment that the dumped state expects, or the neural network weights cannot be restored (see
+                restore), otherwise the restored RigLogic instance.
+            @note
+                Data that must be re-arranged for a different calculation or floating point type (see restore)
+                is copied into memory.
+            @warning
+                User is responsible for releasing the returned pointer by calling destroy.
+            @see dumpMapped
+            @see destroy
+        */
+        static RigLogic* restoreMapped(MemoryMappedFileStream* source, MemoryResource* memRes = nullptr);
         /**
             @brief Create a snapshot of an initialized RigLogic instance.
             @param destination
@@ -76,6 +145,17 @@ class RLAPI RigLogic {
             @see restore
         */
         virtual void dump(BoundedIOStream* destination) const = 0;
+        /**
+            @brief Create a snapshot of an initialized RigLogic instance, suitable for memory-mapping.
+            @note
+                Unlike dump, the produced snapshot stores bulk data in native byte order, with each array aligned
+                to a cache-line boundary, so it can be used in-place, and is thus not portable across architectures
+                with different byte order.
+            @param destination
+                The output stream into which the current state of RigLogic is going to be written.
+            @see restoreMapped
+        */
+        virtual void dumpMapped(BoundedIOStream* destination) const = 0;
         /**
             @brief Retrieve the configuration that RigLogic was initialized with.
         */
@@ -132,16 +212,56 @@ class RLAPI RigLogic {
             @see calculateJoints
         */
         virtual std::uint16_t getJointGroupCount() const = 0;
+        /**
+            @brief Number of joint work items of the specified LOD.
+            @note
+                Work items cover all joint groups of the LOD, with roughly equal estimated cost, by splitting large
+                joint groups into ranges of rows, and merging small joint groups.
+            @see calculateJointWorkItem
+        */
+        virtual std::uint16_t getJointWorkItemCount(std::uint16_t lod) const = 0;
         /**
             @brief Number of neural networks for driving machine learned behavior.
             @see calculateMachineLearnedBehavior
         */
         virtual std::uint16_t getNeuralNetworkCount() const = 0;
+        /**
+            @brief Accuracy of the quantized weights of the specified neural network.
+            @note
+                Weights are quantized only if Configuration::neuralNetworkWeightQuantization requests it, in which case
+                each network is evaluated with both float and quantized weights when RigLogic is created, for the
+                calibration inputs given to create, or if there are none, for a fixed set of pseudo-random inputs in
+                range [-1.0, 1.0]. The error is only as representative as those inputs are of the actual controls.
+            @param neuralNetIndex
+                The neural network whose accuracy is requested.
+            @warning
+                The index must be less than the value returned by getNeuralNetworkCount.
+            @return
+                The largest absolute difference of network outputs between float and quantized weights, measured at
+                the sample inputs, or zero if the weights are not quantized.
+        */
+        virtual float getNeuralNetworkQuantizationError(std::uint16_t neuralNetIndex) const = 0;
         /**
             @brief Number of RBF solvers for driving RBF behavior.
             @see calculateRBFBehavior
         */
         virtual std::uint16_t getRBFSolverCount() const = 0;
+        /**
+            @brief Accuracy of the reduced precision storage of the specified RBF solver.
+            @note
+                When half floats are used (the default, see Configuration::floatingPointType) and supported (by both
+                the build and the CPU), RBF solver targets and interpolation coefficients are stored as half floats,
+                unless their values exceed the half float range, or the conversion would change pose weights by more
+                than 1e-3.
+            @param solverIndex
+                The RBF solver whose accuracy is requested.
+            @warning
+                The index must be less than the value returned by getRBFSolverCount.
+            @return
+                The largest absolute difference in pose weights between full and half precision storage, measured at
+                a sample of the solver's targets, or zero if the solver stores its values as floats.
+        */
+        virtual float getRBFSolverHalfFloatError(std::uint16_t solverIndex) const = 0;
         /**
             @brief Number of meshes.
         */
@@ -250,6 +370,23 @@ class RLAPI RigLogic {
             @see calculate
         */
         virtual void calculateJoints(RigInstance* instance, std::uint16_t jointGroupIndex) const = 0;
+        /**
+            @brief Calculate individual joint work items.
+            @note
+                Like calculating individual joint groups, but better balanced across threads, as work items are of
+                roughly equal cost. Work items write disjoint outputs, so they may be calculated concurrently, and
+                calculating all of them is equivalent to calculating all joint groups.
+            @note
+                This is considered as an expert usage use case.
+            @param instance
+                The rig instance whose outputs are to be calculated.
+            @param workItemIndex
+                A work item's position in the zero-indexed array of joint work items of the instance's current LOD.
+            @warning
+                The index must be less than the value returned by getJointWorkItemCount for the instance's current LOD.
+            @see calculate
+        */
+        virtual void calculateJointWorkItem(RigInstance* instance, std::uint16_t workItemIndex) const = 0;
         /**
             @brief Calculate only the blend shape channel weights of the rig.
             @note
@@ -276,10 +413,128 @@ class RLAPI RigLogic {
                   - Calculate joint output values
                   - Calculate blend shape output values
                   - Calculate animated map output values
+            @note
+                If the instance was last evaluated by this function (or any other complete evaluation) on the same LOD,
+                only the PSDs, joint groups, blend shape channels and animated maps that depend on controls whose
+                values changed since then are recalculated. Neural networks and RBF solvers are still evaluated in full
+                whenever any raw control changed. Calling any of the partial calculation functions, changing the LOD or
+                a neural network mask causes the next evaluation to be a complete one.
             @param instance
                 The rig instance whose outputs are to be calculated.
         */
         virtual void calculate(RigInstance* instance) const = 0;
+        /**
+            @brief Calculate outputs for joints, blend shapes, and animated maps, distributing the work across an executor.
+            @note
+                Produces the same results as calculate, but independent parts of the evaluation are dispatched
+                as parallel tasks, respecting the dependencies between them:
+                  - Calculate machine learned behavior controls (one task per neural network)
+                  - Calculate RBF controls (one task per RBF solver)
+                  - Calculate input values (raw controls + PSDs)
+                  - Calculate joint output values (one task per joint work item, see getJointWorkItemCount),
+                    blend shape output values and animated map output values, all concurrently
+                  - Calculate joint outputs not partitioned into joint groups (twist and swing setups)
+            @note
+                RBF solvers whose controls overlap each other are calculated as a single task, in order.
+            @note
+                Joint work items have roughly equal estimated cost, as large joint groups are split into ranges of
+                rows and runs of small joint groups are merged, so the number of joint tasks does not depend on the
+                number of joint groups.
+            @param instance
+                The rig instance whose outputs are to be calculated.
+            @param executor
+                The executor that runs the parallel tasks. If null, the evaluation is single-threaded.
+            @warning
+                Only one thread at a time may evaluate the same rig instance.
+            @see Executor
+        */
+        virtual void calculate(RigInstance* instance, Executor* executor) const = 0;
+        /**
+            @brief Calculate only the input control values for a batch of rig instances.
+            @note
+                Equivalent to calling calculateControls for each instance separately, but the PSD
+                definitions are traversed only once for all instances that are on the same LOD.
+            @note
+                This is considered as an advanced usage use case.
+            @param instances
+                The rig instances whose outputs are to be calculated.
+            @param count
+                The number of rig instances in the batch.
+            @see calculate
+        */
+        virtual void calculateControls(RigInstance** instances, std::size_t count) const = 0;
+        /**
+            @brief Calculate only the joint outputs for a batch of rig instances.
+            @note
+                Equivalent to calling calculateJoints for each instance separately (within floating-point
+                rounding), but the joint matrices are streamed only once for all instances that are on the same LOD, while
+                being multiplied against the control values of several instances at once.
+            @note
+                This is considered as an advanced usage use case.
+            @param instances
+                The rig instances whose outputs are to be calculated.
+            @param count
+                The number of rig instances in the batch.
+            @see calculate
+        */
+        virtual void calculateJoints(RigInstance** instances, std::size_t count) const = 0;
+        /**
+            @brief Calculate only the machine learned behavior controls for a batch of rig instances.
+            @note
+                Equivalent to calling calculateMachineLearnedBehaviorControls for each instance separately
+                (within floating-point rounding), but each neural network is evaluated for up to 16 instances (that are on the same LOD) at once,
+                so the weights of each layer are streamed from memory only once for all of them.
+            @note
+                This is considered as an advanced usage use case.
+            @param instances
+                The rig instances whose outputs are to be calculated.
+            @param count
+                The number of rig instances in the batch.
+            @see calculate
+        */
+        virtual void calculateMachineLearnedBehaviorControls(RigInstance** instances, std::size_t count) const = 0;
+        /**
+            @brief Calculate only the blend shape channel weights for a batch of rig instances.
+            @note
+                This is considered as an advanced usage use case.
+            @param instances
+                The rig instances whose blend shape channel weights are to be calculated.
+            @param count
+                The number of rig instances in the batch.
+            @see calculate
+        */
+        virtual void calculateBlendShapes(RigInstance** instances, std::size_t count) const = 0;
+        /**
+            @brief Calculate only the animated map outputs for a batch of rig instances.
+            @note
+                This is considered as an advanced usage use case.
+            @param instances
+                The rig instances whose outputs are to be calculated.
+            @param count
+                The number of rig instances in the batch.
+            @see calculate
+        */
+        virtual void calculateAnimatedMaps(RigInstance** instances, std::size_t count) const = 0;
+        /**
+            @brief Calculate outputs for joints, blend shapes, and animated maps for a batch of rig instances.
+            @note
+                Produces the same results as calling calculate for each instance separately (within
+                floating-point rounding, as the batched kernels accumulate in a different order), but the
+                instances are grouped by their current LOD, and each group is evaluated in a single pass
+                over the rig data of each stage, which amortizes the memory traffic across the whole batch.
+            @note
+                RBF behavior controls are still evaluated for each instance separately.
+            @note
+                Temporary storage needed for the batch is allocated through the memory resource that was
+                used to create this RigLogic instance.
+            @param instances
+                The rig instances whose outputs are to be calculated.
+            @param count
+                The number of rig instances in the batch.
+            @warning
+                All instances must have been created from this RigLogic instance.
+        */
+        virtual void calculate(RigInstance** instances, std::size_t count) const = 0;
         /**
             @brief Collect stats that summarize the overall amount of data that participate in computation for the current LOD.
             @param instance
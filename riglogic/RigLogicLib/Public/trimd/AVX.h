@@ -4,12 +4,15 @@
 
 // *INDENT-OFF*
 #ifdef TRIMD_ENABLE_AVX
+#include "trimd/Macros.h"
 #include "trimd/Polyfill.h"
 
 #include <immintrin.h>
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 namespace avx {
 
 struct F256 {
@@ -334,8 +337,121 @@ inline F256 rsqrt(const F256& rhs) {
     #endif  // TRIMD_ENABLE_FAST_INVERSE_SQRT
 }
 
+inline F256 sqrt(const F256& rhs) {
+    return F256{_mm256_sqrt_ps(rhs.data)};
+}
+
+inline F256 round(const F256& rhs) {
+    return F256{_mm256_round_ps(rhs.data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+// 2^n, where each n must be a whole number in range [-126, 127]
+inline F256 pow2i(const F256& rhs) {
+    // Integer shifts are done on 128-bit halves, as 256-bit integer instructions require AVX2
+    const __m256i integral = _mm256_cvtps_epi32(rhs.data);
+    const __m128i bias = _mm_set1_epi32(127);
+    const __m128i lower = _mm_slli_epi32(_mm_add_epi32(_mm256_castsi256_si128(integral), bias), 23);
+    const __m128i upper = _mm_slli_epi32(_mm_add_epi32(_mm256_extractf128_si256(integral, 1), bias), 23);
+    return F256{_mm256_insertf128_ps(_mm256_castps128_ps256(_mm_castsi128_ps(lower)), _mm_castsi128_ps(upper), 1)};
+}
+
+inline F256 fmadd(const F256& lhs, const F256& rhs, const F256& addend) {
+    #ifdef TRIMD_ENABLE_FMA
+    return F256{_mm256_fmadd_ps(lhs.data, rhs.data, addend.data)};
+    #else
+    return F256{_mm256_add_ps(_mm256_mul_ps(lhs.data, rhs.data), addend.data)};
+    #endif  // TRIMD_ENABLE_FMA
+}
+
+inline F256 fnmadd(const F256& lhs, const F256& rhs, const F256& addend) {
+    #ifdef TRIMD_ENABLE_FMA
+    return F256{_mm256_fnmadd_ps(lhs.data, rhs.data, addend.data)};
+    #else
+    return F256{_mm256_sub_ps(addend.data, _mm256_mul_ps(lhs.data, rhs.data))};
+    #endif  // TRIMD_ENABLE_FMA
+}
+
+// Eight 32-bit integer lanes, used as accumulators of integer dot products
+struct I256 {
+    using value_type = std::int32_t;
+
+    __m256i data;
+
+    I256() : data{_mm256_setzero_si256()} {
+    }
+
+    explicit I256(__m256i value) : data{value} {
+    }
+
+    explicit I256(std::int32_t value) : I256{_mm256_set1_epi32(value)} {
+    }
+
+    I256(std::int32_t v1, std::int32_t v2, std::int32_t v3, std::int32_t v4, std::int32_t v5, std::int32_t v6,
+         std::int32_t v7, std::int32_t v8) : data{_mm256_set_epi32(v8, v7, v6, v5, v4, v3, v2, v1)} {
+    }
+
+    I256& operator+=(const I256& rhs) {
+        #ifdef TRIMD_ENABLE_AVX2
+        data = _mm256_add_epi32(data, rhs.data);
+        #else
+        const __m128i lower = _mm_add_epi32(_mm256_castsi256_si128(data), _mm256_castsi256_si128(rhs.data));
+        const __m128i upper = _mm_add_epi32(_mm256_extractf128_si256(data, 1), _mm256_extractf128_si256(rhs.data, 1));
+        data = _mm256_insertf128_si256(_mm256_castsi128_si256(lower), upper, 1);
+        #endif  // TRIMD_ENABLE_AVX2
+        return *this;
+    }
+
+    I256& operator-=(const I256& rhs) {
+        #ifdef TRIMD_ENABLE_AVX2
+        data = _mm256_sub_epi32(data, rhs.data);
+        #else
+        const __m128i lower = _mm_sub_epi32(_mm256_castsi256_si128(data), _mm256_castsi256_si128(rhs.data));
+        const __m128i upper = _mm_sub_epi32(_mm256_extractf128_si256(data, 1), _mm256_extractf128_si256(rhs.data, 1));
+        data = _mm256_insertf128_si256(_mm256_castsi128_si256(lower), upper, 1);
+        #endif  // TRIMD_ENABLE_AVX2
+        return *this;
+    }
+
+    static constexpr std::size_t size() {
+        return sizeof(decltype(data)) / sizeof(value_type);
+    }
+
+    static constexpr std::size_t alignment() {
+        return sizeof(decltype(data));
+    }
+
+};
+
+inline I256 operator+(const I256& lhs, const I256& rhs) {
+    return I256(lhs) += rhs;
+}
+
+inline I256 operator-(const I256& lhs, const I256& rhs) {
+    return I256(lhs) -= rhs;
+}
+
+// Sign extends eight pairs of adjacent 8-bit integers to 16 bits, multiplies each pair with the pair of 16-bit integers
+// held by every 32-bit lane of pairs (low half first), and adds up the two products of each lane (vpmaddwd)
+inline I256 madd8x2(const std::int8_t* source, const I256& pairs) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    #ifdef TRIMD_ENABLE_AVX2
+    return I256{_mm256_madd_epi16(_mm256_cvtepi8_epi16(bytes), pairs.data)};
+    #else
+    const __m128i lower = _mm_madd_epi16(_mm_cvtepi8_epi16(bytes), _mm256_castsi256_si128(pairs.data));
+    const __m128i upper = _mm_madd_epi16(_mm_cvtepi8_epi16(_mm_unpackhi_epi64(bytes, bytes)),
+                                         _mm256_extractf128_si256(pairs.data, 1));
+    return I256{_mm256_insertf128_si256(_mm256_castsi128_si256(lower), upper, 1)};
+    #endif  // TRIMD_ENABLE_AVX2
+}
+
+inline F256 toFloat(const I256& rhs) {
+    return F256{_mm256_cvtepi32_ps(rhs.data)};
+}
+
 } // namespace avx
 
+TRIMD_END_ISA_NAMESPACE
+
 } // namespace trimd
 
 #endif  // TRIMD_ENABLE_AVX
@@ -0,0 +1,408 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// *INDENT-OFF*
+#ifdef TRIMD_ENABLE_AVX512
+#include "trimd/Macros.h"
+#include "trimd/Polyfill.h"
+
+#include <immintrin.h>
+
+namespace trimd {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+namespace avx512 {
+
+namespace detail {
+
+// GCC implements many unmasked intrinsics on top of an uninitialized pass-through operand, and reports it
+// (-Wmaybe-uninitialized) wherever they get inlined, so their masked forms are used with a full mask instead
+constexpr __mmask16 fullMask = static_cast<__mmask16>(0xFFFFu);
+
+#ifdef TRIMD_ENABLE_F16C
+inline __m512 cvtph(__m256i halfs) {
+    return _mm512_mask_cvtph_ps(_mm512_setzero_ps(), fullMask, halfs);
+}
+
+inline __m256i cvtps(__m512 floats) {
+    #if defined(__clang__) || defined(__GNUC__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wold-style-cast"
+        #if !defined(__clang__)
+            #pragma GCC diagnostic ignored "-Wuseless-cast"
+        #endif
+    #endif
+    const __m256i halfs = _mm512_mask_cvtps_ph(_mm256_setzero_si256(), fullMask, floats,
+                                               _MM_FROUND_CUR_DIRECTION);
+    #if defined(__clang__) || defined(__GNUC__)
+        #pragma GCC diagnostic pop
+    #endif
+    return halfs;
+}
+#endif  // TRIMD_ENABLE_F16C
+
+}  // namespace detail
+
+struct F512 {
+    using value_type = float;
+
+    __m512 data;
+
+    F512() : data{_mm512_setzero_ps()} {
+    }
+
+    explicit F512(__m512 value) : data{value} {
+    }
+
+    explicit F512(float value) : F512{_mm512_set1_ps(value)} {
+    }
+
+    F512(float v1, float v2, float v3, float v4, float v5, float v6, float v7, float v8,
+         float v9, float v10, float v11, float v12, float v13, float v14, float v15, float v16) :
+        data{_mm512_set_ps(v16, v15, v14, v13, v12, v11, v10, v9, v8, v7, v6, v5, v4, v3, v2, v1)} {
+    }
+
+    static F512 fromAlignedSource(const float* source) {
+        return F512{_mm512_load_ps(source)};
+    }
+
+    static F512 fromUnalignedSource(const float* source) {
+        return F512{_mm512_loadu_ps(source)};
+    }
+
+    static F512 loadSingleValue(const float* source) {
+        return F512{_mm512_maskz_loadu_ps(static_cast<__mmask16>(1u), source)};
+    }
+
+    #ifdef TRIMD_ENABLE_F16C
+        static F512 fromAlignedSource(const std::uint16_t* source) {
+            return F512{detail::cvtph(_mm256_load_si256(reinterpret_cast<const __m256i*>(source)))};
+        }
+
+        static F512 fromUnalignedSource(const std::uint16_t* source) {
+            return F512{detail::cvtph(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)))};
+        }
+
+        static F512 loadSingleValue(const std::uint16_t* source) {
+            return F512{detail::cvtph(_mm256_inserti128_si256(_mm256_setzero_si256(), _mm_loadu_si16(source), 0))};
+        }
+
+    #endif  // TRIMD_ENABLE_F16C
+
+    template<typename T>
+    static void prefetchT0(const T* source) {
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wold-style-cast"
+        #endif
+        _mm_prefetch(reinterpret_cast<const char*>(source), _MM_HINT_T0);
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic pop
+        #endif
+    }
+
+    template<typename T>
+    static void prefetchT1(const T* source) {
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wold-style-cast"
+        #endif
+        _mm_prefetch(reinterpret_cast<const char*>(source), _MM_HINT_T1);
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic pop
+        #endif
+    }
+
+    template<typename T>
+    static void prefetchT2(const T* source) {
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wold-style-cast"
+        #endif
+        _mm_prefetch(reinterpret_cast<const char*>(source), _MM_HINT_T2);
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic pop
+        #endif
+    }
+
+    template<typename T>
+    static void prefetchNTA(const T* source) {
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Wold-style-cast"
+        #endif
+        _mm_prefetch(reinterpret_cast<const char*>(source), _MM_HINT_NTA);
+        #if defined(__clang__) || defined(__GNUC__)
+            #pragma GCC diagnostic pop
+        #endif
+    }
+
+    void alignedLoad(const float* source) {
+        data = _mm512_load_ps(source);
+    }
+
+    void unalignedLoad(const float* source) {
+        data = _mm512_loadu_ps(source);
+    }
+
+    void alignedStore(float* dest) const {
+        _mm512_store_ps(dest, data);
+    }
+
+    void unalignedStore(float* dest) const {
+        _mm512_storeu_ps(dest, data);
+    }
+
+    #ifdef TRIMD_ENABLE_F16C
+    void alignedLoad(const std::uint16_t* source) {
+        data = detail::cvtph(_mm256_load_si256(reinterpret_cast<const __m256i*>(source)));
+    }
+
+    void unalignedLoad(const std::uint16_t* source) {
+        data = detail::cvtph(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)));
+    }
+
+    void alignedStore(std::uint16_t* dest) const {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dest), detail::cvtps(data));
+    }
+
+    void unalignedStore(std::uint16_t* dest) const {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), detail::cvtps(data));
+    }
+    #endif  // TRIMD_ENABLE_F16C
+
+    float sum() const {
+        return _mm512_reduce_add_ps(data);
+    }
+
+    F512& operator+=(const F512& rhs) {
+        data = _mm512_add_ps(data, rhs.data);
+        return *this;
+    }
+
+    F512& operator-=(const F512& rhs) {
+        data = _mm512_sub_ps(data, rhs.data);
+        return *this;
+    }
+
+    F512& operator*=(const F512& rhs) {
+        data = _mm512_mul_ps(data, rhs.data);
+        return *this;
+    }
+
+    F512& operator/=(const F512& rhs) {
+        data = _mm512_div_ps(data, rhs.data);
+        return *this;
+    }
+
+    // Bitwise operations on floats require AVX-512DQ, so the integer variants from AVX-512F are used instead
+    F512& operator&=(const F512& rhs) {
+        data = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(data), _mm512_castps_si512(rhs.data)));
+        return *this;
+    }
+
+    F512& operator|=(const F512& rhs) {
+        data = _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(data), _mm512_castps_si512(rhs.data)));
+        return *this;
+    }
+
+    F512& operator^=(const F512& rhs) {
+        data = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(data), _mm512_castps_si512(rhs.data)));
+        return *this;
+    }
+
+    static constexpr std::size_t size() {
+        return sizeof(decltype(data)) / sizeof(float);
+    }
+
+    static constexpr std::size_t alignment() {
+        return alignof(decltype(data));
+    }
+
+};
+
+// Comparisons produce a mask register, which is expanded into all 1s / all 0s lanes, the same as with SSE and AVX
+inline F512 fromMask(__mmask16 mask) {
+    return F512{_mm512_castsi512_ps(_mm512_maskz_set1_epi32(mask, -1))};
+}
+
+inline F512 operator==(const F512& lhs, const F512& rhs) {
+    return fromMask(_mm512_cmp_ps_mask(lhs.data, rhs.data, _CMP_EQ_OQ));
+}
+
+inline F512 operator!=(const F512& lhs, const F512& rhs) {
+    return fromMask(_mm512_cmp_ps_mask(lhs.data, rhs.data, _CMP_NEQ_OQ));
+}
+
+inline F512 operator<(const F512& lhs, const F512& rhs) {
+    return fromMask(_mm512_cmp_ps_mask(lhs.data, rhs.data, _CMP_LT_OQ));
+}
+
+inline F512 operator<=(const F512& lhs, const F512& rhs) {
+    return fromMask(_mm512_cmp_ps_mask(lhs.data, rhs.data, _CMP_LE_OQ));
+}
+
+inline F512 operator>(const F512& lhs, const F512& rhs) {
+    return fromMask(_mm512_cmp_ps_mask(lhs.data, rhs.data, _CMP_GT_OQ));
+}
+
+inline F512 operator>=(const F512& lhs, const F512& rhs) {
+    return fromMask(_mm512_cmp_ps_mask(lhs.data, rhs.data, _CMP_GE_OQ));
+}
+
+inline F512 operator+(const F512& lhs, const F512& rhs) {
+    return F512(lhs) += rhs;
+}
+
+inline F512 operator-(const F512& lhs, const F512& rhs) {
+    return F512(lhs) -= rhs;
+}
+
+inline F512 operator*(const F512& lhs, const F512& rhs) {
+    return F512(lhs) *= rhs;
+}
+
+inline F512 operator/(const F512& lhs, const F512& rhs) {
+    return F512(lhs) /= rhs;
+}
+
+inline F512 operator&(const F512& lhs, const F512& rhs) {
+    return F512(lhs) &= rhs;
+}
+
+inline F512 operator|(const F512& lhs, const F512& rhs) {
+    return F512(lhs) |= rhs;
+}
+
+inline F512 operator^(const F512& lhs, const F512& rhs) {
+    return F512(lhs) ^= rhs;
+}
+
+inline F512 operator~(const F512& rhs) {
+    return F512{_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(rhs.data), _mm512_set1_epi32(-1)))};
+}
+
+inline void transpose(F512& row0, F512& row1, F512& row2, F512& row3, F512& row4, F512& row5, F512& row6, F512& row7,
+                      F512& row8, F512& row9, F512& row10, F512& row11, F512& row12, F512& row13, F512& row14, F512& row15) {
+    // Transpose 4x4 blocks within each 128-bit lane
+    __m512 t0 = _mm512_maskz_unpacklo_ps(detail::fullMask, row0.data, row1.data);
+    __m512 t1 = _mm512_maskz_unpackhi_ps(detail::fullMask, row0.data, row1.data);
+    __m512 t2 = _mm512_maskz_unpacklo_ps(detail::fullMask, row2.data, row3.data);
+    __m512 t3 = _mm512_maskz_unpackhi_ps(detail::fullMask, row2.data, row3.data);
+    __m512 t4 = _mm512_maskz_unpacklo_ps(detail::fullMask, row4.data, row5.data);
+    __m512 t5 = _mm512_maskz_unpackhi_ps(detail::fullMask, row4.data, row5.data);
+    __m512 t6 = _mm512_maskz_unpacklo_ps(detail::fullMask, row6.data, row7.data);
+    __m512 t7 = _mm512_maskz_unpackhi_ps(detail::fullMask, row6.data, row7.data);
+    __m512 t8 = _mm512_maskz_unpacklo_ps(detail::fullMask, row8.data, row9.data);
+    __m512 t9 = _mm512_maskz_unpackhi_ps(detail::fullMask, row8.data, row9.data);
+    __m512 t10 = _mm512_maskz_unpacklo_ps(detail::fullMask, row10.data, row11.data);
+    __m512 t11 = _mm512_maskz_unpackhi_ps(detail::fullMask, row10.data, row11.data);
+    __m512 t12 = _mm512_maskz_unpacklo_ps(detail::fullMask, row12.data, row13.data);
+    __m512 t13 = _mm512_maskz_unpackhi_ps(detail::fullMask, row12.data, row13.data);
+    __m512 t14 = _mm512_maskz_unpacklo_ps(detail::fullMask, row14.data, row15.data);
+    __m512 t15 = _mm512_maskz_unpackhi_ps(detail::fullMask, row14.data, row15.data);
+    __m512 tt0 = _mm512_maskz_shuffle_ps(detail::fullMask, t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt1 = _mm512_maskz_shuffle_ps(detail::fullMask, t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt2 = _mm512_maskz_shuffle_ps(detail::fullMask, t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt3 = _mm512_maskz_shuffle_ps(detail::fullMask, t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt4 = _mm512_maskz_shuffle_ps(detail::fullMask, t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt5 = _mm512_maskz_shuffle_ps(detail::fullMask, t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt6 = _mm512_maskz_shuffle_ps(detail::fullMask, t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt7 = _mm512_maskz_shuffle_ps(detail::fullMask, t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt8 = _mm512_maskz_shuffle_ps(detail::fullMask, t8, t10, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt9 = _mm512_maskz_shuffle_ps(detail::fullMask, t8, t10, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt10 = _mm512_maskz_shuffle_ps(detail::fullMask, t9, t11, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt11 = _mm512_maskz_shuffle_ps(detail::fullMask, t9, t11, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt12 = _mm512_maskz_shuffle_ps(detail::fullMask, t12, t14, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt13 = _mm512_maskz_shuffle_ps(detail::fullMask, t12, t14, _MM_SHUFFLE(3, 2, 3, 2));
+    __m512 tt14 = _mm512_maskz_shuffle_ps(detail::fullMask, t13, t15, _MM_SHUFFLE(1, 0, 1, 0));
+    __m512 tt15 = _mm512_maskz_shuffle_ps(detail::fullMask, t13, t15, _MM_SHUFFLE(3, 2, 3, 2));
+    // Transpose the 4x4 grid of 128-bit lanes
+    const __m512 l0 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt0, tt4, 0x88);
+    const __m512 l1 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt1, tt5, 0x88);
+    const __m512 l2 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt2, tt6, 0x88);
+    const __m512 l3 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt3, tt7, 0x88);
+    const __m512 l4 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt0, tt4, 0xDD);
+    const __m512 l5 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt1, tt5, 0xDD);
+    const __m512 l6 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt2, tt6, 0xDD);
+    const __m512 l7 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt3, tt7, 0xDD);
+    const __m512 l8 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt8, tt12, 0x88);
+    const __m512 l9 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt9, tt13, 0x88);
+    const __m512 l10 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt10, tt14, 0x88);
+    const __m512 l11 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt11, tt15, 0x88);
+    const __m512 l12 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt8, tt12, 0xDD);
+    const __m512 l13 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt9, tt13, 0xDD);
+    const __m512 l14 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt10, tt14, 0xDD);
+    const __m512 l15 = _mm512_maskz_shuffle_f32x4(detail::fullMask, tt11, tt15, 0xDD);
+    row0.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l0, l8, 0x88);
+    row1.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l1, l9, 0x88);
+    row2.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l2, l10, 0x88);
+    row3.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l3, l11, 0x88);
+    row4.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l4, l12, 0x88);
+    row5.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l5, l13, 0x88);
+    row6.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l6, l14, 0x88);
+    row7.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l7, l15, 0x88);
+    row8.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l0, l8, 0xDD);
+    row9.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l1, l9, 0xDD);
+    row10.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l2, l10, 0xDD);
+    row11.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l3, l11, 0xDD);
+    row12.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l4, l12, 0xDD);
+    row13.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l5, l13, 0xDD);
+    row14.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l6, l14, 0xDD);
+    row15.data = _mm512_maskz_shuffle_f32x4(detail::fullMask, l7, l15, 0xDD);
+}
+
+inline F512 abs(const F512& rhs) {
+    return F512{_mm512_abs_ps(rhs.data)};
+}
+
+inline F512 andnot(const F512& lhs, const F512& rhs) {
+    const __m512i result = _mm512_maskz_andnot_epi32(detail::fullMask,
+                                                     _mm512_castps_si512(lhs.data),
+                                                     _mm512_castps_si512(rhs.data));
+    return F512{_mm512_castsi512_ps(result)};
+}
+
+inline F512 rsqrt(const F512& rhs) {
+    #ifndef TRIMD_ENABLE_FAST_INVERSE_SQRT
+    return F512{_mm512_maskz_rsqrt14_ps(detail::fullMask, rhs.data)};
+    #else
+    const __m512i shifted = _mm512_maskz_srli_epi32(detail::fullMask, _mm512_castps_si512(rhs.data), 1);
+    const __m512i subtracted = _mm512_sub_epi32(_mm512_set1_epi32(0x5f1ffff9), shifted);
+    F512 result{_mm512_castsi512_ps(subtracted)};
+    result *= F512{0.703952253f} * (F512{2.38924456f} - rhs * result * result);
+    return result;
+    #endif  // TRIMD_ENABLE_FAST_INVERSE_SQRT
+}
+
+inline F512 sqrt(const F512& rhs) {
+    return F512{_mm512_maskz_sqrt_ps(detail::fullMask, rhs.data)};
+}
+
+inline F512 round(const F512& rhs) {
+    return F512{_mm512_maskz_roundscale_ps(detail::fullMask, rhs.data, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+// 2^n, where each n must be a whole number in range [-126, 127]
+inline F512 pow2i(const F512& rhs) {
+    return F512{_mm512_maskz_scalef_ps(detail::fullMask, _mm512_set1_ps(1.0f), rhs.data)};
+}
+
+inline F512 fmadd(const F512& lhs, const F512& rhs, const F512& addend) {
+    return F512{_mm512_fmadd_ps(lhs.data, rhs.data, addend.data)};
+}
+
+inline F512 fnmadd(const F512& lhs, const F512& rhs, const F512& addend) {
+    return F512{_mm512_fnmadd_ps(lhs.data, rhs.data, addend.data)};
+}
+
+} // namespace avx512
+
+TRIMD_END_ISA_NAMESPACE
+
+} // namespace trimd
+
+#endif  // TRIMD_ENABLE_AVX512
+// *INDENT-ON*
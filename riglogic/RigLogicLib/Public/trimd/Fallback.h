@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include "trimd/Macros.h"
+
 #ifdef _MSC_VER
     #pragma warning(push)
     #pragma warning(disable : 4365 4987)
 #endif
+#include <cstdint>
 #include <utility>
 #ifdef _MSC_VER
     #pragma warning(pop)
@@ -13,6 +16,8 @@
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 namespace fallback {
 
 template<typename T128>
@@ -252,6 +257,43 @@ inline T256<T128> rsqrt(const T256<T128>& rhs) {
     return T256<T128>{rsqrt(rhs.data1), rsqrt(rhs.data2)};
 }
 
+template<typename T128>
+inline T256<T128> sqrt(const T256<T128>& rhs) {
+    return T256<T128>{sqrt(rhs.data1), sqrt(rhs.data2)};
+}
+
+template<typename T128>
+inline T256<T128> round(const T256<T128>& rhs) {
+    return T256<T128>{round(rhs.data1), round(rhs.data2)};
+}
+
+template<typename T128>
+inline T256<T128> pow2i(const T256<T128>& rhs) {
+    return T256<T128>{pow2i(rhs.data1), pow2i(rhs.data2)};
+}
+
+template<typename T128>
+inline T256<T128> fmadd(const T256<T128>& lhs, const T256<T128>& rhs, const T256<T128>& addend) {
+    return T256<T128>{fmadd(lhs.data1, rhs.data1, addend.data1), fmadd(lhs.data2, rhs.data2, addend.data2)};
+}
+
+template<typename T128>
+inline T256<T128> fnmadd(const T256<T128>& lhs, const T256<T128>& rhs, const T256<T128>& addend) {
+    return T256<T128>{fnmadd(lhs.data1, rhs.data1, addend.data1), fnmadd(lhs.data2, rhs.data2, addend.data2)};
+}
+
+template<typename T128>
+inline T256<T128> madd8x2(const std::int8_t* source, const T256<T128>& pairs) {
+    return T256<T128>{madd8x2(source, pairs.data1), madd8x2(source + T128::size() * 2ul, pairs.data2)};
+}
+
+template<typename T128>
+inline auto toFloat(const T256<T128>& rhs) -> T256<decltype(toFloat(rhs.data1))> {
+    return T256<decltype(toFloat(rhs.data1))>{toFloat(rhs.data1), toFloat(rhs.data2)};
+}
+
 }  // namespace fallback
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace trimd
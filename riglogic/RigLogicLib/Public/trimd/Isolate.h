@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// Included before anything else by translation units that contain code for wider instruction sets than the rest of the
+// program, with one of these defined to select them:
+//   TRIMD_ISOLATE_AVX2   - AVX2, FMA and F16C
+//   TRIMD_ISOLATE_AVX512 - AVX-512F, AVX2, FMA and F16C
+// Such a translation unit is compiled with the same code generation flags as the rest of the program, and only trimd, and
+// the kernels declared between TRIMD_BEGIN_ISA_NAMESPACE and TRIMD_END_ISA_NAMESPACE, are compiled for the selected
+// instruction sets. Everything else (the standard library, containers, implicitly declared member functions) stays on the
+// baseline, because its inline functions and template instantiations are deduplicated by the linker with those of the
+// other translation units, so any of the copies may end up being used. Selecting them with code generation flags instead
+// would not keep them apart, as GCC compiles implicitly declared member functions for the flags of the command line.
+// Compilers that accept the intrinsics without code generation flags (MSVC) do not need it, and others that cannot switch
+// targets within a translation unit (Clang) must be given the same flags for all translation units.
+#if defined(__GNUC__) && !defined(__clang__) && !defined(TRIMD_ISOLATE_TARGET)
+    #if defined(TRIMD_ISOLATE_AVX512)
+        #define TRIMD_ISOLATE_TARGET _Pragma("GCC target(\"avx512f,avx2,fma,f16c\")")
+        #define TRIMD_TARGET_AVX512F
+    #elif defined(TRIMD_ISOLATE_AVX2)
+        #define TRIMD_ISOLATE_TARGET _Pragma("GCC target(\"avx2,fma,f16c\")")
+    #endif
+    #if defined(TRIMD_ISOLATE_TARGET)
+        #define TRIMD_TARGET_SSE3
+        #define TRIMD_TARGET_SSSE3
+        #define TRIMD_TARGET_SSE41
+        #define TRIMD_TARGET_SSE42
+        #define TRIMD_TARGET_AVX
+        #define TRIMD_TARGET_AVX2
+        #define TRIMD_TARGET_FMA
+        #define TRIMD_TARGET_F16C
+    #endif
+#endif
+
+#include "trimd/Macros.h"
@@ -9,3 +9,103 @@
         #define FORCE_INLINE inline __attribute__((always_inline))
     #endif
 #endif
+
+// Instruction sets that the code in the ISA namespace (see below) is compiled for, enabled either by the code generation
+// flags or by the selection of trimd/Isolate.h
+#if defined(__SSE3__) && !defined(TRIMD_TARGET_SSE3)
+    #define TRIMD_TARGET_SSE3
+#endif
+#if defined(__SSSE3__) && !defined(TRIMD_TARGET_SSSE3)
+    #define TRIMD_TARGET_SSSE3
+#endif
+#if defined(__SSE4_1__) && !defined(TRIMD_TARGET_SSE41)
+    #define TRIMD_TARGET_SSE41
+#endif
+#if defined(__SSE4_2__) && !defined(TRIMD_TARGET_SSE42)
+    #define TRIMD_TARGET_SSE42
+#endif
+#if defined(__AVX__) && !defined(TRIMD_TARGET_AVX)
+    #define TRIMD_TARGET_AVX
+#endif
+#if defined(__AVX2__) && !defined(TRIMD_TARGET_AVX2)
+    #define TRIMD_TARGET_AVX2
+#endif
+#if defined(__FMA__) && !defined(TRIMD_TARGET_FMA)
+    #define TRIMD_TARGET_FMA
+#endif
+#if defined(__F16C__) && !defined(TRIMD_TARGET_F16C)
+    #define TRIMD_TARGET_F16C
+#endif
+#if defined(__AVX512F__) && !defined(TRIMD_TARGET_AVX512F)
+    #define TRIMD_TARGET_AVX512F
+#endif
+
+// Everything in trimd is declared in an inline namespace named after the instruction sets that it is compiled for, so
+// translation units compiled for different instruction sets never share an inline function or a template instantiation
+// (which the linker would deduplicate, keeping an arbitrary one of the copies).
+// Kernels instantiated over trimd types may be declared in the same namespace (see TRIMD_BEGIN_ISA_NAMESPACE).
+#if defined(TRIMD_TARGET_SSE3)
+    #define TRIMD_ISA_TAG_SSE3 _sse3
+#else
+    #define TRIMD_ISA_TAG_SSE3
+#endif
+#if defined(TRIMD_TARGET_SSSE3)
+    #define TRIMD_ISA_TAG_SSSE3 _ssse3
+#else
+    #define TRIMD_ISA_TAG_SSSE3
+#endif
+#if defined(TRIMD_TARGET_SSE41)
+    #define TRIMD_ISA_TAG_SSE41 _sse41
+#else
+    #define TRIMD_ISA_TAG_SSE41
+#endif
+#if defined(TRIMD_TARGET_SSE42)
+    #define TRIMD_ISA_TAG_SSE42 _sse42
+#else
+    #define TRIMD_ISA_TAG_SSE42
+#endif
+#if defined(TRIMD_TARGET_AVX)
+    #define TRIMD_ISA_TAG_AVX _avx
+#else
+    #define TRIMD_ISA_TAG_AVX
+#endif
+#if defined(TRIMD_TARGET_AVX2)
+    #define TRIMD_ISA_TAG_AVX2 _avx2
+#else
+    #define TRIMD_ISA_TAG_AVX2
+#endif
+#if defined(TRIMD_TARGET_FMA)
+    #define TRIMD_ISA_TAG_FMA _fma
+#else
+    #define TRIMD_ISA_TAG_FMA
+#endif
+#if defined(TRIMD_TARGET_F16C)
+    #define TRIMD_ISA_TAG_F16C _f16c
+#else
+    #define TRIMD_ISA_TAG_F16C
+#endif
+#if defined(TRIMD_TARGET_AVX512F)
+    #define TRIMD_ISA_TAG_AVX512F _avx512f
+#else
+    #define TRIMD_ISA_TAG_AVX512F
+#endif
+
+#define TRIMD_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define TRIMD_CONCAT(lhs, rhs) TRIMD_CONCAT_IMPL(lhs, rhs)
+
+#if !defined(TRIMD_ISA_NAMESPACE)
+    #define TRIMD_ISA_NAMESPACE \
+        TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT(TRIMD_CONCAT( \
+            isa, TRIMD_ISA_TAG_SSE3), TRIMD_ISA_TAG_SSSE3), TRIMD_ISA_TAG_SSE41), TRIMD_ISA_TAG_SSE42), TRIMD_ISA_TAG_AVX), \
+            TRIMD_ISA_TAG_AVX2), TRIMD_ISA_TAG_FMA), TRIMD_ISA_TAG_F16C), TRIMD_ISA_TAG_AVX512F)
+#endif
+
+// Only the code between these is compiled for the instruction sets selected by trimd/Isolate.h (if the translation unit
+// selects any), everything else for those of the code generation flags
+#if defined(TRIMD_ISOLATE_TARGET)
+    #define TRIMD_BEGIN_ISA_NAMESPACE _Pragma("GCC push_options") TRIMD_ISOLATE_TARGET inline namespace TRIMD_ISA_NAMESPACE {
+    #define TRIMD_END_ISA_NAMESPACE } _Pragma("GCC pop_options")
+#else
+    #define TRIMD_BEGIN_ISA_NAMESPACE inline namespace TRIMD_ISA_NAMESPACE {
+    #define TRIMD_END_ISA_NAMESPACE }
+#endif
@@ -0,0 +1,191 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+// *INDENT-OFF*
+// Vectorized approximations of transcendental functions, written only in terms of the operations every
+// trimd type provides, so the same code serves F128, F256 and F512 on all backends.
+// This header is included by TRiMD.h after the per-instruction set function imports.
+
+#include "trimd/Macros.h"
+
+namespace trimd {
+
+TRIMD_BEGIN_ISA_NAMESPACE
+
+namespace detail {
+
+template<typename TFVec>
+inline TFVec clampAbove(const TFVec& value, const TFVec& limit) {
+    const TFVec mask = (value > limit);
+    return andnot(mask, value) | (limit & mask);
+}
+
+template<typename TFVec>
+inline TFVec clampBelow(const TFVec& value, const TFVec& limit) {
+    const TFVec mask = (value < limit);
+    return andnot(mask, value) | (limit & mask);
+}
+
+}  // namespace detail
+
+// Odd [13/6] rational minimax approximation, x * P(x^2) / Q(x^2), with |x| clamped to the point where it
+// saturates to 1.0f. Max absolute (and relative) error is below 3.3e-7 over the entire float range.
+template<typename TFVec>
+inline TFVec tanh(const TFVec& x) {
+    const TFVec absX = abs(x);
+    const TFVec sign = x ^ absX;
+    const TFVec xc = detail::clampAbove(absX, TFVec{7.99881172180175781f});
+    const TFVec x2 = xc * xc;
+
+    TFVec p = fmadd(x2, TFVec{-2.76076847742355e-16f}, TFVec{2.00018790482477e-13f});
+    p = fmadd(p, x2, TFVec{-8.60467152213735e-11f});
+    p = fmadd(p, x2, TFVec{5.12229709037114e-08f});
+    p = fmadd(p, x2, TFVec{1.48572235717979e-05f});
+    p = fmadd(p, x2, TFVec{6.37261928875436e-04f});
+    p = fmadd(p, x2, TFVec{4.89352455891786e-03f});
+    p = p * xc;
+
+    TFVec q = fmadd(x2, TFVec{1.19825839466702e-06f}, TFVec{1.18534705686654e-04f});
+    q = fmadd(q, x2, TFVec{2.26843463243900e-03f});
+    q = fmadd(q, x2, TFVec{4.89352518554385e-03f});
+
+    return (p / q) ^ sign;
+}
+
+// Odd [7/6] Pade approximant, with |x| clamped to the point where it reaches 1.0f.
+// Max absolute error is ~7.1e-5, trading accuracy for fewer multiply-adds than the above.
+template<typename TFVec>
+inline TFVec fastTanh(const TFVec& x) {
+    const TFVec absX = abs(x);
+    const TFVec sign = x ^ absX;
+    const TFVec xc = detail::clampAbove(absX, TFVec{4.785f});
+    const TFVec x2 = xc * xc;
+
+    TFVec p = x2 + TFVec{378.0f};
+    p = fmadd(p, x2, TFVec{17325.0f});
+    p = fmadd(p, x2, TFVec{135135.0f});
+    p = p * xc;
+
+    TFVec q = fmadd(x2, TFVec{28.0f}, TFVec{3150.0f});
+    q = fmadd(q, x2, TFVec{62370.0f});
+    q = fmadd(q, x2, TFVec{135135.0f});
+
+    return (p / q) ^ sign;
+}
+
+// sigmoid(x) = 0.5 + 0.5 * tanh(0.5 * x), so the absolute error bounds are half of the respective tanh variant
+template<typename TFVec>
+inline TFVec sigmoid(const TFVec& x) {
+    const TFVec half{0.5f};
+    return fmadd(half, tanh(x * half), half);
+}
+
+template<typename TFVec>
+inline TFVec fastSigmoid(const TFVec& x) {
+    const TFVec half{0.5f};
+    return fmadd(half, fastTanh(x * half), half);
+}
+
+// Cephes-style range reduction x = n * ln(2) + r, |r| <= ln(2) / 2, with a degree 7 polynomial for e^r.
+// Inputs are clamped to [-87, 88], so the result is always a normal float, with max relative error below 2e-7.
+template<typename TFVec>
+inline TFVec exp(const TFVec& x) {
+    const TFVec xc = detail::clampBelow(detail::clampAbove(x, TFVec{88.0f}), TFVec{-87.0f});
+    const TFVec n = round(xc * TFVec{1.44269504088896341f});
+    TFVec r = fnmadd(n, TFVec{0.693359375f}, xc);
+    r = fnmadd(n, TFVec{-2.12194440e-4f}, r);
+
+    TFVec p = fmadd(r, TFVec{1.9875691500e-4f}, TFVec{1.3981999507e-3f});
+    p = fmadd(p, r, TFVec{8.3334519073e-3f});
+    p = fmadd(p, r, TFVec{4.1665795894e-2f});
+    p = fmadd(p, r, TFVec{1.6666665459e-1f});
+    p = fmadd(p, r, TFVec{5.0000001201e-1f});
+    p = fmadd(p * r, r, r + TFVec{1.0f});
+
+    return p * pow2i(n);
+}
+
+// acos(|x|) = sqrt(1 - |x|) * P(|x|) (Abramowitz & Stegun 4.4.46), mirrored as pi - acos(|x|) for negative inputs.
+// Inputs are clamped to [-1, 1], max absolute error is below 5e-7.
+template<typename TFVec>
+inline TFVec acos(const TFVec& x) {
+    const TFVec absX = detail::clampAbove(abs(x), TFVec{1.0f});
+
+    TFVec p = fmadd(absX, TFVec{-0.0012624911f}, TFVec{0.0066700901f});
+    p = fmadd(p, absX, TFVec{-0.0170881256f});
+    p = fmadd(p, absX, TFVec{0.0308918810f});
+    p = fmadd(p, absX, TFVec{-0.0501743046f});
+    p = fmadd(p, absX, TFVec{0.0889789874f});
+    p = fmadd(p, absX, TFVec{-0.2145988016f});
+    p = fmadd(p, absX, TFVec{1.5707963050f});
+    p = p * sqrt(TFVec{1.0f} - absX);
+
+    const TFVec negative = (x < TFVec{});
+    return andnot(negative, p) | ((TFVec{3.14159265358979323f} - p) & negative);
+}
+
+namespace detail {
+
+// Range reduction x = n * pi + r, |r| <= pi / 2, with pi split into three parts, so r stays exact for |x| up to ~1e4.
+// Returns r, and sets sign to the sign bit by which sin(r) and cos(r) need to be flipped (for odd n).
+template<typename TFVec>
+inline TFVec reduceByPi(const TFVec& x, TFVec& sign) {
+    const TFVec n = round(x * TFVec{0.318309886183790672f});
+    TFVec r = fnmadd(n, TFVec{3.140625f}, x);
+    r = fnmadd(n, TFVec{9.67502593994140625e-4f}, r);
+    r = fnmadd(n, TFVec{1.509957990978376432e-7f}, r);
+    const TFVec odd = (fnmadd(round(n * TFVec{0.5f}), TFVec{2.0f}, n) != TFVec{});
+    sign = TFVec{-0.0f} & odd;
+    return r;
+}
+
+// Odd degree 13 Taylor polynomial of sin(r), for |r| <= pi / 2
+template<typename TFVec>
+inline TFVec sinPolynomial(const TFVec& r, const TFVec& r2) {
+    TFVec p = fmadd(r2, TFVec{1.6059043836821613e-10f}, TFVec{-2.5052108385441720e-8f});
+    p = fmadd(p, r2, TFVec{2.7557319223985891e-6f});
+    p = fmadd(p, r2, TFVec{-1.9841269841269841e-4f});
+    p = fmadd(p, r2, TFVec{8.3333333333333333e-3f});
+    p = fmadd(p, r2, TFVec{-1.6666666666666667e-1f});
+    return fmadd(p * r2, r, r);
+}
+
+// Even degree 14 Taylor polynomial of cos(r), for |r| <= pi / 2
+template<typename TFVec>
+inline TFVec cosPolynomial(const TFVec& r2) {
+    TFVec p = fmadd(r2, TFVec{-1.1470745597729725e-11f}, TFVec{2.0876756987868099e-9f});
+    p = fmadd(p, r2, TFVec{-2.7557319223985891e-7f});
+    p = fmadd(p, r2, TFVec{2.4801587301587302e-5f});
+    p = fmadd(p, r2, TFVec{-1.3888888888888889e-3f});
+    p = fmadd(p, r2, TFVec{4.1666666666666667e-2f});
+    p = fmadd(p, r2, TFVec{-0.5f});
+    return fmadd(p, r2, TFVec{1.0f});
+}
+
+}  // namespace detail
+
+// sin(n * pi + r) = (-1)^n * sin(r), with sin(r) approximated by a polynomial.
+// Max absolute error is below 2e-7 for |x| up to ~1e4 (where the range reduction stays exact).
+template<typename TFVec>
+inline TFVec sin(const TFVec& x) {
+    TFVec sign;
+    const TFVec r = detail::reduceByPi(x, sign);
+    return detail::sinPolynomial(r, r * r) ^ sign;
+}
+
+// Both sine and cosine from a single range reduction, as cos(n * pi + r) = (-1)^n * cos(r) as well.
+// Max absolute error is below 2e-7 for both, in the same range as sin.
+template<typename TFVec>
+inline void sincos(const TFVec& x, TFVec& sinX, TFVec& cosX) {
+    TFVec sign;
+    const TFVec r = detail::reduceByPi(x, sign);
+    const TFVec r2 = r * r;
+    sinX = detail::sinPolynomial(r, r2) ^ sign;
+    cosX = detail::cosPolynomial(r2) ^ sign;
+}
+
+TRIMD_END_ISA_NAMESPACE
+
+}  // namespace trimd
+// *INDENT-ON*
@@ -4,6 +4,7 @@
 
 // *INDENT-OFF*
 #ifdef TRIMD_ENABLE_NEON
+#include "trimd/Macros.h"
 #include "trimd/Fallback.h"
 
 #include <arm_neon.h>
@@ -12,6 +13,8 @@
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 namespace neon {
 
 struct F128 {
@@ -262,14 +265,68 @@ inline F128 rsqrt(const F128& rhs) {
     #endif  // TRIMD_ENABLE_FAST_INVERSE_SQRT
 }
 
+inline F128 sqrt(const F128& rhs) {
+    #if defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM64EC)
+    return F128{vsqrtq_f32(rhs.data)};
+    #else
+    // x * rsqrt(x) refined by two Newton-Raphson steps, with zero inputs (where rsqrt is infinite) passed through
+    float32x4_t reciprocal = vrsqrteq_f32(rhs.data);
+    reciprocal = vmulq_f32(vrsqrtsq_f32(vmulq_f32(reciprocal, reciprocal), rhs.data), reciprocal);
+    reciprocal = vmulq_f32(vrsqrtsq_f32(vmulq_f32(reciprocal, reciprocal), rhs.data), reciprocal);
+    const uint32x4_t isZero = vceqq_f32(rhs.data, vdupq_n_f32(0.0f));
+    return F128{vbslq_f32(isZero, rhs.data, vmulq_f32(rhs.data, reciprocal))};
+    #endif
+}
+
+inline F128 round(const F128& rhs) {
+    #if defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM64EC)
+    return F128{vrndnq_f32(rhs.data)};
+    #else
+    // Ties are rounded away from zero
+    const uint32x4_t signMask = vdupq_n_u32(0x80000000u);
+    const uint32x4_t half = vorrq_u32(vandq_u32(vreinterpretq_u32_f32(rhs.data), signMask), vreinterpretq_u32_f32(vdupq_n_f32(0.5f)));
+    return F128{vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(rhs.data, vreinterpretq_f32_u32(half))))};
+    #endif
+}
+
+// 2^n, where each n must be a whole number in range [-126, 127]
+inline F128 pow2i(const F128& rhs) {
+    const int32x4_t biased = vaddq_s32(vcvtq_s32_f32(rhs.data), vdupq_n_s32(127));
+    return F128{vreinterpretq_f32_s32(vshlq_n_s32(biased, 23))};
+}
+
+inline F128 fmadd(const F128& lhs, const F128& rhs, const F128& addend) {
+    #if defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM64EC)
+    return F128{vfmaq_f32(addend.data, lhs.data, rhs.data)};
+    #else
+    // ARMv7 NEON has only the non-fused multiply-accumulate
+    return F128{vmlaq_f32(addend.data, lhs.data, rhs.data)};
+    #endif
+}
+
+inline F128 fnmadd(const F128& lhs, const F128& rhs, const F128& addend) {
+    #if defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM64EC)
+    return F128{vfmsq_f32(addend.data, lhs.data, rhs.data)};
+    #else
+    return F128{vmlsq_f32(addend.data, lhs.data, rhs.data)};
+    #endif
+}
+
 using F256 = fallback::T256<F128>;
 using fallback::transpose;
 using fallback::abs;
 using fallback::andnot;
 using fallback::rsqrt;
+using fallback::sqrt;
+using fallback::round;
+using fallback::pow2i;
+using fallback::fmadd;
+using fallback::fnmadd;
 
 } // namespace neon
 
+TRIMD_END_ISA_NAMESPACE
+
 } // namespace trimd
 
 #endif  // TRIMD_ENABLE_NEON
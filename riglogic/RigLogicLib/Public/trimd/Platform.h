@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "trimd/Macros.h"
+
 // *INDENT-OFF*
 #if defined(__arm__) || defined(__aarch64__) || defined(_M_ARM64) || defined(_M_ARM64EC)
     #define TRIMD_PLATFORM_ARM 1
@@ -14,6 +16,8 @@
 
 namespace trimd {
 
+// Declared outside of TRIMD_ISA_NAMESPACE, so it may be passed between translation units compiled for different
+// instruction sets
 struct CPUFeatures {
     // ARM
     bool NEON;
@@ -26,7 +30,10 @@ struct CPUFeatures {
     bool SSE41;
     bool SSE42;
     bool AVX;
+    bool AVX2;
+    bool FMA;
     bool F16C;
+    bool AVX512F;
 };
 
 }  // namespace trimd
@@ -53,6 +60,8 @@ struct CPUFeatures {
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 #ifdef TRIMD_PLATFORM_X86
     #ifdef _MSC_VER
         static void cpuidex(int info[4], int functionid, int subfunctionid) {
@@ -65,6 +74,19 @@ namespace trimd {
         }
     #endif
 
+    #ifdef _MSC_VER
+        static unsigned long long xgetbv(unsigned int index) {
+            return _xgetbv(index);
+        }
+    #else
+        static unsigned long long xgetbv(unsigned int index) {
+            unsigned int eax;
+            unsigned int edx;
+            __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (index));
+            return (static_cast<unsigned long long>(edx) << 32) | eax;
+        }
+    #endif
+
     inline CPUFeatures getCPUFeatures() {
         CPUFeatures flags = {};
         int info[4];
@@ -77,6 +99,22 @@ namespace trimd {
         flags.SSE42 = (info[2] & (1 << 20)) != 0;
         flags.AVX = (info[2] & (1 << 28)) != 0;
         flags.F16C = (info[2] & (1 << 29)) != 0;
+        flags.FMA = (info[2] & (1 << 12)) != 0;
+        // VEX and EVEX encoded instructions also require the OS to save the extended register state,
+        // YMM for AVX (XCR0 bits 1, 2), and additionally the opmask and ZMM state for AVX-512 (XCR0 bits 5, 6, 7)
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const unsigned long long xcr0 = (osxsave ? xgetbv(0) : 0ull);
+        const bool ymmEnabled = ((xcr0 & 0x06ull) == 0x06ull);
+        const bool zmmEnabled = ((xcr0 & 0xE6ull) == 0xE6ull);
+        flags.AVX = flags.AVX && ymmEnabled;
+        flags.F16C = flags.F16C && ymmEnabled;
+        flags.FMA = flags.FMA && ymmEnabled;
+        cpuidex(info, 0, 0);
+        if (info[0] >= 7) {
+            cpuidex(info, 7, 0);
+            flags.AVX2 = flags.AVX && ((info[1] & (1 << 5)) != 0);
+            flags.AVX512F = zmmEnabled && ((info[1] & (1 << 16)) != 0);
+        }
         return flags;
     }
 #endif  // TRIMD_PLATFORM_X86
@@ -155,16 +193,22 @@ namespace trimd {
     #endif  // __linux__
 #endif  // TRIMD_PLATFORM_ARM
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace trimd
 
 #else
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 inline CPUFeatures getCPUFeatures() {
     return CPUFeatures{};
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace trimd
 
 #endif  // TRIMD_ENABLE_RUNTIME_FEATURE_DETECTION
@@ -4,6 +4,7 @@
 
 // *INDENT-OFF*
 #ifdef TRIMD_ENABLE_SSE
+#include "trimd/Macros.h"
 #include "trimd/Fallback.h"
 #include "trimd/Polyfill.h"
 
@@ -11,6 +12,8 @@
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 namespace sse {
 
 struct F128 {
@@ -160,7 +163,7 @@ struct F128 {
     #endif  // TRIMD_ENABLE_F16C
 
     float sum() const {
-        __m128 temp = _mm_movehdup_ps(data);
+        __m128 temp = _mm_shuffle_ps(data, data, _MM_SHUFFLE(3, 3, 1, 1));
         __m128 result = _mm_add_ps(data, temp);
         temp = _mm_movehl_ps(temp, result);
         result = _mm_add_ss(result, temp);
@@ -295,14 +298,107 @@ inline F128 rsqrt(const F128& rhs) {
     #endif  // TRIMD_ENABLE_FAST_INVERSE_SQRT
 }
 
+inline F128 sqrt(const F128& rhs) {
+    return F128{_mm_sqrt_ps(rhs.data)};
+}
+
+// Round to nearest, using the current rounding mode (ties to even by default)
+inline F128 round(const F128& rhs) {
+    return F128{_mm_cvtepi32_ps(_mm_cvtps_epi32(rhs.data))};
+}
+
+// 2^n, where each n must be a whole number in range [-126, 127]
+inline F128 pow2i(const F128& rhs) {
+    const __m128i biased = _mm_add_epi32(_mm_cvtps_epi32(rhs.data), _mm_set1_epi32(127));
+    return F128{_mm_castsi128_ps(_mm_slli_epi32(biased, 23))};
+}
+
+// SSE has no fused multiply-add, so it's emulated (and rounds twice)
+inline F128 fmadd(const F128& lhs, const F128& rhs, const F128& addend) {
+    return F128{_mm_add_ps(_mm_mul_ps(lhs.data, rhs.data), addend.data)};
+}
+
+inline F128 fnmadd(const F128& lhs, const F128& rhs, const F128& addend) {
+    return F128{_mm_sub_ps(addend.data, _mm_mul_ps(lhs.data, rhs.data))};
+}
+
+// Four 32-bit integer lanes, used as accumulators of integer dot products
+struct I128 {
+    using value_type = std::int32_t;
+
+    __m128i data;
+
+    I128() : data{_mm_setzero_si128()} {
+    }
+
+    explicit I128(__m128i value) : data{value} {
+    }
+
+    explicit I128(std::int32_t value) : I128{_mm_set1_epi32(value)} {
+    }
+
+    I128(std::int32_t v1, std::int32_t v2, std::int32_t v3, std::int32_t v4) : data{_mm_set_epi32(v4, v3, v2, v1)} {
+    }
+
+    I128& operator+=(const I128& rhs) {
+        data = _mm_add_epi32(data, rhs.data);
+        return *this;
+    }
+
+    I128& operator-=(const I128& rhs) {
+        data = _mm_sub_epi32(data, rhs.data);
+        return *this;
+    }
+
+    static constexpr std::size_t size() {
+        return sizeof(decltype(data)) / sizeof(value_type);
+    }
+
+    static constexpr std::size_t alignment() {
+        return sizeof(decltype(data));
+    }
+
+};
+
+inline I128 operator+(const I128& lhs, const I128& rhs) {
+    return I128(lhs) += rhs;
+}
+
+inline I128 operator-(const I128& lhs, const I128& rhs) {
+    return I128(lhs) -= rhs;
+}
+
+// Sign extends four pairs of adjacent 8-bit integers to 16 bits, multiplies each pair with the pair of 16-bit integers
+// held by every 32-bit lane of pairs (low half first), and adds up the two products of each lane (pmaddwd)
+inline I128 madd8x2(const std::int8_t* source, const I128& pairs) {
+    const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+    // SSE2 has no sign extension, so each byte is duplicated into a 16-bit lane and arithmetically shifted back down
+    const __m128i words = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+    return I128{_mm_madd_epi16(words, pairs.data)};
+}
+
+inline F128 toFloat(const I128& rhs) {
+    return F128{_mm_cvtepi32_ps(rhs.data)};
+}
+
 using F256 = fallback::T256<F128>;
+using I256 = fallback::T256<I128>;
 using fallback::transpose;
 using fallback::abs;
 using fallback::andnot;
 using fallback::rsqrt;
+using fallback::sqrt;
+using fallback::round;
+using fallback::pow2i;
+using fallback::fmadd;
+using fallback::fnmadd;
+using fallback::madd8x2;
+using fallback::toFloat;
 
 } // namespace sse
 
+TRIMD_END_ISA_NAMESPACE
+
 } // namespace trimd
 
 #endif  // TRIMD_ENABLE_SSE
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "trimd/Macros.h"
 #include "trimd/Fallback.h"
 #include "trimd/Utils.h"
 
@@ -12,12 +13,15 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #ifdef _MSC_VER
     #pragma warning(pop)
 #endif
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 namespace scalar {
 
 template<typename T>
@@ -319,13 +323,86 @@ inline T128<T> rsqrt(const T128<T>& rhs) {
     #endif  // TRIMD_ENABLE_FAST_INVERSE_SQRT
 }
 
+template<typename T>
+inline T128<T> sqrt(const T128<T>& rhs) {
+    return {std::sqrt(rhs.data[0]),
+            std::sqrt(rhs.data[1]),
+            std::sqrt(rhs.data[2]),
+            std::sqrt(rhs.data[3])};
+}
+
+// Round to nearest (ties to even in the default rounding mode)
+template<typename T>
+inline T128<T> round(const T128<T>& rhs) {
+    return {std::nearbyint(rhs.data[0]),
+            std::nearbyint(rhs.data[1]),
+            std::nearbyint(rhs.data[2]),
+            std::nearbyint(rhs.data[3])};
+}
+
+// 2^n, where each n must be a whole number in range [-126, 127]
+template<typename T>
+inline T128<T> pow2i(const T128<T>& rhs) {
+    return {std::ldexp(1.0f, static_cast<int>(rhs.data[0])),
+            std::ldexp(1.0f, static_cast<int>(rhs.data[1])),
+            std::ldexp(1.0f, static_cast<int>(rhs.data[2])),
+            std::ldexp(1.0f, static_cast<int>(rhs.data[3]))};
+}
+
+// Emulated, rounds twice
+template<typename T>
+inline T128<T> fmadd(const T128<T>& lhs, const T128<T>& rhs, const T128<T>& addend) {
+    return {lhs.data[0] * rhs.data[0] + addend.data[0],
+            lhs.data[1] * rhs.data[1] + addend.data[1],
+            lhs.data[2] * rhs.data[2] + addend.data[2],
+            lhs.data[3] * rhs.data[3] + addend.data[3]};
+}
+
+template<typename T>
+inline T128<T> fnmadd(const T128<T>& lhs, const T128<T>& rhs, const T128<T>& addend) {
+    return {addend.data[0] - lhs.data[0] * rhs.data[0],
+            addend.data[1] - lhs.data[1] * rhs.data[1],
+            addend.data[2] - lhs.data[2] * rhs.data[2],
+            addend.data[3] - lhs.data[3] * rhs.data[3]};
+}
+
+// See sse::madd8x2
+inline T128<std::int32_t> madd8x2(const std::int8_t* source, const T128<std::int32_t>& pairs) {
+    T128<std::int32_t> result;
+    for (std::size_t i = 0ul; i < T128<std::int32_t>::size(); ++i) {
+        const auto bits = static_cast<std::uint32_t>(pairs.data[i]);
+        const auto low = static_cast<std::int16_t>(static_cast<std::uint16_t>(bits & 0xFFFFu));
+        const auto high = static_cast<std::int16_t>(static_cast<std::uint16_t>(bits >> 16u));
+        result.data[i] = source[i * 2ul] * low + source[i * 2ul + 1ul] * high;
+    }
+    return result;
+}
+
+inline T128<float> toFloat(const T128<std::int32_t>& rhs) {
+    return {static_cast<float>(rhs.data[0]),
+            static_cast<float>(rhs.data[1]),
+            static_cast<float>(rhs.data[2]),
+            static_cast<float>(rhs.data[3])};
+}
+
 using F128 = T128<float>;
+using I128 = T128<std::int32_t>;
 using F256 = fallback::T256<F128>;
+using I256 = fallback::T256<I128>;
 using fallback::transpose;
 using fallback::abs;
 using fallback::andnot;
 using fallback::rsqrt;
+using fallback::sqrt;
+using fallback::round;
+using fallback::pow2i;
+using fallback::fmadd;
+using fallback::fnmadd;
+using fallback::madd8x2;
+using fallback::toFloat;
 
 }  // namespace scalar
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace trimd
@@ -2,21 +2,45 @@
 
 #pragma once
 
+#include "trimd/Macros.h"
 #include "trimd/Platform.h"
 // Includes that go after platform detection macros
 #include "trimd/AVX.h"
+#include "trimd/AVX512.h"
 #include "trimd/NEON.h"
 #include "trimd/SSE.h"
 #include "trimd/Scalar.h"
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
+#if defined(TRIMD_ENABLE_AVX512)
+    using F512 = avx512::F512;
+    using avx512::abs;
+    using avx512::transpose;
+    using avx512::andnot;
+    using avx512::rsqrt;
+    using avx512::sqrt;
+    using avx512::round;
+    using avx512::pow2i;
+    using avx512::fmadd;
+    using avx512::fnmadd;
+#endif  // TRIMD_ENABLE_AVX512
+
 #if defined(TRIMD_ENABLE_AVX)
     using F256 = avx::F256;
     using avx::abs;
     using avx::transpose;
     using avx::andnot;
     using avx::rsqrt;
+    using avx::sqrt;
+    using avx::round;
+    using avx::pow2i;
+    using avx::fmadd;
+    using avx::fnmadd;
+    using avx::madd8x2;
+    using avx::toFloat;
 #elif defined(TRIMD_ENABLE_SSE)
     using F256 = sse::F256;
 #elif defined(TRIMD_ENABLE_NEON)
@@ -31,12 +55,24 @@ namespace trimd {
     using sse::transpose;
     using sse::andnot;
     using sse::rsqrt;
+    using sse::sqrt;
+    using sse::round;
+    using sse::pow2i;
+    using sse::fmadd;
+    using sse::fnmadd;
+    using sse::madd8x2;
+    using sse::toFloat;
 #elif defined(TRIMD_ENABLE_NEON)
     using F128 = neon::F128;
     using neon::abs;
     using neon::transpose;
     using neon::andnot;
     using neon::rsqrt;
+    using neon::sqrt;
+    using neon::round;
+    using neon::pow2i;
+    using neon::fmadd;
+    using neon::fnmadd;
 #else
     using F128 = scalar::F128;
 #endif  // TRIMD_ENABLE_SSE
@@ -45,5 +81,16 @@ using scalar::abs;
 using scalar::transpose;
 using scalar::andnot;
 using scalar::rsqrt;
+using scalar::sqrt;
+using scalar::round;
+using scalar::pow2i;
+using scalar::fmadd;
+using scalar::fnmadd;
+using scalar::madd8x2;
+using scalar::toFloat;
+
+TRIMD_END_ISA_NAMESPACE
 
 }  // namespace trimd
+
+#include "trimd/Math.h"
@@ -15,6 +15,8 @@
 
 namespace trimd {
 
+TRIMD_BEGIN_ISA_NAMESPACE
+
 template<typename TTarget, typename TSource>
 FORCE_INLINE TTarget bitcast(TSource source) {
     static_assert(sizeof(TTarget) == sizeof(TSource), "Target and source must be of equal size.");
@@ -23,4 +25,6 @@ FORCE_INLINE TTarget bitcast(TSource source) {
     return target;
 }
 
+TRIMD_END_ISA_NAMESPACE
+
 }  // namespace trimd
@@ -46,6 +46,17 @@ class TRIOAPI MemoryMappedFileStream : public BoundedIOStream, public Buffered,
         MemoryMappedFileStream(MemoryMappedFileStream&&) = default;
         MemoryMappedFileStream& operator=(MemoryMappedFileStream&&) = default;
 
+        /**
+            @brief Direct access to the mapped contents of the file.
+            @return
+                Pointer to the first byte of the file if the whole file is mapped into a single view, nullptr otherwise
+                (e.g. if the stream is not open, the file is empty or the platform has no memory mapping support).
+                The default implementation returns nullptr.
+            @warning
+                The pointer is invalidated by closing, resizing or writing past the end of the stream.
+        */
+        virtual const char* getMappedData();
+
 };
 
 }  // namespace trio